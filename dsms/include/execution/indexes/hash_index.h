@@ -29,10 +29,19 @@ namespace Execution {
 
 	// forward decl.
 	class HashIndexIterator;
+	class OpenHashIndexIterator;
 	
 	// Implementation is essentially the standard one: fixed number of
 	// buckets, and an index structure that linearizes memory for layout
 	// of buckets. [[ Explanation ]]
+	//
+	// Alternatively (setOpenAddressing), the index is an open addressing
+	// table in the style of Swiss tables: each slot has a control byte
+	// with 7 bits of the hash of its entry, and we probe groups of 16
+	// slots, comparing their control bytes with SSE2 instructions.  The
+	// table grows when it gets too full and shrinks when it gets too
+	// empty, and in both cases entries move to the new table a few
+	// groups at a time, with each update, rather than all at once.
 	
 	class HashIndex : public Index {
 	private:
@@ -137,6 +146,52 @@ namespace Execution {
 		std::ostream&         LOG;
 		
 		static const unsigned int UPDATE_ROLE = 6;
+		
+		//----------------------------------------------------------------------
+		// Open addressing layout
+		//----------------------------------------------------------------------
+		
+		/// Number of slots whose control bytes are probed together
+		static const unsigned int GROUP_SIZE = 16;
+		
+		/// Number of groups of the old table moved to the new table with
+		/// each update, while we resize
+		static const unsigned int REHASH_GROUPS = 4;
+		
+		/// Control bytes: full slots have 7 bits of the hash of their
+		/// entry
+		static const unsigned char CTRL_EMPTY   = 0x80;
+		static const unsigned char CTRL_DELETED = 0xFE;
+		
+		/// An open addressing table.  Each page holds the control bytes,
+		/// hash values and tuples of slotsPerPage consecutive slots
+		struct Table {
+			char         **pages;
+			unsigned int   numPages;
+			unsigned int   numSlots;
+			unsigned int   numFull;
+			unsigned int   numDeleted;
+		};
+		
+		/// Use the open addressing layout?
+		bool                  bOpen;
+		
+		/// The table we insert into
+		Table                 table;
+		
+		/// The table we are moving entries out of (if bRehashing)
+		Table                 oldTable;
+		
+		bool                  bRehashing;
+		
+		/// Next group of oldTable to move
+		unsigned int          rehashGroup;
+		
+		/// log_2 (number of slots per page)
+		unsigned int          logSlotsPerPage;
+		
+		/// Tuple iterator for scanning the open addressing table
+		OpenHashIndexIterator *openIter;
 
 #ifdef _MONITOR_
 		/// Number of hash entries
@@ -145,6 +200,7 @@ namespace Execution {
 		
 	public:
 		friend class HashIndexIterator;
+		friend class OpenHashIndexIterator;
 		
 		HashIndex (unsigned int id, std::ostream& LOG);
 		virtual ~HashIndex();
@@ -155,12 +211,21 @@ namespace Execution {
 		int setScanHashEval (HEval *hashEval);
 		int setKeyEqual (BEval *keyEqual);
 		int setThreshold (float threshold);
+		
+		/**
+		 * Use the open addressing layout.  The threshold is then the
+		 * maximum fraction of slots that are full or deleted.
+		 */
+		int setOpenAddressing (bool bOpen);
+		
 		int initialize();
 		
 		int insertTuple (Tuple tuple);
 		int deleteTuple (Tuple tuple);
 		int getScan (TupleIterator *&iter);
 		int releaseScan (TupleIterator *iter);
+		int prefetchScan (Hash &hashValue);
+		int getScan (Hash hashValue, TupleIterator *&iter);
 		
 		void printDist() const;
 
@@ -178,6 +243,48 @@ namespace Execution {
 		int doubleNumBuckets ();
 		int rehashBucketIndexNode (char *, char *, unsigned int, Hash);		
 		int rehashBucket (Entry **, Entry **, Hash);		
+		
+		// Open addressing layout
+		int openInsertTuple (Tuple tuple);
+		int openDeleteTuple (Tuple tuple);
+		
+		int allocTable (Table &t, unsigned int numSlots);
+		void freeTable (Table &t);
+		void insertEntry (Table &t, Tuple tuple, Hash hashValue);
+		bool deleteEntry (Table &t, Tuple tuple, Hash hashValue);
+		void clearSlot (Table &t, unsigned char *ctrl, unsigned int s);
+		
+		unsigned int getTargetNumSlots () const;
+		int startRehash (unsigned int numSlots);
+		void rehashStep ();
+		
+		unsigned int getNumGroups (const Table &t) const {
+			return t.numSlots / GROUP_SIZE;
+		}
+		
+		unsigned char *getCtrl (const Table &t, unsigned int slot) const {
+			return (unsigned char *)t.pages [slot >> logSlotsPerPage] +
+				(slot & ((1 << logSlotsPerPage) - 1));
+		}
+		
+		Hash *getHash (const Table &t, unsigned int slot) const {
+			return (Hash *)(t.pages [slot >> logSlotsPerPage] +
+							(1 << logSlotsPerPage)) +
+				(slot & ((1 << logSlotsPerPage) - 1));
+		}
+		
+		Tuple *getTuple (const Table &t, unsigned int slot) const {
+			return (Tuple *)(t.pages [slot >> logSlotsPerPage] +
+							 (1 << logSlotsPerPage) * (1 + sizeof (Hash))) +
+				(slot & ((1 << logSlotsPerPage) - 1));
+		}
+		
+		/// Bitmask of the slots of a group whose control byte is ctrl
+		static unsigned int matchCtrl (const unsigned char *group,
+									   unsigned char ctrl);
+		
+		/// Bitmask of the empty or deleted slots of a group
+		static unsigned int matchFree (const unsigned char *group);
 	};
 	
 	class HashIndexIterator : public TupleIterator {
@@ -233,6 +340,67 @@ namespace Execution {
 			return true;
 		}
 	};
+	
+	/**
+	 * Iterator over the entries of an open addressing HashIndex with a
+	 * given hash value and key: we follow the probe sequence of the hash
+	 * value until a group with an empty slot, first in the current
+	 * table and then in the old table if the index is being resized.
+	 */
+	class OpenHashIndexIterator : public TupleIterator {
+	private:
+		const HashIndex      *index;
+		EvalContext          *evalContext;
+		BEval                *keyEqual;
+		
+		/// Table being probed
+		const HashIndex::Table *table;
+		
+		/// Hash value and control byte we look for
+		Hash                  hashValue;
+		unsigned char         ctrl;
+		
+		/// Current group, and number of groups probed in the table
+		unsigned int          group;
+		unsigned int          numProbed;
+		
+		/// Slots of the current group still to be checked
+		unsigned int          matches;
+		
+		/// Does the probe sequence end with the current group?
+		bool                  bLastGroup;
+		
+		/// Next tuple to return (0 if none)
+		Tuple                 next;
+		
+		static const unsigned int SCAN_ROLE = 7;
+		
+		void startTable (const HashIndex::Table *table);
+		void findNext ();
+		
+	public:
+		OpenHashIndexIterator (const HashIndex *_index,
+							   EvalContext     *_evalContext,
+							   BEval           *_keyEqual) {
+			index = _index;
+			evalContext = _evalContext;
+			keyEqual = _keyEqual;
+		}
+		
+		~OpenHashIndexIterator () {}
+		
+		int initialize (Hash hashValue);
+		
+		bool getNext (Tuple& tuple) {
+			if (!next)
+				return false;
+			
+			tuple = next;
+			findNext ();
+			
+			return true;
+		}
+	};
 }
 
 #endif
@@ -1,6 +1,10 @@
 #ifndef _INDEX_
 #define _INDEX_
 
+#ifndef _TYPES_
+#include "common/types.h"
+#endif
+
 #ifndef _TUPLE_
 #include "execution/internals/tuple.h"
 #endif
@@ -27,6 +31,24 @@ namespace Execution {
 		virtual int deleteTuple (Tuple tuple) = 0;
 		virtual int getScan (TupleIterator *& iter) = 0;
 		virtual int releaseScan (TupleIterator *iter) = 0;
+		
+		/**
+		 * Compute the hash of the scan key of the currently bound tuples,
+		 * and prefetch the part of the index that a scan for it starts
+		 * with.  Indexes that cannot do better just return 0.
+		 */
+		virtual int prefetchScan (Hash &hashValue) {
+			hashValue = 0;
+			return 0;
+		}
+		
+		/**
+		 * getScan, with the hashValue of a prefetchScan for the same
+		 * bindings.
+		 */
+		virtual int getScan (Hash hashValue, TupleIterator *& iter) {
+			return getScan (iter);
+		}
 	};
 #else
 	class Index {
@@ -37,6 +59,24 @@ namespace Execution {
 		virtual int deleteTuple (Tuple tuple) = 0;
 		virtual int getScan (TupleIterator *& iter) = 0;
 		virtual int releaseScan (TupleIterator *iter) = 0;
+		
+		/**
+		 * Compute the hash of the scan key of the currently bound tuples,
+		 * and prefetch the part of the index that a scan for it starts
+		 * with.  Indexes that cannot do better just return 0.
+		 */
+		virtual int prefetchScan (Hash &hashValue) {
+			hashValue = 0;
+			return 0;
+		}
+		
+		/**
+		 * getScan, with the hashValue of a prefetchScan for the same
+		 * bindings.
+		 */
+		virtual int getScan (Hash hashValue, TupleIterator *& iter) {
+			return getScan (iter);
+		}
 	};
 #endif	
 	
@@ -7,6 +7,10 @@
 #include "execution/internals/eval_context.h"
 #endif
 
+#ifndef _CHAR_OPS_
+#include "execution/internals/char_ops.h"
+#endif
+
 namespace Execution {
 	
 	enum AOp {		
@@ -38,8 +42,22 @@ namespace Execution {
 		unsigned int c2;
 		unsigned int dr;
 		unsigned int dc;		
+		
+		/// Width of the copied CHAR column (0 if not known)
+		unsigned int len;
+		
+		AInstr () : len (0) {}
 	};
 	
+	/// An instruction compiled to a function
+	typedef void (*AFunc) (char **roles, const AInstr &instr);
+	
+	/**
+	 * An arithmetic evaluator.  As for BEval, the arithmetic and copy
+	 * instructions are compiled to pre-instantiated functions as they are
+	 * added, and the evaluator interprets its instructions only if some
+	 * are not compiled.
+	 */
 	struct AEval {
 	private:
 		static const unsigned int MAX_INSTRS = 20;
@@ -48,14 +66,56 @@ namespace Execution {
 		unsigned int numInstrs;
 		char **roles;		
 		
+		/// Compiled instructions
+		AFunc funcs [MAX_INSTRS];
+		
+		/// Are all the instructions compiled?
+		bool bCompiled;
+		
 	public:
 		AEval ();
 		~AEval ();
 		
 		int addInstr (AInstr instr);
 		int setEvalContext (EvalContext *evalContext);		
-
+		
+		/**
+		 * Are all the instructions compiled?
+		 */
+		bool isCompiled () const {
+			return bCompiled;
+		}
+		
 		inline void eval () {
+			if (!bCompiled) {
+				interpret ();
+				return;
+			}
+			
+			for (unsigned int i = 0 ; i < numInstrs ; i++)
+				(*funcs [i]) (roles, instrs [i]);
+		}
+
+		/**
+		 * Can the evaluator be run using evalBatch()?  True if it only
+		 * does arithmetic and copies, with all the results going to
+		 * outRole.
+		 */
+		bool isVectorizable (unsigned int outRole) const;
+		
+		/**
+		 * Run the evaluator over a batch: inTuples[t] and outTuples[t]
+		 * are bound in turn to inRole and outRole; the other roles are
+		 * as bound for eval().
+		 */
+		void evalBatch (const Tuple *inTuples, const Tuple *outTuples,
+						unsigned int numTuples, unsigned int inRole,
+						unsigned int outRole);
+		
+		/**
+		 * Evaluate by interpreting the instructions
+		 */
+		inline void interpret () {
 			
 			for (unsigned int i = 0 ; i < numInstrs ; i++) {
 				
@@ -131,8 +191,9 @@ namespace Execution {
 					break;
 					
 				case CHR_CPY:
-					strcpy (CLOC(instrs[i].dr, instrs[i].dc),
-							CLOC(instrs[i].r1, instrs[i].c1));
+					charCopy (CLOC(instrs[i].dr, instrs[i].dc),
+							  CLOC(instrs[i].r1, instrs[i].c1),
+							  instrs[i].len);
 					break;
 					
 				case BYT_CPY:
@@ -183,7 +244,7 @@ namespace Execution {
 					break;
 					
 				case FLT_UMN:
-					if (FLOC (instrs [i].r1, instrs [i].c1) <
+					if (FLOC (instrs [i].r1, instrs [i].c1) >
 						FLOC (instrs [i].r2, instrs [i].c2)) {
 						
 						FLOC (instrs [i].dr, instrs [i].dc) = 
@@ -210,6 +271,9 @@ namespace Execution {
 				}
 			}
 		}
+		
+	private:
+		static AFunc compile (const AInstr &instr);
 	};
 }
 
@@ -11,6 +11,10 @@
 #include "execution/internals/aeval.h"
 #endif
 
+#ifndef _CHAR_OPS_
+#include "execution/internals/char_ops.h"
+#endif
+
 #define CHECK(b) { if(!(b)) return false;}
 #define EVAL(e) { if ((e)) (e)-> eval();}
 
@@ -76,8 +80,25 @@ namespace Execution {
 		Column         c2;
 		AEval         *e1;
 		AEval         *e2;
+		
+		/// Width of the compared CHAR columns (0 if not known)
+		unsigned int   len;
+		
+		BInstr () : len (0) {}
 	};
 	
+	/// An instruction compiled to a function: returns the result of the
+	/// comparison
+	typedef bool (*BFunc) (char **roles, const BInstr &instr);
+	
+	/**
+	 * A boolean evaluator: a conjunction of comparisons.
+	 *
+	 * The common instructions are compiled, as they are added, to
+	 * functions pre-instantiated from templates for each type and
+	 * comparison.  If all the instructions are compiled, eval() calls
+	 * their functions; otherwise it interprets the instructions.
+	 */
 	class BEval {
 	private:
 		static const unsigned int MAX_INSTRS = 20;
@@ -86,6 +107,12 @@ namespace Execution {
 		unsigned       numInstrs;
 		char         **roles;
 		
+		/// Compiled instructions
+		BFunc          funcs [MAX_INSTRS];
+		
+		/// Are all the instructions compiled?
+		bool           bCompiled;
+		
 	public:
 		BEval ();
 		~BEval ();
@@ -93,7 +120,50 @@ namespace Execution {
 		int setEvalContext (EvalContext *evalContext);
 		int addInstr (BInstr instr);
 		
+		/**
+		 * Are all the instructions compiled?
+		 */
+		bool isCompiled () const {
+			return bCompiled;
+		}
+		
 		inline bool eval () const {
+			if (!bCompiled)
+				return interpret ();
+			
+			for (unsigned int i = 0 ; i < numInstrs ; i++)
+				if (!(*funcs [i]) (roles, instrs [i]))
+					return false;
+			
+			return true;
+		}
+		
+		/**
+		 * Can the predicate be evaluated using evalBatch()?  True if it
+		 * only compares integer, float and byte attributes (no
+		 * arithmetic, no strings).
+		 */
+		bool isVectorizable () const;
+		
+		/**
+		 * Evaluate the predicate over a batch of tuples, each bound in
+		 * turn to role; the other roles are as bound for eval().  The
+		 * predicate is evaluated one instruction at a time over
+		 * VECTOR_SIZE tuples.
+		 *
+		 * @param tuples     the tuples
+		 * @param numTuples  number of tuples
+		 * @param role       role to which the tuples are bound
+		 * @param sel        (output) selection vector: sel[t] is
+		 *                   nonzero iff tuples[t] satisfies the predicate
+		 */
+		void evalBatch (const Tuple *tuples, unsigned int numTuples,
+						unsigned int role, unsigned char *sel) const;
+		
+		/**
+		 * Evaluate by interpreting the instructions
+		 */
+		inline bool interpret () const {
 			for (unsigned int i = 0 ; i < numInstrs ; i++) {
 				switch (instrs [i].op) {
 				case INT_LT: 
@@ -194,33 +264,39 @@ namespace Execution {
 					
 
 				case CHR_LT: 
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) < 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) < 0);
 					break;
 
 				case CHR_LE:
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) <= 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) <= 0);
 					break;
 
 				case CHR_GT:
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) > 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) > 0);
 					break;
 
 				case CHR_GE:
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) >= 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) >= 0);
 					break;
 
 				case CHR_EQ:
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) == 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) == 0);
 					break;
 					
 				case CHR_NE:
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) != 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) != 0);
 					break;
 
 
@@ -377,48 +453,54 @@ namespace Execution {
 					EVAL (instrs[i].e1);
 					EVAL (instrs[i].e2);
 					
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) < 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) < 0);
 					break;
 
 				case C_CHR_LE:
 					EVAL (instrs[i].e1);
 					EVAL (instrs[i].e2);
 					
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) <= 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) <= 0);
 					break;
 
 				case C_CHR_GT:
 					EVAL (instrs[i].e1);
 					EVAL (instrs[i].e2);
 					
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) > 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) > 0);
 					break;
 
 				case C_CHR_GE:
 					EVAL (instrs[i].e1);
 					EVAL (instrs[i].e2);
 					
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) >= 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) >= 0);
 					break;
 
 				case C_CHR_EQ:
 					EVAL (instrs[i].e1);
 					EVAL (instrs[i].e2);
 					
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) == 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) == 0);
 					break;
 					
 				case C_CHR_NE:
 					EVAL (instrs[i].e1);
 					EVAL (instrs[i].e2);
 					
-					CHECK(strcmp (CLOC(instrs[i].r1, instrs[i].c1),
-								  CLOC(instrs[i].r2, instrs[i].c2)) != 0);
+					CHECK(charCompare (CLOC(instrs[i].r1, instrs[i].c1),
+									   CLOC(instrs[i].r2, instrs[i].c2),
+									   instrs[i].len) != 0);
 					break;
 					
 				default:
@@ -428,6 +510,9 @@ namespace Execution {
 			
 			return true;
 		}
+		
+	private:
+		static BFunc compile (const BInstr &instr);
 	};
 }
 #endif
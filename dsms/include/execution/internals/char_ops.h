@@ -0,0 +1,59 @@
+#ifndef _CHAR_OPS_
+#define _CHAR_OPS_
+
+/**
+ * @file       char_ops.h
+ * @date       Oct. 17, 2026
+ * @brief      Comparison, copy and hashing of CHAR columns.
+ */
+
+#include <string.h>
+
+#ifndef _TYPES_
+#include "common/types.h"
+#endif
+
+/**
+ * A CHAR column stores a null-terminated string in a fixed number of
+ * bytes: the width of the column, known from its TupleLayout.  The
+ * bytes after the terminator are undefined, and a string that fills
+ * the column has no terminator.
+ *
+ * The routines below take the width (len) of the column, and work on
+ * 16 bytes at a time without reading past it.  A width of 0 stands for
+ * "unknown": the routines then fall back to the C string functions.
+ */
+
+namespace Execution {
+
+	/**
+	 * Compare two CHAR columns, as strncmp (s1, s2, len).
+	 */
+	int charCompare (const char *s1, const char *s2, unsigned int len);
+
+	/**
+	 * Length of the string in a CHAR column, as strnlen (s, len).
+	 */
+	unsigned int charLength (const char *s, unsigned int len);
+
+	/**
+	 * Update a hash value with the string in a CHAR column.  The hash is
+	 * the CRC32C of the string, computed with the SSE4.2 crc32
+	 * instruction on CPUs that have it.  It depends only on the string,
+	 * not on the width of the column.
+	 */
+	Hash charHash (const char *s, unsigned int len, Hash hash);
+
+	/**
+	 * Copy a CHAR column.  The destination column is at least len bytes
+	 * wide.
+	 */
+	inline void charCopy (char *dst, const char *src, unsigned int len) {
+		if (len)
+			memcpy (dst, src, len);
+		else
+			strcpy (dst, src);
+	}
+}
+
+#endif
@@ -16,6 +16,29 @@ namespace Execution {
 		char *roles [MAX_ROLES];
 		void bind (Tuple tuple, unsigned int roleId);
 	};
+	
+	/// Number of tuples that the batch evaluators (BEval::evalBatch,
+	/// AEval::evalBatch) process at a time
+	static const unsigned int VECTOR_SIZE = 64;
+	
+	/**
+	 * Gather column c of a batch of tuples into vals, the columnar
+	 * scratch space of the batch evaluators.  If tuples is null, the
+	 * column of the fixed tuple is repeated numTuples times.
+	 */
+	template <class T>
+	inline void gatherColumn (T *vals, const Tuple *tuples, char *fixed,
+							  Column c, unsigned int numTuples) {
+		if (tuples) {
+			for (unsigned int t = 0 ; t < numTuples ; t++)
+				vals [t] = ((T *)tuples [t]) [c];
+		}
+		else {
+			T val = ((T *)fixed) [c];
+			for (unsigned int t = 0 ; t < numTuples ; t++)
+				vals [t] = val;
+		}
+	}
 }
 
 #endif
@@ -9,6 +9,10 @@
 #include "execution/internals/eval_context.h"
 #endif
 
+#ifndef _CHAR_OPS_
+#include "execution/internals/char_ops.h"
+#endif
+
 #ifndef _DEBUG_
 #include "common/debug.h"
 #endif
@@ -25,8 +29,21 @@ namespace Execution {
 		Type         type;
 		unsigned int r;
 		Column       c;
+		
+		/// Width of a CHAR column (0 if not known)
+		unsigned int len;
+		
+		HInstr () : len (0) {}
 	};
 	
+	/// An instruction compiled to a function: returns the hash updated
+	/// with the column of the instruction
+	typedef Hash (*HFunc) (char **roles, const HInstr &instr, Hash hash);
+	
+	/**
+	 * A hash evaluator.  As for BEval, the instructions are compiled to
+	 * pre-instantiated functions (one per column type) as they are added.
+	 */
 	class HEval {
 	private:
 		static const unsigned int MAX_INSTRS = 20;
@@ -34,6 +51,12 @@ namespace Execution {
 		unsigned int   numInstrs;
 		HInstr         instrs [MAX_INSTRS];
 		
+		/// Compiled instructions
+		HFunc          funcs [MAX_INSTRS];
+		
+		/// Are all the instructions compiled?
+		bool           bCompiled;
+		
 	public:
 		HEval ();
 		~HEval ();
@@ -41,32 +64,52 @@ namespace Execution {
 		int setEvalContext (EvalContext *evalContext);			
 		int addInstr (HInstr instr);
 		
-		inline Hash eval () const {			
+		/**
+		 * Are all the instructions compiled?
+		 */
+		bool isCompiled () const {
+			return bCompiled;
+		}
+		
+		inline Hash eval () const {
+			Hash hash = 5381;
+			
+			if (!bCompiled)
+				return interpret ();
+			
+			for (unsigned int i = 0 ; i < numInstrs ; i++)
+				hash = (*funcs [i]) (roles, instrs [i], hash);
+			
+			return finish (hash);
+		}
+		
+		/**
+		 * Evaluate by interpreting the instructions
+		 */
+		inline Hash interpret () const {			
 			Hash hash = 5381;			
-			char *cptr; 
-			int c;
 			
 			for (unsigned int i = 0 ; i < numInstrs ; i++) {
 				switch (instrs[i].type) {
 				case INT:
-					hash = ((hash << 5) + hash) + 
-						inthash (ILOC(instrs[i].r, instrs[i].c));
+					hash = combine (hash, ILOC(instrs[i].r, instrs[i].c));
 					break;
 					
 				case BYTE:
 					
-					hash = ((hash << 5) + hash) + 
-						BLOC(instrs[i].r, instrs[i].c);
+					hash = combine (hash, (unsigned char)
+									BLOC(instrs[i].r, instrs[i].c));
 					break;
 					
 				case CHAR:
 					
-					cptr = CLOC (instrs[i].r, instrs[i].c);
-					while ((c = *cptr++))
-						hash = ((hash << 5) + hash) + c;
+					hash = charHash (CLOC (instrs[i].r, instrs[i].c),
+									 instrs[i].len, hash);
 					break;
 					
 				case FLOAT:
+					hash = combine (hash, floatBits (FLOC(instrs[i].r,
+														  instrs[i].c)));
 					break;
 					
 				default:					
@@ -74,26 +117,55 @@ namespace Execution {
 				}
 			}
 			
+			return finish (hash);
+		}
+		
+		// The hash of a tuple is built 32 bits at a time with the mixing
+		// steps of MurmurHash3, so that every bit of every column
+		// affects every bit of the hash: indexes use both the low bits
+		// (bucket) and the high bits of hash values.
+		
+		/**
+		 * Update a hash value with a 32-bit word.
+		 */
+		static inline Hash combine (Hash hash, unsigned int word) {
+			word *= 0xcc9e2d51;
+			word  = (word << 15) | (word >> 17);
+			word *= 0x1b873593;
+			
+			hash ^= word;
+			hash  = (hash << 13) | (hash >> 19);
+			return hash * 5 + 0xe6546b64;
+		}
+		
+		/**
+		 * Final avalanche of a hash value.
+		 */
+		static inline Hash finish (Hash hash) {
+			hash ^= hash >> 16;
+			hash *= 0x85ebca6b;
+			hash ^= hash >> 13;
+			hash *= 0xc2b2ae35;
+			hash ^= hash >> 16;
 			return hash;
 		}
-
-	private:
 		
-		// Hash function from 
-		// http://www.concentric.net/~Ttwang/tech/inthash.htm
-		inline int inthash(int key) const {			
-			key += ~(key << 15);
-			key ^=  (key >> 10);
-			key +=  (key << 3);
-			key ^=  (key >> 6);
-			key += ~(key << 11);
-			key ^=  (key >> 16);
-			return key;
+		/**
+		 * The bits of a float, such that floats that compare equal have
+		 * the same bits (0.0 and -0.0).
+		 */
+		static inline unsigned int floatBits (float f) {
+			union {
+				float        f;
+				unsigned int u;
+			} bits;
+			
+			bits.f = (f == 0)? 0 : f;
+			return bits.u;
 		}
 		
-		//inline int inthash(int key) const {
-		//	return key;
-		//}		
+	private:
+		static HFunc compile (const HInstr &instr);
 	};
 }
 
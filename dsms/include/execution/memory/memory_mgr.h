@@ -2,41 +2,176 @@
 #define _MEMORY_MGR_
 
 #include <ostream>
+#include <pthread.h>
 
 #ifndef _DEBUG_
 #include "common/debug.h"
 #endif
 
+#ifdef _MONITOR_
+#ifndef _MEMORY_MONITOR_
+#include "execution/monitors/memory_monitor.h"
+#endif
+#endif
+
+/**
+ * The memory manager hands out pages of PAGE_SIZE bytes from arenas of
+ * ARENA_SIZE bytes mapped from the system.  Arenas are aligned to
+ * ARENA_SIZE, and the first page of an arena holds its header, so the
+ * arena (and page) of any pointer into our memory is found by masking
+ * the pointer.
+ *
+ * The manager starts with enough arenas for the configured memory size
+ * and maps new arenas when it runs out of pages, up to an optional
+ * limit.  Pages of an arena are handed out in address order the first
+ * time, so memory is committed only when it is used.
+ *
+ * Optionally, arenas are backed by huge pages (explicit huge pages if
+ * the system has reserved some, transparent huge pages otherwise), and
+ * the arenas are bound to NUMA nodes: a page is allocated from an arena
+ * of the node of the cpu that asks for it.
+ *
+ * Each thread allocates and deallocates pages through its own page
+ * cache, without locking.  A cache takes CACHE_BATCH pages at a time
+ * from the shared lists when it is empty, and gives CACHE_BATCH pages
+ * back when it holds twice as many.  The caches count hits, refills and
+ * frees of pages allocated by other threads (the arena header records
+ * the cache that allocated each of its pages), and report them to the
+ * memory monitor in batches.
+ */
+
 namespace Execution {
 	
+#ifdef _MONITOR_
+	class MemoryManager : public Monitor::MemoryMonitor {
+#else
 	class MemoryManager {
+#endif
 	private:
-
+	
 		/// System-wide unique identifier
 		unsigned int id;
 		
-		/// Memory being managed
-		char *memory;
-		
 		/// Size of each page of memory
 		static const unsigned int PAGE_SIZE     = 4096;
-		static const unsigned int LOG_PAGE_SIZE = 12;	   
-		static const unsigned int PAGE_MASK     = 0xfffff000;
+		static const unsigned int LOG_PAGE_SIZE = 12;
+		
+		/// Size of each arena of pages (64 MB)
+		static const unsigned int LOG_ARENA_SIZE = 26;
+		static const unsigned long ARENA_SIZE = (1UL << LOG_ARENA_SIZE);
+		
+		/// Maximum number of arenas
+		static const unsigned int MAX_ARENAS = 4096;
+		
+		/// Maximum number of NUMA nodes
+		static const unsigned int MAX_NODES = 64;
+		
+		/// getId() ids have this granularity (in log bytes)
+		static const unsigned int LOG_ID_ALIGN = 2;
+		
+		/// Number of pages moved between a page cache and the shared lists
+		/// at a time
+		static const unsigned int CACHE_BATCH = 32;
+		
+		/// Number of events a page cache counts before it reports them
+		static const int CACHE_REPORT = 1024;
+		
+		/// Header stored in the first pages of an arena
+		struct ArenaHeader {
+			/// Position of the arena in arenas
+			unsigned int index;
+			
+			/// NUMA node of the arena
+			unsigned int node;
+			
+			/// Id of the cache that allocated each page of the arena
+			unsigned char owners [ARENA_SIZE >> LOG_PAGE_SIZE];
+		};
+		
+		/// Number of pages holding the arena header
+		static const unsigned int HEADER_PAGES =
+			(sizeof (ArenaHeader) + PAGE_SIZE - 1) / PAGE_SIZE;
+		
+		/// Pages cached by a thread
+		struct PageCache {
+			/// Memory manager of the cache
+			MemoryManager *memMgr;
+			
+			/// Linked list of cached pages
+			char *pages;
+			
+			/// Number of cached pages
+			unsigned int numPages;
+			
+			/// Id recorded as owner of the pages allocated through this
+			/// cache (never 0)
+			unsigned char id;
+			
+			/// Events not reported to the monitor yet
+			int numHits;
+			int numRefills;
+			int numRemoteFrees;
+			int numEvents;
+		};
+		
+		/// Pages of a NUMA node
+		struct Node {
+			/// Linked list of deallocated pages
+			char *emptyPageList;
+			
+			/// Next page never allocated in the last arena of the node
+			char *nextPage;
+			
+			/// End of the last arena of the node
+			char *arenaEnd;
+			
+			/// Arenas of the node from this position in arenas on have
+			/// not been used yet
+			unsigned int nextArena;
+		};
+		
+		/// Arenas mapped so far
+		char *arenas [MAX_ARENAS];
 		
-		// Amount of memory
-		unsigned int memorySize;
+		/// Number of arenas
+		unsigned int numArenas;
 		
-		/// Number of pages in memory
-		unsigned int numPages;
+		/// Maximum number of arenas that we can map
+		unsigned int maxArenas;
+		
+		/// Memory size we start with
+		unsigned long long int memorySize;
+		
+		/// Limit on the memory size (0 for none)
+		unsigned long long int maxMemorySize;
+		
+		/// Back arenas with huge pages?
+		bool bHugePages;
+		
+		/// Bind arenas to NUMA nodes?
+		bool bNuma;
+		
+		/// NUMA nodes
+		Node nodes [MAX_NODES];
+		
+		/// Number of NUMA nodes
+		unsigned int numNodes;
 		
 		/// System-wide logger
 		std::ostream  &LOG;
 		
-		/// Linked list of empty pages
-		char *emptyPageList;
+		/// Lock for the arenas and empty pages lists: pages are allocated
+		/// and deallocated by all the scheduler threads
+		pthread_mutex_t mutex;
 		
-	public:
+		/// Page cache of each thread
+		pthread_key_t cacheKey;
 		
+		/// Number of page caches created so far
+		unsigned int numCaches;
+	
+	public:
+	
 		MemoryManager (unsigned int id, std::ostream &LOG);
 		~MemoryManager();
 		
@@ -44,13 +179,22 @@ namespace Execution {
 		// Initialization routines
 		//------------------------------------------------------------
 		
-		int setMemorySize (unsigned int memorySize);		
+		int setMemorySize (unsigned long long int memorySize);
+		
+		/**
+		 * Limit the memory that we map from the system as we grow.  By
+		 * default (0), we grow as long as the system gives us memory.
+		 */
+		int setMaxMemorySize (unsigned long long int maxMemorySize);
+		
+		int setHugePages (bool bHugePages);
+		int setNuma (bool bNuma);
 		int initialize ();
 		
 		/**
 		 * @return size of pages
 		 */
-		unsigned int getPageSize () const { 
+		unsigned int getPageSize () const {
 			return PAGE_SIZE;
 		}
 		
@@ -61,33 +205,63 @@ namespace Execution {
 		
 		/**
 		 * Convert a pointer into our memory into a unique integer
-		 * identifier.  Pointers to different locations get distinct
-		 * identifiers. This is used within LinStore.
+		 * identifier.  Pointers to different locations (at least
+		 * 1 << LOG_ID_ALIGN bytes apart) get distinct identifiers.  The
+		 * identifier is 64 bits wide so that it covers every arena we
+		 * can map.  This is used within LinStore.
 		 *
 		 * @param ptr pointer to the memory location
 		 * @return unique id for the memory location
-		 */ 
-		unsigned int getId (char *ptr) {
+		 */
+		unsigned long long getId (char *ptr) {
+			char *arena;
+			
 			ASSERT (ptr);
-			ASSERT (ptr >= memory);
-			ASSERT (ptr - memory < (int)memorySize);
 			
-			return (ptr - memory);
+			arena = getArena (ptr);
+			
+			return ((((unsigned long long)((ArenaHeader *)arena) -> index) <<
+					 (LOG_ARENA_SIZE - LOG_ID_ALIGN)) |
+					((ptr - arena) >> LOG_ID_ALIGN));
 		}
 		
 		char *getPage (char *ptr) {
 			ASSERT (ptr);
-			ASSERT (ptr >= memory);
-			ASSERT (ptr - memory < (int)memorySize);
+			ASSERT (ptr - getArena (ptr) >= (long)(HEADER_PAGES * PAGE_SIZE));
 			
-			return (memory + ((ptr - memory) & PAGE_MASK));
+			return (char *)((unsigned long)ptr &
+							~(unsigned long)(PAGE_SIZE - 1));
 		}
-
+		
 		/**
 		 * Deallocate a page
 		 */
 		int deallocatePage (char *page);
+	
+	private:
+		char *getArena (char *ptr) const {
+			return (char *)((unsigned long)ptr & ~(ARENA_SIZE - 1));
+		}
+		
+		ArenaHeader *getHeader (char *ptr) const {
+			return (ArenaHeader *)getArena (ptr);
+		}
+		
+		unsigned char &owner (char *page) const {
+			return getHeader (page) -> owners
+				[(page - getArena (page)) >> LOG_PAGE_SIZE];
+		}
+		
+		PageCache *getCache ();
+		int refillCache (PageCache *cache);
+		void releaseCache (PageCache *cache, unsigned int numPages);
+		void reportCache (PageCache *cache);
+		static void destroyCache (void *arg);
 		
+		bool getNodePage (Node *node, char *&page);
+		int addArena (unsigned int node);
+		char *mapArena ();
+		unsigned int getNode () const;
 	};
 }
 
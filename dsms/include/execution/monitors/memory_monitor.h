@@ -0,0 +1,48 @@
+#ifndef _MEMORY_MONITOR_
+#define _MEMORY_MONITOR_
+
+#ifndef _PROPERTY_MONITOR_
+#include "execution/monitors/property_monitor.h"
+#endif
+
+namespace Monitor {
+
+	/**
+	 * A monitor for the page caches of the memory manager.  The caches
+	 * count events locally, and add their counts here in batches (while
+	 * holding the lock of the memory manager).
+	 */
+	class MemoryMonitor : public PropertyMonitor {
+	private:
+		/// Number of pages allocated from a page cache without going to
+		/// the shared lists
+		int numCacheHits;
+		
+		/// Number of times a page cache was refilled from the shared
+		/// lists
+		int numCacheRefills;
+		
+		/// Number of pages freed by a thread other than the one that
+		/// allocated them
+		int numRemoteFrees;
+		
+	public:
+		MemoryMonitor () {
+			numCacheHits = 0;
+			numCacheRefills = 0;
+			numRemoteFrees = 0;
+		}
+		
+		virtual ~MemoryMonitor () {}
+		
+		void logCache (int hits, int refills, int remoteFrees) {
+			numCacheHits += hits;
+			numCacheRefills += refills;
+			numRemoteFrees += remoteFrees;
+		}
+		
+		virtual int getIntProperty (int property, int &val);
+	};
+}
+
+#endif
@@ -31,6 +31,10 @@ namespace Monitor {
 		/// The number of input tuples seen (inner and outer)
 		long numInput;		
 		
+		/// The number of pairs of an input tuple and a tuple of the
+		/// synopsis of the other input that the join considered
+		double numPairs;
+		
 	public:
 		OperatorMonitor ();
 		virtual ~OperatorMonitor();
@@ -47,6 +51,14 @@ namespace Monitor {
 			numInput ++;
 		}
 		
+		void logInput (unsigned int num) {
+			numInput += num;
+		}
+		
+		void logPairs (int num) {
+			numPairs += num;
+		}
+		
 		virtual int getDoubleProperty (int property, double &val);
 		virtual int getIntProperty (int property, int &val);			
 	};
@@ -34,6 +34,17 @@ namespace Monitor {
 	
 	static const int QUEUE_NUM_ELEM = 23;
 	static const int QUEUE_LAST_TS = 24;
+	
+	/// Page caches of the memory manager
+	static const int MEM_CACHE_HITS = 25;
+	static const int MEM_CACHE_REFILLS = 26;
+	static const int MEM_REMOTE_FREES = 27;
+	
+	/// Number of elements read by a source
+	static const int SOURCE_NUM_TUPLES = 28;
+	
+	/// Number of pairs of tuples considered by a join (double)
+	static const int JOIN_NPAIRS = 29;
 };
 
 #endif
@@ -0,0 +1,75 @@
+#ifndef _TRACE_BUFFER_
+#define _TRACE_BUFFER_
+
+/**
+ * @file         trace_buffer.h
+ * @date         Oct. 17, 2026
+ * @brief        Compile-time operator tracepoints
+ */
+
+#ifndef _TYPES_
+#include "common/types.h"
+#endif
+
+#ifndef _CPP_OSTREAM_
+#include <ostream>
+#endif
+
+/**
+ * Operators mark interesting events with TRACE (event, opId, ts, arg).
+ * Unless the system is compiled with -D_TRACE_, TRACE expands to
+ * nothing, like ASSERT without -D_DM_.  Otherwise the events go to a
+ * ring buffer in memory which keeps the most recent TRACE_BUFFER_SIZE
+ * of them: recording an event reserves a slot with an atomic increment
+ * and never blocks, so operators running in different threads can
+ * trace concurrently.  TraceBuffer::dump() writes out the buffer, and
+ * the server does so at the end of the execution.
+ */
+
+namespace Monitor {
+	
+	enum TraceEvent {
+		/// RangeWindow: an input element (arg: 1 if heartbeat)
+		TR_WIN_INPUT,
+		
+		/// RangeWindow / GroupAggr: the window slides (arg: new start)
+		TR_WIN_SLIDE,
+		
+		/// RangeWindow: a tuple expires (arg: timestamp of the tuple)
+		TR_WIN_EXPIRE,
+		
+		/// The operator stalls on a full output queue
+		TR_STALL,
+		
+		/// GroupAggr: a group is updated after panes expire (arg: 1 if
+		/// the group is gone)
+		TR_PANE_EXPIRE
+	};
+
+#ifdef _TRACE_
+
+	/// Number of events kept.  A power of 2
+	static const unsigned int TRACE_BUFFER_SIZE = (1 << 16);
+	
+	class TraceBuffer {
+	public:
+		static void record (TraceEvent event, unsigned int opId,
+							Timestamp ts, long long arg);
+		
+		/**
+		 * Write out the events in the buffer, oldest first.  Events
+		 * being recorded while we dump may be left out.
+		 */
+		static void dump (std::ostream &out);
+	};
+
+#define TRACE(e,o,t,a) (Monitor::TraceBuffer::record ((e),(o),(t),(a)))
+
+#else
+
+#define TRACE(e,o,t,a) {}
+
+#endif
+}
+
+#endif
@@ -35,6 +35,20 @@
 #include "execution/internals/eval_context.h"
 #endif
 
+#ifndef _HEVAL_
+#include "execution/internals/heval.h"
+#endif
+
+#ifndef _FILTER_ITER_
+#include "execution/internals/filter_iter.h"
+#endif
+
+#ifndef _INDEX_
+#include "execution/indexes/index.h"
+#endif
+
+#include <pthread.h>
+
 #ifndef _CPP_OSTREAM_
 #include <ostream>
 #endif
@@ -50,6 +64,16 @@ namespace Execution {
 	/**
 	 * Binary join is a symmetric operator that joins two relations and
 	 * produces another relation.
+	 *
+	 * An equijoin can be partitioned (setPartitions): the join state is
+	 * then hash-partitioned on the join key, each partition with its own
+	 * indexes on the outer and inner tuples.  The operator dequeues a
+	 * batch of elements in the order it would process them, and the
+	 * partitions probe their elements in parallel, each on its own
+	 * thread, recording the matching tuples.  The operator then produces
+	 * the output of the batch element by element, so the output is
+	 * exactly that of the serial join.  Stores and synopses shared with
+	 * other operators are only touched by the operator thread.
 	 */
 	class BinaryJoin : public Operator {		
 	private:
@@ -142,6 +166,86 @@ namespace Execution {
 		
 		/// [[ Explanation ]]
 		TupleIterator *scanWhenStalled;
+		
+		//----------------------------------------------------------------------
+		// Partitioned join
+		//----------------------------------------------------------------------
+		
+		/// A tuple of the opposite input joining with an element of the
+		/// batch
+		struct Match {
+			unsigned int elem;
+			Tuple        tuple;
+		};
+		
+		/// An element of the current batch
+		struct BatchElement {
+			Element      element;
+			bool         bOuter;
+			
+			/// Partition that probes the element (numPartitions for
+			/// heartbeats)
+			unsigned int partition;
+		};
+		
+		/// A partition of the join state, probed by one thread
+		struct Partition {
+			BinaryJoin     *join;
+			unsigned int    partitionId;
+			
+			/// Evaluation context of the indexes & predicates of the
+			/// partition
+			EvalContext    *evalContext;
+			
+			Index          *outerIndex;
+			Index          *innerIndex;
+			
+			/// Non-equality predicates on the tuples scanned from the
+			/// indexes (0 if none)
+			FilterIterator *outerFilter;
+			FilterIterator *innerFilter;
+			
+			/// Matches of the batch elements of this partition, in batch
+			/// order
+			Match          *matches;
+			unsigned int    numMatches;
+			unsigned int    maxMatches;
+			
+			/// Next match to produce output for
+			unsigned int    nextMatch;
+			
+			pthread_t       thread;
+			int             rc;
+		};
+		
+		/// Number of partitions (0 if the join is not partitioned)
+		unsigned int numPartitions;
+		
+		Partition *partitions;
+		
+		/// Hash of the join key of outer & inner tuples
+		HEval *outerHash;
+		HEval *innerHash;
+		
+		/// The current batch
+		BatchElement *batch;
+		unsigned int batchLen;
+		unsigned int maxBatchLen;
+		
+		/// Next element of the batch to produce output for
+		unsigned int nextElem;
+		
+		/// Are we producing the output of a batch?
+		bool bMerging;
+		
+		/// Synchronization with the threads of partitions 1, 2, ...
+		pthread_mutex_t mutex;
+		pthread_cond_t  startCond;
+		pthread_cond_t  doneCond;
+		unsigned int    batchNo;
+		unsigned int    numDone;
+		bool            bWorkers;
+		bool            bQuit;
 
 		// [[ Consistency explanation ]]
 		static const unsigned int OUTER_ROLE = 2;
@@ -149,6 +253,9 @@ namespace Execution {
 		static const unsigned int OUTPUT_ROLE = 4;
 		
 	public:
+		/// Maximum number of partitions of a partitioned join
+		static const unsigned int MAX_PARTITIONS = 32;
+		
 		BinaryJoin (unsigned int id, std::ostream &LOG);
 		virtual ~BinaryJoin ();
 		
@@ -169,6 +276,25 @@ namespace Execution {
 		int setEvalContext (EvalContext *evalContext);
 		int setOutputConstructor (AEval *outputConstructor);
 		
+		/**
+		 * Partition the join into numPartitions partitions on the join
+		 * key, hashed by outerHash (OUTER_ROLE) & innerHash (INNER_ROLE).
+		 * The outer & inner synopses then do not need indexes.
+		 */
+		int setPartitions (unsigned int numPartitions,
+						   HEval *outerHash, HEval *innerHash);
+		
+		/**
+		 * The state of a partition: indexes on its outer & inner tuples,
+		 * scanned with an outer & inner tuple bound respectively, and
+		 * non-equality predicates on the scanned tuples (or 0), all in
+		 * evalContext.
+		 */
+		int setPartition (unsigned int partitionId,
+						  EvalContext *evalContext,
+						  Index *outerIndex, Index *innerIndex,
+						  BEval *outerPred, BEval *innerPred);
+		
 		/// run ...
 		int run (TimeSlice timeSlice);
 
@@ -183,6 +309,18 @@ namespace Execution {
 		int clearStallInnerPlus ();
 		int clearStallInnerMinus ();
 		int clearStall ();
+		
+		// Partitioned join
+		int runPartitioned (TimeSlice timeSlice);
+		int addToBatch (Element element, bool bOuter);
+		int probeBatch ();
+		int probePartition (Partition *partition);
+		int addMatch (Partition *partition, unsigned int elem, Tuple tuple);
+		int produceBatchOutput ();
+		int produceOutput (BatchElement *batchElement, Tuple match);
+		int finishElement (BatchElement *batchElement);
+		
+		static void *worker (void *arg);
 	};	
 }
 
@@ -56,6 +56,11 @@ namespace Execution {
 	 * 4. Evaluation context
 	 * 5. Arithmetic evaluator
 	 * 6. Stall logic
+	 *
+	 * Outer elements are processed in batches of consecutive outer
+	 * elements: we first compute the hashes of the scans of all the
+	 * tuples of the batch, and prefetch what the scans will read from
+	 * the inner synopsis, so that the cache misses of the scans overlap.
 	 */
 
 	class BinStreamJoin : public Operator {
@@ -110,14 +115,29 @@ namespace Execution {
 		/// Timestamp of the last element enqueued in the output
 		Timestamp lastOutputTs;
 		
+		/// We stall while scanning for outerBatch [nextOuter]
 		bool bStalled;
 		TupleIterator *innerScanWhenStalled;
-		Tuple stallTuple;
+		
+		/// Number of outer elements probed as one batch
+		static const unsigned int PROBE_BATCH_SIZE = 32;
+		
+		/// Outer elements yet to be joined (locked until they are)
+		Element outerBatch [PROBE_BATCH_SIZE];
+		
+		/// Hints for the scans of outerBatch (see RelationSynopsis)
+		Hash scanHints [PROBE_BATCH_SIZE];
+		
+		unsigned int numOuter;
+		unsigned int nextOuter;
 
 		static const unsigned int OUTER_ROLE = 2;
 		static const unsigned int INNER_ROLE = 3;
 		static const unsigned int OUTPUT_ROLE = 4;		
 		
+		/// Output elements enqueued as one batch
+		Element outputBatch [Queue::BATCH_SIZE];
+		
 	public:
 		BinStreamJoin(unsigned int id, std::ostream &LOG);
 		virtual ~BinStreamJoin();
@@ -137,7 +157,8 @@ namespace Execution {
 		
 	private:
 	    int clearStall();
-		inline int processOuter (Element e);
+		int produceOutput (TupleIterator *innerScan, Timestamp ts);
+		int processOuterBatch ();
 		inline int processInner (Element e);
 	};
 }
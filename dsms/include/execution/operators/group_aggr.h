@@ -4,8 +4,7 @@
 /**
  * @file       group_aggr.h
  * @date       May 30, 2004
- * @brief      Group by and aggregation operator.  [[ currently does not
- *             handle MAX & MIN ]]
+ * @brief      Group by and aggregation operator.
  */
 
 #ifndef _OPERATOR_
@@ -28,6 +27,14 @@
 #include "execution/internals/beval.h"
 #endif
 
+#ifndef _MINMAX_SYN_
+#include "execution/synopses/minmax_syn.h"
+#endif
+
+#ifndef _PANE_SYN_
+#include "execution/synopses/pane_syn.h"
+#endif
+
 #ifndef _STORE_ALLOC_
 #include "execution/stores/store_alloc.h"
 #endif
@@ -67,6 +74,40 @@ namespace Execution {
 		/// "current" group - the group of the latest input tuple
 		unsigned int outScanId;
 		
+		/// MAX / MIN aggregates of the groups, maintained incrementally
+		/// (optional).  When present, we never rescan the input
+		/// synopsis.
+		MinMaxSynopsis *minMaxSynopsis;
+		
+		/// Per-pane partial aggregates of the groups (optional).  When
+		/// present, the input is a stream, and we evaluate a range
+		/// window sliding over it ourselves: when a slide's worth of
+		/// tuples (a pane) leaves the window, each group is updated
+		/// once, from the partial aggregates of its remaining panes.
+		PaneSynopsis *paneSynopsis;
+		
+		/// Range & slide of the window (if paneSynopsis)
+		TimeDuration windowSize;
+		TimeDuration slideSize;
+		
+		/// Start of the window and its first pane
+		Timestamp windowStart;
+		unsigned int firstPane;
+		
+		/// We are updating the groups with expired panes, and the next
+		/// group to look at
+		bool bExpiring;
+		char *expireGroup;
+		
+		/// Input element that made panes expire, to be processed once
+		/// the groups are updated
+		bool bPending;
+		Element pendingElement;
+		
+		/// Column of the aggr. tuples that points to the group's
+		/// header in minMaxSynopsis or paneSynopsis
+		Column groupCol;
+		
 		/// Storage allocator for output tuples
 		StorageAlloc *outStore;
 		
@@ -138,14 +179,23 @@ namespace Execution {
 		int setEmptyGroupEvaluator (BEval *emptyGroupEval);
 		int setRescanEvaluator (BEval *bScanReq);
 		int setUpdateEvaluator (AEval *updateEval);
+		int setMinMaxSynopsis (MinMaxSynopsis *synopsis, Column groupCol);
+		int setPaneSynopsis (PaneSynopsis *synopsis, Column groupCol,
+							 unsigned int windowSize,
+							 unsigned int slideSize);
 		
 		int run (TimeSlice timeSlice);
 		
 	private:
 		
+		int processElement (Element inputElement);
 		int processPlus (Element inputElement);
 		int processMinus (Element inputElement);
-		int produceOutputTupleForMinus (Tuple newAggrTuple);
+		int produceOutputTupleForMinus (Tuple inpTuple, Tuple oldAggrTuple,
+										Tuple newAggrTuple);
+		
+		int advanceWindow (Element inputElement);
+		int expirePanes ();
 	};
 }
 
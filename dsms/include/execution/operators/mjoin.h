@@ -0,0 +1,253 @@
+#ifndef _MJOIN_
+#define _MJOIN_
+
+/**
+ * @file       mjoin.h
+ * @date       Oct. 17, 2026
+ * @brief      Multi-way join operator
+ */
+
+#ifndef _OPERATOR_
+#include "execution/operators/operator.h"
+#endif
+
+#ifndef _QUEUE_
+#include "execution/queues/queue.h"
+#endif
+
+#ifndef _AEVAL_
+#include "execution/internals/aeval.h"
+#endif
+
+#ifndef _BEVAL_
+#include "execution/internals/beval.h"
+#endif
+
+#ifndef _STORE_ALLOC_
+#include "execution/stores/store_alloc.h"
+#endif
+
+#ifndef _LIN_SYN_
+#include "execution/synopses/lin_syn.h"
+#endif
+
+#ifndef _REL_SYN_
+#include "execution/synopses/rel_syn.h"
+#endif
+
+#ifndef _EVAL_CONTEXT_
+#include "execution/internals/eval_context.h"
+#endif
+
+#ifndef _CPP_OSTREAM_
+#include <ostream>
+#endif
+
+#ifdef _MONITOR_
+#ifndef _JOIN_MONITOR_
+#include "execution/monitors/join_monitor.h"
+#endif
+#endif
+
+namespace Execution {
+	
+	/**
+	 * Multi-way join is a symmetric operator that joins n > 2 relations
+	 * and produces another relation, like a tree of binary joins but
+	 * without the synopses of the intermediate results.
+	 *
+	 * The operator keeps a synopsis of each input.  An element of input
+	 * i updates the synopsis of i, and is then joined with the other
+	 * synopses one after the other, in a probe order that starts with
+	 * i: the tuples of the next input are scanned for each combination
+	 * of tuples of the inputs before it.  Input j is scanned with an
+	 * index on its equality predicates with an input k before it in the
+	 * order (setIndexScan (j, k, ..)), or with a scan of all its tuples
+	 * if there is none.  The conjuncts of the join predicate are each
+	 * checked as soon as all the inputs they refer to are bound.
+	 *
+	 * The probe orders are chosen greedily from the observed fanout of
+	 * the inputs - the number of tuples of an input that pass the
+	 * predicates per scan of the input - preferring the inputs that can
+	 * be scanned with an index, and recomputed every REORDER_INTERVAL
+	 * elements.
+	 *
+	 * The tuple of input i is bound to role INPUT_ROLE + i, the output
+	 * tuple to OUTPUT_ROLE.
+	 */
+	class MJoin : public Operator {
+	public:
+		/// Maximum number of inputs
+		static const unsigned int MAX_INPUTS = 4;
+		
+		/// Maximum number of conjuncts of the join predicate
+		static const unsigned int MAX_PREDS = 20;
+		
+		static const unsigned int INPUT_ROLE = 2;
+		static const unsigned int OUTPUT_ROLE = 9;
+	
+	private:
+		/// System-wide unique identifier
+		unsigned int id;
+		
+		/// System log
+		std::ostream &LOG;
+		
+		/// Number of inputs
+		unsigned int numInputs;
+		
+		struct Input {
+			Queue             *queue;
+			
+			/// Store of the tuples of the input
+			StorageAlloc      *store;
+			
+			/// Synopsis storing the current state of the input
+			RelationSynopsis  *synopsis;
+			
+			/// Scan of the tuples joining with the bound tuple of
+			/// input k on the equality predicates between the two
+			bool               bIndexScan [MAX_INPUTS];
+			unsigned int       indexScanId [MAX_INPUTS];
+			
+			/// Scan of all the tuples
+			unsigned int       fullScanId;
+			
+			/// Timestamp of the last element dequeued
+			Timestamp          lastTs;
+			
+			/// Number of scans of the input, and of the tuples scanned
+			/// that passed the predicates, since the last reorder
+			double             numProbes;
+			double             numMatches;
+		};
+		
+		Input inputs [MAX_INPUTS];
+		
+		/// Conjuncts of the join predicate, and the inputs each refers
+		/// to (bit i for input i)
+		BEval *preds [MAX_PREDS];
+		unsigned int predInputs [MAX_PREDS];
+		unsigned int numPreds;
+		
+		/// A step of a probe order: the input bound at the step, the
+		/// scan that produces its tuples, and the conjuncts checked
+		/// once it is bound
+		struct ProbeStep {
+			unsigned int input;
+			unsigned int scanId;
+			unsigned int preds [MAX_PREDS];
+			unsigned int numPreds;
+		};
+		
+		/// Probe order of the elements of each input: step 0 binds the
+		/// element
+		ProbeStep order [MAX_INPUTS][MAX_INPUTS];
+		
+		/// Synopsis storing the output of the join, used to generate
+		/// MINUS tuples.  Null if all the inputs are streams
+		LineageSynopsis *joinSynopsis;
+		
+		/// Storage allocator for the output
+		StorageAlloc *outStore;
+		
+		/// Output queue
+		Queue *outputQueue;
+		
+		/// Evaluation context in which all the action takes place
+		EvalContext *evalContext;
+		
+		/// Arithmetic evaluator to construct the output tuple
+		AEval *outputConstructor;
+		
+		/// Timestamp of the last element enqueued in the output
+		Timestamp lastOutputTs;
+		
+		/// Number of elements processed since the probe orders were
+		/// last computed
+		unsigned int numSinceReorder;
+		
+		static const unsigned int REORDER_INTERVAL = 1024;
+		
+		//----------------------------------------------------------------------
+		// The element being joined
+		//----------------------------------------------------------------------
+		
+		/// Element & the input it came from
+		Element curElement;
+		unsigned int curInput;
+		
+		/// Tuples bound for the inputs, in input order: the lineage of
+		/// the output
+		Tuple lineage [MAX_INPUTS];
+		
+		/// Open scans of the steps of the probe order of curInput
+		TupleIterator *scans [MAX_INPUTS];
+		
+		/// Step whose scan produces the next tuple (0 when done)
+		unsigned int curStep;
+		
+		/// Did the output queue fill up while we joined curElement?
+		bool bStalled;
+	
+	public:
+		MJoin (unsigned int id, std::ostream &LOG);
+		virtual ~MJoin ();
+		
+		//----------------------------------------------------------------------
+		// Initialization routines
+		//----------------------------------------------------------------------
+		int setNumInputs (unsigned int numInputs);
+		int setInputQueue (unsigned int input, Queue *inputQueue);
+		int setInputStore (unsigned int input, StorageAlloc *store);
+		int setSynopsis (unsigned int input, RelationSynopsis *synopsis);
+		
+		/**
+		 * Scan scanId of the synopsis of input returns the tuples that
+		 * join with the tuple of input k on their equality predicates.
+		 */
+		int setIndexScan (unsigned int input, unsigned int k,
+						  unsigned int scanId);
+		
+		/// Scan scanId of the synopsis of input returns all its tuples
+		int setFullScan (unsigned int input, unsigned int scanId);
+		
+		/// A conjunct of the join predicate, which refers to the inputs
+		/// in the bitmap inputMask
+		int addPredicate (BEval *pred, unsigned int inputMask);
+		
+		int setJoinSynopsis (LineageSynopsis *joinSynopsis);
+		int setOutputQueue (Queue *outputQueue);
+		int setOutStore (StorageAlloc *outStore);
+		int setEvalContext (EvalContext *evalContext);
+		int setOutputConstructor (AEval *outputConstructor);
+		int initialize ();
+		
+		int run (TimeSlice timeSlice);
+	
+	private:
+		/// Compute the probe orders from the current statistics
+		void computeOrders ();
+		
+		/// Start joining an element of an input
+		int processElement (Element element, unsigned int input);
+		
+		/// Continue joining curElement until done or stalled
+		int probe ();
+		
+		/// Produce the output for the currently bound tuples
+		int produceOutput ();
+		
+		/// Done with curElement
+		int finishElement ();
+		
+		bool checkPreds (const ProbeStep &step) const {
+			for (unsigned int p = 0 ; p < step.numPreds ; p++)
+				if (!preds [step.preds [p]] -> eval ())
+					return false;
+			return true;
+		}
+	};
+}
+
+#endif
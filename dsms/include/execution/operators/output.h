@@ -91,6 +91,32 @@ namespace Execution {
 		// Object that accepts my output.
 		Interface::QueryOutput *output;
 		
+		// Input elements dequeued as one batch
+		Element batch [Queue::BATCH_SIZE];
+		
+		// Elements of the batch that are not processed yet: batchPos
+		// .. batchLen-1
+		unsigned int batchPos;
+		unsigned int batchLen;
+		
+		//----------------------------------------------------------------------
+		// Plan migration: the output of a query is produced by the output
+		// operator of its old plan up to a timestamp, and by the output
+		// operator of its new plan from then on.
+		//----------------------------------------------------------------------
+		
+		// Output operator of the old plan, which we wait for before
+		// producing elements with timestamp >= startTs
+		Output *prevOutput;
+		Timestamp startTs;
+		
+		// We produce no elements with timestamp >= endTs
+		bool bEnd;
+		Timestamp endTs;
+		
+		// We have seen an element with timestamp >= endTs
+		bool bRetired;
+		
 #ifdef _DM_
 		Timestamp   lastInputTs;
 #endif
@@ -111,6 +137,23 @@ namespace Execution {
 		int initialize();
 		
 		int run(TimeSlice timeSlice);		
+		
+		/**
+		 * Replace the output operator prevOutput: elements with
+		 * timestamp < startTs are dropped, and the others are produced
+		 * once prevOutput is retired.
+		 */
+		int setStart (Timestamp startTs, Output *prevOutput);
+		
+		/**
+		 * Produce only the elements with timestamp < endTs.
+		 */
+		int setEnd (Timestamp endTs);
+		
+		/**
+		 * True once all the elements with timestamp < endTs are produced
+		 */
+		bool isRetired () const { return bRetired; }
 	};
 }
 
@@ -94,6 +94,20 @@ namespace Execution {
 		/// [[ Explanation ]]
 		static const unsigned int OUTPUT_ROLE = 3;			
 		
+		/// Elements dequeued from the input queue in one batch.  The
+		/// output elements replace the input elements and are enqueued
+		/// as one batch.
+		Element batch [Queue::BATCH_SIZE];
+		
+		/// Produce the output tuples of each batch at once (see
+		/// AEval::evalBatch) instead of one tuple at a time
+		bool bVectorized;
+		
+		/// Input and output tuples of the PLUS elements of the batch
+		/// (vectorized mode)
+		Tuple inTuples [Queue::BATCH_SIZE];
+		Tuple outTuples [Queue::BATCH_SIZE];
+		
 	public:
 		Project(unsigned int id, std::ostream &LOG);
 		virtual ~Project();
@@ -110,6 +124,12 @@ namespace Execution {
 		int setProjEvaluator (AEval *projEval);
 		int setEvalContext (EvalContext *evalContext);
 		
+		/**
+		 * Use the vectorized mode.  The projection evaluator should be
+		 * vectorizable (AEval::isVectorizable).
+		 */
+		int setVectorized (bool bVectorized);
+		
 		int run(TimeSlice timeSlice);
 	};
 }
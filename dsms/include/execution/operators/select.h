@@ -68,6 +68,20 @@ namespace Execution {
 		/// [[ Explanation ]] Note: same as INPUT_CONTEXT in inst_select.cc
 		static const unsigned int INPUT_CONTEXT = 2;
 		
+		/// Elements dequeued from the input queue in one batch.  The
+		/// elements that pass the predicate are moved to the front and
+		/// enqueued as one batch.
+		Element batch [Queue::BATCH_SIZE];
+		
+		/// Evaluate the predicate over each batch at once (see
+		/// BEval::evalBatch) instead of one tuple at a time
+		bool bVectorized;
+		
+		/// Tuples of the batch, and the selection vector computed by the
+		/// predicate for them (vectorized mode)
+		Tuple tuples [Queue::BATCH_SIZE];
+		unsigned char sel [Queue::BATCH_SIZE];
+		
 	public:
 		Select(unsigned int id, std::ostream &LOG);
 		virtual ~Select();
@@ -81,6 +95,12 @@ namespace Execution {
 		int setPredicate (BEval *predicate);
 		int setEvalContext (EvalContext *evalContext);
 		
+		/**
+		 * Use the vectorized mode.  The predicate should be
+		 * vectorizable (BEval::isVectorizable).
+		 */
+		int setVectorized (bool bVectorized);
+		
 		int run (TimeSlice timeSlice); 
 	};
 }
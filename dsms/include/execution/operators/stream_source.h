@@ -48,7 +48,7 @@ namespace Execution {
 		// Specification of the attributes in the input stream
 		Attr attrs [MAX_ATTRS];
 		unsigned int numAttrs;
-
+		
 		static const unsigned int TIMESTAMP_OFFSET = 0;
 		static const unsigned int DATA_OFFSET = TIMESTAMP_SIZE;
 		unsigned int offsets [MAX_ATTRS];
@@ -61,7 +61,26 @@ namespace Execution {
 		
 		Timestamp lastInputTs;	   
 		Timestamp lastOutputTs;
-
+		
+		// Output elements enqueued as one batch
+		Element batch [Queue::BATCH_SIZE];
+		
+		//----------------------------------------------------------------------
+		// Plan migration (see migrate ()): until an input element with
+		// timestamp >= switchTs arrives, every tuple is also copied to
+		// the output of the new plan.
+		//----------------------------------------------------------------------
+		
+		bool           bMigrating;
+		Timestamp      switchTs;
+		Queue         *newQueue;
+		StorageAlloc  *newStoreAlloc;
+		Timestamp      newLastOutputTs;
+		Element        newBatch [Queue::BATCH_SIZE];
+		
+		int decode (const char *inputTuple, StorageAlloc *store,
+					Tuple &outputTuple);
+		int endMigration (unsigned int numOutput, unsigned int numNewOutput);
 		
 		std::ostream& LOG;
 		
@@ -77,6 +96,20 @@ namespace Execution {
 		int initialize ();
 		
 		int run (TimeSlice timeSlice);
+		
+		/**
+		 * Start feeding a new plan that replaces the plan reading from
+		 * the current output queue.  Both plans get the input tuples
+		 * with timestamp < switchTs; the current one then gets a
+		 * heartbeat for switchTs and nothing after it, while the new
+		 * one gets all the input that follows.  The output queue of the
+		 * new plan is the one set by setOutputQueue() after this call.
+		 */
+		int migrate (StorageAlloc *store, Timestamp switchTs);
+		
+		bool isMigrating () const { return bMigrating; }
+		
+		Timestamp getLastInputTs () const { return lastInputTs; }
 	};
 }
 
@@ -33,6 +33,10 @@ namespace Execution {
 	class Queue {
 #endif
 	public:
+		/// Number of elements that operators move through a queue at a
+		/// time
+		static const unsigned int BATCH_SIZE = 64;
+		
 		virtual ~Queue () {}
 		
 		/**
@@ -69,6 +73,58 @@ namespace Execution {
 		 * @return true if the queue is empty, false otherwise.
 		 */
 		virtual bool isEmpty () const = 0;
+		
+		/**
+		 * Enqueue a batch of elements, in order.  Queues that can do
+		 * better than one enqueue() per element override this.
+		 *
+		 * @param  elements    The elements to be enqueued
+		 * @param  numElements Number of elements to be enqueued
+		 * @return             Number of elements enqueued (the first ones
+		 *                     of the batch)
+		 */
+		virtual unsigned int enqueueBatch (const Element *elements,
+										   unsigned int numElements) {
+			unsigned int e;
+			
+			for (e = 0 ; e < numElements ; e++)
+				if (!enqueue (elements [e]))
+					break;
+			return e;
+		}
+		
+		/**
+		 * Dequeue up to maxElements of the oldest elements, in order.
+		 *
+		 * @param  elements    (output) The dequeued elements
+		 * @param  maxElements Maximum number of elements to dequeue
+		 * @return             Number of elements dequeued
+		 */
+		virtual unsigned int dequeueBatch (Element *elements,
+										   unsigned int maxElements) {
+			unsigned int e;
+			
+			for (e = 0 ; e < maxElements ; e++)
+				if (!dequeue (elements [e]))
+					break;
+			return e;
+		}
+		
+		/**
+		 * @return number of elements that can be enqueued without the
+		 *         queue getting full (a lower bound).
+		 */
+		virtual unsigned int getFreeSpace () const {
+			return isFull () ? 0 : 1;
+		}
+		
+		/**
+		 * Make the elements enqueued so far visible to the reader.
+		 * Called by the scheduler, in the thread of the writer, after it
+		 * runs the writer.  Queues that do not hold back elements do
+		 * nothing.
+		 */
+		virtual void flush () {}
 	};
 }
 
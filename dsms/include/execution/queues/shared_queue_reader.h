@@ -45,6 +45,8 @@ namespace Execution {
 		bool peek (Element &element) const;
 		bool isFull () const;
 		bool isEmpty () const;		
+		unsigned int dequeueBatch (Element *elements,
+								   unsigned int maxElements);
 	};
 }
 
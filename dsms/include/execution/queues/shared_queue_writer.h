@@ -106,6 +106,9 @@ namespace Execution {
 		bool peek (Element &element) const; // not implemented
 		bool isFull () const;
 		bool isEmpty () const; // not implemented
+		unsigned int enqueueBatch (const Element *elements,
+								   unsigned int numElements);
+		unsigned int getFreeSpace () const;
 		
 		//------------------------------------------------------------
 		// Called by the reader
@@ -114,6 +117,9 @@ namespace Execution {
 		bool peek (Element &element, unsigned int readerId) const;
 		bool isFull (unsigned int readerId) const;
 		bool isEmpty (unsigned int readerId) const;
+		unsigned int dequeueBatch (Element *elements,
+								   unsigned int maxElements,
+								   unsigned int readerId);
 
 	private:
 		int computePageLayout ();
@@ -88,6 +88,11 @@ namespace Execution {
 		bool peek (Element &element) const;
 		bool isFull () const;
 		bool isEmpty () const;
+		unsigned int enqueueBatch (const Element *elements,
+								   unsigned int numElements);
+		unsigned int dequeueBatch (Element *elements,
+								   unsigned int maxElements);
+		unsigned int getFreeSpace () const;
 		
 	private:	  		
 		int computePageLayout();
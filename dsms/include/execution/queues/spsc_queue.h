@@ -0,0 +1,149 @@
+#ifndef _SPSC_QUEUE_
+#define _SPSC_QUEUE_
+
+/**
+ * @file         spsc_queue.h
+ * @date         Oct. 17, 2026
+ * @brief        A lock-free queue between two threads.
+ */
+
+#include <ostream>
+
+#ifndef _QUEUE_
+#include "execution/queues/queue.h"
+#endif
+
+#ifndef _MEMORY_MGR_
+#include "execution/memory/memory_mgr.h"
+#endif
+
+/**
+ * An SpscQueue connects a source operator and a destination operator
+ * that are run by different threads of the scheduler.  At any time, only
+ * one thread enqueues (the producer) and one thread dequeues (the
+ * consumer), so the queue needs no locks:
+ *
+ * 1. The elements are stored in a ring over a fixed number of pages
+ *    (got from the memory manager, as for SimpleQueue).
+ *
+ * 2. The producer owns the tail index and the consumer the head index.
+ *    Each side publishes its index with a release store and reads the
+ *    index of the other side with an acquire load.  The two indexes are
+ *    on separate cache lines, and each side keeps a cached copy of the
+ *    other's index that it refreshes only when the ring looks full (or
+ *    empty).
+ *
+ * 3. The producer publishes new elements in batches of PUBLISH_BATCH,
+ *    and on heartbeats.  The scheduler calls flush() after running the
+ *    producer, so that no element stays unpublished.
+ *
+ * One slot of the ring is never used, to tell a full ring from an empty
+ * one.
+ */
+
+namespace Execution {
+	class SpscQueue : public Queue {
+	private:
+		/// Size of a cache line
+		static const unsigned int CACHE_LINE = 64;
+		
+		/// Number of elements the producer enqueues before publishing them
+		static const unsigned int PUBLISH_BATCH = 32;
+		
+		//------------------------------------------------------------
+		// Read-only after initialization
+		//------------------------------------------------------------
+		
+		// System wide unique id assigned to me.
+		int id;
+		
+		// Memory manager for the pages
+		MemoryManager *memMgr;
+		
+		// Number of pages of memory that I am allowed to have
+		unsigned int numPages;
+		
+		// Pages of the ring
+		Element **pages;
+		
+		// Number of elements per page = 1 << logElementsPerPage
+		unsigned int logElementsPerPage;
+		
+		// Number of slots in the ring
+		unsigned int numSlots;
+		
+		std::ostream& LOG;
+		
+		char pad0 [CACHE_LINE];
+		
+		//------------------------------------------------------------
+		// Producer
+		//------------------------------------------------------------
+		
+		/// Slot of the next element to enqueue
+		unsigned int nextTail;
+		
+		/// Number of elements enqueued but not published
+		unsigned int numPending;
+		
+		/// Last head seen by the producer
+		mutable unsigned int cachedHead;
+		
+		char pad1 [CACHE_LINE];
+		
+		/// Published tail: the elements before it are visible to the
+		/// consumer
+		unsigned int tail;
+		
+		char pad2 [CACHE_LINE];
+		
+		//------------------------------------------------------------
+		// Consumer
+		//------------------------------------------------------------
+		
+		/// Slot of the next element to dequeue
+		unsigned int head;
+		
+		/// Last tail seen by the consumer
+		mutable unsigned int cachedTail;
+		
+		char pad3 [CACHE_LINE];
+	
+	public:
+	
+		SpscQueue (int id, std::ostream& LOG);
+		virtual ~SpscQueue ();
+		
+		// Initialization routines.
+		int setNumPages (unsigned int numPages);
+		int setMemoryManager (MemoryManager *memMgr);
+		int initialize ();
+		
+		// Inherited from Queue.
+		bool enqueue (Element element);
+		bool dequeue (Element &element);
+		bool peek (Element &element) const;
+		bool isFull () const;
+		bool isEmpty () const;
+		void flush ();
+		unsigned int enqueueBatch (const Element *elements,
+								   unsigned int numElements);
+		unsigned int dequeueBatch (Element *elements,
+								   unsigned int maxElements);
+		unsigned int getFreeSpace () const;
+	
+	private:
+		Element *slot (unsigned int s) const {
+			return pages [s >> logElementsPerPage] +
+				(s & ((1U << logElementsPerPage) - 1));
+		}
+		
+		unsigned int next (unsigned int s) const {
+			return (s + 1 == numSlots) ? 0 : s + 1;
+		}
+		
+		void publish ();
+	};
+}
+
+#endif
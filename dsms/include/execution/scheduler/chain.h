@@ -0,0 +1,65 @@
+#ifndef _CHAIN_
+#define _CHAIN_
+
+/**
+ * @file       chain.h
+ * @date       Oct. 17, 2026
+ * @brief      Chain scheduler: minimizes the memory used by queued
+ *             elements.
+ */
+
+#ifndef _PRIORITY_SCHED_
+#include "execution/scheduler/priority.h"
+#endif
+
+/**
+ * Chain scheduling (Babcock et al., "Chain: Operator Scheduling for
+ * Memory Minimization in Data Stream Systems").  For each path from a
+ * source to an output, the progress chart of an element plots its
+ * remaining size (the product of the selectivities of the operators it
+ * went through) against the time spent on it (the sum of their per
+ * element costs).  The lower envelope of the chart splits the path into
+ * segments, and the operators of a segment get the steepness of the
+ * segment as priority: the operators that get rid of the most data per
+ * unit of time run first.  An operator on several paths gets its
+ * highest priority.
+ *
+ * The selectivities and costs are estimated from the operator and queue
+ * monitors, and refreshed every UPDATE_PERIOD time units.  Without
+ * monitors (_MONITOR_ not defined), all operators get the same priority.
+ */
+
+namespace Execution {
+	class ChainScheduler : public PriorityScheduler {
+	private:
+		/// Number of time units between two updates of the priorities
+		static const long long int UPDATE_PERIOD = 10;
+		
+		/// Maximum number of source-to-output paths considered
+		static const unsigned int MAX_PATHS = 1000;
+		
+		/// Estimated per element cost of an operator
+		double cost [MAX_OPS];
+		
+		/// Estimated selectivity of an operator
+		double selectivity [MAX_OPS];
+		
+		/// Number of paths considered in the current update
+		unsigned int numPaths;
+	
+	public:
+		ChainScheduler (std::ostream &LOG);
+		virtual ~ChainScheduler ();
+	
+	protected:
+		void updatePriorities (long long int round);
+		double getPriority (unsigned int o) const;
+	
+	private:
+		void estimate (unsigned int o);
+		void addPaths (unsigned int o, unsigned int *path, unsigned int len);
+		void setSegments (const unsigned int *path, unsigned int len);
+	};
+}
+
+#endif
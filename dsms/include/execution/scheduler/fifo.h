@@ -0,0 +1,35 @@
+#ifndef _FIFO_
+#define _FIFO_
+
+/**
+ * @file       fifo.h
+ * @date       Oct. 17, 2026
+ * @brief      Scheduler that processes the queued elements in timestamp
+ *             order.
+ */
+
+#ifndef _PRIORITY_SCHED_
+#include "execution/scheduler/priority.h"
+#endif
+
+/**
+ * The FIFO scheduler runs the ready operator with the oldest (smallest
+ * timestamp) element in its input queues, so that elements go through
+ * the plan roughly in arrival order.  This minimizes the latency of the
+ * outputs rather than the memory used.  Operators blocked at their
+ * output hold an element older than any queued one, and run first.
+ */
+
+namespace Execution {
+	class FifoScheduler : public PriorityScheduler {
+	public:
+		FifoScheduler (std::ostream &LOG);
+		virtual ~FifoScheduler ();
+	
+	protected:
+		void updatePriorities (long long int round);
+		double getPriority (unsigned int o) const;
+	};
+}
+
+#endif
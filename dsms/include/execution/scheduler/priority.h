@@ -0,0 +1,124 @@
+#ifndef _PRIORITY_SCHED_
+#define _PRIORITY_SCHED_
+
+/**
+ * @file       priority.h
+ * @date       Oct. 17, 2026
+ * @brief      Base class for single threaded schedulers that always run
+ *             the ready operator with the highest priority.
+ */
+
+#include <ostream>
+
+#ifndef _SCHEDULER_
+#include "execution/scheduler/scheduler.h"
+#endif
+
+/**
+ * In each time unit, a priority scheduler repeatedly picks the ready
+ * (see WorkStealingScheduler) operator with the highest priority and
+ * runs it, until no operator other than a source is ready.  It then
+ * runs the sources once, so new input enters the system only after the
+ * elements already queued have been processed as far as they can go.
+ * This bounds the number of elements buffered in the queues and stores.
+ *
+ * An operator can have input that it cannot consume yet (e.g., a join
+ * waiting for its other input).  An operator that made no progress in
+ * its last run is not picked again until one of its input operators
+ * produces something.
+ *
+ * Derived classes define the priorities.
+ */
+
+namespace Execution {
+	class PriorityScheduler : public Scheduler {
+	protected:
+		/// Maximum number of operators
+		static const unsigned int MAX_OPS = 100;
+		
+		/// Maximum number of inputs of an operator
+		static const unsigned int MAX_INPUTS = 4;
+		
+		/// Maximum number of operator runs between two runs of the
+		/// sources, per operator
+		static const unsigned int MAX_STEPS_PER_OP = 100;
+		
+		struct OpInfo {
+			/// The operator
+			Operator *op;
+			
+			/// Input queues of the operator
+			Queue *inQueues [MAX_INPUTS];
+			
+			/// Operators producing the inputs
+			Operator *inOps [MAX_INPUTS];
+			
+			/// Indexes (in ops) of the operators producing the inputs,
+			/// MAX_OPS if unknown
+			unsigned int inputs [MAX_INPUTS];
+			
+			/// Number of input queues
+			unsigned int numInputs;
+			
+			/// Output queue of the operator (0 if none)
+			Queue *outQueue;
+			
+			/// Was the output queue full after the last run of the op?
+			bool bBlocked;
+			
+			/// Did the last run of the operator make no progress?
+			bool bStuck;
+			
+			/// Priority (used by derived classes)
+			double priority;
+		};
+		
+		/// Operators that we are scheduling
+		OpInfo ops [MAX_OPS];
+		
+		/// Number of operators
+		unsigned int numOps;
+		
+		/// Are the inputs of the operators resolved to indexes?
+		bool bLinked;
+		
+		bool bStop;
+		
+		/// System log
+		std::ostream &LOG;
+	
+	public:
+		PriorityScheduler (std::ostream &LOG);
+		virtual ~PriorityScheduler ();
+		
+		// Inherited from Scheduler
+		int addOperator (Operator *op);
+		int addOperator (Operator *op, unsigned int fragment);
+		int setQueues (Operator *op, Queue **inQueues, Operator **inOps,
+					   unsigned int numInputs, Queue *outQueue);
+		int run (long long int numTimeUnits);
+		int stop ();
+		int resume ();
+	
+	protected:
+		/**
+		 * Called at the beginning of every time unit.
+		 *
+		 * @param round     number of time units run so far
+		 */
+		virtual void updatePriorities (long long int round) = 0;
+		
+		/**
+		 * @return the current priority of a ready operator
+		 */
+		virtual double getPriority (unsigned int o) const = 0;
+	
+	private:
+		void link ();
+		int runQueued ();
+		int runOp (unsigned int o);
+		bool isReady (const OpInfo *info) const;
+	};
+}
+
+#endif
@@ -24,6 +24,9 @@ namespace Execution {
 		
 		// Inherited from Scheduler
 		int addOperator (Operator *op);				
+		int addOperator (Operator *op, unsigned int fragment);
+		int setQueues (Operator *op, Queue **inQueues, Operator **inOps,
+					   unsigned int numInputs, Queue *outQueue);
 		int run (long long int numTimeUnits);
 		int stop ();
 		int resume ();
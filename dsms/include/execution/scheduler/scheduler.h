@@ -5,7 +5,34 @@
 #include "execution/operators/operator.h"
 #endif
 
+#ifndef _QUEUE_
+#include "execution/queues/queue.h"
+#endif
+
 namespace Execution {
+	
+	/**
+	 * Scheduling policies, selected by the SCHEDULER parameter of the
+	 * config file.
+	 */
+	enum SchedulerKind {
+		/// Operators run in round robin order (RoundRobinScheduler, or
+		/// ThreadPoolScheduler for more than one thread)
+		RR_SCHEDULER,
+		
+		/// Operators with pending input run by worker threads that steal
+		/// work from each other (WorkStealingScheduler)
+		WS_SCHEDULER,
+		
+		/// Chain: operators that reduce the queued data fastest run first
+		/// (ChainScheduler)
+		CHAIN_SCHEDULER,
+		
+		/// Operators with the oldest input element run first
+		/// (FifoScheduler)
+		FIFO_SCHEDULER
+	};
+	
 	class Scheduler {
 	public:
 		/**
@@ -13,6 +40,26 @@ namespace Execution {
 		 */
 		virtual int addOperator (Operator *op) = 0;
 		
+		/**
+		 * Add a new operator to schedule as part of a given execution
+		 * fragment.  All the operators of a fragment are run by the same
+		 * thread; schedulers that use a single thread ignore the
+		 * fragment.
+		 */
+		virtual int addOperator (Operator *op, unsigned int fragment) = 0;
+		
+		/**
+		 * Inform the scheduler about the input and output queues of an
+		 * (already added) operator, and the operators producing its
+		 * inputs (inOps [i] writes into inQueues [i], possibly through a
+		 * shared queue).  Source operators have no input queues, and
+		 * output operators no output queue (outQueue = 0).  Schedulers
+		 * that do not look at the queues ignore this.
+		 */
+		virtual int setQueues (Operator *op, Queue **inQueues,
+							   Operator **inOps, unsigned int numInputs,
+							   Queue *outQueue) = 0;
+		
 		/**
 		 * Schedule the operators for a prescribed set of time units.
 		 */		
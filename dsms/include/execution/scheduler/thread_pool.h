@@ -0,0 +1,111 @@
+#ifndef _THREAD_POOL_
+#define _THREAD_POOL_
+
+/**
+ * @file       thread_pool.h
+ * @date       Oct. 17, 2026
+ * @brief      Scheduler that runs plan fragments on a pool of threads
+ */
+
+#include <pthread.h>
+#include <ostream>
+
+#ifndef _SCHEDULER_
+#include "execution/scheduler/scheduler.h"
+#endif
+
+/**
+ * The operators of the plan are partitioned into fragments by the plan
+ * manager so that operators sharing synopses or stores are in the same
+ * fragment, and fragments communicate only through queues.  The thread
+ * pool scheduler runs each fragment on its own thread, using round
+ * robin scheduling within a fragment.  Fragment 0 is run by the thread
+ * that calls run(); the other fragments are run by worker threads,
+ * each pinned to a cpu.
+ *
+ * A time unit is one round over the operators of a fragment, as in the
+ * round robin scheduler.  Fragments are kept within MAX_SKEW rounds of
+ * each other, so that a producer does not spend its rounds on a full
+ * output queue while its consumer is behind.
+ */
+
+namespace Execution {
+	class ThreadPoolScheduler : public Scheduler {
+	public:
+		/// Maximum number of threads (fragments)
+		static const unsigned int MAX_THREADS = 32;
+		
+	private:
+		/// Maximum number of operators per fragment
+		static const unsigned int MAX_OPS = 100;
+		
+		/// Maximum number of rounds a fragment can be ahead of the
+		/// slowest fragment
+		static const long long int MAX_SKEW = 4;
+		
+		struct Fragment {
+			/// Operators of this fragment
+			Operator *ops [MAX_OPS];
+			
+			/// Output queues of the operators (0 for none)
+			Queue *outQueues [MAX_OPS];
+			
+			/// Number of operators of this fragment
+			unsigned int numOps;
+			
+			/// The scheduler running this fragment
+			ThreadPoolScheduler *sched;
+			
+			/// Thread running this fragment
+			pthread_t thread;
+			
+			/// Number of rounds completed in the current run (read by
+			/// the other fragments with acquire semantics)
+			long long int round;
+			
+			/// Return code of the last run
+			int rc;
+		};
+		
+		/// Fragments that we are scheduling
+		Fragment fragments [MAX_THREADS];
+		
+		/// Number of fragments (threads)
+		unsigned int numThreads;
+		
+		/// Number of fragments with at least one operator
+		unsigned int numActive;
+		
+		/// Time units of the current run (0 for ever)
+		long long int numTimeUnits;
+		
+		/// Set (with release semantics) to stop all the fragments
+		bool bStop;
+		
+		/// System log
+		std::ostream &LOG;
+		
+	public:
+		ThreadPoolScheduler (unsigned int numThreads, std::ostream &LOG);
+		virtual ~ThreadPoolScheduler ();
+		
+		// Inherited from Scheduler
+		int addOperator (Operator *op);
+		int addOperator (Operator *op, unsigned int fragment);
+		int setQueues (Operator *op, Queue **inQueues, Operator **inOps,
+					   unsigned int numInputs, Queue *outQueue);
+		int run (long long int numTimeUnits);
+		int stop ();
+		int resume ();
+		
+	private:
+		int runFragment (Fragment *fragment);
+		int runOp (Fragment *fragment, unsigned int o);
+		bool waitForOthers (long long int round);
+		int drain ();
+		
+		static void *worker (void *arg);
+	};
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef _WORK_STEALING_
+#define _WORK_STEALING_
+
+/**
+ * @file       work_stealing.h
+ * @date       Oct. 17, 2026
+ * @brief      Scheduler that runs only operators with pending work, using
+ *             worker threads that steal work from each other.
+ */
+
+#include <pthread.h>
+#include <ostream>
+
+#ifndef _SCHEDULER_
+#include "execution/scheduler/scheduler.h"
+#endif
+
+/**
+ * The round robin schedulers call every operator once per round, even
+ * operators with nothing to do.  The work stealing scheduler checks the
+ * queues of an operator and runs it only if it is ready: it has an input
+ * element to process (or is a source), or it was blocked at its output
+ * queue which has room now.  In both cases, its output queue must not be
+ * full.
+ *
+ * The plan manager partitions the plan into (up to MAX_TASKS) fragments,
+ * called tasks here.  A task is the unit of work stealing: it is run by
+ * one worker at a time, since its operators share state.  Each task has
+ * a home worker that runs it; a worker which finds nothing ready in its
+ * own tasks steals a ready task from another worker.
+ */
+
+namespace Execution {
+	class WorkStealingScheduler : public Scheduler {
+	public:
+		/// Maximum number of worker threads
+		static const unsigned int MAX_THREADS = 32;
+		
+		/// Maximum number of tasks (plan fragments)
+		static const unsigned int MAX_TASKS = 32;
+		
+	private:
+		/// Maximum number of operators
+		static const unsigned int MAX_OPS = 100;
+		
+		/// Maximum number of inputs of an operator
+		static const unsigned int MAX_INPUTS = 4;
+		
+		/// Maximum number of rounds a worker can be ahead of the slowest
+		/// worker
+		static const long long int MAX_SKEW = 4;
+		
+		/// Maximum number of rounds to drain the queues at the end of a
+		/// run
+		static const unsigned int MAX_DRAIN_ROUNDS = 1000;
+		
+		struct OpInfo {
+			/// The operator
+			Operator *op;
+			
+			/// Input queues of the operator
+			Queue *inQueues [MAX_INPUTS];
+			
+			/// Number of input queues
+			unsigned int numInputs;
+			
+			/// Output queue of the operator (0 if none)
+			Queue *outQueue;
+			
+			/// Was the output queue full after the last run of the op?
+			bool bBlocked;
+		};
+		
+		struct Task {
+			/// Operators of this task (indexes in ops)
+			unsigned int ops [MAX_OPS];
+			
+			/// Number of operators of this task
+			unsigned int numOps;
+			
+			/// Is the task being run by some worker?  Taken with a
+			/// compare-and-swap and released with __sync_lock_release
+			int busy;
+		};
+		
+		struct Worker {
+			/// The scheduler
+			WorkStealingScheduler *sched;
+			
+			/// Worker id: the worker runs tasks id, id + numThreads, ...
+			unsigned int id;
+			
+			/// Thread running this worker
+			pthread_t thread;
+			
+			/// Number of rounds completed in the current run (read by
+			/// the other workers with acquire semantics)
+			long long int round;
+			
+			/// Number of tasks stolen from other workers
+			unsigned long long int numSteals;
+			
+			/// Return code of the last run
+			int rc;
+		};
+		
+		/// Operators that we are scheduling
+		OpInfo ops [MAX_OPS];
+		
+		/// Number of operators
+		unsigned int numOps;
+		
+		/// Tasks
+		Task tasks [MAX_TASKS];
+		
+		/// Number of tasks
+		unsigned int numTasks;
+		
+		/// Workers
+		Worker workers [MAX_THREADS];
+		
+		/// Number of workers
+		unsigned int numThreads;
+		
+		/// Time units of the current run (0 for ever)
+		long long int numTimeUnits;
+		
+		/// Set (with release semantics) to stop all the workers
+		bool bStop;
+		
+		/// System log
+		std::ostream &LOG;
+		
+	public:
+		WorkStealingScheduler (unsigned int numThreads, std::ostream &LOG);
+		virtual ~WorkStealingScheduler ();
+		
+		// Inherited from Scheduler
+		int addOperator (Operator *op);
+		int addOperator (Operator *op, unsigned int fragment);
+		int setQueues (Operator *op, Queue **inQueues, Operator **inOps,
+					   unsigned int numInputs, Queue *outQueue);
+		int run (long long int numTimeUnits);
+		int stop ();
+		int resume ();
+		
+	private:
+		int runWorker (Worker *worker);
+		int runTask (Task *task, bool &bRun);
+		bool isReady (const OpInfo *info) const;
+		bool hasInput () const;
+		bool waitForOthers (long long int round);
+		int drain ();
+		
+		static void *worker (void *arg);
+	};
+}
+
+#endif
@@ -96,10 +96,13 @@ namespace Execution {
 		//----------------------------------------------------------------------
 		
 		/// Maximum number of lineage columns
-		static const unsigned int MAX_LINEAGE = 2;
+		static const unsigned int MAX_LINEAGE = 4;
 		
 		/// The columns in the stored tuples that correspond to lineages.
+		/// Each lineage is the 64 bit id (MemoryManager::getId()) of a
+		/// tuple: linCols hold its lower and linHiCols its upper 32 bits
 		Column linCols [MAX_LINEAGE];
+		Column linHiCols [MAX_LINEAGE];
 		
 		/// number of lineages in this store
 		unsigned int numLins;
@@ -130,7 +133,7 @@ namespace Execution {
 		int setRefCountCol (Column refcount);
 		int setNumStubs (unsigned int numStubs);
 		int setThreshold (float threshold);
-		int addLineage (Column col);
+		int addLineage (Column col, Column hiCol);
 		int setLineageTuple (Tuple tuple);
 		int setIndex (Index *index);
 		int setEvalContext (EvalContext *evalContext);
@@ -49,6 +49,10 @@ namespace Execution {
 		/// Number of tuples allocated so far in this page
 		unsigned int numAllocInCurPage;
 		
+		/// Are tuples referenced by threads other than the owner's?  If
+		/// so, reference counts are updated atomically.
+		bool bConcurrent;
+		
 		/// System Log
 		std::ostream& LOG;
 		
@@ -59,6 +63,7 @@ namespace Execution {
 		
 		int setMemoryManager(MemoryManager *memMgr);
 		int setTupleLen(unsigned int tupleLen);
+		int setConcurrent(bool bConcurrent);
 		int initialize();
 		
 		int newTuple (Tuple& tuple);
@@ -0,0 +1,153 @@
+#ifndef _MINMAX_SYN_
+#define _MINMAX_SYN_
+
+/**
+ * @file         minmax_syn.h
+ * @date         Oct. 17, 2026
+ * @brief        Synopsis maintaining MAX and MIN aggregates over a
+ *               window, per group.
+ */
+
+#ifndef _TUPLE_
+#include "execution/internals/tuple.h"
+#endif
+
+#ifndef _TYPES_
+#include "common/types.h"
+#endif
+
+#ifndef _MEMORY_MGR_
+#include "execution/memory/memory_mgr.h"
+#endif
+
+#ifndef _CPP_OSTREAM_
+#include <ostream>
+#endif
+
+/**
+ * A MinMaxSynopsis maintains the MAX and MIN aggregates of the groups
+ * of a group-by aggregation, when tuples leave the input relation in
+ * the order in which they entered it, as they do in the output of a
+ * row or range window.
+ *
+ * For each group and aggregate we keep a monotonic deque of input
+ * tuples: the values in the deque are strictly decreasing (MAX) or
+ * increasing (MIN) from front to back, so the front holds the current
+ * aggregate.  A new tuple removes from the back all the tuples whose
+ * value it matches or beats: they leave the window before it, so they
+ * can never be the aggregate again.  A MINUS tuple is at the front of
+ * the deque if it is there at all.  Both operations are amortized
+ * constant time, so the aggregation never has to rescan the group.
+ *
+ * A group is identified by a header allocated by the synopsis, which
+ * the operator keeps with the group's aggregation tuple.
+ */
+
+namespace Execution {
+	class MinMaxSynopsis {
+	private:
+		/// Maximum number of MAX / MIN aggregates
+		static const unsigned int MAX_AGGRS = 10;
+		
+		/// An entry of a deque.  The header of a group is an array of
+		/// nodes, the sentinels of its (circular) deques
+		struct Node {
+			Tuple  tuple;
+			union {
+				int   ival;
+				float fval;
+			} val;
+			Node  *prev;
+			Node  *next;
+		};
+		
+		/// System-wide unique id
+		unsigned int id;
+		
+		/// System log
+		std::ostream &LOG;
+		
+		/// Memory manager from which we get our pages
+		MemoryManager *memMgr;
+		
+		/// Aggregates we maintain
+		struct {
+			Type    type;
+			Column  inCol;
+			Column  outCol;
+			bool    bMax;
+		} aggrs [MAX_AGGRS];
+		
+		unsigned int numAggrs;
+		
+		/// Free nodes
+		Node *freeNodes;
+		
+		/// Free group headers, linked through their first sentinel
+		Node *freeHeaders;
+		
+		int allocNode (Node *&node);
+		int allocHeader (Node *&header);
+		int allocPage (Node *&freeList, unsigned int unitSize);
+		
+		/// Does the value of node1 match or beat that of node2 for
+		/// aggregate a?
+		bool dominates (unsigned int a, Node *node1, Node *node2) const;
+	
+	public:
+		MinMaxSynopsis (unsigned int id, std::ostream &LOG);
+		~MinMaxSynopsis ();
+		
+		//------------------------------------------------------------
+		// Initialization routines
+		//------------------------------------------------------------
+		
+		int setMemoryManager (MemoryManager *memMgr);
+		
+		/**
+		 * Add an aggregate.
+		 *
+		 * @param  type      Type of the aggregated attribute (INT / FLOAT)
+		 * @param  inCol     Column of the attribute in input tuples
+		 * @param  outCol    Column of the aggregate in aggr. tuples
+		 * @param  bMax      MAX if true, MIN otherwise
+		 */
+		int addAggr (Type type, Column inCol, Column outCol, bool bMax);
+		
+		int initialize ();
+		
+		//------------------------------------------------------------
+		// Maintenance
+		//------------------------------------------------------------
+		
+		/**
+		 * Create the (empty) deques for a new group.
+		 *
+		 * @param  group     (output) header of the group
+		 */
+		int newGroup (char *&group);
+		
+		/**
+		 * Free the deques of a group that has become empty.
+		 */
+		int deleteGroup (char *group);
+		
+		/**
+		 * A PLUS tuple of the group.
+		 */
+		int insertTuple (char *group, Tuple tuple);
+		
+		/**
+		 * A MINUS tuple of the group.
+		 */
+		int deleteTuple (char *group, Tuple tuple);
+		
+		/**
+		 * Write the current aggregates of a (nonempty) group into its
+		 * aggregation tuple.
+		 */
+		int copyExtremes (char *group, Tuple aggrTuple) const;
+	};
+}
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef _PANE_SYN_
+#define _PANE_SYN_
+
+/**
+ * @file         pane_syn.h
+ * @date         Oct. 17, 2026
+ * @brief        Synopsis maintaining per-pane partial aggregates of the
+ *               groups of an aggregation over a sliding range window.
+ */
+
+#ifndef _TUPLE_
+#include "execution/internals/tuple.h"
+#endif
+
+#ifndef _EVAL_CONTEXT_
+#include "execution/internals/eval_context.h"
+#endif
+
+#ifndef _AEVAL_
+#include "execution/internals/aeval.h"
+#endif
+
+#ifndef _MEMORY_MGR_
+#include "execution/memory/memory_mgr.h"
+#endif
+
+#ifndef _CPP_OSTREAM_
+#include <ostream>
+#endif
+
+/**
+ * A range window that slides by s time units changes only every s time
+ * units: the tuples with timestamps in [k*s, (k+1)*s) - pane k - leave
+ * the window together.  A PaneSynopsis keeps, for each group of an
+ * aggregation over such a window, one partial aggregation tuple per
+ * pane in which the group has tuples.  When panes expire, the new
+ * aggregate of the group is computed from the partial aggregates of the
+ * remaining panes, independent of the number of tuples in the expired
+ * panes.
+ *
+ * The panes of a group form a queue, which we evaluate with two stacks:
+ * the older panes (the front) carry the aggregate of themselves and all
+ * the newer panes of the front, and the newer panes (the back) share a
+ * running aggregate.  The aggregate of the group is then a combination
+ * of two partial aggregates, and each pane takes part in one suffix
+ * computation, when it moves from the back to the front.  The newest
+ * pane, the one still being filled, always stays in the back.
+ *
+ * Partial aggregation tuples have the layout of the aggregation tuples
+ * of the operator, and are computed by its evaluators:
+ *
+ *   initEval    : INPUT_ROLE tuple -> new aggregate in NEW_OUTPUT_ROLE
+ *   updateEval  : folds the INPUT_ROLE tuple into NEW_OUTPUT_ROLE
+ *   combineEval : OLD_OUTPUT_ROLE + PANE_ROLE -> NEW_OUTPUT_ROLE
+ */
+
+namespace Execution {
+	class PaneSynopsis {
+	private:
+		/// A pane of a group.  The partial aggregate of the pane and
+		/// (in the front) the suffix aggregate follow the header
+		struct Pane {
+			unsigned int  paneNo;
+			Pane         *prev;
+			Pane         *next;
+		};
+		
+		/// A group.  The running aggregate of the back follows the
+		/// header
+		struct Group {
+			Group        *prev;
+			Group        *next;
+			
+			/// Current aggregation tuple of the group
+			Tuple         aggrTuple;
+			
+			/// Panes, oldest first
+			Pane         *oldest;
+			Pane         *newest;
+			
+			/// Oldest pane of the back
+			Pane         *back;
+		};
+		
+		static const unsigned int INPUT_ROLE      = 4;
+		static const unsigned int OLD_OUTPUT_ROLE = 3;
+		static const unsigned int NEW_OUTPUT_ROLE = 2;
+		static const unsigned int PANE_ROLE       = 5;
+		
+		/// System-wide unique id
+		unsigned int id;
+		
+		/// System log
+		std::ostream &LOG;
+		
+		/// Memory manager from which we get our pages
+		MemoryManager *memMgr;
+		
+		EvalContext *evalContext;
+		AEval *initEval;
+		AEval *updateEval;
+		AEval *combineEval;
+		
+		/// Length of an aggregation tuple
+		unsigned int tupleLen;
+		
+		/// ... rounded up so that the aggregates after it stay aligned
+		unsigned int alignedLen;
+		
+		/// Sizes of a pane and a group with their aggregates
+		unsigned int paneSize;
+		unsigned int groupSize;
+		
+		/// Groups with at least one pane
+		Group *groups;
+		
+		/// Free panes & groups, linked through their first word
+		char *freePanes;
+		char *freeGroups;
+		
+		/// Round up a size so that what follows is suitably aligned
+		static unsigned int align (unsigned int size) {
+			return (size + sizeof (double) - 1) & ~(sizeof (double) - 1);
+		}
+		
+		char *getPartial (Pane *pane) const {
+			return (char *)pane + align (sizeof (Pane));
+		}
+		
+		char *getSuffix (Pane *pane) const {
+			return (char *)pane + align (sizeof (Pane)) + alignedLen;
+		}
+		
+		char *getBackAggr (Group *group) const {
+			return (char *)group + align (sizeof (Group));
+		}
+		
+		/// Move all the panes of the back but the newest to the front
+		void flip (Group *group);
+		
+		/// Combine two partial aggregates into dest
+		void combine (char *left, char *right, char *dest);
+		
+		int allocUnit (char *&freeList, unsigned int unitSize, char *&unit);
+		void freeUnit (char *&freeList, char *unit);
+	
+	public:
+		PaneSynopsis (unsigned int id, std::ostream &LOG);
+		~PaneSynopsis ();
+		
+		//------------------------------------------------------------
+		// Initialization routines
+		//------------------------------------------------------------
+		
+		int setMemoryManager (MemoryManager *memMgr);
+		int setEvalContext (EvalContext *evalContext);
+		
+		/**
+		 * The evaluators computing partial aggregates (see above).  We
+		 * own the combineEval; the others belong to the operator.
+		 */
+		int setEvaluators (AEval *initEval, AEval *updateEval,
+						   AEval *combineEval);
+		
+		/// Length of the aggregation tuples, without the columns of the
+		/// store
+		int setTupleLen (unsigned int tupleLen);
+		
+		int initialize ();
+		
+		//------------------------------------------------------------
+		// Maintenance
+		//------------------------------------------------------------
+		
+		int newGroup (char *&group);
+		int deleteGroup (char *group);
+		
+		/**
+		 * A tuple of the group, which belongs to pane paneNo (never
+		 * older than the newest pane of the group).
+		 */
+		int insertTuple (char *group, unsigned int paneNo, Tuple tuple);
+		
+		/**
+		 * Drop the panes of the group older than firstPane.
+		 *
+		 * @param  bEmpty    (output) true if no pane of the group is left
+		 */
+		int expirePanes (char *group, unsigned int firstPane, bool &bEmpty);
+		
+		/**
+		 * Compute the aggregate of a (nonempty) group over its panes
+		 * into aggrTuple.
+		 */
+		int getAggregate (char *group, Tuple aggrTuple);
+		
+		bool hasExpiredPanes (char *group, unsigned int firstPane) const {
+			return (((Group *)group) -> oldest -> paneNo < firstPane);
+		}
+		
+		Tuple getAggrTuple (char *group) const {
+			return ((Group *)group) -> aggrTuple;
+		}
+		
+		void setAggrTuple (char *group, Tuple aggrTuple) {
+			((Group *)group) -> aggrTuple = aggrTuple;
+		}
+		
+		/// Iteration over the groups
+		char *getFirstGroup () const {
+			return (char *)groups;
+		}
+		
+		char *getNextGroup (char *group) const {
+			return (char *)(((Group *)group) -> next);
+		}
+	};
+}
+
+#endif
@@ -8,6 +8,10 @@
  */
 
 
+#ifndef _TYPES_
+#include "common/types.h"
+#endif
+
 #ifndef _TUPLE_
 #include "execution/internals/tuple.h"
 #endif
@@ -65,6 +69,28 @@ namespace Execution {
 		virtual int releaseScan (unsigned int scanId,
 								 TupleIterator *iter) = 0;
 		
+		/**
+		 * Prepare scan scanId for the currently bound tuples: prefetch
+		 * what the scan will read first.  Synopses that cannot do
+		 * better do nothing.
+		 *
+		 * @param   scanId     Specification of which scan we want.
+		 * @param   hint       (output) to be passed to getScan
+		 * @return             [[ usual convention ]]
+		 */
+		virtual int prefetchScan (unsigned int scanId, Hash &hint) {
+			hint = 0;
+			return 0;
+		}
+		
+		/**
+		 * getScan, with the hint of a prefetchScan for the same bindings.
+		 */
+		virtual int getScan (unsigned int    scanId,
+							 Hash            hint,
+							 TupleIterator  *&iter) {
+			return getScan (scanId, iter);
+		}
 	};
 #else
 	
@@ -107,6 +133,28 @@ namespace Execution {
 		virtual int releaseScan (unsigned int scanId,
 								 TupleIterator *iter) = 0;
 		
+		/**
+		 * Prepare scan scanId for the currently bound tuples: prefetch
+		 * what the scan will read first.  Synopses that cannot do
+		 * better do nothing.
+		 *
+		 * @param   scanId     Specification of which scan we want.
+		 * @param   hint       (output) to be passed to getScan
+		 * @return             [[ usual convention ]]
+		 */
+		virtual int prefetchScan (unsigned int scanId, Hash &hint) {
+			hint = 0;
+			return 0;
+		}
+		
+		/**
+		 * getScan, with the hint of a prefetchScan for the same bindings.
+		 */
+		virtual int getScan (unsigned int    scanId,
+							 Hash            hint,
+							 TupleIterator  *&iter) {
+			return getScan (scanId, iter);
+		}
 	};	
 #endif
 }
@@ -87,6 +87,13 @@ namespace Execution {
 		int deleteTuple (Tuple tuple);
 		int getScan (unsigned int scanId, TupleIterator *&iter);
 		int releaseScan (unsigned int scanId, TupleIterator *iter);
+		int prefetchScan (unsigned int scanId, Hash &hint);
+		int getScan (unsigned int scanId, Hash hint, TupleIterator *&iter);
+		
+	private:
+		/// Apply the predicate of scan scanId (if any) to a source scan
+		int filterScan (unsigned int scanId, TupleIterator *source,
+						TupleIterator *&iter);
 	};
 }
 
@@ -57,6 +57,19 @@ namespace Interface {
 		 * @return            0 (success), !0 (failure)
 		 */
 		virtual int end() = 0;
+		
+		/**
+		 * Declared rate of the table: the number of tuples it produces
+		 * per time unit.  The optimizer uses it to estimate the sizes
+		 * of the windows over the table until the rate of the table has
+		 * been observed.  By default a source declares no rate.
+		 *
+		 * @param   rate      tuples per time unit
+		 * @return            0 (rate declared), !0 (no rate known)
+		 */
+		virtual int getRateHint (double &rate) {
+			return -1;
+		}
 	};
 }
 
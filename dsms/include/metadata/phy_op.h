@@ -105,6 +105,9 @@ namespace Physical {
 		// Combination of a str-join followed by project
 		PO_STR_JOIN_PROJECT,
 		
+		// Relation join of more than two inputs
+		PO_MJOIN,
+		
 		// Group-by aggregation
 		PO_GROUP_AGGR,
 		
@@ -158,9 +161,9 @@ namespace Physical {
 		PO_SS_GEN
 	};	
 	
-	// Maximum number of inputs to an operator: we only consider unary and
-	// binary operators now ...
-	static const unsigned int MAX_IN_BRANCHING = 2;
+	// Maximum number of inputs to an operator: all operators are unary or
+	// binary, except multi-way joins
+	static const unsigned int MAX_IN_BRANCHING = 4;
 	static const unsigned int MAX_GROUP_ATTRS = 10;
 	static const unsigned int MAX_AGGR_ATTRS  = 10;
 
@@ -221,6 +224,9 @@ namespace Physical {
 		/// Instantiated operator
 		Execution::Operator *instOp;
 		
+		/// Execution fragment (worker thread) that runs this operator
+		unsigned int fragment;
+		
 		union {
 			
 			struct {
@@ -330,6 +336,22 @@ namespace Physical {
 				Synopsis *innerSyn;
 			} STR_JOIN_PROJECT;
 			
+			struct {
+				// My output schema is the concatenation of the first
+				// numInputAttrs [i] attributes of each input i, stored
+				// at construction time like JOIN.numOuterAttrs
+				unsigned int numInputAttrs [MAX_IN_BRANCHING];
+				
+				// Join predicate
+				BExpr *pred;
+				
+				// Synopses for the inputs
+				Synopsis *inSyns [MAX_IN_BRANCHING];
+				
+				// Synopsis for output (required to generate MINUS elements)
+				Synopsis *joinSyn;
+			} MJOIN;
+			
 			struct {
 				// grouping attributes
 				Attr         groupAttrs [MAX_GROUP_ATTRS];
@@ -351,6 +373,12 @@ namespace Physical {
 				
 				// Synopsis for output
 				Synopsis *outSyn;
+				
+				// Range and slide of a sliding range window over the
+				// input stream that the operator evaluates itself, a
+				// pane at a time (slideUnits == 0 if none)
+				unsigned int timeUnits;
+				unsigned int slideUnits;
 			} GROUP_AGGR;
 			
 			struct {
@@ -55,6 +55,10 @@ namespace Physical {
 		/// Instantiated store
 		Execution::StorageAlloc *instStore;
 		
+		/// Are tuples of this store referenced by operators running in
+		/// a different fragment than the owner?
+		bool bConcurrent;
+		
 		union {
 			struct {
 				Index *idx;
@@ -167,6 +167,19 @@ namespace Metadata {
 
 		/// debug
 		virtual int printStat () = 0;
+		
+		/**
+		 * Update the rates of the base tables, and the selectivities of
+		 * the joins of two base tables, in the table manager with those
+		 * observed since the last update (requires _MONITOR_), and
+		 * determine if some of them has drifted away from the one the
+		 * current plan was built with.
+		 *
+		 * @param   bDrifted     (output) has some rate or selectivity
+		 *                       drifted?
+		 * @return               0 (success), !0 (failure)
+		 */
+		virtual int updateStatistics (bool &bDrifted) = 0;
 
 #ifdef _SYS_STR_
 		
@@ -189,6 +202,29 @@ namespace Metadata {
 									Logical::Operator *logPlan,
 									Interface::QueryOutput *output,
 									Execution::Scheduler *sched) = 0;
+		
+		/**
+		 * Migrate the running plan to a new plan without stopping the
+		 * execution or losing the state of the windows.  The new plan
+		 * runs alongside the current one (parallel track): the stream
+		 * sources feed both plans until the windows of the new plan
+		 * hold all the tuples they need, and from then on the outputs
+		 * of the queries are produced by the new plan.
+		 *
+		 * beginMigration() determines if the current plan can be
+		 * migrated (bMigrate), addMigrationPlan() is then called with
+		 * the new logical plan of each query with an output, and
+		 * endMigration() instantiates the new operators and adds them to
+		 * the scheduler.  These are called when the execution is
+		 * not running.
+		 */
+		
+		virtual int beginMigration (bool &bMigrate) = 0;
+		
+		virtual int addMigrationPlan (unsigned int queryId,
+									  Logical::Operator *logPlan) = 0;
+		
+		virtual int endMigration (Execution::Scheduler *sched) = 0;
 #endif
 		
 	};
@@ -198,6 +198,50 @@ namespace Metadata {
 			unsigned int opId;
 		} queryOutOps [MAX_QUERIES];
 		
+		//----------------------------------------------------------------------
+		// Statistics (plan_stats.cc): per entry of sourceOps
+		//----------------------------------------------------------------------
+		
+		/// Rate of the table when the plan was built
+		double planRates [MAX_TABLES];
+		
+		/// Number of elements read by the source of the table, and the
+		/// timestamp of its output, when its rate was last observed
+		int obsTuples [MAX_TABLES];
+		int obsTs [MAX_TABLES];
+		
+		/// Per entry of ops: selectivity of a join when the plan was
+		/// built (0 if unknown)
+		double planJoinSels [MAX_OPS];
+		
+		/// Per entry of ops: number of input tuples, pairs of tuples
+		/// considered and output tuples of a join when its selectivity
+		/// was last observed
+		int obsJoinInput [MAX_OPS];
+		double obsJoinPairs [MAX_OPS];
+		int obsJoinOutput [MAX_OPS];
+		
+		//----------------------------------------------------------------------
+		// Plan migration (plan_migrate.cc)
+		//----------------------------------------------------------------------
+		
+		/// Maximum number of operators in the plans migrated to
+		static const unsigned int MAX_MIGRATE_OPS = 500;
+		
+		/// Operators of the plans migrated to, including the stream
+		/// sources feeding them
+		Operator *migrateOps [MAX_MIGRATE_OPS];
+		unsigned int numMigrateOps;
+		
+		/// Output operators of the plans migrated to, and the output
+		/// operators of the current plans they replace
+		Operator *newOutOps [MAX_OUTPUT];
+		Operator *oldOutOps [MAX_OUTPUT];
+		unsigned int numMigrateOutputs;
+		
+		/// Number of time units of input the windows of the plan span
+		unsigned int migrateHorizon;
+		
 	public:
 		PlanManagerImpl(TableManager *tableMgr, std::ostream& LOG);
 		virtual ~PlanManagerImpl();		
@@ -308,6 +352,8 @@ namespace Metadata {
 #endif
 
 		int printStat ();
+		
+		int updateStatistics (bool &bDrifted);
 
 #ifdef _SYS_STR_
 		
@@ -319,6 +365,13 @@ namespace Metadata {
 							Logical::Operator *logPlan,
 							Interface::QueryOutput *output,
 							Execution::Scheduler *sched);
+		
+		int beginMigration (bool &bMigrate);
+		
+		int addMigrationPlan (unsigned int queryId,
+							  Logical::Operator *logPlan);
+		
+		int endMigration (Execution::Scheduler *sched);
 #endif
 		
 	private:
@@ -452,6 +505,11 @@ namespace Metadata {
 					 Physical::Operator **phyChildPlans,
 					 Physical::Operator *&phyPlan);
 		
+		// PO_MJOIN
+		int mk_mjoin (Logical::Operator *logPlan,
+					  Physical::Operator **phyChildPlans,
+					  Physical::Operator *&phyPlan);
+		
 		// PO_STR_JOIN
 		int mk_str_join (Logical::Operator *logPlan,
 						 Physical::Operator **phyChildPlans,
@@ -461,6 +519,10 @@ namespace Metadata {
 		int mk_group_aggr (Logical::Operator *logPlan,
 						   Physical::Operator **phyChildPlans,
 						   Physical::Operator *&phyPlan);
+		
+		// Fold a sliding range window below a PO_GROUP_AGGR into it
+		int fold_slide_win (Physical::Operator *gaOp,
+							Physical::Operator *&input);
 
 		// PO_DISTINCT
 		int mk_distinct (Logical::Operator *logPlan,
@@ -543,6 +605,27 @@ namespace Metadata {
 		 */
 		
 		int removeQuerySources ();
+		
+		/**
+		 * Remember the rates of the base tables (and the selectivities of
+		 * their joins) the plan is built with, which updateStatistics()
+		 * compares the observed ones to.
+		 */
+		int savePlanRates ();
+		
+		/**
+		 * The base tables joined by a binary join, if each of its inputs
+		 * reads a single base table (through selects, projects and
+		 * windows).
+		 */
+		bool getJoinTables (const Operator *op, unsigned int &outerTable,
+							unsigned int &innerTable) const;
+		
+		/**
+		 * Observe the selectivity of the binary joins of two base tables
+		 * (plan_stats.cc).
+		 */
+		int updateJoinSelectivities (bool &bDrifted);
 
 		/**
 		 * Add sink operators to drain away output from operators with
@@ -550,6 +633,16 @@ namespace Metadata {
 		 */
 		int addSinks ();
 		
+		/**
+		 * Share the operators that compute the same output from the
+		 * same inputs across queries: the readers of the copies read
+		 * the one that is kept (through a shared queue).  A select whose
+		 * input is also read by a select applying some of its
+		 * predicates reads the output of that select instead, and
+		 * applies the rest of its predicates only.
+		 */
+		int shareSubplans ();
+		
 		/**
 		 * Wherever possible, merge two select operators that apply
 		 * different predicates into one select operator that applies all
@@ -585,6 +678,7 @@ namespace Metadata {
 		int add_syn_proj (Operator *op);
 		int add_syn_join (Operator *op);
 		int add_syn_str_join (Operator *op);
+		int add_syn_mjoin (Operator *op);
 		int add_syn_join_proj (Operator *op);
 		int add_syn_str_join_proj (Operator *op);
 		int add_syn_gby_aggr (Operator *op);
@@ -662,6 +756,15 @@ namespace Metadata {
 		// Set the input stores for operators
 		int set_in_stores ();
 		
+		//----------------------------------------------------------------------
+		// Partitioning of the operators into execution fragments, each run
+		// by a different thread (defined in plan_fragment.cc)
+		//----------------------------------------------------------------------
+		
+		int assign_fragments ();
+		
+		int set_sched_queues (Operator *op, Execution::Scheduler *sched);
+		
 		// defined in gen_phy_plan.cc
 		int mk_dummy_project (Operator *child, Operator *&project);
 		
@@ -708,6 +811,7 @@ namespace Metadata {
 		int inst_project (Physical::Operator *op);
 		int inst_join (Physical::Operator *op);
 		int inst_str_join (Physical::Operator *op);
+		int inst_mjoin (Physical::Operator *op);
 		int inst_aggr (Physical::Operator *op);
 		int inst_distinct (Physical::Operator *op);
 		int inst_row_win (Physical::Operator *op);
@@ -801,6 +905,10 @@ namespace Metadata {
 							 Physical::Operator **opList,
 							 unsigned int &numOps);
 		
+		int shareSubplans_mon (Physical::Operator *&plan,
+							   Physical::Operator **opList,
+							   unsigned int &numOps);
+		
 		int mergeSelects_mon (Physical::Operator *&plan,
 							  Physical::Operator **opList,
 							  unsigned int &numOps);
@@ -846,6 +954,14 @@ namespace Metadata {
 						   Physical::Queue **queueList, unsigned int,
 						   Physical::Store **storeList, unsigned int,
 						   Physical::Synopsis **synList, unsigned int);
+		
+		//------------------------------------------------------------
+		// Plan migration routines
+		//------------------------------------------------------------
+		
+		bool canMigrate ();
+		int addMigrateOps (Physical::Operator *op);
+		int inst_str_source_store (Physical::Operator *op);
 	};
 }
 
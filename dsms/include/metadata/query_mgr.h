@@ -20,8 +20,8 @@ namespace Metadata {
 	 * the system.  It also assigns a unique identifier to each query
 	 * which is used by the rest of the system.
 	 *
-	 * Storing the query strings does not serve any useful purpose at
-	 * present - but seems in general to be a useful thing to do :)
+	 * The query strings are used to plan the queries again during
+	 * execution (see ServerImpl::replan()).
 	 */
 	
 	class QueryManager {
@@ -55,6 +55,17 @@ namespace Metadata {
 		
 		int registerQuery (const char *queryStr, unsigned int queryStrLen,
 						   unsigned int &queryId);
+		
+		/**
+		 * Number of queries registered so far: the queries have ids 0
+		 * .. getNumQueries() - 1
+		 */
+		unsigned int getNumQueries () const;
+		
+		/**
+		 * Get the string of a registered query (null terminated)
+		 */
+		const char *getQuery (unsigned int queryId) const;
 	};
 }
 
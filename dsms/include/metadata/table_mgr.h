@@ -34,6 +34,9 @@ namespace Metadata {
 			bool            isStream;
 			unsigned int    numAttrs;
 			Attribute       attrList [ MAX_ATTRS ];
+			
+			// Estimated number of tuples per time unit (0 if unknown)
+			double          rate;
 		};		
 		
 		// Number of tables currently registered
@@ -42,6 +45,10 @@ namespace Metadata {
 		// Information about currently registered tables
 		Table               tableList [ MAX_TABLES ];
 		
+		// Observed selectivities of the joins of two tables (0 if
+		// unknown), symmetric
+		double              joinSels [ MAX_TABLES ][ MAX_TABLES ];
+		
 	public:
 		TableManager();		
 		~TableManager();
@@ -173,6 +180,48 @@ namespace Metadata {
 		 */		
 		const char *getTableName (unsigned int tableId) const;
 		
+		//---------------------------------------------------------------------
+		//
+		// Statistics used by the query optimizer
+		//
+		//---------------------------------------------------------------------
+		
+		/**
+		 * Set the estimated rate of a table: the number of tuples
+		 * (elements for a relation) per time unit.  The estimate is
+		 * either declared by the source of the table, or observed while
+		 * the system runs.
+		 *
+		 * @param    tableId  identifier of the table
+		 * @param    rate     tuples per time unit, 0 if unknown
+		 * @return            0 (success), !0 (failure)
+		 */
+		int setRate (unsigned int tableId, double rate);
+		
+		/**
+		 * Get the estimated rate of a table, 0 if unknown
+		 */
+		double getRate (unsigned int tableId) const;
+		
+		/**
+		 * Set the selectivity of the predicates that join two tables:
+		 * the fraction of the pairs of their tuples that join, as
+		 * observed by a join of the two tables while the system runs.
+		 *
+		 * @param    tableId1  identifier of a table
+		 * @param    tableId2  identifier of the other table
+		 * @param    sel       selectivity, 0 if unknown
+		 * @return             0 (success), !0 (failure)
+		 */
+		int setJoinSelectivity (unsigned int tableId1, unsigned int tableId2,
+								double sel);
+		
+		/**
+		 * Get the selectivity of the join of two tables, 0 if unknown
+		 */
+		double getJoinSelectivity (unsigned int tableId1,
+								   unsigned int tableId2) const;
+		
 		/// Debug
 		void printState() const;
 
@@ -91,6 +91,13 @@ class LogPlanGen {
 	 */ 
 	int t_streamCross (Logical::Operator *&plan);
 	
+	/**
+	 * Order the inputs of a cross product of more than two inputs by
+	 * the estimated cost of the binary joins they become, using the
+	 * rates of the tables (log_join_order.cc)
+	 */
+	int t_orderJoins (Logical::Operator *&plan);
+	
 	/**
 	 * Transform: Identify stream joins: Stream join is a special join
 	 * which has a stream one its "outer" and a stream or relation on its
@@ -33,11 +33,22 @@ class ConfigFileReader {
 		SHARED_QUEUE_SIZE,
 		INDEX_THRESHOLD,
 		RUN_TIME,
-		CPU_SPEED
+		CPU_SPEED,
+		NUM_THREADS,
+		SCHEDULER,
+		MAX_MEMORY_SIZE,
+		HUGE_PAGES,
+		NUMA,
+		VECTORIZE,
+		OPEN_HASH_INDEX,
+		JOIN_THREADS,
+		MULTIWAY_JOIN,
+		REPLAN_INTERVAL
 	};
 	
 	/**
-	 * The value of a parameter: could be an integer or a double
+	 * The value of a parameter: could be an integer or a double.  The
+	 * value of SCHEDULER is an Execution::SchedulerKind in ival.
 	 */ 
 	union ParamVal {
 		int ival;
@@ -66,6 +77,8 @@ class ConfigFileReader {
 	int parseLine (const char  *lineBuf,
 				   Param       &param,
 				   ParamVal    &val);
+	
+	int parseScheduler (const char *ptr, ParamVal &val);
 };
 
 #endif
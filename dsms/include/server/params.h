@@ -1,12 +1,32 @@
 #ifndef _PARAMS_
 #define _PARAMS_
 
+#ifndef _SCHEDULER_
+#include "execution/scheduler/scheduler.h"
+#endif
+
 /// Size of the memory managed by MemoryManager that is available to the
 /// execution units  
-unsigned int MEMORY;
+unsigned long long int MEMORY;
 
 /// Default memory size = 64 MB
-static const unsigned int MEMORY_DEFAULT = (1 << 20) * 64;
+static const unsigned long long int MEMORY_DEFAULT = (1 << 20) * 64;
+
+/// Size up to which the MemoryManager grows when it runs out of memory
+unsigned long long int MAX_MEMORY;
+
+/// Default: no limit
+static const unsigned long long int MAX_MEMORY_DEFAULT = 0;
+
+/// Back the memory with huge pages
+bool HUGE_PAGES;
+
+static const bool HUGE_PAGES_DEFAULT = false;
+
+/// Bind the memory to the NUMA nodes of the threads that use it
+bool NUMA;
+
+static const bool NUMA_DEFAULT = false;
 
 /// Memory allocated to a queue in number of pages
 unsigned int QUEUE_SIZE;
@@ -25,6 +45,11 @@ double INDEX_THRESHOLD;
 
 static const double INDEX_THRESHOLD_DEFAULT = 0.85;
 
+/// Use open addressing in the hash indexes
+bool OPEN_HASH_INDEX;
+
+static const bool OPEN_HASH_INDEX_DEFAULT = false;
+
 /// Number of iterations of the scheduler
 long long int SCHEDULER_TIME;
 
@@ -35,4 +60,43 @@ int CPU_SPEED;
 
 static const int CPU_SPEED_DEFAULT = 2000; // 2000 MHz
 
+/// Number of worker threads that execute the operators
+unsigned int NUM_THREADS;
+
+/// Default: all operators run in the server thread
+static const unsigned int NUM_THREADS_DEFAULT = 1;
+
+/// Evaluate the predicates of selections and the projections over
+/// batches of tuples where possible
+bool VECTORIZE;
+
+static const bool VECTORIZE_DEFAULT = false;
+
+/// Number of partitions probed in parallel by a relation equijoin
+unsigned int JOIN_THREADS;
+
+/// Default: joins probe in the thread of the operator
+static const unsigned int JOIN_THREADS_DEFAULT = 1;
+
+/// Evaluate joins of three or four relations with one multi-way join
+/// operator instead of a tree of binary joins
+bool MULTIWAY_JOIN;
+
+static const bool MULTIWAY_JOIN_DEFAULT = false;
+
+/// Number of iterations of the scheduler between two checks of the
+/// rates of the tables: if some rate drifted away from the one the plan
+/// was built with, the queries are planned again and the running plan
+/// is migrated to the new one
+long long int REPLAN_INTERVAL;
+
+/// Default: the plan is never changed
+static const long long int REPLAN_INTERVAL_DEFAULT = 0;
+
+/// Scheduling policy
+Execution::SchedulerKind SCHEDULER;
+
+static const Execution::SchedulerKind SCHEDULER_DEFAULT =
+	Execution::RR_SCHEDULER;
+
 #endif
@@ -91,6 +91,10 @@ class ServerImpl : public Server {
 	// condition variable to wake up the main thread after interruption
 	pthread_cond_t mainThreadWait;
 	
+	/// Number of queries registered before the execution began: the
+	/// queries registered later are monitors
+	unsigned int numAppQueries;
+	
  public:
 	ServerImpl(std::ostream &LOG);
 	~ServerImpl();
@@ -284,6 +288,21 @@ class ServerImpl : public Server {
  private:
 	int interruptExecution ();
 	int resumeExecution ();
+	
+	/**
+	 * Run the scheduler for SCHEDULER_TIME iterations, re-planning the
+	 * queries every REPLAN_INTERVAL iterations.
+	 */
+	int runScheduler ();
+	
+#ifdef _SYS_STR_
+	/**
+	 * Plan the queries again with the rates of the tables observed so
+	 * far, if some rate drifted away from the one the running plan was
+	 * built with, and migrate the running plan to the new one.
+	 */
+	int replan ();
+#endif
 };
 
 #endif
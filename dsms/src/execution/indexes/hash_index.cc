@@ -13,14 +13,21 @@
 #include "execution/indexes/hash_index.h"
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 // 3 layers should suffice for 1 G records
 #define MAX_LAYERS      3
 
+// The control byte of a full slot: the low 7 bits of the hash value.  The
+// remaining bits select the first group of the probe sequence
+#define HASH_CTRL(h)   ((unsigned char)((h) & 0x7F))
+#define HASH_GROUP(h)  ((h) >> 7)
+
 using namespace Execution;
 using namespace std;
 
-static unsigned int pathToBucket [MAX_LAYERS];
-
 int HashIndex::computeBucketIndexParams() 
 {
 	// number of bits per layer: floor (log_2 (pageSize / sizeof(void*)))
@@ -85,6 +92,11 @@ HashIndex::HashIndex(unsigned int id, ostream & _LOG)
 	this -> keyEqual = 0;
 	this -> scanHashEval = 0;
 	this -> iter = 0;
+	this -> bOpen = false;
+	this -> table.pages = 0;
+	this -> oldTable.pages = 0;
+	this -> bRehashing = false;
+	this -> openIter = 0;
 
 #ifdef _MONITOR_
 	this -> numEntries = 0;
@@ -101,6 +113,12 @@ HashIndex::~HashIndex () {
 		delete scanHashEval;
 	if (iter)
 		delete iter;
+	if (openIter)
+		delete openIter;
+	if (table.pages)
+		delete [] table.pages;
+	if (oldTable.pages)
+		delete [] oldTable.pages;
 }
 
 int HashIndex::setMemoryManager (MemoryManager *memMgr)
@@ -151,6 +169,12 @@ int HashIndex::setThreshold (float threshold)
 	return 0;
 }
 
+int HashIndex::setOpenAddressing (bool bOpen)
+{
+	this -> bOpen = bOpen;
+	return 0;
+}
+
 int HashIndex::initialize ()
 {
 	int rc;
@@ -159,6 +183,26 @@ int HashIndex::initialize ()
 	
 	pageSize = memMgr -> getPageSize();
 	
+	if (bOpen) {
+		
+		// As many slots per page as fit: a control byte, a hash value
+		// and a tuple per slot
+		for (logSlotsPerPage = 0 ;
+			 (2U << logSlotsPerPage) * (1 + sizeof (Hash) + sizeof (Tuple))
+				 <= pageSize ;
+			 logSlotsPerPage++)
+			;
+		
+		ASSERT ((1U << logSlotsPerPage) >= GROUP_SIZE);
+		
+		if ((rc = allocTable (table, 1 << logSlotsPerPage)) != 0)
+			return rc;
+		
+		openIter = new OpenHashIndexIterator (this, evalContext, keyEqual);
+		
+		return 0;
+	}
+	
 	// Work out the initial details (parameters) of the bucket index
 	// structure 
 	if ((rc = computeBucketIndexParams ()) != 0)
@@ -197,7 +241,10 @@ int HashIndex::initialize ()
 HashIndex::Entry **HashIndex::getBucket (Hash hashValue) const
 {	
 	char *bucketIndexNode;
-		
+	
+	// Local, since indexes can be used by different threads
+	unsigned int pathToBucket [MAX_LAYERS];
+	
 	for (unsigned int l = numLayers - 1; l > 0  ; 
 		 hashValue >>= numBitsPerLayer, l--)	
 		pathToBucket [l] = NON_ROOT_MASK & hashValue; 
@@ -284,6 +331,9 @@ int HashIndex::insertTuple (Tuple tuple)
 	numEntries++;
 #endif
 	
+	if (bOpen)
+		return openInsertTuple (tuple);
+	
 	// Compute the hash of the tuple
 	evalContext -> bind (tuple, UPDATE_ROLE);
 	hashValue = updateHashEval -> eval();
@@ -315,9 +365,12 @@ int HashIndex::deleteTuple (Tuple tuple)
 	Entry   *delEntry;
 
 #ifdef _MONITOR_
-	numEntries++;
+	numEntries--;
 #endif
 	
+	if (bOpen)
+		return openDeleteTuple (tuple);
+	
 	// compute the hash of the tuple
 	evalContext -> bind (tuple, UPDATE_ROLE);
 	hashValue = updateHashEval -> eval();
@@ -348,13 +401,49 @@ int HashIndex::deleteTuple (Tuple tuple)
 }
 
 int HashIndex::getScan (TupleIterator *& _iter)
+{
+	// Compute the hash 
+	return getScan (scanHashEval -> eval(), _iter);
+}
+
+/**
+ * Prefetch the bucket, or the control bytes and hash values of the
+ * first group of the probe sequence.  Of a chained bucket we can only
+ * prefetch the head: the entries depend on it.
+ */
+int HashIndex::prefetchScan (Hash &hashValue)
+{
+	unsigned int slot;
+	
+	hashValue = scanHashEval -> eval();
+	
+	if (bOpen) {
+		slot = (HASH_GROUP (hashValue) & (getNumGroups (table) - 1)) *
+			GROUP_SIZE;
+		
+		__builtin_prefetch (getCtrl (table, slot));
+		__builtin_prefetch (getHash (table, slot));
+		
+		return 0;
+	}
+	
+	__builtin_prefetch (getBucket (hashValue));
+	
+	return 0;
+}
+
+int HashIndex::getScan (Hash hashValue, TupleIterator *& _iter)
 {
 	int rc;
-	Hash      hashValue;
 	Entry   **bucket;
 	
-	// Compute the hash 
-	hashValue = scanHashEval -> eval();
+	if (bOpen) {
+		if ((rc = openIter -> initialize (hashValue)) != 0)
+			return rc;
+		
+		_iter = openIter;
+		return 0;
+	}
 	
 	// The bucket to be scanned.
 	bucket = getBucket (hashValue);
@@ -559,12 +648,382 @@ int HashIndex::rehashBucket (Entry **oldBucket, Entry **newBucket,
 	return 0;
 }
 
+//----------------------------------------------------------------------
+// Open addressing layout
+//----------------------------------------------------------------------
+
+unsigned int HashIndex::matchCtrl (const unsigned char *group,
+								   unsigned char ctrl)
+{
+#ifdef __SSE2__
+	return _mm_movemask_epi8
+		(_mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *) group),
+						 _mm_set1_epi8 ((char) ctrl)));
+#else
+	unsigned int mask = 0;
+	
+	for (unsigned int s = 0 ; s < GROUP_SIZE ; s++)
+		if (group [s] == ctrl)
+			mask |= (1 << s);
+	return mask;
+#endif
+}
+
+unsigned int HashIndex::matchFree (const unsigned char *group)
+{
+#ifdef __SSE2__
+	// Empty & deleted slots are the ones with the high bit set
+	return _mm_movemask_epi8 (_mm_loadu_si128 ((const __m128i *) group));
+#else
+	unsigned int mask = 0;
+	
+	for (unsigned int s = 0 ; s < GROUP_SIZE ; s++)
+		if (group [s] & 0x80)
+			mask |= (1 << s);
+	return mask;
+#endif
+}
+
+int HashIndex::allocTable (Table &t, unsigned int numSlots)
+{
+	int rc;
+	
+	ASSERT (numSlots >= (1U << logSlotsPerPage));
+	
+	t.numSlots = numSlots;
+	t.numPages = numSlots >> logSlotsPerPage;
+	t.numFull = 0;
+	t.numDeleted = 0;
+	t.pages = new char* [t.numPages];
+	
+	for (unsigned int p = 0 ; p < t.numPages ; p++) {
+		if ((rc = memMgr -> allocatePage (t.pages [p])) != 0) {
+			LOG << "HashIndex [" << id << "]: "
+				<< "Unable to allocate page" << endl;
+			
+			return rc;
+		}
+		
+		// All slots are initially empty
+		memset (t.pages [p], CTRL_EMPTY, 1 << logSlotsPerPage);
+	}
+	
+	return 0;
+}
+
+void HashIndex::freeTable (Table &t)
+{
+	for (unsigned int p = 0 ; p < t.numPages ; p++)
+		memMgr -> deallocatePage (t.pages [p]);
+	
+	delete [] t.pages;
+	t.pages = 0;
+}
+
+/**
+ * Insert an entry into the first free slot of its probe sequence.  The
+ * groups of the probe sequence are g, g+1, g+3, g+6, ... which, for a
+ * power of two number of groups, covers all groups.
+ */
+void HashIndex::insertEntry (Table &t, Tuple tuple, Hash hashValue)
+{
+	unsigned int   groupMask, group, step, slot;
+	unsigned char *ctrl;
+	unsigned int   free;
+	
+	groupMask = getNumGroups (t) - 1;
+	group = HASH_GROUP (hashValue) & groupMask;
+	
+	for (step = 1 ; ; group = (group + step ++) & groupMask) {
+		ctrl = getCtrl (t, group * GROUP_SIZE);
+		
+		if ((free = matchFree (ctrl)) != 0)
+			break;
+	}
+	
+	slot = __builtin_ctz (free);
+	if (ctrl [slot] == CTRL_DELETED)
+		t.numDeleted --;
+	
+	ctrl [slot] = HASH_CTRL (hashValue);
+	slot += group * GROUP_SIZE;
+	*getHash (t, slot) = hashValue;
+	*getTuple (t, slot) = tuple;
+	
+	t.numFull ++;
+}
+
+bool HashIndex::deleteEntry (Table &t, Tuple tuple, Hash hashValue)
+{
+	unsigned int   groupMask, group, step;
+	unsigned char *ctrl;
+	unsigned int   matches, s;
+	
+	groupMask = getNumGroups (t) - 1;
+	group = HASH_GROUP (hashValue) & groupMask;
+	
+	for (step = 1 ; step <= getNumGroups (t) ;
+		 group = (group + step ++) & groupMask) {
+		
+		ctrl = getCtrl (t, group * GROUP_SIZE);
+		matches = matchCtrl (ctrl, HASH_CTRL (hashValue));
+		
+		for ( ; matches ; matches &= matches - 1) {
+			s = __builtin_ctz (matches);
+			
+			if (*getTuple (t, group * GROUP_SIZE + s) == tuple) {
+				clearSlot (t, ctrl, s);
+				return true;
+			}
+		}
+		
+		// The probe sequence of hashValue ends here
+		if (matchCtrl (ctrl, CTRL_EMPTY))
+			return false;
+	}
+	
+	return false;
+}
+
+/**
+ * Free slot s of a group.  If the group has an empty slot, it has never
+ * been full, so no probe sequence continues past it, and the slot can
+ * be made empty.  Otherwise it has to be marked deleted.
+ */
+void HashIndex::clearSlot (Table &t, unsigned char *ctrl, unsigned int s)
+{
+	if (matchCtrl (ctrl, CTRL_EMPTY)) {
+		ctrl [s] = CTRL_EMPTY;
+	}
+	else {
+		ctrl [s] = CTRL_DELETED;
+		t.numDeleted ++;
+	}
+	
+	t.numFull --;
+}
+
+/**
+ * Number of slots for a new table holding the current entries: a
+ * power of two at least one page large, and at most half as full as
+ * the threshold allows.  Between two resizes, the table can then grow
+ * by 2x or shrink by 4x.
+ */
+unsigned int HashIndex::getTargetNumSlots () const
+{
+	unsigned int numSlots;
+	
+	ASSERT (!bRehashing);
+	
+	numSlots = 1 << logSlotsPerPage;
+	while (table.numFull + 1 > threshold / 2 * numSlots)
+		numSlots *= 2;
+	
+	return numSlots;
+}
+
+/**
+ * Start moving the entries to a new table with numSlots slots (which
+ * may be the same as now, to get rid of deleted slots).  The move is
+ * done REHASH_GROUPS groups at a time by the updates that follow, which
+ * keeps the cost of each update bounded.
+ */
+int HashIndex::startRehash (unsigned int numSlots)
+{
+	int rc;
+	
+	ASSERT (!bRehashing);
+	
+	if (numSlots != table.numSlots)
+		LOG << "HashIndex [" << id << "]: "
+			<< "Resizing to " << numSlots << " slots"
+			<< endl;
+	
+	oldTable = table;
+	if ((rc = allocTable (table, numSlots)) != 0)
+		return rc;
+	
+	bRehashing = true;
+	rehashGroup = 0;
+	
+	return 0;
+}
+
+void HashIndex::rehashStep ()
+{
+	unsigned int   endGroup, slot;
+	unsigned char *ctrl;
+	unsigned int   full, s;
+	
+	ASSERT (bRehashing);
+	
+	endGroup = rehashGroup + REHASH_GROUPS;
+	if (endGroup > getNumGroups (oldTable))
+		endGroup = getNumGroups (oldTable);
+	
+	for ( ; rehashGroup < endGroup ; rehashGroup++) {
+		ctrl = getCtrl (oldTable, rehashGroup * GROUP_SIZE);
+		full = ~matchFree (ctrl) & ((1 << GROUP_SIZE) - 1);
+		
+		for ( ; full ; full &= full - 1) {
+			s = __builtin_ctz (full);
+			slot = rehashGroup * GROUP_SIZE + s;
+			
+			insertEntry (table, *getTuple (oldTable, slot),
+						 *getHash (oldTable, slot));
+			clearSlot (oldTable, ctrl, s);
+		}
+	}
+	
+	if (rehashGroup == getNumGroups (oldTable)) {
+		ASSERT (oldTable.numFull == 0);
+		
+		freeTable (oldTable);
+		bRehashing = false;
+	}
+}
+
+int HashIndex::openInsertTuple (Tuple tuple)
+{
+	Hash hashValue;
+	
+	evalContext -> bind (tuple, UPDATE_ROLE);
+	hashValue = updateHashEval -> eval();
+	
+	if (bRehashing)
+		rehashStep ();
+	
+	insertEntry (table, tuple, hashValue);
+	
+	// Too few free slots: grow, or just get rid of deleted slots
+	if (!bRehashing &&
+		table.numFull + table.numDeleted > threshold * table.numSlots)
+		return startRehash (getTargetNumSlots ());
+	
+	return 0;
+}
+
+int HashIndex::openDeleteTuple (Tuple tuple)
+{
+	Hash hashValue;
+	unsigned int numSlots;
+	
+	evalContext -> bind (tuple, UPDATE_ROLE);
+	hashValue = updateHashEval -> eval();
+	
+	if (bRehashing)
+		rehashStep ();
+	
+	if (!deleteEntry (table, tuple, hashValue) &&
+		!(bRehashing && deleteEntry (oldTable, tuple, hashValue))) {
+		
+		// We failed to find this tuple:
+		return -1;
+	}
+	
+	// Too many empty slots: shrink
+	if (!bRehashing &&
+		table.numFull < threshold / 8 * table.numSlots &&
+		(numSlots = getTargetNumSlots ()) < table.numSlots)
+		return startRehash (numSlots);
+	
+	return 0;
+}
+
+//----------------------------------------------------------------------
+// OpenHashIndexIterator
+//----------------------------------------------------------------------
+
+int OpenHashIndexIterator::initialize (Hash _hashValue)
+{
+	hashValue = _hashValue;
+	ctrl = HASH_CTRL (hashValue);
+	
+	startTable (&index -> table);
+	findNext ();
+	
+	return 0;
+}
+
+void OpenHashIndexIterator::startTable (const HashIndex::Table *_table)
+{
+	const unsigned char *groupCtrl;
+	
+	table = _table;
+	group = HASH_GROUP (hashValue) & (index -> getNumGroups (*table) - 1);
+	numProbed = 1;
+	
+	groupCtrl = index -> getCtrl (*table, group * HashIndex::GROUP_SIZE);
+	matches = HashIndex::matchCtrl (groupCtrl, ctrl);
+	bLastGroup = (HashIndex::matchCtrl (groupCtrl,
+										HashIndex::CTRL_EMPTY) != 0);
+}
+
+void OpenHashIndexIterator::findNext ()
+{
+	const unsigned char *groupCtrl;
+	unsigned int numGroups, slot;
+	Tuple tuple;
+	
+	while (true) {
+		
+		// Candidates of the current group
+		for ( ; matches ; matches &= matches - 1) {
+			slot = group * HashIndex::GROUP_SIZE + __builtin_ctz (matches);
+			
+			if (*index -> getHash (*table, slot) != hashValue)
+				continue;
+			
+			tuple = *index -> getTuple (*table, slot);
+			evalContext -> bind (tuple, SCAN_ROLE);
+			
+			// found the tuple
+			if (keyEqual -> eval ()) {
+				matches &= matches - 1;
+				next = tuple;
+				return;
+			}
+		}
+		
+		numGroups = index -> getNumGroups (*table);
+		
+		// End of the probe sequence in this table
+		if (bLastGroup || numProbed == numGroups) {
+			if (table == &index -> table && index -> bRehashing) {
+				startTable (&index -> oldTable);
+				continue;
+			}
+			
+			next = 0;
+			return;
+		}
+		
+		group = (group + numProbed ++) & (numGroups - 1);
+		
+		groupCtrl = index -> getCtrl (*table, group * HashIndex::GROUP_SIZE);
+		matches = HashIndex::matchCtrl (groupCtrl, ctrl);
+		bLastGroup = (HashIndex::matchCtrl (groupCtrl,
+											HashIndex::CTRL_EMPTY) != 0);
+	}
+}
+
 void HashIndex::printDist () const
 {
 	Entry **bucket;
 	Entry *entry;
 	unsigned int count;
 	
+	// Number of full slots per group
+	if (bOpen) {
+		for (unsigned int g = 0 ; g < getNumGroups (table) ; g++) {
+			count = GROUP_SIZE -
+				__builtin_popcount (matchFree (getCtrl (table,
+														g * GROUP_SIZE)));
+			LOG << count << endl;
+		}
+		return;
+	}
+	
 	for (Hash h = 0 ; h < numBuckets ; h++) {
 		bucket = getBucket (h);	
 		
@@ -588,12 +1047,12 @@ void HashIndex::printDist () const
 int HashIndex::getIntProperty (int property, int& val)
 {
 	if (property == Monitor::HINDEX_NUM_BUCKETS) {
-		val = (int)numBuckets;
+		val = (int)(bOpen ? table.numSlots : numBuckets);
 		return 0;
 	}
 	
 	if (property == Monitor::HINDEX_NUM_NONMT_BUCKETS) {
-		val = (int)numNonEmptyBuckets;
+		val = (int)(bOpen ? table.numFull : numNonEmptyBuckets);
 		return 0;
 	}
 	
@@ -12,6 +12,7 @@ AEval::AEval ()
 {
 	numInstrs = 0;
 	roles = 0;
+	bCompiled = true;
 }
 
 AEval::~AEval () {}
@@ -23,10 +24,77 @@ int AEval::addInstr (AInstr instr)
 	if (numInstrs == MAX_INSTRS)
 		return -1;
 
+	// Compile the instruction if we can
+	funcs [numInstrs] = compile (instr);
+	if (!funcs [numInstrs])
+		bCompiled = false;
+	
 	instrs [numInstrs ++] = instr;
 	return 0;
 }
 
+/**
+ * Arithmetic functors
+ */
+struct Add {
+	template <class T> static T apply (T a, T b) { return a + b; }
+};
+
+struct Sub {
+	template <class T> static T apply (T a, T b) { return a - b; }
+};
+
+struct Mul {
+	template <class T> static T apply (T a, T b) { return a * b; }
+};
+
+struct Div {
+	template <class T> static T apply (T a, T b) { return a / b; }
+};
+
+template <class T, class O>
+static void arith (char **roles, const AInstr &instr)
+{
+	((T *)roles [instr.dr]) [instr.dc] =
+		O::apply (((T *)roles [instr.r1]) [instr.c1],
+				  ((T *)roles [instr.r2]) [instr.c2]);
+}
+
+template <class T>
+static void copy (char **roles, const AInstr &instr)
+{
+	((T *)roles [instr.dr]) [instr.dc] = ((T *)roles [instr.r1]) [instr.c1];
+}
+
+static void copyStr (char **roles, const AInstr &instr)
+{
+	charCopy (CLOC(instr.dr, instr.dc), CLOC(instr.r1, instr.c1), instr.len);
+}
+
+/**
+ * Compiled arithmetic and copy instructions, in the order of AOp
+ */
+static const AFunc arithFuncs [] = {
+	arith<int, Add>,   arith<int, Sub>,   arith<int, Mul>,   arith<int, Div>,
+	arith<float, Add>, arith<float, Sub>, arith<float, Mul>, arith<float, Div>,
+	copy<int>,         copy<float>,       copyStr,           copy<char>
+};
+
+/**
+ * @return the compiled function for an instruction, 0 if the
+ * instruction is left to the interpreter (the instructions used by
+ * aggregations)
+ */
+AFunc AEval::compile (const AInstr &instr)
+{
+	ASSERT (sizeof (arithFuncs) / sizeof (AFunc) == BYT_CPY + 1);
+	
+	if (instr.op <= BYT_CPY)
+		return arithFuncs [instr.op];
+	
+	return 0;
+}
+
 int AEval::setEvalContext (EvalContext *evalContext)
 {
 	ASSERT (evalContext);
@@ -35,3 +103,135 @@ int AEval::setEvalContext (EvalContext *evalContext)
 	return 0;
 }
 
+bool AEval::isVectorizable (unsigned int outRole) const
+{
+	for (unsigned int i = 0 ; i < numInstrs ; i++) {
+		if (instrs [i].op > BYT_CPY || instrs [i].dr != outRole)
+			return false;
+	}
+	
+	return true;
+}
+
+/**
+ * Arithmetic in the order of the AOp enumeration.
+ */
+enum Arith { ADD, SUB, MUL, DIV, CPY };
+
+/**
+ * Run an arithmetic (or copy) instruction over a batch of numTuples (<=
+ * VECTOR_SIZE) tuples: gather the operands, compute, and scatter the
+ * results into the output tuples.
+ */
+template <class T>
+static void compute (const AInstr &instr, Arith arith,
+					 const Tuple *inTuples, const Tuple *outTuples,
+					 unsigned int numTuples, unsigned int inRole,
+					 unsigned int outRole, char **roles)
+{
+	T a [VECTOR_SIZE];
+	T b [VECTOR_SIZE];
+	
+	ASSERT (numTuples <= VECTOR_SIZE);
+	
+	gatherColumn (a, ((instr.r1 == inRole)? inTuples :
+					  (instr.r1 == outRole)? outTuples : 0),
+				  roles [instr.r1], instr.c1, numTuples);
+	
+	if (arith != CPY)
+		gatherColumn (b, ((instr.r2 == inRole)? inTuples :
+						  (instr.r2 == outRole)? outTuples : 0),
+					  roles [instr.r2], instr.c2, numTuples);
+	
+	switch (arith) {
+	case ADD:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			a [t] += b [t];
+		break;
+		
+	case SUB:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			a [t] -= b [t];
+		break;
+		
+	case MUL:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			a [t] *= b [t];
+		break;
+		
+	case DIV:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			a [t] /= b [t];
+		break;
+		
+	case CPY:
+		break;
+	}
+	
+	for (unsigned int t = 0 ; t < numTuples ; t++)
+		((T *)outTuples [t]) [instr.dc] = a [t];
+}
+
+void AEval::evalBatch (const Tuple *inTuples, const Tuple *outTuples,
+					   unsigned int numTuples, unsigned int inRole,
+					   unsigned int outRole)
+{
+	unsigned int n;
+	const AInstr *instr;
+	char *src;
+	
+	for (unsigned int b = 0 ; b < numTuples ; b += VECTOR_SIZE) {
+		
+		n = numTuples - b;
+		if (n > VECTOR_SIZE)
+			n = VECTOR_SIZE;
+		
+		for (unsigned int i = 0 ; i < numInstrs ; i++) {
+			instr = instrs + i;
+			
+			switch (instr -> op) {
+			case INT_ADD: case INT_SUB: case INT_MUL: case INT_DIV:
+				compute<int> (*instr, (Arith)(instr -> op - INT_ADD),
+							  inTuples + b, outTuples + b, n, inRole,
+							  outRole, roles);
+				break;
+				
+			case FLT_ADD: case FLT_SUB: case FLT_MUL: case FLT_DIV:
+				compute<float> (*instr, (Arith)(instr -> op - FLT_ADD),
+								inTuples + b, outTuples + b, n, inRole,
+								outRole, roles);
+				break;
+				
+			case INT_CPY:
+				compute<int> (*instr, CPY, inTuples + b, outTuples + b, n,
+							  inRole, outRole, roles);
+				break;
+				
+			case FLT_CPY:
+				compute<float> (*instr, CPY, inTuples + b, outTuples + b,
+								n, inRole, outRole, roles);
+				break;
+				
+			case BYT_CPY:
+				compute<char> (*instr, CPY, inTuples + b, outTuples + b, n,
+							   inRole, outRole, roles);
+				break;
+				
+			case CHR_CPY:
+				for (unsigned int t = b ; t < b + n ; t++) {
+					src = ((instr -> r1 == inRole)? inTuples [t] :
+						   (instr -> r1 == outRole)? outTuples [t] :
+						   roles [instr -> r1]);
+					charCopy (outTuples [t] + instr -> dc, src + instr -> c1,
+							  instr -> len);
+				}
+				break;
+				
+			default:
+				// Not vectorizable
+				ASSERT (0);
+				break;
+			}
+		}
+	}
+}
@@ -13,6 +13,7 @@ BEval::BEval ()
 {
 	numInstrs = 0;
 	roles = 0;
+	bCompiled = true;
 }
 
 BEval::~BEval () {
@@ -52,6 +53,187 @@ int BEval::addInstr (BInstr instr)
 	if (numInstrs == MAX_INSTRS)
 		return -1;
 
+	// Compile the instruction if we can
+	funcs [numInstrs] = compile (instr);
+	if (!funcs [numInstrs])
+		bCompiled = false;
+	
 	instrs [numInstrs ++] = instr;
 	return 0;
 }
+
+/**
+ * Comparison functors
+ */
+struct Lt {
+	template <class T> static bool apply (T a, T b) { return a < b; }
+};
+
+struct Le {
+	template <class T> static bool apply (T a, T b) { return a <= b; }
+};
+
+struct Gt {
+	template <class T> static bool apply (T a, T b) { return a > b; }
+};
+
+struct Ge {
+	template <class T> static bool apply (T a, T b) { return a >= b; }
+};
+
+struct Eq {
+	template <class T> static bool apply (T a, T b) { return a == b; }
+};
+
+struct Ne {
+	template <class T> static bool apply (T a, T b) { return a != b; }
+};
+
+template <class T, class C>
+static bool compare (char **roles, const BInstr &instr)
+{
+	return C::apply (((T *)roles [instr.r1]) [instr.c1],
+					 ((T *)roles [instr.r2]) [instr.c2]);
+}
+
+template <class C>
+static bool compareStr (char **roles, const BInstr &instr)
+{
+	return C::apply (charCompare (CLOC(instr.r1, instr.c1),
+								  CLOC(instr.r2, instr.c2), instr.len), 0);
+}
+
+/**
+ * Compiled comparisons without arithmetic, in the order of BOp
+ */
+static const BFunc compareFuncs [] = {
+	compare<int, Lt>,   compare<int, Le>,   compare<int, Gt>,
+	compare<int, Ge>,   compare<int, Eq>,   compare<int, Ne>,
+	compare<float, Lt>, compare<float, Le>, compare<float, Gt>,
+	compare<float, Ge>, compare<float, Eq>, compare<float, Ne>,
+	compareStr<Lt>,     compareStr<Le>,     compareStr<Gt>,
+	compareStr<Ge>,     compareStr<Eq>,     compareStr<Ne>,
+	compare<char, Lt>,  compare<char, Le>,  compare<char, Gt>,
+	compare<char, Ge>,  compare<char, Eq>,  compare<char, Ne>
+};
+
+/**
+ * @return the compiled function for an instruction, 0 if the
+ * instruction is left to the interpreter (comparisons of arithmetic
+ * expressions)
+ */
+BFunc BEval::compile (const BInstr &instr)
+{
+	ASSERT (sizeof (compareFuncs) / sizeof (BFunc) == BYT_NE + 1);
+	
+	if (instr.op <= BYT_NE)
+		return compareFuncs [instr.op];
+	
+	return 0;
+}
+
+bool BEval::isVectorizable () const
+{
+	for (unsigned int i = 0 ; i < numInstrs ; i++) {
+		if ((instrs [i].op < INT_LT || instrs [i].op > FLT_NE) &&
+			(instrs [i].op < BYT_LT || instrs [i].op > BYT_NE))
+			return false;
+	}
+	
+	return true;
+}
+
+/**
+ * Comparisons in the order of the BOp enumeration.
+ */
+enum Cmp { LT, LE, GT, GE, EQ, NE };
+
+/**
+ * Evaluate a comparison of instr over a batch of numTuples (<=
+ * VECTOR_SIZE) tuples, and-ing the result into sel.  The loops are
+ * simple enough for the compiler to vectorize.
+ */
+template <class T>
+static void filter (const BInstr &instr, Cmp cmp, const Tuple *tuples,
+					unsigned int numTuples, unsigned int role,
+					char **roles, unsigned char *sel)
+{
+	T a [VECTOR_SIZE];
+	T b [VECTOR_SIZE];
+	
+	ASSERT (numTuples <= VECTOR_SIZE);
+	
+	gatherColumn (a, (instr.r1 == role)? tuples : 0, roles [instr.r1],
+				  instr.c1, numTuples);
+	gatherColumn (b, (instr.r2 == role)? tuples : 0, roles [instr.r2],
+				  instr.c2, numTuples);
+	
+	switch (cmp) {
+	case LT:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sel [t] &= (a [t] < b [t]);
+		break;
+		
+	case LE:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sel [t] &= (a [t] <= b [t]);
+		break;
+		
+	case GT:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sel [t] &= (a [t] > b [t]);
+		break;
+		
+	case GE:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sel [t] &= (a [t] >= b [t]);
+		break;
+		
+	case EQ:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sel [t] &= (a [t] == b [t]);
+		break;
+		
+	case NE:
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sel [t] &= (a [t] != b [t]);
+		break;
+	}
+}
+
+void BEval::evalBatch (const Tuple *tuples, unsigned int numTuples,
+					   unsigned int role, unsigned char *sel) const
+{
+	unsigned int n;
+	BOp op;
+	
+	for (unsigned int t = 0 ; t < numTuples ; t++)
+		sel [t] = 1;
+	
+	for (unsigned int b = 0 ; b < numTuples ; b += VECTOR_SIZE) {
+		
+		n = numTuples - b;
+		if (n > VECTOR_SIZE)
+			n = VECTOR_SIZE;
+		
+		for (unsigned int i = 0 ; i < numInstrs ; i++) {
+			op = instrs [i].op;
+			
+			if (op >= INT_LT && op <= INT_NE)
+				filter<int> (instrs [i], (Cmp)(op - INT_LT), tuples + b,
+							 n, role, roles, sel + b);
+			
+			else if (op >= FLT_LT && op <= FLT_NE)
+				filter<float> (instrs [i], (Cmp)(op - FLT_LT), tuples + b,
+							   n, role, roles, sel + b);
+			
+			else if (op >= BYT_LT && op <= BYT_NE)
+				filter<char> (instrs [i], (Cmp)(op - BYT_LT), tuples + b,
+							  n, role, roles, sel + b);
+			
+			// Not vectorizable
+			else
+				ASSERT (0);
+		}
+	}
+}
@@ -0,0 +1,156 @@
+/**
+ * @file       char_ops.cc
+ * @date       Oct. 17, 2026
+ * @brief      Comparison and hashing of CHAR columns
+ */
+
+#ifndef _CHAR_OPS_
+#include "execution/internals/char_ops.h"
+#endif
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#include <nmmintrin.h>
+#define _HW_CRC32C_
+#endif
+
+using namespace Execution;
+
+int Execution::charCompare (const char *s1, const char *s2, unsigned int len)
+{
+	if (len == 0)
+		return strcmp (s1, s2);
+
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128 ();
+	__m128i b1, b2;
+	int stop, i;
+	
+	// Stop at the first byte that differs, or that ends s1
+	while (len >= 16) {
+		b1 = _mm_loadu_si128 ((const __m128i *) s1);
+		b2 = _mm_loadu_si128 ((const __m128i *) s2);
+		
+		stop = (_mm_movemask_epi8 (_mm_cmpeq_epi8 (b1, b2)) ^ 0xffff) |
+			_mm_movemask_epi8 (_mm_cmpeq_epi8 (b1, zero));
+		
+		if (stop) {
+			i = __builtin_ctz (stop);
+			return (int)(unsigned char)s1 [i] - (int)(unsigned char)s2 [i];
+		}
+		
+		s1 += 16;
+		s2 += 16;
+		len -= 16;
+	}
+#endif
+
+	return strncmp (s1, s2, len);
+}
+
+unsigned int Execution::charLength (const char *s, unsigned int len)
+{
+	const char *end;
+	
+	if (len == 0)
+		return strlen (s);
+
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128 ();
+	unsigned int n = 0;
+	int stop;
+	
+	for ( ; n + 16 <= len ; n += 16) {
+		stop = _mm_movemask_epi8
+			(_mm_cmpeq_epi8 (_mm_loadu_si128 ((const __m128i *)(s + n)),
+							 zero));
+		if (stop)
+			return n + __builtin_ctz (stop);
+	}
+	
+	end = (const char *) memchr (s + n, 0, len - n);
+#else
+	end = (const char *) memchr (s, 0, len);
+#endif
+
+	return end ? (end - s) : len;
+}
+
+//----------------------------------------------------------------------
+// CRC32C (Castagnoli polynomial, reflected), without the initial and
+// final inversion: the hash value so far is the initial CRC.
+//----------------------------------------------------------------------
+
+static const Hash CRC32C_POLY = 0x82F63B78;
+
+static Hash crcTable [256];
+
+static Hash crc32cSw (Hash crc, const char *s, unsigned int n)
+{
+	while (n--)
+		crc = crcTable [(crc ^ (unsigned char)*s++) & 0xff] ^ (crc >> 8);
+	return crc;
+}
+
+#ifdef _HW_CRC32C_
+__attribute__ ((target ("sse4.2")))
+static Hash crc32cHw (Hash crc, const char *s, unsigned int n)
+{
+	unsigned int w;
+
+#ifdef __x86_64__
+	unsigned long long d;
+	
+	for ( ; n >= 8 ; s += 8, n -= 8) {
+		memcpy (&d, s, 8);
+		crc = (Hash) _mm_crc32_u64 (crc, d);
+	}
+#endif
+
+	for ( ; n >= 4 ; s += 4, n -= 4) {
+		memcpy (&w, s, 4);
+		crc = _mm_crc32_u32 (crc, w);
+	}
+	
+	while (n--)
+		crc = _mm_crc32_u8 (crc, (unsigned char)*s++);
+	
+	return crc;
+}
+#endif
+
+/// The CRC32C routine for this CPU, set by crc32cInit ()
+static Hash (*crc32c) (Hash, const char *, unsigned int);
+
+/// Makes crc32cInit () run once, before the first hash of any thread
+static pthread_once_t crc32cOnce = PTHREAD_ONCE_INIT;
+
+static void crc32cInit ()
+{
+	Hash c;
+	
+	for (unsigned int b = 0 ; b < 256 ; b++) {
+		c = b;
+		for (int k = 0 ; k < 8 ; k++)
+			c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : (c >> 1);
+		crcTable [b] = c;
+	}
+
+#ifdef _HW_CRC32C_
+	__builtin_cpu_init ();
+	if (__builtin_cpu_supports ("sse4.2"))
+		crc32c = crc32cHw;
+	else
+		crc32c = crc32cSw;
+#else
+	crc32c = crc32cSw;
+#endif
+}
+
+Hash Execution::charHash (const char *s, unsigned int len, Hash hash)
+{
+	pthread_once (&crc32cOnce, crc32cInit);
+	return crc32c (hash, s, charLength (s, len));
+}
@@ -0,0 +1,345 @@
+/**
+ * @file       eval_bench.cc
+ * @date       Oct. 17, 2026
+ * @brief      Microbenchmark of the expression evaluators
+ *
+ * Usage: eval_bench [num-tuples [num-runs]]
+ *
+ * Evaluates a few common predicates, projections and hash functions
+ * over num-tuples (default 1000000) tuples, and reports the best of
+ * num-runs (default 5) runs in ns/tuple for each way of evaluating
+ * them: the interpreter, the compiled instructions, and the batch
+ * evaluator where the expression is vectorizable.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#ifndef _BEVAL_
+#include "execution/internals/beval.h"
+#endif
+
+#ifndef _AEVAL_
+#include "execution/internals/aeval.h"
+#endif
+
+#ifndef _HEVAL_
+#include "execution/internals/heval.h"
+#endif
+
+using namespace Execution;
+
+// Roles, as bound by the operators
+static const unsigned int CONST_ROLE  = 1;
+static const unsigned int INPUT_ROLE  = 2;
+static const unsigned int OUTPUT_ROLE = 3;
+
+// Layout of the input tuples: int A, int B, float F, char S[8]
+static const Column A_COL     = 0;
+static const Column B_COL     = 1;
+static const Column F_COL     = 2;
+static const Column S_COL     = 12;
+static const unsigned int S_LEN     = 8;
+static const unsigned int TUPLE_SIZE = 20;
+
+// Layout of the constant tuple: int 5, int 10, float 0.5
+static const Column C5_COL    = 0;
+static const Column C10_COL   = 1;
+static const Column CHALF_COL = 2;
+
+enum Mode { INTERPRET, COMPILED, BATCH };
+static const char *modeNames [] = { "interpret", "compiled", "batch" };
+
+static unsigned int numTuples;
+static unsigned int numRuns;
+static Tuple *inTuples;
+static Tuple *outTuples;
+static EvalContext evalContext;
+
+static double now ()
+{
+	struct timeval tv;
+	
+	gettimeofday (&tv, 0);
+	return tv.tv_sec * 1e9 + tv.tv_usec * 1e3;
+}
+
+static void report (const char *name, Mode mode, double ns, long check)
+{
+	printf ("%-24s %-10s %8.2f ns/tuple  (%ld)\n", name, modeNames [mode],
+			ns / numTuples, check);
+}
+
+static void benchBEval (const char *name, BEval *eval)
+{
+	unsigned char sel [VECTOR_SIZE];
+	unsigned int n;
+	double start, best;
+	long count = 0;
+	
+	for (int m = INTERPRET ; m <= BATCH ; m++) {
+		if (m == COMPILED && !eval -> isCompiled ())
+			continue;
+		if (m == BATCH && !eval -> isVectorizable ())
+			continue;
+		
+		best = 0;
+		for (unsigned int r = 0 ; r < numRuns ; r++) {
+			count = 0;
+			start = now ();
+			
+			if (m == BATCH) {
+				for (unsigned int t = 0 ; t < numTuples ; t += n) {
+					n = numTuples - t;
+					if (n > VECTOR_SIZE)
+						n = VECTOR_SIZE;
+					
+					eval -> evalBatch (inTuples + t, n, INPUT_ROLE, sel);
+					for (unsigned int s = 0 ; s < n ; s++)
+						count += sel [s];
+				}
+			}
+			else {
+				for (unsigned int t = 0 ; t < numTuples ; t++) {
+					evalContext.bind (inTuples [t], INPUT_ROLE);
+					if (m == INTERPRET)
+						count += eval -> interpret ();
+					else
+						count += eval -> eval ();
+				}
+			}
+			
+			if (r == 0 || now () - start < best)
+				best = now () - start;
+		}
+		
+		report (name, (Mode)m, best, count);
+	}
+}
+
+static void benchAEval (const char *name, AEval *eval)
+{
+	unsigned int n;
+	double start, best;
+	long sum = 0;
+	
+	for (int m = INTERPRET ; m <= BATCH ; m++) {
+		if (m == COMPILED && !eval -> isCompiled ())
+			continue;
+		if (m == BATCH && !eval -> isVectorizable (OUTPUT_ROLE))
+			continue;
+		
+		best = 0;
+		for (unsigned int r = 0 ; r < numRuns ; r++) {
+			start = now ();
+			
+			if (m == BATCH) {
+				for (unsigned int t = 0 ; t < numTuples ; t += n) {
+					n = numTuples - t;
+					if (n > VECTOR_SIZE)
+						n = VECTOR_SIZE;
+					
+					eval -> evalBatch (inTuples + t, outTuples + t, n,
+									   INPUT_ROLE, OUTPUT_ROLE);
+				}
+			}
+			else {
+				for (unsigned int t = 0 ; t < numTuples ; t++) {
+					evalContext.bind (inTuples [t], INPUT_ROLE);
+					evalContext.bind (outTuples [t], OUTPUT_ROLE);
+					if (m == INTERPRET)
+						eval -> interpret ();
+					else
+						eval -> eval ();
+				}
+			}
+			
+			if (r == 0 || now () - start < best)
+				best = now () - start;
+		}
+		
+		sum = 0;
+		for (unsigned int t = 0 ; t < numTuples ; t++)
+			sum += ICOL (outTuples [t], 0);
+		
+		report (name, (Mode)m, best, sum);
+	}
+}
+
+static void benchHEval (const char *name, HEval *eval)
+{
+	double start, best;
+	long sum = 0;
+	
+	for (int m = INTERPRET ; m <= COMPILED ; m++) {
+		if (m == COMPILED && !eval -> isCompiled ())
+			continue;
+		
+		best = 0;
+		for (unsigned int r = 0 ; r < numRuns ; r++) {
+			sum = 0;
+			start = now ();
+			
+			for (unsigned int t = 0 ; t < numTuples ; t++) {
+				evalContext.bind (inTuples [t], INPUT_ROLE);
+				if (m == INTERPRET)
+					sum += eval -> interpret () & 0xff;
+				else
+					sum += eval -> eval () & 0xff;
+			}
+			
+			if (r == 0 || now () - start < best)
+				best = now () - start;
+		}
+		
+		report (name, (Mode)m, best, sum);
+	}
+}
+
+static BInstr compare (BOp op, Column c1, Column c2)
+{
+	BInstr instr;
+	
+	instr.op = op;
+	instr.r1 = INPUT_ROLE;
+	instr.c1 = c1;
+	instr.r2 = CONST_ROLE;
+	instr.c2 = c2;
+	instr.e1 = 0;
+	instr.e2 = 0;
+	
+	return instr;
+}
+
+static AInstr arith (AOp op, Column c1, Column c2, Column dc)
+{
+	AInstr instr;
+	
+	instr.op = op;
+	instr.r1 = INPUT_ROLE;
+	instr.c1 = c1;
+	instr.r2 = INPUT_ROLE;
+	instr.c2 = c2;
+	instr.dr = OUTPUT_ROLE;
+	instr.dc = dc;
+	
+	return instr;
+}
+
+static HInstr hash (Type type, Column c, unsigned int len = 0)
+{
+	HInstr instr;
+	
+	instr.type = type;
+	instr.r = INPUT_ROLE;
+	instr.c = c;
+	instr.len = len;
+	
+	return instr;
+}
+
+int main (int argc, char *argv [])
+{
+	char *inData, *outData;
+	char constTuple [TUPLE_SIZE];
+	BEval gt, range, flt, str;
+	AEval add, cpy;
+	HEval hashA, hashAB, hashS;
+	BInstr strInstr;
+	
+	numTuples = (argc > 1)? atoi (argv [1]) : 1000000;
+	numRuns = (argc > 2)? atoi (argv [2]) : 5;
+	
+	if (numTuples == 0 || numRuns == 0) {
+		fprintf (stderr, "Usage: %s [num-tuples [num-runs]]\n", argv [0]);
+		return 1;
+	}
+	
+	// Input tuples: A uniform in [0, 16), B, F uniform in [0, 1), S
+	inData = (char *) malloc (numTuples * TUPLE_SIZE);
+	outData = (char *) malloc (numTuples * TUPLE_SIZE);
+	inTuples = (Tuple *) malloc (numTuples * sizeof (Tuple));
+	outTuples = (Tuple *) malloc (numTuples * sizeof (Tuple));
+	
+	if (!inData || !outData || !inTuples || !outTuples) {
+		fprintf (stderr, "Out of memory\n");
+		return 1;
+	}
+	
+	srand (1);
+	for (unsigned int t = 0 ; t < numTuples ; t++) {
+		inTuples [t] = inData + t * TUPLE_SIZE;
+		outTuples [t] = outData + t * TUPLE_SIZE;
+		
+		ICOL (inTuples [t], A_COL) = rand () % 16;
+		ICOL (inTuples [t], B_COL) = rand ();
+		FCOL (inTuples [t], F_COL) = (float) rand () / RAND_MAX;
+		strcpy (CCOL (inTuples [t], S_COL), (rand () % 2)? "abc" : "xyz");
+	}
+	
+	ICOL (constTuple, C5_COL) = 5;
+	ICOL (constTuple, C10_COL) = 10;
+	FCOL (constTuple, CHALF_COL) = 0.5;
+	strcpy (CCOL (constTuple, S_COL), "abc");
+	evalContext.bind (constTuple, CONST_ROLE);
+	
+	// A > 5
+	gt.addInstr (compare (INT_GT, A_COL, C5_COL));
+	gt.setEvalContext (&evalContext);
+	benchBEval ("A > 5", &gt);
+	
+	// A > 5 AND A < 10
+	range.addInstr (compare (INT_GT, A_COL, C5_COL));
+	range.addInstr (compare (INT_LT, A_COL, C10_COL));
+	range.setEvalContext (&evalContext);
+	benchBEval ("A > 5 AND A < 10", &range);
+	
+	// F < 0.5
+	flt.addInstr (compare (FLT_LT, F_COL, CHALF_COL));
+	flt.setEvalContext (&evalContext);
+	benchBEval ("F < 0.5", &flt);
+	
+	// S = 'abc'
+	strInstr = compare (CHR_EQ, S_COL, S_COL);
+	strInstr.len = S_LEN;
+	str.addInstr (strInstr);
+	str.setEvalContext (&evalContext);
+	benchBEval ("S = 'abc'", &str);
+	
+	// A + B
+	add.addInstr (arith (INT_ADD, A_COL, B_COL, 0));
+	add.setEvalContext (&evalContext);
+	benchAEval ("A + B", &add);
+	
+	// A, B, F
+	cpy.addInstr (arith (INT_CPY, A_COL, A_COL, 0));
+	cpy.addInstr (arith (INT_CPY, B_COL, B_COL, 1));
+	cpy.addInstr (arith (FLT_CPY, F_COL, F_COL, 2));
+	cpy.setEvalContext (&evalContext);
+	benchAEval ("A, B, F", &cpy);
+	
+	// hash (A)
+	hashA.addInstr (hash (INT, A_COL));
+	hashA.setEvalContext (&evalContext);
+	benchHEval ("hash (A)", &hashA);
+	
+	// hash (A, B)
+	hashAB.addInstr (hash (INT, A_COL));
+	hashAB.addInstr (hash (INT, B_COL));
+	hashAB.setEvalContext (&evalContext);
+	benchHEval ("hash (A, B)", &hashAB);
+	
+	// hash (S)
+	hashS.addInstr (hash (CHAR, S_COL, S_LEN));
+	hashS.setEvalContext (&evalContext);
+	benchHEval ("hash (S)", &hashS);
+	
+	free (inData);
+	free (outData);
+	free (inTuples);
+	free (outTuples);
+	
+	return 0;
+}
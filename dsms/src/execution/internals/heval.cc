@@ -8,6 +8,7 @@ HEval::HEval ()
 {
 	roles = 0;
 	numInstrs = 0;
+	bCompiled = true;
 }
 
 HEval::~HEval () {}
@@ -27,6 +28,49 @@ int HEval::addInstr (HInstr instr)
 	if (numInstrs == MAX_INSTRS)
 		return -1;
 	
+	// Compile the instruction if we can
+	funcs [numInstrs] = compile (instr);
+	if (!funcs [numInstrs])
+		bCompiled = false;
+	
 	instrs [numInstrs ++] = instr;
 	return 0;
 }
+
+static Hash hashInt (char **roles, const HInstr &instr, Hash hash)
+{
+	return HEval::combine (hash, ILOC(instr.r, instr.c));
+}
+
+static Hash hashByte (char **roles, const HInstr &instr, Hash hash)
+{
+	return HEval::combine (hash, (unsigned char) BLOC(instr.r, instr.c));
+}
+
+static Hash hashChar (char **roles, const HInstr &instr, Hash hash)
+{
+	return charHash (CLOC (instr.r, instr.c), instr.len, hash);
+}
+
+static Hash hashFloat (char **roles, const HInstr &instr, Hash hash)
+{
+	return HEval::combine (hash, HEval::floatBits (FLOC(instr.r, instr.c)));
+}
+
+/**
+ * @return the compiled function for an instruction, 0 if the
+ * instruction is left to the interpreter
+ */
+HFunc HEval::compile (const HInstr &instr)
+{
+	switch (instr.type) {
+	case INT:   return hashInt;
+	case BYTE:  return hashByte;
+	case CHAR:  return hashChar;
+	case FLOAT: return hashFloat;
+	default:
+		break;
+	}
+	
+	return 0;
+}
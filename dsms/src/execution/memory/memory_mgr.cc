@@ -4,7 +4,10 @@
  * @brief       System wide memory manager
  */
 
+#include <cstdio>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 
 #ifndef _MEMORY_MGR_
 #include "execution/memory/memory_mgr.h"
@@ -14,25 +17,48 @@ using namespace Execution;
 using namespace std;
 
 #define NEXT(page) (*((char **)(page)))
-#define PAGENUM(page) ((page - memory) >> LOG_PAGE_SIZE)
+#define PAGENUM(page) (getId (page) >> (LOG_PAGE_SIZE - LOG_ID_ALIGN))
+
+/// Memory policy for mbind: prefer the node, but fall back to others
+/// if it is full
+static const int MPOL_PREFERRED_ = 1;
 
 MemoryManager::MemoryManager (unsigned int _id, ostream& _LOG)
 	: LOG (_LOG)
 {
 	this -> id = _id;
-	this -> memory = 0;
+	this -> numArenas = 0;
+	this -> maxArenas = 0;
 	this -> memorySize = 0;
-	this -> numPages = 0;
-	this -> emptyPageList = 0;
+	this -> maxMemorySize = 0;
+	this -> bHugePages = false;
+	this -> bNuma = false;
+	this -> numNodes = 1;
+	this -> numCaches = 0;
+	
+	for (unsigned int n = 0 ; n < MAX_NODES ; n++) {
+		nodes [n].emptyPageList = 0;
+		nodes [n].nextPage = 0;
+		nodes [n].arenaEnd = 0;
+		nodes [n].nextArena = 0;
+	}
+	
+	pthread_mutex_init (&mutex, 0);
+	pthread_key_create (&cacheKey, destroyCache);
 }
 
 MemoryManager::~MemoryManager () {
-	if (memory) {
-		free (memory);
-	}
+	// The other threads have released their caches when they exited
+	free (pthread_getspecific (cacheKey));
+	pthread_key_delete (cacheKey);
+	
+	for (unsigned int a = 0 ; a < numArenas ; a++)
+		munmap (arenas [a], ARENA_SIZE);
+	
+	pthread_mutex_destroy (&mutex);
 }
 
-int MemoryManager::setMemorySize (unsigned int memorySize)
+int MemoryManager::setMemorySize (unsigned long long int memorySize)
 {
 	ASSERT (memorySize > 0);
 	
@@ -40,60 +66,110 @@ int MemoryManager::setMemorySize (unsigned int memorySize)
 	return 0;
 }
 
+int MemoryManager::setMaxMemorySize (unsigned long long int maxMemorySize)
+{
+	this -> maxMemorySize = maxMemorySize;
+	return 0;
+}
+
+int MemoryManager::setHugePages (bool bHugePages)
+{
+	this -> bHugePages = bHugePages;
+	return 0;
+}
+
+int MemoryManager::setNuma (bool bNuma)
+{
+	this -> bNuma = bNuma;
+	return 0;
+}
+
 /**
- * Allocate memory, set page size, compute number pages, and initialize
- * the array used to maintain reference counts.  We set the page size to
- * the system define PAGESIZE - there seems to be no particular rationale
- * for this.
+ * Map the arenas for the initial memory size, spread over the NUMA
+ * nodes.  The nodes present in the system are the ones listed in sysfs.
  */
 int MemoryManager::initialize ()
-{	
-	// conservatively round memorySize to be multiples of PAGE_SIZE, which
-	// simplifies the management for us.
-	numPages = (memorySize + PAGE_SIZE) / PAGE_SIZE;
-	memorySize = numPages * PAGE_SIZE;
-	memory = (char *)malloc (numPages * PAGE_SIZE);
-	
-	if (!memory) {
-		LOG << "Memory Manager: unable to allocate memory" << endl;
+{
+	char path [64];
+	unsigned int numInitArenas;
+	
+	numNodes = 1;
+	if (bNuma) {
+		for (numNodes = 0 ; numNodes < MAX_NODES ; numNodes++) {
+			sprintf (path, "/sys/devices/system/node/node%u", numNodes);
+			if (access (path, F_OK) != 0)
+				break;
+		}
 		
-		numPages  = 0;
+		if (numNodes == 0)
+			numNodes = 1;
+	}
+	
+	numInitArenas = (unsigned int)((memorySize + ARENA_SIZE - 1) /
+								   ARENA_SIZE);
+	if (numInitArenas < numNodes)
+		numInitArenas = numNodes;
+	
+	if (numInitArenas > MAX_ARENAS) {
+		LOG << "Memory Manager: memory size too large" << endl;
 		return -1;
 	}
 	
-	// Add all pages to the empty pages linked list
-	char *page = memory;
-	for (unsigned int p = 0 ; p < numPages - 1 ; p++, page += PAGE_SIZE)	
-		NEXT(page) = page + PAGE_SIZE;	
-	NEXT (page) = 0;
+	maxArenas = MAX_ARENAS;
+	if (maxMemorySize > 0 && maxMemorySize / ARENA_SIZE < MAX_ARENAS)
+		maxArenas = (unsigned int)(maxMemorySize / ARENA_SIZE);
+	if (maxArenas < numInitArenas)
+		maxArenas = numInitArenas;
+	
+	for (unsigned int a = 0 ; a < numInitArenas ; a++) {
+		if (addArena (a % numNodes) != 0) {
+			LOG << "Memory Manager: unable to allocate memory" << endl;
+			return -1;
+		}
+	}
 	
-	LOG << "Memory Manager: started with " << numPages 
-		<< " pages of size " << PAGE_SIZE << endl;
+	LOG << "Memory Manager: started with " << numArenas
+		<< " arenas of " << (ARENA_SIZE / PAGE_SIZE)
+		<< " pages of size " << PAGE_SIZE
+		<< " on " << numNodes << " nodes" << endl;
 	
-	emptyPageList = memory;
-
 	return 0;
 }
 
-
 /**
- * Allocate a new page. 
+ * Allocate a new page.
  *
- * The new page is picked from the beginning of empty pages linked list. 
+ * The new page is picked from the beginning of the page cache of this
+ * thread, which we refill if it is empty.
  */ 
 int MemoryManager::allocatePage (char *&page)
-{	
-	// We do not have any more pages.
-	if (emptyPageList == 0) {
+{
+	PageCache *cache;
+	
+	if ((cache = getCache ()) == 0) {
+		LOG << "Memory Manager: unable to allocate page cache" << endl;
+		return -1;
+	}
+	
+	if (cache -> pages) {
+		cache -> numHits ++;
+	}
+	
+	else if (refillCache (cache) != 0) {
 		LOG << "Memory Manager: out of memory" << endl;		
 		return -1;
 	}
 	
-	// first page in the empty pages list
-	page = emptyPageList;
-		
-	// Update the empty pages list.
-	emptyPageList = NEXT(emptyPageList);
+	page = cache -> pages;
+	cache -> pages = NEXT(page);
+	cache -> numPages --;
+	owner (page) = cache -> id;
+	
+	if (++ cache -> numEvents == CACHE_REPORT) {
+		pthread_mutex_lock (&mutex);
+		reportCache (cache);
+		pthread_mutex_unlock (&mutex);
+	}
 	
 #ifdef _DM_
 	//LOG << "Memory Manager: Allocated page " << PAGENUM(page) << endl;
@@ -105,17 +181,301 @@ int MemoryManager::allocatePage (char *&page)
 /**
  * Deallocate a page
  * 
- * The deallocated page is inserted at the beginning of the empty pages
- * list
+ * The deallocated page is inserted at the beginning of the page cache of
+ * this thread.  If the cache holds too many pages, we return some to the
+ * shared lists.
  */ 
 int MemoryManager::deallocatePage (char *page)
-{	
-	NEXT(page) = emptyPageList;
-	emptyPageList = page;
-
+{
+	PageCache *cache;
+	
+	ASSERT (page == getPage (page));
+	
+	if ((cache = getCache ()) == 0) {
+		LOG << "Memory Manager: unable to allocate page cache" << endl;
+		return -1;
+	}
+	
+	if (owner (page) != cache -> id)
+		cache -> numRemoteFrees ++;
+	
+	NEXT(page) = cache -> pages;
+	cache -> pages = page;
+	cache -> numPages ++;
+	
+	if (cache -> numPages >= 2 * CACHE_BATCH)
+		releaseCache (cache, CACHE_BATCH);
+	
+	if (++ cache -> numEvents == CACHE_REPORT) {
+		pthread_mutex_lock (&mutex);
+		reportCache (cache);
+		pthread_mutex_unlock (&mutex);
+	}
+	
 #ifdef _DM_
 	//LOG << "Memory Manager: Deallocated page " << PAGENUM(page) << endl;
 #endif
 	
 	return 0;
 }
+
+/**
+ * @return the page cache of this thread, created on first use
+ */
+MemoryManager::PageCache *MemoryManager::getCache ()
+{
+	PageCache *cache;
+	
+	if ((cache = (PageCache *)pthread_getspecific (cacheKey)) != 0)
+		return cache;
+	
+	if ((cache = (PageCache *)malloc (sizeof (PageCache))) == 0)
+		return 0;
+	
+	cache -> memMgr = this;
+	cache -> pages = 0;
+	cache -> numPages = 0;
+	cache -> numHits = 0;
+	cache -> numRefills = 0;
+	cache -> numRemoteFrees = 0;
+	cache -> numEvents = 0;
+	
+	// Owner ids are reused after 255 caches, which only makes the count
+	// of remote frees approximate
+	pthread_mutex_lock (&mutex);
+	cache -> id = (unsigned char)(numCaches ++ % 255 + 1);
+	pthread_mutex_unlock (&mutex);
+	
+	pthread_setspecific (cacheKey, cache);
+	
+	return cache;
+}
+
+/**
+ * Move up to CACHE_BATCH pages from the shared lists into an empty page
+ * cache.  Pages are taken from the node of the cpu we are running on.
+ * If the node has no pages left, we map a new arena for it, or take
+ * pages from another node if we cannot.
+ */
+int MemoryManager::refillCache (PageCache *cache)
+{
+	unsigned int node, i;
+	char *page;
+	
+	ASSERT (cache -> numPages == 0);
+	
+	pthread_mutex_lock (&mutex);
+	
+	node = getNode ();
+	
+	while (cache -> numPages < CACHE_BATCH) {
+		for (i = 0 ; i < numNodes ; i++) {
+			if (getNodePage (nodes + (node + i) % numNodes, page) ||
+				(i == 0 && addArena (node) == 0 &&
+				 getNodePage (nodes + node, page)))
+				break;
+		}
+		
+		// We do not have any more pages.
+		if (i == numNodes)
+			break;
+		
+		NEXT(page) = cache -> pages;
+		cache -> pages = page;
+		cache -> numPages ++;
+	}
+	
+	cache -> numRefills ++;
+	reportCache (cache);
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return (cache -> numPages > 0) ? 0 : -1;
+}
+
+/**
+ * Return pages from a page cache to the empty pages lists of the nodes
+ * of their arenas.
+ */
+void MemoryManager::releaseCache (PageCache *cache, unsigned int numPages)
+{
+	char *page;
+	Node *n;
+	
+	ASSERT (numPages <= cache -> numPages);
+	
+	pthread_mutex_lock (&mutex);
+	
+	for (unsigned int p = 0 ; p < numPages ; p++) {
+		page = cache -> pages;
+		cache -> pages = NEXT(page);
+		cache -> numPages --;
+		
+		n = nodes + getHeader (page) -> node;
+		NEXT(page) = n -> emptyPageList;
+		n -> emptyPageList = page;
+	}
+	
+	reportCache (cache);
+	
+	pthread_mutex_unlock (&mutex);
+}
+
+/**
+ * Report the events counted by a page cache to the monitor.  Called with
+ * the lock held.
+ */
+void MemoryManager::reportCache (PageCache *cache)
+{
+#ifdef _MONITOR_
+	logCache (cache -> numHits, cache -> numRefills,
+			  cache -> numRemoteFrees);
+#endif
+	
+	cache -> numHits = 0;
+	cache -> numRefills = 0;
+	cache -> numRemoteFrees = 0;
+	cache -> numEvents = 0;
+}
+
+/**
+ * Release the page cache of a thread when it exits.
+ */
+void MemoryManager::destroyCache (void *arg)
+{
+	PageCache *cache = (PageCache *)arg;
+	
+	cache -> memMgr -> releaseCache (cache, cache -> numPages);
+	free (cache);
+}
+
+/**
+ * Get a page of a node: the first page in its empty pages linked list,
+ * or else the next page of its arenas that was never allocated.
+ *
+ * @return false if the node has no pages left
+ */
+bool MemoryManager::getNodePage (Node *n, char *&page)
+{
+	unsigned int a;
+	
+	if (n -> emptyPageList) {
+		page = n -> emptyPageList;
+		n -> emptyPageList = NEXT(n -> emptyPageList);
+		return true;
+	}
+	
+	if (n -> nextPage == n -> arenaEnd) {
+		for (a = n -> nextArena ; a < numArenas ; a++)
+			if (nodes + ((ArenaHeader *)arenas [a]) -> node == n)
+				break;
+		
+		if (a == numArenas)
+			return false;
+		
+		// The first pages hold the header
+		n -> nextPage = arenas [a] + HEADER_PAGES * PAGE_SIZE;
+		n -> arenaEnd = arenas [a] + ARENA_SIZE;
+		n -> nextArena = a + 1;
+	}
+	
+	page = n -> nextPage;
+	n -> nextPage += PAGE_SIZE;
+	
+	return true;
+}
+
+/**
+ * Map a new arena, bound to a NUMA node.
+ */
+int MemoryManager::addArena (unsigned int node)
+{
+	char *arena;
+	unsigned long mask;
+	
+	ASSERT (node < numNodes);
+	
+	if (numArenas == maxArenas)
+		return -1;
+	
+	if ((arena = mapArena ()) == 0)
+		return -1;
+	
+	if (bNuma && numNodes > 1) {
+		mask = (1UL << node);
+		syscall (SYS_mbind, arena, ARENA_SIZE, MPOL_PREFERRED_, &mask,
+				 sizeof (mask) * 8, 0);
+	}
+	
+	getHeader (arena) -> index = numArenas;
+	getHeader (arena) -> node = node;
+	arenas [numArenas ++] = arena;
+	
+	if (numArenas > 1) {
+		LOG << "Memory Manager: added arena " << numArenas - 1
+			<< " on node " << node << endl;
+	}
+	
+	return 0;
+}
+
+/**
+ * Map ARENA_SIZE bytes aligned to ARENA_SIZE: we map twice as much, and
+ * unmap what is not aligned.
+ *
+ * @return the arena, 0 if the system has no memory to give
+ */
+char *MemoryManager::mapArena ()
+{
+	char *region, *arena;
+	int flags;
+	
+	flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	
+	// Huge pages must be reserved: otherwise we would fault when we touch
+	// the memory, rather than fail here
+	region = (char *)MAP_FAILED;
+#ifdef MAP_HUGETLB
+	if (bHugePages)
+		region = (char *)mmap (0, 2 * ARENA_SIZE, PROT_READ | PROT_WRITE,
+							   flags | MAP_HUGETLB, -1, 0);
+#endif
+
+	if (region == (char *)MAP_FAILED) {
+		region = (char *)mmap (0, 2 * ARENA_SIZE, PROT_READ | PROT_WRITE,
+							   flags | MAP_NORESERVE, -1, 0);
+		
+		if (region == (char *)MAP_FAILED)
+			return 0;
+
+#ifdef MADV_HUGEPAGE
+		// No reserved huge pages: ask for transparent ones
+		if (bHugePages)
+			madvise (region, 2 * ARENA_SIZE, MADV_HUGEPAGE);
+#endif
+	}
+	
+	arena = getArena (region + ARENA_SIZE - 1);
+	if (arena > region)
+		munmap (region, arena - region);
+	if (arena + ARENA_SIZE < region + 2 * ARENA_SIZE)
+		munmap (arena + ARENA_SIZE, region + ARENA_SIZE - arena);
+	
+	return arena;
+}
+
+/**
+ * @return the NUMA node of the cpu we are running on
+ */
+unsigned int MemoryManager::getNode () const
+{
+	unsigned int cpu, node;
+	
+	if (!bNuma || numNodes == 1)
+		return 0;
+	
+	if (syscall (SYS_getcpu, &cpu, &node, 0) != 0)
+		return 0;
+	
+	return node % numNodes;
+}
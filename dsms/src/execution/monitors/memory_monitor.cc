@@ -0,0 +1,29 @@
+#ifndef _MEMORY_MONITOR_
+#include "execution/monitors/memory_monitor.h"
+#endif
+
+#ifndef _PROPERTY_
+#include "execution/monitors/property.h"
+#endif
+
+using namespace Monitor;
+
+int MemoryMonitor::getIntProperty (int property, int &val) {
+	
+	if (property == MEM_CACHE_HITS) {
+		val = numCacheHits;
+		return 0;
+	}
+	
+	if (property == MEM_CACHE_REFILLS) {
+		val = numCacheRefills;
+		return 0;
+	}
+	
+	if (property == MEM_REMOTE_FREES) {
+		val = numRemoteFrees;
+		return 0;
+	}
+	
+	return PropertyMonitor::getIntProperty (property, val);
+}
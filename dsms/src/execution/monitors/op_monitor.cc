@@ -18,6 +18,7 @@ OperatorMonitor::OperatorMonitor ()
 	outTs = 0;
 	numJoined = 0;
 	numInput = 0;
+	numPairs = 0.0;
 }
 OperatorMonitor::~OperatorMonitor () {}
 
@@ -45,6 +46,11 @@ int OperatorMonitor::getDoubleProperty (int property, double &val)
 		return 0;
 	}
 	
+	if (property == JOIN_NPAIRS) {
+		val = numPairs;
+		return 0;
+	}
+	
 	return PropertyMonitor::getDoubleProperty (property, val);		
 }
 
@@ -55,7 +61,7 @@ int OperatorMonitor::getIntProperty (int property, int &val)
 		return 0;
 	}
 	
-	if (property == JOIN_NINPUT) {
+	if (property == JOIN_NINPUT || property == SOURCE_NUM_TUPLES) {
 		val = numInput;
 		return 0;
 	}
@@ -0,0 +1,94 @@
+/**
+ * @file       trace_buffer.cc
+ * @date       Oct. 17, 2026
+ * @brief      Ring buffer of operator trace events
+ */
+
+#ifndef _TRACE_BUFFER_
+#include "execution/monitors/trace_buffer.h"
+#endif
+
+#ifdef _TRACE_
+
+using namespace Monitor;
+
+/// A traced event.  seq is the number of the event, written last: a
+/// reader that finds seq changed while it copied the record raced with
+/// a writer
+struct TraceRecord {
+	volatile unsigned long long int seq;
+	TraceEvent                      event;
+	unsigned int                    opId;
+	Timestamp                       ts;
+	long long int                   arg;
+};
+
+static const unsigned long long int NO_SEQ = ~0ULL;
+
+static TraceRecord records [TRACE_BUFFER_SIZE];
+
+/// Number of events recorded so far
+static unsigned long long int numEvents = 0;
+
+static const char *eventNames [] = {
+	"WIN_INPUT",
+	"WIN_SLIDE",
+	"WIN_EXPIRE",
+	"STALL",
+	"PANE_EXPIRE"
+};
+
+void TraceBuffer::record (TraceEvent event, unsigned int opId,
+						  Timestamp ts, long long arg)
+{
+	unsigned long long int seq;
+	TraceRecord *rec;
+	
+	seq = __sync_fetch_and_add (&numEvents, 1ULL);
+	rec = records + (seq & (TRACE_BUFFER_SIZE - 1));
+	
+	rec -> seq   = NO_SEQ;
+	__sync_synchronize ();
+	
+	rec -> event = event;
+	rec -> opId  = opId;
+	rec -> ts    = ts;
+	rec -> arg   = arg;
+	
+	__sync_synchronize ();
+	rec -> seq   = seq;
+}
+
+void TraceBuffer::dump (std::ostream &out)
+{
+	unsigned long long int end, seq;
+	TraceRecord rec;
+	
+	end = __sync_fetch_and_add (&numEvents, 0ULL);
+	seq = (end > TRACE_BUFFER_SIZE)? end - TRACE_BUFFER_SIZE : 0;
+	
+	out << "Trace: " << end << " events" << std::endl;
+	
+	for ( ; seq < end ; seq++) {
+		const TraceRecord &slot = records [seq & (TRACE_BUFFER_SIZE - 1)];
+		
+		if (slot.seq != seq)
+			continue;
+		
+		rec.event = slot.event;
+		rec.opId  = slot.opId;
+		rec.ts    = slot.ts;
+		rec.arg   = slot.arg;
+		
+		__sync_synchronize ();
+		if (slot.seq != seq)
+			continue;
+		
+		out << seq << ": op " << rec.opId
+			<< " " << eventNames [rec.event]
+			<< " ts " << rec.ts
+			<< " " << rec.arg << std::endl;
+	}
+}
+
+#endif
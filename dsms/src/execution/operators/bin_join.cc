@@ -6,6 +6,12 @@
 #include "common/debug.h"
 #endif
 
+#ifdef _MONITOR_
+#ifndef _PROPERTY_
+#include "execution/monitors/property.h"
+#endif
+#endif
+
 #define MIN(a,b) (((a) < (b))? (a) : (b))
 
 #define LOCK_OUT_TUPLE(t) (outStore -> addRef ((t)))
@@ -17,6 +23,19 @@
 using namespace Execution;
 using namespace std;
 
+#ifdef _MONITOR_
+/// Number of tuples of a synopsis that an input tuple is joined with
+static int synSize (RelationSynopsis *synopsis)
+{
+	int numTuples;
+	
+	if (synopsis -> getIntProperty (Monitor::SYN_NUM_TUPLES, numTuples) != 0)
+		return 0;
+	
+	return numTuples;
+}
+#endif
+
 BinaryJoin::BinaryJoin (unsigned int id, ostream &_LOG)
 	: LOG (_LOG)
 {
@@ -37,9 +56,60 @@ BinaryJoin::BinaryJoin (unsigned int id, ostream &_LOG)
 	this -> lastOutputTs = 0;
 	this -> bStalled = false;
 	this -> scanWhenStalled = 0;
+	this -> numPartitions = 0;
+	this -> partitions = 0;
+	this -> outerHash = 0;
+	this -> innerHash = 0;
+	this -> batch = 0;
+	this -> batchLen = 0;
+	this -> maxBatchLen = 0;
+	this -> nextElem = 0;
+	this -> bMerging = false;
+	this -> batchNo = 0;
+	this -> numDone = 0;
+	this -> bWorkers = false;
+	this -> bQuit = false;
+	
+	pthread_mutex_init (&mutex, 0);
+	pthread_cond_init (&startCond, 0);
+	pthread_cond_init (&doneCond, 0);
 }
 
 BinaryJoin::~BinaryJoin () {
+	if (bWorkers) {
+		pthread_mutex_lock (&mutex);
+		bQuit = true;
+		pthread_cond_broadcast (&startCond);
+		pthread_mutex_unlock (&mutex);
+		
+		for (unsigned int p = 1 ; p < numPartitions ; p++)
+			pthread_join (partitions [p].thread, 0);
+	}
+	
+	for (unsigned int p = 0 ; p < numPartitions ; p++) {
+		if (partitions [p].evalContext)
+			delete partitions [p].evalContext;
+		if (partitions [p].outerFilter)
+			delete partitions [p].outerFilter;
+		if (partitions [p].innerFilter)
+			delete partitions [p].innerFilter;
+		if (partitions [p].matches)
+			delete [] partitions [p].matches;
+	}
+	
+	if (partitions)
+		delete [] partitions;
+	if (outerHash)
+		delete outerHash;
+	if (innerHash)
+		delete innerHash;
+	if (batch)
+		delete [] batch;
+	
+	pthread_mutex_destroy (&mutex);
+	pthread_cond_destroy (&startCond);
+	pthread_cond_destroy (&doneCond);
+	
 	if (evalContext)
 		delete evalContext;
 	if (outputConstructor)
@@ -144,6 +214,65 @@ int BinaryJoin::setOutputConstructor (AEval *outputConstructor)
 	return 0;
 }
 
+int BinaryJoin::setPartitions (unsigned int numPartitions,
+							   HEval *outerHash, HEval *innerHash)
+{
+	ASSERT (numPartitions > 0 && numPartitions <= MAX_PARTITIONS);
+	ASSERT (outerHash);
+	ASSERT (innerHash);
+	
+	this -> numPartitions = numPartitions;
+	this -> outerHash = outerHash;
+	this -> innerHash = innerHash;
+	
+	partitions = new Partition [numPartitions];
+	
+	for (unsigned int p = 0 ; p < numPartitions ; p++) {
+		partitions [p].join = this;
+		partitions [p].partitionId = p;
+		partitions [p].evalContext = 0;
+		partitions [p].outerIndex = 0;
+		partitions [p].innerIndex = 0;
+		partitions [p].outerFilter = 0;
+		partitions [p].innerFilter = 0;
+		partitions [p].matches = 0;
+		partitions [p].numMatches = 0;
+		partitions [p].maxMatches = 0;
+		partitions [p].nextMatch = 0;
+		partitions [p].rc = 0;
+	}
+	
+	return 0;
+}
+
+int BinaryJoin::setPartition (unsigned int partitionId,
+							  EvalContext *evalContext,
+							  Index *outerIndex, Index *innerIndex,
+							  BEval *outerPred, BEval *innerPred)
+{
+	Partition *partition;
+	
+	ASSERT (partitionId < numPartitions);
+	ASSERT (evalContext);
+	ASSERT (outerIndex);
+	ASSERT (innerIndex);
+	
+	partition = partitions + partitionId;
+	
+	partition -> evalContext = evalContext;
+	partition -> outerIndex = outerIndex;
+	partition -> innerIndex = innerIndex;
+	
+	if (outerPred)
+		partition -> outerFilter = new FilterIterator (evalContext,
+													   outerPred);
+	if (innerPred)
+		partition -> innerFilter = new FilterIterator (evalContext,
+													   innerPred);
+	
+	return 0;
+}
+
 int BinaryJoin::run (TimeSlice timeSlice)
 {
 	int rc;
@@ -152,6 +281,9 @@ int BinaryJoin::run (TimeSlice timeSlice)
 	Element outerPeekElement, innerPeekElement;
 	Element outerElement, innerElement;
 	
+	if (numPartitions > 0)
+		return runPartitioned (timeSlice);
+	
 #ifdef _MONITOR_
 	startTimer ();
 #endif
@@ -365,6 +497,7 @@ int BinaryJoin::processOuterPlus (Element outerElement)
 
 #ifdef _MONITOR_
 	logInput ();
+	logPairs (synSize (innerSynopsis));
 #endif
 	
 	// Iterator that scans the inner
@@ -556,6 +689,7 @@ int BinaryJoin::processInnerPlus (Element innerElement)
 
 #ifdef _MONITOR_
 	logInput ();
+	logPairs (synSize (outerSynopsis));
 #endif
 	
 	// Iterator that scans the outer
@@ -1070,3 +1204,510 @@ int BinaryJoin::clearStall()
 
 	return -1;
 }
+
+/**
+ * run () of a partitioned join.  We first produce the rest of the output
+ * of the previous batch, if we could not before.  We then dequeue a new
+ * batch, in the order in which run () would process the elements, probe
+ * the partitions, and produce the output of the batch.
+ */
+int BinaryJoin::runPartitioned (TimeSlice timeSlice)
+{
+	int rc;
+	Timestamp outerMinTs, innerMinTs;
+	Element outerPeekElement, innerPeekElement;
+	Element element;
+	bool bOuter;
+	
+#ifdef _MONITOR_
+	startTimer ();
+#endif
+	
+	if (bMerging) {
+		
+		if ((rc = produceBatchOutput ()) != 0)
+			return rc;
+		
+		// Output queue still full
+		if (bMerging) {
+			
+#ifdef _MONITOR_
+			stopTimer ();
+			logOutTs (lastOutputTs);
+#endif
+			
+			return 0;
+		}
+	}
+	
+	// Minimum timestamp possible on the next outer & inner element
+	outerMinTs = lastOuterTs;
+	innerMinTs = lastInnerTs;
+	
+	if (maxBatchLen < timeSlice) {
+		if (batch)
+			delete [] batch;
+		
+		maxBatchLen = timeSlice;
+		batch = new BatchElement [maxBatchLen];
+	}
+	
+	batchLen = 0;
+	while (batchLen < timeSlice) {
+		
+		if (outerInputQueue -> peek (outerPeekElement))
+			outerMinTs = outerPeekElement.timestamp;
+		
+		if (innerInputQueue -> peek (innerPeekElement))
+			innerMinTs = innerPeekElement.timestamp;
+		
+		if (outerMinTs < innerMinTs) {
+			if (!outerInputQueue -> dequeue (element))
+				break;
+			bOuter = true;
+		}
+		
+		else if (innerMinTs < outerMinTs) {
+			if (!innerInputQueue -> dequeue (element))
+				break;
+			bOuter = false;
+		}
+		
+		else if (outerInputQueue -> dequeue (element)) {
+			bOuter = true;
+		}
+		
+		else if (innerInputQueue -> dequeue (element)) {
+			bOuter = false;
+		}
+		
+		else {
+			// both queues are empty
+			break;
+		}
+		
+		if (bOuter)
+			lastOuterTs = element.timestamp;
+		else
+			lastInnerTs = element.timestamp;
+		
+		if ((rc = addToBatch (element, bOuter)) != 0)
+			return rc;
+	}
+	
+	if (batchLen > 0) {
+		
+		if ((rc = probeBatch ()) != 0)
+			return rc;
+		
+		nextElem = 0;
+		bMerging = true;
+		
+		if ((rc = produceBatchOutput ()) != 0)
+			return rc;
+	}
+	
+	// Heartbeat generation
+	if (!bMerging && !outputQueue -> isFull() &&
+		(lastOutputTs < innerMinTs) && (lastOutputTs < outerMinTs)) {
+		
+		lastOutputTs = MIN (outerMinTs, innerMinTs);
+		
+		outputQueue -> enqueue (Element::Heartbeat (lastOutputTs));
+	}
+	
+#ifdef _MONITOR_
+	stopTimer ();
+	logOutTs (lastOutputTs);
+#endif
+	
+	return 0;
+}
+
+/**
+ * Append an element to the batch, and pick its partition.  The tuple of
+ * a PLUS element enters the synopsis of its input right away: the
+ * synopses have no indexes in a partitioned join, and only keep the
+ * tuples in the store.
+ */
+int BinaryJoin::addToBatch (Element element, bool bOuter)
+{
+	int rc;
+	BatchElement *batchElement;
+	Hash hash;
+	
+	batchElement = batch + batchLen++;
+	batchElement -> element = element;
+	batchElement -> bOuter = bOuter;
+	
+	// Heartbeats require no processing
+	if (element.kind == E_HEARTBEAT) {
+		batchElement -> partition = numPartitions;
+		return 0;
+	}
+	
+#ifdef _MONITOR_
+	if (element.kind == E_PLUS) {
+		logInput ();
+		logPairs (synSize (bOuter? innerSynopsis : outerSynopsis));
+	}
+#endif
+	
+	if (bOuter) {
+		evalContext -> bind (element.tuple, OUTER_ROLE);
+		hash = outerHash -> eval ();
+		
+		if (element.kind == E_PLUS) {
+			if ((rc = outerSynopsis -> insertTuple (element.tuple)) != 0)
+				return rc;
+		}
+	}
+	
+	else {
+		evalContext -> bind (element.tuple, INNER_ROLE);
+		hash = innerHash -> eval ();
+		
+		if (element.kind == E_PLUS) {
+			if ((rc = innerSynopsis -> insertTuple (element.tuple)) != 0)
+				return rc;
+		}
+	}
+	
+	// The high bits of the hash: the indexes use the low bits
+	batchElement -> partition = ((hash >> 16) * numPartitions) >> 16;
+	
+	return 0;
+}
+
+/**
+ * Probe all the partitions for the elements of the batch: partition 0
+ * in this thread, and the others in their own threads, which we start
+ * with the first batch.
+ */
+int BinaryJoin::probeBatch ()
+{
+	int rc;
+	
+	for (unsigned int p = 0 ; p < numPartitions ; p++) {
+		partitions [p].numMatches = 0;
+		partitions [p].nextMatch = 0;
+		partitions [p].rc = 0;
+	}
+	
+	if (numPartitions > 1) {
+		
+		if (!bWorkers) {
+			for (unsigned int p = 1 ; p < numPartitions ; p++) {
+				if (pthread_create (&partitions [p].thread, 0, worker,
+									partitions + p) != 0) {
+					LOG << "BinaryJoin: unable to create thread" << endl;
+					return -1;
+				}
+			}
+			bWorkers = true;
+		}
+		
+		pthread_mutex_lock (&mutex);
+		numDone = 0;
+		batchNo ++;
+		pthread_cond_broadcast (&startCond);
+		pthread_mutex_unlock (&mutex);
+	}
+	
+	rc = probePartition (partitions);
+	
+	if (numPartitions > 1) {
+		pthread_mutex_lock (&mutex);
+		while (numDone < numPartitions - 1)
+			pthread_cond_wait (&doneCond, &mutex);
+		pthread_mutex_unlock (&mutex);
+	}
+	
+	if (rc != 0)
+		return rc;
+	
+	for (unsigned int p = 1 ; p < numPartitions ; p++)
+		if (partitions [p].rc != 0)
+			return partitions [p].rc;
+	
+	return 0;
+}
+
+/**
+ * Thread probing a partition for each batch, until the operator is
+ * destroyed.
+ */
+void *BinaryJoin::worker (void *arg)
+{
+	Partition *partition;
+	BinaryJoin *join;
+	unsigned int batchNo;
+	
+	partition = (Partition *)arg;
+	join = partition -> join;
+	batchNo = 0;
+	
+	pthread_mutex_lock (&join -> mutex);
+	
+	while (true) {
+		while (!join -> bQuit && join -> batchNo == batchNo)
+			pthread_cond_wait (&join -> startCond, &join -> mutex);
+		
+		if (join -> bQuit)
+			break;
+		
+		batchNo = join -> batchNo;
+		pthread_mutex_unlock (&join -> mutex);
+		
+		partition -> rc = join -> probePartition (partition);
+		
+		pthread_mutex_lock (&join -> mutex);
+		if (++ join -> numDone == join -> numPartitions - 1)
+			pthread_cond_signal (&join -> doneCond);
+	}
+	
+	pthread_mutex_unlock (&join -> mutex);
+	
+	return 0;
+}
+
+/**
+ * Process the elements of the batch in a partition, in batch order: an
+ * element updates the index of its input, and scans the index of the
+ * other input for the tuples it joins with, as in processOuterPlus etc.
+ */
+int BinaryJoin::probePartition (Partition *partition)
+{
+	int rc;
+	EvalContext    *context;
+	BatchElement   *batchElement;
+	Index          *updateIndex, *scanIndex;
+	FilterIterator *filter;
+	TupleIterator  *indexScan, *scan;
+	Tuple           tuple;
+	
+	context = partition -> evalContext;
+	
+	for (unsigned int e = 0 ; e < batchLen ; e++) {
+		batchElement = batch + e;
+		
+		if (batchElement -> partition != partition -> partitionId)
+			continue;
+		
+		tuple = batchElement -> element.tuple;
+		
+		if (batchElement -> bOuter) {
+			context -> bind (tuple, OUTER_ROLE);
+			updateIndex = partition -> outerIndex;
+			scanIndex = partition -> innerIndex;
+			filter = partition -> innerFilter;
+		}
+		
+		else {
+			context -> bind (tuple, INNER_ROLE);
+			updateIndex = partition -> innerIndex;
+			scanIndex = partition -> outerIndex;
+			filter = partition -> outerFilter;
+		}
+		
+		if (batchElement -> element.kind == E_PLUS)
+			rc = updateIndex -> insertTuple (tuple);
+		else
+			rc = updateIndex -> deleteTuple (tuple);
+		if (rc != 0) return rc;
+		
+		if ((rc = scanIndex -> getScan (indexScan)) != 0)
+			return rc;
+		
+		if (filter) {
+			if ((rc = filter -> initialize (indexScan)) != 0)
+				return rc;
+			scan = filter;
+		}
+		else {
+			scan = indexScan;
+		}
+		
+		while (scan -> getNext (tuple)) {
+			if ((rc = addMatch (partition, e, tuple)) != 0)
+				return rc;
+		}
+		
+		if ((rc = scanIndex -> releaseScan (indexScan)) != 0)
+			return rc;
+	}
+	
+	return 0;
+}
+
+int BinaryJoin::addMatch (Partition *partition, unsigned int elem,
+						  Tuple tuple)
+{
+	Match *matches;
+	
+	if (partition -> numMatches == partition -> maxMatches) {
+		matches = new Match [2 * partition -> maxMatches + 64];
+		
+		for (unsigned int m = 0 ; m < partition -> numMatches ; m++)
+			matches [m] = partition -> matches [m];
+		
+		if (partition -> matches)
+			delete [] partition -> matches;
+		
+		partition -> matches = matches;
+		partition -> maxMatches = 2 * partition -> maxMatches + 64;
+	}
+	
+	partition -> matches [partition -> numMatches].elem = elem;
+	partition -> matches [partition -> numMatches].tuple = tuple;
+	partition -> numMatches ++;
+	
+	return 0;
+}
+
+/**
+ * Produce the output of the batch, element by element, from the matches
+ * found by the partitions.  If the output queue fills up, we continue
+ * from where we stopped in the next run.
+ */
+int BinaryJoin::produceBatchOutput ()
+{
+	int rc;
+	BatchElement *batchElement;
+	Partition    *partition;
+	Match        *match;
+	
+	ASSERT (bMerging);
+	
+	while (nextElem < batchLen) {
+		batchElement = batch + nextElem;
+		
+		if (batchElement -> partition < numPartitions) {
+			partition = partitions + batchElement -> partition;
+			
+			while (partition -> nextMatch < partition -> numMatches) {
+				match = partition -> matches + partition -> nextMatch;
+				
+				if (match -> elem != nextElem)
+					break;
+				
+				if (outputQueue -> isFull())
+					return 0;
+				
+				if ((rc = produceOutput (batchElement, match -> tuple)) != 0)
+					return rc;
+				
+				partition -> nextMatch ++;
+			}
+		}
+		
+		if ((rc = finishElement (batchElement)) != 0)
+			return rc;
+		
+		nextElem ++;
+	}
+	
+	bMerging = false;
+	return 0;
+}
+
+/**
+ * Output the join of the tuple of an element of the batch with a tuple
+ * of the other input: a PLUS element for a PLUS element and a MINUS
+ * element for a MINUS element, as in processOuterPlus etc.
+ */
+int BinaryJoin::produceOutput (BatchElement *batchElement, Tuple match)
+{
+	int rc;
+	Tuple outerTuple, innerTuple, outputTuple;
+	Element outputElement;
+	
+	if (batchElement -> bOuter) {
+		outerTuple = batchElement -> element.tuple;
+		innerTuple = match;
+	}
+	else {
+		outerTuple = match;
+		innerTuple = batchElement -> element.tuple;
+	}
+	
+	lineage [0] = outerTuple;
+	lineage [1] = innerTuple;
+	
+	if (batchElement -> element.kind == E_MINUS && joinSynopsis) {
+		
+		rc = joinSynopsis -> getTuple (lineage, outputTuple);
+		if (rc != 0) return rc;
+		
+		rc = joinSynopsis -> deleteTuple (outputTuple);
+		if (rc != 0) return rc;
+	}
+	
+	else {
+		
+		// allocate space for the output tuple
+		if ((rc = outStore -> newTuple (outputTuple)) != 0)
+			return rc;
+		
+		// construct the output tuple
+		evalContext -> bind (outerTuple, OUTER_ROLE);
+		evalContext -> bind (innerTuple, INNER_ROLE);
+		evalContext -> bind (outputTuple, OUTPUT_ROLE);
+		outputConstructor -> eval ();
+		
+		if (batchElement -> element.kind == E_PLUS && joinSynopsis) {
+			rc = joinSynopsis -> insertTuple (outputTuple, lineage);
+			if (rc != 0) return rc;
+			
+			LOCK_OUT_TUPLE (outputTuple);
+		}
+	}
+	
+	outputElement.kind = batchElement -> element.kind;
+	outputElement.tuple = outputTuple;
+	outputElement.timestamp = batchElement -> element.timestamp;
+	
+	outputQueue -> enqueue (outputElement);
+	lastOutputTs = outputElement.timestamp;
+	
+#ifdef _MONITOR_
+	if (outputElement.kind == E_PLUS)
+		logJoin ();
+#endif
+	
+	return 0;
+}
+
+/**
+ * All the output of an element of the batch has been produced: the tuple
+ * of a MINUS element can leave the synopsis of its input, and be
+ * discarded.
+ */
+int BinaryJoin::finishElement (BatchElement *batchElement)
+{
+	int rc;
+	Tuple tuple;
+	
+	if (batchElement -> element.kind != E_MINUS)
+		return 0;
+	
+	tuple = batchElement -> element.tuple;
+	
+	if (batchElement -> bOuter) {
+		if ((rc = outerSynopsis -> deleteTuple (tuple)) != 0)
+			return rc;
+		
+		UNLOCK_OUTER_TUPLE (tuple);
+		UNLOCK_OUTER_TUPLE (tuple);
+	}
+	
+	else {
+		if ((rc = innerSynopsis -> deleteTuple (tuple)) != 0)
+			return rc;
+		
+		UNLOCK_INNER_TUPLE (tuple);
+		UNLOCK_INNER_TUPLE (tuple);
+	}
+	
+	return 0;
+}
@@ -12,6 +12,12 @@
 #include "execution/operators/bin_str_join.h"
 #endif
 
+#ifdef _MONITOR_
+#ifndef _PROPERTY_
+#include "execution/monitors/property.h"
+#endif
+#endif
+
 #define MIN(a,b) (((a) < (b))? (a) : (b))
 
 #define LOCK_INNER_TUPLE(t) (innerInStore -> addRef ((t)))
@@ -24,6 +30,20 @@
 
 using namespace Execution;
 using namespace std;
+
+#ifdef _MONITOR_
+/// Number of tuples of a synopsis that an input tuple is joined with
+static int synSize (RelationSynopsis *synopsis)
+{
+	int numTuples;
+	
+	if (synopsis -> getIntProperty (Monitor::SYN_NUM_TUPLES, numTuples) != 0)
+		return 0;
+	
+	return numTuples;
+}
+#endif
+
 BinStreamJoin::BinStreamJoin(unsigned int id, std::ostream &_LOG)
 	: LOG (_LOG)
 {
@@ -44,6 +64,8 @@ BinStreamJoin::BinStreamJoin(unsigned int id, std::ostream &_LOG)
 	
 	this -> bStalled                = false;
 	this -> innerScanWhenStalled    = 0;
+	this -> numOuter                = 0;
+	this -> nextOuter               = 0;
 }
 
 BinStreamJoin::~BinStreamJoin()
@@ -193,13 +215,18 @@ int BinStreamJoin::run(TimeSlice timeSlice)
 				if (outerElement.kind == E_HEARTBEAT)
 					continue;
 				
-				// We might stall inside processOuter, in which case
-				// bStalled is set.  Note that the for loop terminates in
-				// that case.
-				if ((rc = processOuter (outerElement)) != 0)
-					return rc;
+				// Recall: outer is a stream
+				ASSERT (outerElement.kind == E_PLUS);
 				
-				UNLOCK_OUTER_TUPLE (outerElement.tuple);
+				outerBatch [numOuter++] = outerElement;
+				
+				// We might stall inside processOuterBatch, in which
+				// case bStalled is set.  Note that the for loop
+				// terminates in that case.
+				if (numOuter == PROBE_BATCH_SIZE) {
+					if ((rc = processOuterBatch ()) != 0)
+						return rc;
+				}
 			}
 			
 			// If outer does not have an element, I cannot do any
@@ -211,6 +238,16 @@ int BinStreamJoin::run(TimeSlice timeSlice)
 		
 		else {
 			
+			// The outer elements before this inner element have to be
+			// joined with the inner synopsis as it is now
+			if (nextOuter < numOuter) {
+				if ((rc = processOuterBatch ()) != 0)
+					return rc;
+				
+				if (bStalled)
+					break;
+			}
+			
 			// If inner has an element, then I know that all future
 			// elements of outer have a timestamp at least as much as that
 			// of this (next inner) element.  
@@ -236,6 +273,11 @@ int BinStreamJoin::run(TimeSlice timeSlice)
 		}
 	}
 	
+	if (!bStalled && nextOuter < numOuter) {
+		if ((rc = processOuterBatch ()) != 0)
+			return rc;
+	}
+	
 	// Heartbeat generation
 	if (!outputQueue -> isFull() && (lastOutputTs < innerMinTs) &&
 		(lastOutputTs < outerMinTs)) {
@@ -279,82 +321,136 @@ int BinStreamJoin::processInner (Element innerElement)
 	return 0;
 }
 
-int BinStreamJoin::processOuter (Element outerElement)
+/**
+ * Join the outer elements of the batch, from nextOuter on, with the
+ * inner synopsis, until we are done or we stall.
+ */
+int BinStreamJoin::processOuterBatch ()
 {
 	int rc;
 	TupleIterator *innerScan;
-	Tuple joinTuple;
-	Tuple outputTuple;
-	Element outputElement;
-
-#ifdef _MONITOR_
-	logInput ();
-#endif
+	Element *outerElement;
 	
 	ASSERT (!bStalled && !innerScanWhenStalled);
 	
-	// Recall: outer is a stream
-	ASSERT (outerElement.kind == E_PLUS);
-	
-	evalContext -> bind (outerElement.tuple, OUTER_ROLE); 
-	
-	if ((rc = innerSynopsis -> getScan (scanId, innerScan)) != 0)
-		return rc;
+	// Hash the scans of all the tuples first, prefetching what they
+	// read
+	for (unsigned int o = nextOuter ; o < numOuter ; o++) {
+		evalContext -> bind (outerBatch [o].tuple, OUTER_ROLE);
+		
+		if ((rc = innerSynopsis -> prefetchScan (scanId, scanHints [o])) != 0)
+			return rc;
+	}
 	
-	while (!outputQueue -> isFull() && innerScan -> getNext (joinTuple)) {
+	for ( ; nextOuter < numOuter ; nextOuter++) {
+		outerElement = outerBatch + nextOuter;
 		
-		if ((rc = outStore -> newTuple (outputTuple)) != 0)
+#ifdef _MONITOR_
+		logInput ();
+		logPairs (synSize (innerSynopsis));
+#endif
+		
+		evalContext -> bind (outerElement -> tuple, OUTER_ROLE);
+		
+		rc = innerSynopsis -> getScan (scanId, scanHints [nextOuter],
+									   innerScan);
+		if (rc != 0) return rc;
+		
+		if ((rc = produceOutput (innerScan, outerElement -> timestamp)) != 0)
 			return rc;
 		
-		evalContext -> bind (joinTuple, INNER_ROLE);
-		evalContext -> bind (outputTuple, OUTPUT_ROLE);
-		outputConstructor -> eval();
+		// We stalled: It is possible that innerScan is also over, in
+		// which case we are strictly not stalled, but we will discover
+		// that late any way ...
+		if (outputQueue -> isFull()) {
+			bStalled = true;
+			innerScanWhenStalled = innerScan;
+			
+			return 0;
+		}
 		
-		outputElement.kind      = E_PLUS;
-		outputElement.tuple     = outputTuple;
-		outputElement.timestamp = outerElement.timestamp;
+		if ((rc = innerSynopsis -> releaseScan (scanId, innerScan)) != 0)
+			return rc;
 		
-		outputQueue -> enqueue (outputElement);
-		lastOutputTs = outputElement.timestamp;
-
-#ifdef _MONITOR_
-		logJoin ();
-#endif
-
+		UNLOCK_OUTER_TUPLE (outerElement -> tuple);
 	}
 	
-	// We stalled: It is possible that innerScan is also over, in which
-	// case we are strictly not stalled, but we will discover that late
-	// any way ...
-	if (outputQueue -> isFull()) {
-		bStalled = true;
-		innerScanWhenStalled = innerScan;
-		stallTuple = outerElement.tuple;
-		
-		LOCK_OUTER_TUPLE (stallTuple);
-	}
+	numOuter = nextOuter = 0;
 	
-	else {
+	return 0;
+}
+
+int BinStreamJoin::clearStall ()
+{
+	int rc;
+	TupleIterator *innerScan;
+	Element *outerElement;
+	
+	ASSERT (bStalled);
+	ASSERT (innerScanWhenStalled);	
+	ASSERT (nextOuter < numOuter);
+	
+	innerScan = innerScanWhenStalled;
+	outerElement = outerBatch + nextOuter;
+	
+	evalContext -> bind (outerElement -> tuple, OUTER_ROLE);
+	if ((rc = produceOutput (innerScan, outerElement -> timestamp)) != 0)
+		return rc;
+	
+	// We cleared the stall
+	if (!outputQueue -> isFull()) {
+		bStalled = false;
+		innerScanWhenStalled = 0;
+		
 		if ((rc = innerSynopsis -> releaseScan (scanId, innerScan)) != 0)
 			return rc;
+		
+		UNLOCK_OUTER_TUPLE (outerElement -> tuple);
+		nextOuter ++;
+		
+		// The rest of the batch
+		return processOuterBatch ();
 	}
 	
 	return 0;
 }
 
-int BinStreamJoin::clearStall ()
+/**
+ * Join the current outer tuple (bound in evalContext) with the inner
+ * tuples returned by innerScan, until the scan is over or the output
+ * queue is full.  The output elements are enqueued in batches.
+ */
+int BinStreamJoin::produceOutput (TupleIterator *innerScan, Timestamp ts)
 {
 	int rc;
-	TupleIterator *innerScan;
 	Tuple joinTuple;
 	Tuple outputTuple;
-	Element outputElement;
+	unsigned int numFree;
+	unsigned int numOutput;
 	
-	ASSERT (bStalled);
-	ASSERT (innerScanWhenStalled);	
+	numFree = 0;
+	numOutput = 0;
 	
-	innerScan = innerScanWhenStalled;	
-	while (!outputQueue -> isFull () && innerScan -> getNext (joinTuple)) {
+	while (true) {
+		
+		// Enqueue the batch so far, and find out how many more elements
+		// the output queue can take
+		if (numFree == 0) {
+			if (numOutput > 0) {
+				outputQueue -> enqueueBatch (outputBatch, numOutput);
+				numOutput = 0;
+			}
+			
+			numFree = outputQueue -> getFreeSpace ();
+			if (numFree == 0)
+				break;
+			
+			if (numFree > Queue::BATCH_SIZE)
+				numFree = Queue::BATCH_SIZE;
+		}
+		
+		if (!innerScan -> getNext (joinTuple))
+			break;
 		
 		if ((rc = outStore -> newTuple (outputTuple)) != 0)
 			return rc;
@@ -363,29 +459,17 @@ int BinStreamJoin::clearStall ()
 		evalContext -> bind (outputTuple, OUTPUT_ROLE);
 		outputConstructor -> eval();
 		
-		outputElement.kind      = E_PLUS;
-		outputElement.tuple     = outputTuple;
-		outputElement.timestamp = lastOuterTs;
+		outputBatch [numOutput++] = Element (E_PLUS, outputTuple, ts);
+		numFree--;
+		lastOutputTs = ts;
 		
-		outputQueue -> enqueue (outputElement);
-		lastOutputTs = lastOuterTs;
-
 #ifdef _MONITOR_
 		logJoin ();
 #endif
-		
 	}
 	
-	// We cleared the stall
-	if (!outputQueue -> isFull()) {
-		bStalled = false;
-		innerScanWhenStalled = 0;
-		
-		if ((rc = innerSynopsis -> releaseScan (scanId, innerScan)) != 0)
-			return rc;
-		
-		UNLOCK_OUTER_TUPLE (stallTuple);
-	}
+	if (numOutput > 0)
+		outputQueue -> enqueueBatch (outputBatch, numOutput);
 	
 	return 0;
 }
@@ -223,7 +223,16 @@ int Dstream::run (TimeSlice timeSlice)
 			UNLOCK_INPUT_TUPLE (inputElement.tuple);
 		}
 	}
-
+	
+	// Heartbeat generation: Assert to the operator above that we won't
+	// produce any element with timestamp < lastInputTs.  (A stalled
+	// operator still has elements with timestamp curTs to produce.)
+	if (!bStalled && !outputQueue -> isFull() &&
+		(lastInputTs > lastOutputTs)) {
+		outputQueue -> enqueue (Element::Heartbeat(lastInputTs));
+		lastOutputTs = lastInputTs;
+	}
+	
 #ifdef _MONITOR_
 	stopTimer ();
 	logOutTs (lastOutputTs);
@@ -12,13 +12,19 @@
 #include "execution/operators/group_aggr.h"
 #endif
 
+#ifndef _TRACE_BUFFER_
+#include "execution/monitors/trace_buffer.h"
+#endif
+
 #define LOCK_OUTPUT_TUPLE(t)   (outStore -> addRef ((t)))
 #define LOCK_INPUT_TUPLE(t)    (inStore -> addRef ((t)))
 #define UNLOCK_OUTPUT_TUPLE(t) (outStore -> decrRef ((t)))
 #define UNLOCK_INPUT_TUPLE(t)  (inStore -> decrRef ((t)))
+#define GROUP(t)               (((char **)(t)) [groupCol])
 
 
 using namespace Execution;
+using namespace Monitor;
 
 GroupAggr::GroupAggr (unsigned int id, std::ostream &_LOG)
 	: LOG (_LOG)
@@ -28,6 +34,16 @@ GroupAggr::GroupAggr (unsigned int id, std::ostream &_LOG)
 	this -> outputQueue         = 0;
 	this -> inputSynopsis       = 0;
 	this -> outputSynopsis      = 0;
+	this -> minMaxSynopsis      = 0;
+	this -> paneSynopsis        = 0;
+	this -> windowSize          = 0;
+	this -> slideSize           = 0;
+	this -> windowStart         = 0;
+	this -> firstPane           = 0;
+	this -> bExpiring           = false;
+	this -> expireGroup         = 0;
+	this -> bPending            = false;
+	this -> groupCol            = 0;
 	this -> outStore            = 0;
 	this -> inStore             = 0;
 	this -> evalContext         = 0;
@@ -58,6 +74,10 @@ GroupAggr::~GroupAggr ()
 		delete initEval;
 	if (emptyGroupEval)
 		delete emptyGroupEval;	
+	if (minMaxSynopsis)
+		delete minMaxSynopsis;
+	if (paneSynopsis)
+		delete paneSynopsis;
 }
 
 int GroupAggr::setInputQueue (Queue *inputQueue)
@@ -150,6 +170,31 @@ int GroupAggr::setRescanEvaluator (BEval *eval)
 	return 0;
 }
 
+int GroupAggr::setMinMaxSynopsis (MinMaxSynopsis *synopsis,
+								  Column groupCol)
+{
+	ASSERT (synopsis);
+	
+	this -> minMaxSynopsis = synopsis;
+	this -> groupCol = groupCol;
+	return 0;
+}
+
+int GroupAggr::setPaneSynopsis (PaneSynopsis *synopsis,
+								Column groupCol,
+								unsigned int windowSize,
+								unsigned int slideSize)
+{
+	ASSERT (synopsis);
+	ASSERT (slideSize > 0 && slideSize <= windowSize);
+	
+	this -> paneSynopsis = synopsis;
+	this -> groupCol = groupCol;
+	this -> windowSize = windowSize;
+	this -> slideSize = slideSize;
+	return 0;
+}
+
 int GroupAggr::setEvalContext (EvalContext *evalContext)
 {
 	ASSERT (evalContext);
@@ -183,8 +228,23 @@ int GroupAggr::run (TimeSlice timeSlice)
 		bStalled = false;
 	}
 	
+	// Continue updating the groups with expired panes, and then process
+	// the element that made them expire.
+	if (bExpiring) {
+		if ((rc = expirePanes ()) != 0)
+			return rc;
+	}
+	
+	if (bPending && !bExpiring && !bStalled && !outputQueue -> isFull()) {
+		bPending = false;
+		
+		if ((rc = processElement (pendingElement)) != 0)
+			return rc;
+	}
+	
 	numElements = timeSlice;
-	for (unsigned int e = 0 ; (e < numElements) && !bStalled ; e++) {
+	for (unsigned int e = 0 ; (e < numElements) && !bStalled && !bPending ;
+		 e++) {
 		
 		// No space in output queue -- no scope for any processing
 		if (outputQueue -> isFull())
@@ -196,22 +256,18 @@ int GroupAggr::run (TimeSlice timeSlice)
 		
 		lastInputTs = inputElement.timestamp;
 		
-		// Heartbeats can be ignored
-		if (inputElement.kind == E_HEARTBEAT)
-			continue;
-		
-		if (inputElement.kind == E_PLUS) {
-			rc = processPlus (inputElement);
-			if (rc != 0) return rc;
-		}
-		
-		else {
-			ASSERT (inputElement.kind == E_MINUS);
-			rc = processMinus (inputElement);
-			if (rc != 0) return rc;
+		// The window slides: the element is processed after the groups
+		// are updated, possibly in a later run.
+		if (paneSynopsis) {
+			if ((rc = advanceWindow (inputElement)) != 0)
+				return rc;
+			
+			if (bPending)
+				break;
 		}
 		
-		UNLOCK_INPUT_TUPLE (inputElement.tuple);
+		if ((rc = processElement (inputElement)) != 0)
+			return rc;
 	}
 	
 	// process heartbeats
@@ -228,6 +284,30 @@ int GroupAggr::run (TimeSlice timeSlice)
 	return 0;
 }
 
+int GroupAggr::processElement (Element inputElement)
+{
+	int rc;
+	
+	// Heartbeats can be ignored
+	if (inputElement.kind == E_HEARTBEAT)
+		return 0;
+	
+	if (inputElement.kind == E_PLUS) {
+		rc = processPlus (inputElement);
+		if (rc != 0) return rc;
+	}
+	
+	else {
+		ASSERT (inputElement.kind == E_MINUS);
+		rc = processMinus (inputElement);
+		if (rc != 0) return rc;
+	}
+	
+	UNLOCK_INPUT_TUPLE (inputElement.tuple);
+	
+	return 0;
+}
+
 int GroupAggr::processPlus (Element inputElement)
 {
 	int rc;
@@ -276,6 +356,27 @@ int GroupAggr::processPlus (Element inputElement)
 		evalContext -> bind (newAggrTuple, NEW_OUTPUT_ROLE);
 		plusEval -> eval ();
 		
+		if (minMaxSynopsis) {
+			GROUP (newAggrTuple) = GROUP (oldAggrTuple);
+			
+			rc = minMaxSynopsis -> insertTuple (GROUP (newAggrTuple),
+												inpTuple);
+			if (rc != 0) return rc;
+		}
+		
+		if (paneSynopsis) {
+			GROUP (newAggrTuple) = GROUP (oldAggrTuple);
+			
+			rc = paneSynopsis -> insertTuple (GROUP (newAggrTuple),
+											  inputElement.timestamp /
+											  slideSize,
+											  inpTuple);
+			if (rc != 0) return rc;
+			
+			paneSynopsis -> setAggrTuple (GROUP (newAggrTuple),
+										  newAggrTuple);
+		}
+		
 		// We insert the new aggr. tuple into the synopsis & delete the
 		// old one 
 		rc = outputSynopsis -> insertTuple (newAggrTuple);
@@ -320,6 +421,29 @@ int GroupAggr::processPlus (Element inputElement)
 		evalContext -> bind (newAggrTuple, NEW_OUTPUT_ROLE);
 		initEval -> eval ();
 		
+		if (minMaxSynopsis) {
+			rc = minMaxSynopsis -> newGroup (GROUP (newAggrTuple));
+			if (rc != 0) return rc;
+			
+			rc = minMaxSynopsis -> insertTuple (GROUP (newAggrTuple),
+												inpTuple);
+			if (rc != 0) return rc;
+		}
+		
+		if (paneSynopsis) {
+			rc = paneSynopsis -> newGroup (GROUP (newAggrTuple));
+			if (rc != 0) return rc;
+			
+			rc = paneSynopsis -> insertTuple (GROUP (newAggrTuple),
+											  inputElement.timestamp /
+											  slideSize,
+											  inpTuple);
+			if (rc != 0) return rc;
+			
+			paneSynopsis -> setAggrTuple (GROUP (newAggrTuple),
+										  newAggrTuple);
+		}
+		
 		// Insert the new aggregation tuple into the synopsis
 		rc = outputSynopsis -> insertTuple (newAggrTuple);
 		if (rc != 0) return rc;
@@ -401,6 +525,11 @@ int GroupAggr::processMinus (Element inputElement)
 	// misnomer) checks if there is only one element in this group.		
 	if (emptyGroupEval -> eval()) {
 		
+		if (minMaxSynopsis) {
+			rc = minMaxSynopsis -> deleteGroup (GROUP (oldAggrTuple));
+			if (rc != 0) return rc;
+		}
+		
 		// delete the old aggregation tuple from our synopsis
 		rc = outputSynopsis -> deleteTuple (oldAggrTuple);
 		if (rc != 0) return rc;
@@ -427,7 +556,8 @@ int GroupAggr::processMinus (Element inputElement)
 		if (rc != 0) return rc;
 		
 		// Produce the new aggr. tuple for the group.
-		rc = produceOutputTupleForMinus (newAggrTuple);
+		rc = produceOutputTupleForMinus (inpTuple, oldAggrTuple,
+										 newAggrTuple);
 		if (rc != 0) return rc;
 		
 		// Insert the new aggr. tuple into the output synopsis and delete
@@ -468,7 +598,9 @@ int GroupAggr::processMinus (Element inputElement)
 	return 0;
 }
 
-int GroupAggr::produceOutputTupleForMinus (Tuple newAggrTuple)
+int GroupAggr::produceOutputTupleForMinus (Tuple inpTuple,
+										   Tuple oldAggrTuple,
+										   Tuple newAggrTuple)
 {
 	int rc;
 	TupleIterator *inScan;
@@ -477,6 +609,21 @@ int GroupAggr::produceOutputTupleForMinus (Tuple newAggrTuple)
 	
 	evalContext -> bind (newAggrTuple, NEW_OUTPUT_ROLE);
 	
+	// The MAX & MIN aggregates are maintained by minMaxSynopsis: the
+	// remaining aggregates are always incremental.
+	if (minMaxSynopsis) {
+		minusEval -> eval ();
+		
+		GROUP (newAggrTuple) = GROUP (oldAggrTuple);
+		
+		rc = minMaxSynopsis -> deleteTuple (GROUP (newAggrTuple),
+											inpTuple);
+		if (rc != 0) return rc;
+		
+		return minMaxSynopsis -> copyExtremes (GROUP (newAggrTuple),
+											   newAggrTuple);
+	}
+	
 	// Assert: At this point, evalContext contains the new input tuple
 	// (MINUS) and the old aggr. tuple for the input tuples group bound.
 	
@@ -519,3 +666,137 @@ int GroupAggr::produceOutputTupleForMinus (Tuple newAggrTuple)
 	return 0;
 }
 	
+
+/**
+ * Slide the window, as RangeWindow does, if the element is past its
+ * end.  The panes before the new start of the window expire, and we
+ * start updating the groups that have tuples in them.
+ */
+int GroupAggr::advanceWindow (Element inputElement)
+{
+	int rc;
+	
+	ASSERT (paneSynopsis);
+	ASSERT (!bExpiring && !bPending);
+	
+	if (inputElement.timestamp < windowStart + windowSize)
+		return 0;
+	
+	// most often a single slide suffices, but we may have to jump
+	windowStart += slideSize;
+	if (inputElement.timestamp >= windowStart + windowSize)
+		windowStart = (inputElement.timestamp / slideSize) * slideSize;
+	
+	firstPane = windowStart / slideSize;
+	
+	TRACE (TR_WIN_SLIDE, id, lastInputTs, windowStart);
+	
+	bExpiring = true;
+	expireGroup = paneSynopsis -> getFirstGroup ();
+	
+	if ((rc = expirePanes ()) != 0)
+		return rc;
+	
+	if (bExpiring || bStalled || outputQueue -> isFull()) {
+		bPending = true;
+		pendingElement = inputElement;
+	}
+	
+	return 0;
+}
+
+/**
+ * Update the groups with panes that expired: each such group gets a new
+ * aggr. tuple computed from its remaining panes, or disappears if it
+ * has none left.  We stop when the output queue fills up, and continue
+ * in the next run.
+ */
+int GroupAggr::expirePanes ()
+{
+	int rc;
+	char          *group;
+	Tuple          oldAggrTuple;
+	Tuple          newAggrTuple;
+	bool           bEmpty;
+	Element        plusElement, minusElement;
+	
+	ASSERT (bExpiring);
+	
+	while (expireGroup && !bStalled) {
+		
+		// Each group needs up to two slots in the output queue
+		if (outputQueue -> isFull())
+			return 0;
+		
+		group = expireGroup;
+		expireGroup = paneSynopsis -> getNextGroup (group);
+		
+		if (!paneSynopsis -> hasExpiredPanes (group, firstPane))
+			continue;
+		
+		oldAggrTuple = paneSynopsis -> getAggrTuple (group);
+		
+		rc = paneSynopsis -> expirePanes (group, firstPane, bEmpty);
+		if (rc != 0) return rc;
+		
+		TRACE (TR_PANE_EXPIRE, id, lastInputTs, bEmpty);
+		
+		// The group no longer exists
+		if (bEmpty) {
+			rc = paneSynopsis -> deleteGroup (group);
+			if (rc != 0) return rc;
+			
+			rc = outputSynopsis -> deleteTuple (oldAggrTuple);
+			if (rc != 0) return rc;
+			
+			minusElement.kind      = E_MINUS;
+			minusElement.tuple     = oldAggrTuple;
+			minusElement.timestamp = lastInputTs;
+			
+			outputQueue -> enqueue (minusElement);
+			lastOutputTs = lastInputTs;
+			
+			continue;
+		}
+		
+		rc = outStore -> newTuple (newAggrTuple);
+		if (rc != 0) return rc;
+		
+		rc = paneSynopsis -> getAggregate (group, newAggrTuple);
+		if (rc != 0) return rc;
+		
+		GROUP (newAggrTuple) = group;
+		paneSynopsis -> setAggrTuple (group, newAggrTuple);
+		
+		rc = outputSynopsis -> insertTuple (newAggrTuple);
+		if (rc != 0) return rc;
+		LOCK_OUTPUT_TUPLE (newAggrTuple);
+		
+		rc = outputSynopsis -> deleteTuple (oldAggrTuple);
+		if (rc != 0) return rc;
+		
+		// Plus element:
+		plusElement.kind      = E_PLUS;
+		plusElement.tuple     = newAggrTuple;
+		plusElement.timestamp = lastInputTs;
+		
+		outputQueue -> enqueue (plusElement);
+		lastOutputTs = lastInputTs;
+		
+		// Minus element:
+		minusElement.kind      = E_MINUS;
+		minusElement.tuple     = oldAggrTuple;
+		minusElement.timestamp = lastInputTs;
+		
+		// We could get stalled now though ...
+		if (!outputQueue -> enqueue (minusElement)) {
+			bStalled = true;
+			stalledElement = minusElement;
+		}
+	}
+	
+	if (!expireGroup)
+		bExpiring = false;
+	
+	return 0;
+}
@@ -0,0 +1,560 @@
+/**
+ * @file       mjoin.cc
+ * @date       Oct. 17, 2026
+ * @brief      Multi-way join operator
+ */
+
+#ifndef _MJOIN_
+#include "execution/operators/mjoin.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _TRACE_BUFFER_
+#include "execution/monitors/trace_buffer.h"
+#endif
+
+#define LOCK_OUT_TUPLE(t) (outStore -> addRef ((t)))
+#define UNLOCK_INPUT_TUPLE(i,t) (inputs [(i)].store -> decrRef ((t)))
+
+using namespace Execution;
+using namespace Monitor;
+using namespace std;
+
+MJoin::MJoin (unsigned int id, ostream &_LOG)
+	: LOG (_LOG)
+{
+	this -> id = id;
+	this -> numInputs = 0;
+	this -> numPreds = 0;
+	this -> joinSynopsis = 0;
+	this -> outStore = 0;
+	this -> outputQueue = 0;
+	this -> evalContext = 0;
+	this -> outputConstructor = 0;
+	this -> lastOutputTs = 0;
+	this -> numSinceReorder = 0;
+	this -> curInput = 0;
+	this -> curStep = 0;
+	this -> bStalled = false;
+	
+	for (unsigned int i = 0 ; i < MAX_INPUTS ; i++) {
+		inputs [i].queue = 0;
+		inputs [i].store = 0;
+		inputs [i].synopsis = 0;
+		inputs [i].fullScanId = 0;
+		inputs [i].lastTs = 0;
+		inputs [i].numProbes = 0;
+		inputs [i].numMatches = 0;
+		
+		for (unsigned int k = 0 ; k < MAX_INPUTS ; k++)
+			inputs [i].bIndexScan [k] = false;
+		
+		lineage [i] = 0;
+		scans [i] = 0;
+	}
+}
+
+MJoin::~MJoin ()
+{
+	if (evalContext)
+		delete evalContext;
+	if (outputConstructor)
+		delete outputConstructor;
+	for (unsigned int p = 0 ; p < numPreds ; p++)
+		delete preds [p];
+}
+
+int MJoin::setNumInputs (unsigned int numInputs)
+{
+	ASSERT (numInputs > 2);
+	
+	if (numInputs > MAX_INPUTS)
+		return -1;
+	
+	this -> numInputs = numInputs;
+	return 0;
+}
+
+int MJoin::setInputQueue (unsigned int input, Queue *inputQueue)
+{
+	ASSERT (input < numInputs);
+	ASSERT (inputQueue);
+	
+	inputs [input].queue = inputQueue;
+	return 0;
+}
+
+int MJoin::setInputStore (unsigned int input, StorageAlloc *store)
+{
+	ASSERT (input < numInputs);
+	ASSERT (store);
+	
+	inputs [input].store = store;
+	return 0;
+}
+
+int MJoin::setSynopsis (unsigned int input, RelationSynopsis *synopsis)
+{
+	ASSERT (input < numInputs);
+	ASSERT (synopsis);
+	
+	inputs [input].synopsis = synopsis;
+	return 0;
+}
+
+int MJoin::setIndexScan (unsigned int input, unsigned int k,
+						 unsigned int scanId)
+{
+	ASSERT (input < numInputs);
+	ASSERT (k < numInputs && k != input);
+	
+	inputs [input].bIndexScan [k] = true;
+	inputs [input].indexScanId [k] = scanId;
+	return 0;
+}
+
+int MJoin::setFullScan (unsigned int input, unsigned int scanId)
+{
+	ASSERT (input < numInputs);
+	
+	inputs [input].fullScanId = scanId;
+	return 0;
+}
+
+int MJoin::addPredicate (BEval *pred, unsigned int inputMask)
+{
+	ASSERT (pred);
+	
+	if (numPreds == MAX_PREDS)
+		return -1;
+	
+	preds [numPreds] = pred;
+	predInputs [numPreds] = inputMask;
+	numPreds++;
+	
+	return 0;
+}
+
+int MJoin::setJoinSynopsis (LineageSynopsis *joinSynopsis)
+{
+	this -> joinSynopsis = joinSynopsis;
+	return 0;
+}
+
+int MJoin::setOutputQueue (Queue *outputQueue)
+{
+	ASSERT (outputQueue);
+	
+	this -> outputQueue = outputQueue;
+	return 0;
+}
+
+int MJoin::setOutStore (StorageAlloc *outStore)
+{
+	ASSERT (outStore);
+	
+	this -> outStore = outStore;
+	return 0;
+}
+
+int MJoin::setEvalContext (EvalContext *evalContext)
+{
+	ASSERT (evalContext);
+	
+	this -> evalContext = evalContext;
+	return 0;
+}
+
+int MJoin::setOutputConstructor (AEval *outputConstructor)
+{
+	ASSERT (outputConstructor);
+	
+	this -> outputConstructor = outputConstructor;
+	return 0;
+}
+
+int MJoin::initialize ()
+{
+	ASSERT (numInputs > 2);
+	ASSERT (outStore);
+	ASSERT (evalContext);
+	ASSERT (outputConstructor);
+	
+	for (unsigned int i = 0 ; i < numInputs ; i++)
+		ASSERT (inputs [i].synopsis);
+	
+	// The queues & input stores are set later, when the plan is linked
+	computeOrders ();
+	
+	return 0;
+}
+
+int MJoin::run (TimeSlice timeSlice)
+{
+	int rc;
+	unsigned int numElements;
+	Timestamp minTs [MAX_INPUTS] = {0};
+	Timestamp outMinTs;
+	Element element;
+	unsigned int input;
+
+#ifdef _MONITOR_
+	startTimer ();
+#endif
+
+	// I have a stall ...
+	if (bStalled) {
+		
+		// The bindings of the tuples of the steps before the current one
+		for (unsigned int s = 0 ; s < curStep ; s++) {
+			input = order [curInput][s].input;
+			evalContext -> bind (lineage [input], INPUT_ROLE + input);
+		}
+		
+		bStalled = false;
+		if ((rc = probe ()) != 0)
+			return rc;
+		
+		// ... and can't clear it
+		if (bStalled) {
+
+#ifdef _MONITOR_
+			stopTimer ();
+			logOutTs (lastOutputTs);
+#endif
+
+			return 0;
+		}
+	}
+	
+	// Minimum timestamp possible on the next element of each input
+	for (unsigned int i = 0 ; i < numInputs ; i++)
+		minTs [i] = inputs [i].lastTs;
+	
+	numElements = timeSlice;
+	
+	for (unsigned int e = 0 ; (e < numElements) && !bStalled ; e++) {
+		
+		// Peek to revise the min timestamp estimates
+		outMinTs = 0;
+		for (unsigned int i = 0 ; i < numInputs ; i++) {
+			if (inputs [i].queue -> peek (element))
+				minTs [i] = element.timestamp;
+			
+			if (i == 0 || minTs [i] < outMinTs)
+				outMinTs = minTs [i];
+		}
+		
+		// We can process an element of an input only if no other input
+		// can have an element with a smaller timestamp.  Among such
+		// inputs we pick the first that has an element waiting.
+		for (input = 0 ; input < numInputs ; input++)
+			if (minTs [input] == outMinTs &&
+				inputs [input].queue -> dequeue (element))
+				break;
+		
+		if (input == numInputs)
+			break;
+		
+		inputs [input].lastTs = element.timestamp;
+		
+		// Processing could lead to stalling (output queue is full while
+		// the operator has elements to output).  In this case bStalled
+		// is set, which terminates the forloop.
+		if (element.kind == E_PLUS || element.kind == E_MINUS) {
+			if ((rc = processElement (element, input)) != 0)
+				return rc;
+		}
+		
+		// Heartbeats require no processing
+#ifdef _DM_
+		else {
+			ASSERT (element.kind == E_HEARTBEAT);
+		}
+#endif
+	}
+	
+	// Heartbeat generation
+	if (!bStalled) {
+		outMinTs = minTs [0];
+		for (unsigned int i = 1 ; i < numInputs ; i++)
+			if (minTs [i] < outMinTs)
+				outMinTs = minTs [i];
+		
+		if (!outputQueue -> isFull() && (lastOutputTs < outMinTs)) {
+			lastOutputTs = outMinTs;
+			outputQueue -> enqueue (Element::Heartbeat (lastOutputTs));
+		}
+	}
+
+#ifdef _MONITOR_
+	stopTimer ();
+	logOutTs (lastOutputTs);
+#endif
+
+	return 0;
+}
+
+/**
+ * A PLUS element is inserted into the synopsis of its input before
+ * the join, and the synopsis takes over the reference of the element to
+ * its tuple.  A MINUS element is deleted from the synopsis, and we hold
+ * on to the tuple until we are done joining it.
+ */
+
+int MJoin::processElement (Element element, unsigned int input)
+{
+	int rc;
+	const ProbeStep *next;
+
+#ifdef _MONITOR_
+	logInput ();
+#endif
+
+	evalContext -> bind (element.tuple, INPUT_ROLE + input);
+	lineage [input] = element.tuple;
+	
+	if (element.kind == E_PLUS) {
+		if ((rc = inputs [input].synopsis -> insertTuple (element.tuple)) != 0)
+			return rc;
+	}
+	
+	else {
+		if ((rc = inputs [input].synopsis -> deleteTuple (element.tuple)) != 0)
+			return rc;
+		UNLOCK_INPUT_TUPLE (input, element.tuple);
+	}
+	
+	curElement = element;
+	curInput = input;
+	curStep = 0;
+	
+	// Predicates over the tuple alone
+	if (checkPreds (order [curInput][0])) {
+		curStep = 1;
+		next = &order [curInput][1];
+		
+		if ((rc = inputs [next -> input].synopsis ->
+			 getScan (next -> scanId, scans [1])) != 0)
+			return rc;
+		inputs [next -> input].numProbes++;
+	}
+	
+	return probe ();
+}
+
+int MJoin::probe ()
+{
+	int rc;
+	Tuple tuple;
+	const ProbeStep *step, *next;
+	
+	while (curStep > 0) {
+		step = &order [curInput][curStep];
+		
+		// The next tuple of the last step produces an output
+		if (curStep == numInputs - 1 && outputQueue -> isFull ()) {
+			bStalled = true;
+			TRACE (TR_STALL, id, curElement.timestamp, 0);
+			return 0;
+		}
+		
+		if (!scans [curStep] -> getNext (tuple)) {
+			if ((rc = inputs [step -> input].synopsis ->
+				 releaseScan (step -> scanId, scans [curStep])) != 0)
+				return rc;
+			curStep--;
+			continue;
+		}
+		
+		evalContext -> bind (tuple, INPUT_ROLE + step -> input);
+		lineage [step -> input] = tuple;
+		
+		if (!checkPreds (*step))
+			continue;
+		
+		inputs [step -> input].numMatches++;
+		
+		if (curStep == numInputs - 1) {
+			if ((rc = produceOutput ()) != 0)
+				return rc;
+			continue;
+		}
+		
+		curStep++;
+		next = &order [curInput][curStep];
+		
+		if ((rc = inputs [next -> input].synopsis ->
+			 getScan (next -> scanId, scans [curStep])) != 0)
+			return rc;
+		inputs [next -> input].numProbes++;
+	}
+	
+	return finishElement ();
+}
+
+int MJoin::produceOutput ()
+{
+	int rc;
+	Tuple outputTuple;
+	Element outputElement;
+	
+	if (curElement.kind == E_PLUS) {
+		
+		// allocate space for the output tuple
+		if ((rc = outStore -> newTuple (outputTuple)) != 0)
+			return rc;
+		
+		// construct the output tuple
+		evalContext -> bind (outputTuple, OUTPUT_ROLE);
+		outputConstructor -> eval ();
+		
+		// We have to insert this tuple in joinSynopsis (if it exists)
+		// to enable us to produce the MINUS tuple later
+		if (joinSynopsis) {
+			if ((rc = joinSynopsis -> insertTuple (outputTuple,
+												   lineage)) != 0)
+				return rc;
+			
+			LOCK_OUT_TUPLE (outputTuple);
+		}
+
+#ifdef _MONITOR_
+		logJoin ();
+#endif
+	}
+	
+	// As in BinaryJoin: the tuple of the PLUS element from the
+	// joinSynopsis, or a fresh one if there is nobody upstream that
+	// cares
+	else if (joinSynopsis) {
+		if ((rc = joinSynopsis -> getTuple (lineage, outputTuple)) != 0)
+			return rc;
+		if ((rc = joinSynopsis -> deleteTuple (outputTuple)) != 0)
+			return rc;
+	}
+	
+	else {
+		if ((rc = outStore -> newTuple (outputTuple)) != 0)
+			return rc;
+		
+		evalContext -> bind (outputTuple, OUTPUT_ROLE);
+		outputConstructor -> eval ();
+	}
+	
+	outputElement.kind = curElement.kind;
+	outputElement.tuple = outputTuple;
+	outputElement.timestamp = curElement.timestamp;
+	
+	outputQueue -> enqueue (outputElement);
+	lastOutputTs = outputElement.timestamp;
+	
+	return 0;
+}
+
+int MJoin::finishElement ()
+{
+	if (curElement.kind == E_MINUS)
+		UNLOCK_INPUT_TUPLE (curInput, curElement.tuple);
+	
+	// Revise the probe orders between elements, never while an element
+	// is half joined
+	if (++numSinceReorder == REORDER_INTERVAL) {
+		computeOrders ();
+		numSinceReorder = 0;
+	}
+	
+	return 0;
+}
+
+/**
+ * The probe order of input a binds a first, and then, step after step,
+ * the input with the smallest fanout among those that can be scanned
+ * with an index on a bound input - or among all the remaining inputs if
+ * no index applies.  The statistics are halved after each computation so
+ * that the orders follow changes in the data.
+ */
+
+void MJoin::computeOrders ()
+{
+	unsigned int bound, prevBound;
+	unsigned int best, bestScan;
+	bool bIndexed, bBestIndexed;
+	unsigned int scanId;
+	double fanout, bestFanout;
+	ProbeStep *step;
+	
+	for (unsigned int a = 0 ; a < numInputs ; a++) {
+		
+		order [a][0].input = a;
+		order [a][0].scanId = 0;
+		bound = (1 << a);
+		
+		for (unsigned int s = 1 ; s < numInputs ; s++) {
+			best = numInputs;
+			bestScan = 0;
+			bBestIndexed = false;
+			bestFanout = 0;
+			
+			for (unsigned int j = 0 ; j < numInputs ; j++) {
+				if (bound & (1 << j))
+					continue;
+				
+				bIndexed = false;
+				scanId = inputs [j].fullScanId;
+				for (unsigned int k = 0 ; k < numInputs && !bIndexed ; k++) {
+					if ((bound & (1 << k)) && inputs [j].bIndexScan [k]) {
+						bIndexed = true;
+						scanId = inputs [j].indexScanId [k];
+					}
+				}
+				
+				fanout = (inputs [j].numMatches + 1) /
+					(inputs [j].numProbes + 1);
+				
+				if (best == numInputs ||
+					(bIndexed && !bBestIndexed) ||
+					(bIndexed == bBestIndexed && fanout < bestFanout)) {
+					best = j;
+					bestScan = scanId;
+					bBestIndexed = bIndexed;
+					bestFanout = fanout;
+				}
+			}
+			
+			ASSERT (best < numInputs);
+			
+			order [a][s].input = best;
+			order [a][s].scanId = bestScan;
+			bound |= (1 << best);
+		}
+		
+		// Each predicate is checked at the first step where all its
+		// inputs are bound
+		prevBound = 0;
+		bound = 0;
+		for (unsigned int s = 0 ; s < numInputs ; s++) {
+			step = &order [a][s];
+			bound |= (1 << step -> input);
+			
+			step -> numPreds = 0;
+			for (unsigned int p = 0 ; p < numPreds ; p++) {
+				if ((predInputs [p] & ~bound) != 0)
+					continue;
+				if (s > 0 && (predInputs [p] & ~prevBound) == 0)
+					continue;
+				step -> preds [step -> numPreds++] = p;
+			}
+			
+			prevBound = bound;
+		}
+	}
+	
+	for (unsigned int i = 0 ; i < numInputs ; i++) {
+		inputs [i].numProbes /= 2;
+		inputs [i].numMatches /= 2;
+	}
+}
@@ -22,6 +22,13 @@ Output::Output(unsigned int _id, std::ostream& _LOG)
 	inStore         = 0;
 	numAttrs        = 0;
 	output          = 0;
+	batchPos        = 0;
+	batchLen        = 0;
+	prevOutput      = 0;
+	startTs         = 0;
+	bEnd            = false;
+	endTs           = 0;
+	bRetired        = false;
 #ifdef _DM_
 	lastInputTs     = 0;
 #endif
@@ -110,6 +117,7 @@ int Output::run (TimeSlice timeSlice)
 	Element inputElement;
 	Tuple inputTuple;
 	unsigned int numElements;	
+	unsigned int numBatch;
 	char effect;
 
 #ifdef _MONITOR_
@@ -118,69 +126,107 @@ int Output::run (TimeSlice timeSlice)
 	
 	numElements = timeSlice;
 
-	for (unsigned int e = 0 ; e < numElements ; e++) {
+	for (unsigned int e = 0 ; e < numElements ; e += numBatch) {
 		
-		// Get the next element
-		if (!inputQueue -> dequeue (inputElement))
-			break;
+		// Elements held back by the last run
+		if (batchPos < batchLen) {
+			numBatch = batchLen - batchPos;
+		}
 		
-		ASSERT (lastInputTs <= inputElement.timestamp);
+		else {
+			numBatch = numElements - e;
+			if (numBatch > Queue::BATCH_SIZE)
+				numBatch = Queue::BATCH_SIZE;
+			
+			// Get the next elements
+			if ((numBatch = inputQueue -> dequeueBatch (batch, numBatch)) == 0)
+				break;
+			
+			batchPos = 0;
+			batchLen = numBatch;
+		}
 		
+		for ( ; batchPos < batchLen ; batchPos++) {
+			inputElement = batch [batchPos];
+			
+			// The output operator we replace is not done yet
+			if (prevOutput && inputElement.timestamp >= startTs) {
+				if (!prevOutput -> isRetired ())
+					break;
+				prevOutput = 0;
+			}
+			
+			ASSERT (lastInputTs <= inputElement.timestamp);
+			
 #ifdef _DM_
-		lastInputTs = inputElement.timestamp;
+			lastInputTs = inputElement.timestamp;
 #endif
-		
-		// Ignore heartbeats
-		if (inputElement.kind == E_HEARTBEAT)
-			continue;
-		
-		inputTuple = inputElement.tuple;
-		
-		// Output timestamp
-		memcpy(buffer, &inputElement.timestamp, TIMESTAMP_SIZE);
-				
-		// Output effect: integer 1 for PLUS, integer 2 for MINUS
-		effect = (inputElement.kind == E_PLUS)? '+' : '-';		
-		memcpy(buffer + EFFECT_OFFSET, &effect, 1);
-		
-		// Output the remaining attributes
-		for (unsigned int a = 0 ; a < numAttrs ; a++) {
-			switch (attrs[a].type) {
-			case INT:							
-				memcpy (buffer + offsets[a],
-						&(ICOL(inputTuple, inCols [a])),
-						INT_SIZE);
-				break;
-				
-			case FLOAT:
-				memcpy (buffer + offsets[a],
-						&(FCOL(inputTuple, inCols [a])),
-						FLOAT_SIZE);
-				break;
-				
-			case BYTE:
-				buffer [offsets[a]] = BCOL(inputTuple,
-										   inCols[a]);
-				break;
-				
-			case CHAR:
-				
-				strncpy (buffer + offsets [a],
-						 (CCOL(inputTuple, inCols [a])),
-						 attrs [a].len);
-				
-				break;
-				
-			default:
-				return -1;
+			
+			if (bEnd && inputElement.timestamp >= endTs)
+				bRetired = true;
+			
+			// Ignore heartbeats
+			if (inputElement.kind == E_HEARTBEAT)
+				continue;
+			
+			inputTuple = inputElement.tuple;
+			
+			// Produced by another output operator
+			if (bRetired || inputElement.timestamp < startTs) {
+				UNLOCK_INPUT_TUPLE(inputTuple);
+				continue;
 			}
+			
+			// Output timestamp
+			memcpy(buffer, &inputElement.timestamp, TIMESTAMP_SIZE);
+			
+			// Output effect: integer 1 for PLUS, integer 2 for MINUS
+			effect = (inputElement.kind == E_PLUS)? '+' : '-';		
+			memcpy(buffer + EFFECT_OFFSET, &effect, 1);
+			
+			// Output the remaining attributes
+			for (unsigned int a = 0 ; a < numAttrs ; a++) {
+				switch (attrs[a].type) {
+				case INT:							
+					memcpy (buffer + offsets[a],
+							&(ICOL(inputTuple, inCols [a])),
+							INT_SIZE);
+					break;
+					
+				case FLOAT:
+					memcpy (buffer + offsets[a],
+							&(FCOL(inputTuple, inCols [a])),
+							FLOAT_SIZE);
+					break;
+					
+				case BYTE:
+					buffer [offsets[a]] = BCOL(inputTuple,
+											   inCols[a]);
+					break;
+					
+				case CHAR:
+					
+					strncpy (buffer + offsets [a],
+							 (CCOL(inputTuple, inCols [a])),
+							 attrs [a].len);
+					
+					break;
+					
+				default:
+					return -1;
+				}
+			}
+			
+			UNLOCK_INPUT_TUPLE(inputTuple);
+			
+			// Output the tuple
+			if ((rc = output -> putNext (buffer, tupleLen)) != 0)
+				return rc;
 		}
 		
-		UNLOCK_INPUT_TUPLE(inputTuple);
-		
-		// Output the tuple
-		if ((rc = output -> putNext (buffer, tupleLen)) != 0)
-			return rc;
+		// Waiting for the output operator we replace
+		if (batchPos < batchLen)
+			break;
 	}
 
 #ifdef _MONITOR_
@@ -190,3 +236,18 @@ int Output::run (TimeSlice timeSlice)
 	return 0;
 }
 
+int Output::setStart (Timestamp startTs, Output *prevOutput)
+{
+	ASSERT (prevOutput);
+	
+	this -> startTs = startTs;
+	this -> prevOutput = prevOutput;
+	return 0;
+}
+
+int Output::setEnd (Timestamp endTs)
+{
+	this -> endTs = endTs;
+	this -> bEnd = true;
+	return 0;
+}
@@ -31,6 +31,7 @@ Project::Project(unsigned int id, ostream &_LOG)
 	this -> outSynopsis      = 0;
 	this -> lastInputTs      = 0;
 	this -> lastOutputTs     = 0;
+	this -> bVectorized      = false;
 }
 
 Project::~Project() {
@@ -94,12 +95,23 @@ int Project::setOutSynopsis (LineageSynopsis *outSynopsis)
 	return 0;
 }
 
+int Project::setVectorized (bool bVectorized)
+{
+	ASSERT (!bVectorized ||
+			(projEval && projEval -> isVectorizable (OUTPUT_ROLE)));
+	
+	this -> bVectorized = bVectorized;
+	return 0;
+}
+
 int Project::run (TimeSlice timeSlice) 
 {
 	unsigned int numElements;
+	unsigned int numBatch;
+	unsigned int numOutput;
+	unsigned int numTuples;
 	Element      inputElement;
 	Tuple        outputTuple;
-	Element      outputElement;
 	int rc;
 
 #ifdef _MONITOR_
@@ -109,78 +121,113 @@ int Project::run (TimeSlice timeSlice)
 	// Number of elements to process
 	numElements = timeSlice;
 	
-	for (unsigned int e = 0 ; e < numElements ; e++) {
+	for (unsigned int e = 0 ; e < numElements ; e += numBatch) {
 		
-		// We are blocked @ output queue
-		if (outputQueue -> isFull())
+		// Each input element produces at most one output element: we
+		// are blocked @ output queue if it has no space.
+		numBatch = outputQueue -> getFreeSpace ();
+		if (numBatch == 0)
 			break;
 		
-		// Get the next input element
-		if (!inputQueue -> dequeue(inputElement)) 
-			break;		
+		if (numBatch > Queue::BATCH_SIZE)
+			numBatch = Queue::BATCH_SIZE;
+		if (numBatch > numElements - e)
+			numBatch = numElements - e;
+		
+		// Get the next input elements
+		if ((numBatch = inputQueue -> dequeueBatch (batch, numBatch)) == 0)
+			break;
 		
 		// Timestamp of last input tuple: used in heartbeat generation
-		lastInputTs = inputElement.timestamp;
-
-		// Plus tuple
-		if (inputElement.kind == E_PLUS) {
-			
-			// Allocate space for output tuple
-			if ((rc = outStore -> newTuple (outputTuple)) != 0) {				
-				return rc;
+		lastInputTs = batch [numBatch - 1].timestamp;
+		
+		// Vectorized mode: produce the output tuples for all the PLUS
+		// elements of the batch
+		if (bVectorized) {
+			numTuples = 0;
+			for (unsigned int b = 0 ; b < numBatch ; b++) {
+				if (batch [b].kind != E_PLUS)
+					continue;
+				
+				if ((rc = outStore -> newTuple (outTuples [numTuples])) != 0)
+					return rc;
+				inTuples [numTuples++] = batch [b].tuple;
 			}
 			
-			// Produce the output tuple
-			evalContext -> bind (outputTuple, OUTPUT_ROLE);
-			evalContext -> bind (inputElement.tuple, INPUT_ROLE);
-			projEval -> eval();
-			
-			// Produce the output element
-			outputElement.kind = E_PLUS;
-			outputElement.tuple = outputTuple;
-			outputElement.timestamp = inputElement.timestamp;		
+			projEval -> evalBatch (inTuples, outTuples, numTuples,
+								   INPUT_ROLE, OUTPUT_ROLE);
+		}
+		
+		numOutput = 0;
+		numTuples = 0;
+		for (unsigned int b = 0 ; b < numBatch ; b++) {
+			inputElement = batch [b];
 			
-			// enqueue the output element
-			outputQueue -> enqueue (outputElement);
-			lastOutputTs = outputElement.timestamp;
+			// Plus tuple
+			if (inputElement.kind == E_PLUS) {
+				
+				if (bVectorized) {
+					outputTuple = outTuples [numTuples++];
+				}
+				
+				else {
+					// Allocate space for output tuple
+					if ((rc = outStore -> newTuple (outputTuple)) != 0) {
+						return rc;
+					}
+					
+					// Produce the output tuple
+					evalContext -> bind (outputTuple, OUTPUT_ROLE);
+					evalContext -> bind (inputElement.tuple, INPUT_ROLE);
+					projEval -> eval();
+				}
+				
+				// Produce the output element
+				batch [numOutput++] = Element (E_PLUS, outputTuple,
+											   inputElement.timestamp);
+				
+				if (outSynopsis) {
+					rc = outSynopsis -> insertTuple (outputTuple,
+													 &inputElement.tuple);
+					if (rc != 0) return rc;
+					
+					// Lock tuple to ensure memory manager does not
+					// deallocate its space
+					LOCK_OUTPUT_TUPLE(outputTuple);
+				}
+				
+				// Discard tuple of input element
+				UNLOCK_INPUT_TUPLE(inputElement.tuple);
+			}
 			
-			if (outSynopsis) {
-				rc = outSynopsis -> insertTuple (outputTuple, &inputElement.tuple);
+			else if (inputElement.kind == E_MINUS) {
+				ASSERT (outSynopsis);
+				
+				// Get the tuple that we produced for the corresponding
+				// PLUS tuple
+				rc = outSynopsis -> getTuple (&inputElement.tuple,
+											  outputTuple);
 				if (rc != 0) return rc;
 				
-				// Lock tuple to ensure memory manager does not deallocate
-				// its space
-				LOCK_OUTPUT_TUPLE(outputTuple);
+				batch [numOutput++] = Element (E_MINUS, outputTuple,
+											   inputElement.timestamp);
+				
+				// Delete the tuple from the synopsis
+				rc = outSynopsis -> deleteTuple (outputTuple);
+				if (rc != 0) return rc;
+				
+				// Discard tuple of input element
+				UNLOCK_INPUT_TUPLE(inputElement.tuple);
 			}
 			
-			// Discard tuple of input element
-			UNLOCK_INPUT_TUPLE(inputElement.tuple);
+			// heartbeats: do nothing
 		}
 		
-		else if (inputElement.kind == E_MINUS) {
-			ASSERT (outSynopsis);
-			
-			// Get the tuple that we produced for the corresponding PLUS tuple
-			rc = outSynopsis -> getTuple (&inputElement.tuple,
-										  outputTuple);
-			if (rc != 0) return rc;
-			
-			outputElement.kind = E_MINUS;
-			outputElement.tuple = outputTuple;
-			outputElement.timestamp = inputElement.timestamp;
-			
-			outputQueue -> enqueue (outputElement);
-			lastOutputTs = outputElement.timestamp;
-			
-			// Delete the tuple from the synopsis
-			rc = outSynopsis -> deleteTuple (outputTuple);
-			if (rc != 0) return rc;
-			
-			// Discard tuple of input element
-			UNLOCK_INPUT_TUPLE(inputElement.tuple);
+		// enqueue the output elements
+		if (numOutput > 0) {
+			outputQueue -> enqueueBatch (batch, numOutput);
+			lastOutputTs = batch [numOutput - 1].timestamp;
 		}
-		
-		// heartbeats: do nothing
 	}
 	
 	// Generate heartbeat if necessary (and possible without blocking) 
@@ -12,11 +12,12 @@
 #include "execution/operators/range_win.h"
 #endif
 
-#include <iostream>
-#include <fstream>
+#ifndef _TRACE_BUFFER_
+#include "execution/monitors/trace_buffer.h"
+#endif
 
 using namespace Execution;
-using namespace std;
+using namespace Monitor;
 
 #define LOCK_INPUT_TUPLE(t) (inStore -> addRef ((t)))
 
@@ -116,9 +117,7 @@ int RangeWindow::run(TimeSlice timeSlice)
         }
     }
 
-    ofstream mylog;
-    mylog.open("/tmp/test", iostream::app);
-    
+    numElements = timeSlice;
     for (unsigned int e = 0 ; e < numElements ; e++) {        
         
         // Get the next element
@@ -133,9 +132,8 @@ int RangeWindow::run(TimeSlice timeSlice)
 
         lastInputTs = inputElement.timestamp;        
         inputTuple = inputElement.tuple;
-        mylog << "new tuple at: " << lastInputTs 
-              << " is heartbeat?: " << (inputElement.kind == E_HEARTBEAT) 
-              << endl;
+        TRACE (TR_WIN_INPUT, id, lastInputTs,
+               (inputElement.kind == E_HEARTBEAT));
         
         if (inputElement.kind == E_PLUS) {
             
@@ -173,6 +171,7 @@ int RangeWindow::run(TimeSlice timeSlice)
             if (outputQueue -> isFull()) {
                 bStalled = true;
                 stalledElement = inputElement;
+                TRACE (TR_STALL, id, lastInputTs, 0);
 
 #ifdef _MONITOR_
                 stopTimer ();
@@ -191,10 +190,12 @@ int RangeWindow::run(TimeSlice timeSlice)
         }
         
         else {
-            // Expire tuples with timestamp < (lastInputTs - windowSize)
-            if (lastInputTs >= windowSize) {
-                if ((rc = expireTuples (lastInputTs - windowSize)) != 0)
-                    return rc;
+            if (slideSize == 0) {
+                // Expire tuples with timestamp <= (lastInputTs - windowSize)
+                if (lastInputTs >= windowSize) {
+                    if ((rc = expireTuples (lastInputTs - windowSize)) != 0)
+                        return rc;
+                }
             } 
 
             else if ((rc = slideExpireTuples()) != 0) {
@@ -216,8 +217,6 @@ int RangeWindow::run(TimeSlice timeSlice)
         }
     }       
 
-    mylog.close();
-    
     ASSERT (!bStalled);    
     if (!outputQueue -> isFull() && (lastOutputTs < lastInputTs))
         outputQueue -> enqueue (Element::Heartbeat(lastInputTs));
@@ -243,6 +242,8 @@ int RangeWindow::slideExpireTuples()
             windowStart = (lastInputTs / slideSize) * slideSize;
         }
 
+        TRACE (TR_WIN_SLIDE, id, lastInputTs, windowStart);
+
         // expire old tuples
         if ((rc = expireTuples (windowStart-1)) != 0)
             return rc;
@@ -258,9 +259,11 @@ int RangeWindow::clearStall()
     ASSERT (bStalled);
     
     bStalled = false;
-    if (lastInputTs >= windowSize) {
-        if ((rc = expireTuples (lastInputTs - windowSize)) != 0)
-            return rc;
+    if (slideSize == 0) {
+        if (lastInputTs >= windowSize) {
+            if ((rc = expireTuples (lastInputTs - windowSize)) != 0)
+                return rc;
+        }
     } 
 
     else if ((rc = slideExpireTuples()) != 0) {
@@ -317,6 +320,7 @@ int RangeWindow::expireTuples (Timestamp expTs)
         // Output queue is full, we cannot send the MINUS tuple
         if (outputQueue -> isFull()) {
             bStalled = true;
+            TRACE (TR_STALL, id, lastInputTs, 0);
             return 0; 
         }
 
@@ -332,6 +336,8 @@ int RangeWindow::expireTuples (Timestamp expTs)
         outputQueue -> enqueue (outputElement);
         lastOutputTs = outputElement.timestamp;
         
+        TRACE (TR_WIN_EXPIRE, id, lastInputTs, oldestTupleTs);
+        
         winSynopsis -> deleteOldestTuple();
     }
     
@@ -213,6 +213,10 @@ int RelSource::run (TimeSlice timeSlice)
 		
 		outputQueue -> enqueue (outElement);
 		lastOutputTs = inputTupleTs;
+		
+#ifdef _MONITOR_
+		logInput ();
+#endif
 	}
 
 	// Heartbeat generation: Assert to the operator above that we won't
@@ -28,6 +28,7 @@ Select::Select (unsigned int _id, ostream &_LOG)
 	lastInputTs  = 0;
 	lastOutputTs = 0;
 	inStore      = 0;
+	bVectorized  = false;
 }
 
 Select::~Select() {
@@ -80,9 +81,21 @@ int Select::setEvalContext (EvalContext *evalContext)
 	return 0;
 }
 
+int Select::setVectorized (bool bVectorized)
+{
+	ASSERT (!bVectorized || (predicate && predicate -> isVectorizable ()));
+	
+	this -> bVectorized = bVectorized;
+	return 0;
+}
+
 int Select::run (TimeSlice timeSlice) 
 {	
 	unsigned int   numElements;
+	unsigned int   numBatch;
+	unsigned int   numOutput;
+	unsigned int   numTuples;
+	bool           bSatisfied;
 	Element        inputElement;
 
 #ifdef _MONITOR_
@@ -92,36 +105,72 @@ int Select::run (TimeSlice timeSlice)
 	// Number of input elements to process
 	numElements = timeSlice;
 
-	for (unsigned int e = 0 ; e < numElements ; e++) {
+	for (unsigned int e = 0 ; e < numElements ; e += numBatch) {
 		
-		// We are blocked @ output queue
-		if (outputQueue -> isFull())
+		// Each input element produces at most one output element, so we
+		// dequeue only as many elements as the output queue can take.
+		// We are blocked @ output queue if it has no space.
+		numBatch = outputQueue -> getFreeSpace ();
+		if (numBatch == 0)
 			break;
 		
+		if (numBatch > Queue::BATCH_SIZE)
+			numBatch = Queue::BATCH_SIZE;
+		if (numBatch > numElements - e)
+			numBatch = numElements - e;
+		
 		// No more tuples to process
-		if (!inputQueue -> dequeue (inputElement))
+		if ((numBatch = inputQueue -> dequeueBatch (batch, numBatch)) == 0)
 			break;
 		
 		// Timestamp of last input tuple: used in heartbeat generation
-		lastInputTs = inputElement.timestamp;
+		lastInputTs = batch [numBatch - 1].timestamp;
 		
-		// Heartbeat: no filtering to be done
-		if (inputElement.kind == E_HEARTBEAT)
-			continue;
-		
-		evalContext -> bind (inputElement.tuple, INPUT_CONTEXT);
+		// Vectorized mode: evaluate the predicate for all the tuples of
+		// the batch (heartbeats need no filtering)
+		if (bVectorized) {
+			numTuples = 0;
+			for (unsigned int b = 0 ; b < numBatch ; b++)
+				if (batch [b].kind != E_HEARTBEAT)
+					tuples [numTuples++] = batch [b].tuple;
+			
+			predicate -> evalBatch (tuples, numTuples, INPUT_CONTEXT, sel);
+		}
 		
-		// The tuple satisfies the predicate: enqueue it to the output,
-		// remember the timestamp (used in heartbeat generation)		
-		if (predicate -> eval()) {			
-			outputQueue -> enqueue (inputElement);
-			lastOutputTs = inputElement.timestamp;
+		numOutput = 0;
+		numTuples = 0;
+		for (unsigned int b = 0 ; b < numBatch ; b++) {
+			inputElement = batch [b];
+			
+			// Heartbeat: no filtering to be done
+			if (inputElement.kind == E_HEARTBEAT)
+				continue;
+			
+			if (bVectorized) {
+				bSatisfied = (sel [numTuples++] != 0);
+			}
+			else {
+				evalContext -> bind (inputElement.tuple, INPUT_CONTEXT);
+				bSatisfied = predicate -> eval();
+			}
+			
+			// The tuple satisfies the predicate: keep it for the output
+			if (bSatisfied) {
+				batch [numOutput++] = inputElement;
+			}
+			
+			// Tuple fails to satisfy the predicate: discard the tuple in
+			// the input element.
+			else {
+				UNLOCK_INPUT_TUPLE (inputElement.tuple);
+			}
 		}
 		
-		// Tuple fails to satisfy the predicate: discard the tuple in the
-		// input element.
-		else {
-			UNLOCK_INPUT_TUPLE (inputElement.tuple);
+		// Enqueue the output, remember the timestamp (used in heartbeat
+		// generation)
+		if (numOutput > 0) {
+			outputQueue -> enqueueBatch (batch, numOutput);
+			lastOutputTs = batch [numOutput - 1].timestamp;
 		}
 	}
 	
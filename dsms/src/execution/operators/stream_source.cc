@@ -21,6 +21,11 @@ StreamSource::StreamSource (unsigned int _id, std::ostream& _LOG)
 	source         = 0;
 	lastInputTs    = 0;
 	lastOutputTs   = 0;
+	bMigrating     = false;
+	switchTs       = 0;
+	newQueue       = 0;
+	newStoreAlloc  = 0;
+	newLastOutputTs = 0;
 }
 
 StreamSource::~StreamSource() {}
@@ -28,15 +33,19 @@ StreamSource::~StreamSource() {}
 int StreamSource::setOutputQueue (Queue *outputQueue)
 {
 	ASSERT (outputQueue);
-
-	this -> outputQueue = outputQueue;
+	
+	// Output queue of the plan we are migrating to
+	if (bMigrating)
+		this -> newQueue = outputQueue;
+	else
+		this -> outputQueue = outputQueue;
 	return 0;
 }
 
 int StreamSource::setStoreAlloc (StorageAlloc *storeAlloc)
 {
 	ASSERT (storeAlloc);
-
+	
 	this -> storeAlloc = storeAlloc;
 	return 0;
 }
@@ -44,7 +53,7 @@ int StreamSource::setStoreAlloc (StorageAlloc *storeAlloc)
 int StreamSource::setTableSource (Interface::TableSource *source)
 {
 	ASSERT (source);
-
+	
 	this -> source = source;
 	return 0;
 }
@@ -54,7 +63,7 @@ int StreamSource::addAttr (Type type, unsigned int len, Column outCol)
 	// We do not have space
 	if (numAttrs == MAX_ATTRS)
 		return -1;
-
+	
 	attrs [numAttrs].type = type;
 	attrs [numAttrs].len = len;
 	outCols [numAttrs] = outCol;
@@ -95,6 +104,12 @@ int StreamSource::run (TimeSlice timeSlice)
 {
 	int rc;
 	unsigned int  numElements;
+	unsigned int  numBatch;
+	unsigned int  numOutput;
+	unsigned int  numNewOutput;
+	unsigned int  numInput;
+	unsigned int  freeSpace;
+	unsigned int  b;
 	char         *inputTuple;
 	Timestamp     inputTs;
 	unsigned int  inputTupleLen;
@@ -106,76 +121,106 @@ int StreamSource::run (TimeSlice timeSlice)
 #endif							
 	
 	numElements = timeSlice;	
-	for (unsigned int e = 0 ; e < numElements ; e++) {
+	for (unsigned int e = 0 ; e < numElements ; e += numBatch) {
 		
 		// We are blocked @ the output queue
-		if (outputQueue -> isFull()) 
-			break;
+		numBatch = outputQueue -> getFreeSpace ();
 		
-		// Get the next input tuple
-		if ((rc = source -> getNext (inputTuple,
-									 inputTupleLen,
-									 bHeartbeat)) != 0)
-			return rc;
+		// While migrating, keep space for the heartbeat that ends the
+		// input of the old plan, and get blocked @ either plan
+		if (bMigrating) {
+			ASSERT (newQueue);
+			
+			numBatch = (numBatch > 0)? numBatch - 1 : 0;
+			
+			freeSpace = newQueue -> getFreeSpace ();
+			if (numBatch > freeSpace)
+				numBatch = freeSpace;
+		}
 		
-		// We do not have an input tuple yet
-		if (!inputTuple)
+		if (numBatch == 0)
 			break;
 		
-		// Get the timestamp: which is the first field
-		memcpy (&inputTs, inputTuple, TIMESTAMP_SIZE);
+		if (numBatch > Queue::BATCH_SIZE)
+			numBatch = Queue::BATCH_SIZE;
+		if (numBatch > numElements - e)
+			numBatch = numElements - e;
 		
-		// We should have a progress of time.
-		if (lastInputTs > inputTs) {
-			LOG << "StreamSource: input not in timestamp order" << endl;
-			return -1;
+		numOutput = 0;
+		numNewOutput = 0;
+		numInput = 0;
+		for (b = 0 ; b < numBatch ; b++) {
+			
+			// Get the next input tuple
+			if ((rc = source -> getNext (inputTuple,
+										 inputTupleLen,
+										 bHeartbeat)) != 0)
+				return rc;
+			
+			// We do not have an input tuple yet
+			if (!inputTuple)
+				break;
+			
+			// Get the timestamp: which is the first field
+			memcpy (&inputTs, inputTuple, TIMESTAMP_SIZE);
+			
+			// We should have a progress of time.
+			if (lastInputTs > inputTs) {
+				LOG << "StreamSource: input not in timestamp order" << endl;
+				return -1;
+			}
+			
+			lastInputTs = inputTs;
+			
+			// The new plan takes over
+			if (bMigrating && inputTs >= switchTs) {
+				if ((rc = endMigration (numOutput, numNewOutput)) != 0)
+					return rc;
+				
+				numOutput = numNewOutput;
+				numNewOutput = 0;
+			}
+			
+			// Ignore heartbeats
+			if (bHeartbeat) {
+				LOG << "Heartbeat received" << endl;
+				continue;
+			}
+			
+			if ((rc = decode (inputTuple, storeAlloc, outputTuple)) != 0)
+				return rc;
+			batch [numOutput++] = Element (E_PLUS, outputTuple, inputTs);
+			
+			if (bMigrating) {
+				if ((rc = decode (inputTuple, newStoreAlloc, outputTuple)) != 0)
+					return rc;
+				newBatch [numNewOutput++] =
+					Element (E_PLUS, outputTuple, inputTs);
+			}
+			
+			numInput ++;
 		}
 		
-		lastInputTs = inputTs;
-		
-		// Ignore heartbeats
-		if (bHeartbeat) {
-			LOG << "Heartbeat received" << endl;
-			continue;
+		if (numOutput > 0) {
+			outputQueue -> enqueueBatch (batch, numOutput);
+			lastOutputTs = batch [numOutput - 1].timestamp;
 		}
 		
-		// Get the storage for the output tuple
-		if ((rc = storeAlloc -> newTuple (outputTuple)) != 0)
-			return rc;
-		
-		// Get the attributes
-		for (unsigned int a = 0 ; a < numAttrs ; a++) {
-			switch (attrs [a].type) {				
-			case INT:
-				memcpy (&ICOL(outputTuple, outCols[a]), 
-						inputTuple + offsets[a], INT_SIZE);
-				break;
-				
-			case FLOAT:
-				memcpy (&FCOL(outputTuple, outCols[a]),
-						inputTuple + offsets[a], FLOAT_SIZE);
-				break;
-				
-			case BYTE:
-				BCOL(outputTuple, outCols[a]) = inputTuple[offsets[a]];
-				break;
-				
-			case CHAR:
-				strncpy (CCOL(outputTuple, outCols[a]),
-						 inputTuple + offsets[a],
-						 attrs[a].len);
-				break;
-				
-			default:
-				// Should not come
-				return -1;
-			}
+		if (numNewOutput > 0) {
+			newQueue -> enqueueBatch (newBatch, numNewOutput);
+			newLastOutputTs = newBatch [numNewOutput - 1].timestamp;
 		}
 		
-		outputQueue -> enqueue (Element(E_PLUS, outputTuple, inputTs));
-		lastOutputTs = inputTs;
+#ifdef _MONITOR_
+		if (numInput > 0)
+			logInput (numInput);
+#endif
+		
+		// The source ran out of tuples
+		if (b < numBatch)
+			break;
 	}
-
+	
 	// Heartbeat generation: Assert to the operator above that we won't
 	// produce any element with timestamp < lastInputTs
 	
@@ -184,6 +229,12 @@ int StreamSource::run (TimeSlice timeSlice)
 		lastOutputTs = lastInputTs;
 	}
 	
+	if (bMigrating && !newQueue -> isFull() &&
+		(lastInputTs > newLastOutputTs)) {
+		newQueue -> enqueue (Element::Heartbeat(lastInputTs));
+		newLastOutputTs = lastInputTs;
+	}
+	
 #ifdef _MONITOR_
 	stopTimer ();
 	logOutTs (lastOutputTs);		
@@ -191,5 +242,107 @@ int StreamSource::run (TimeSlice timeSlice)
 	
 	return 0;
 }
-								
-   
+
+int StreamSource::migrate (StorageAlloc *store, Timestamp switchTs)
+{
+	ASSERT (store);
+	
+	// One migration at a time
+	if (bMigrating) {
+		LOG << "StreamSource: already migrating" << endl;
+		return -1;
+	}
+	
+	// Too late to switch at this timestamp
+	if (switchTs <= lastInputTs) {
+		LOG << "StreamSource: switch timestamp already passed" << endl;
+		return -1;
+	}
+	
+	this -> newQueue = 0;
+	this -> newStoreAlloc = store;
+	this -> switchTs = switchTs;
+	this -> newLastOutputTs = 0;
+	this -> bMigrating = true;
+	
+	return 0;
+}
+
+/**
+ * Hand the output over to the new plan: the old plan gets the elements
+ * decoded so far in this batch, followed by a heartbeat for switchTs,
+ * and the elements decoded for the new plan become the current batch.
+ * run() keeps space for the heartbeat in the old output queue.
+ */
+
+int StreamSource::endMigration (unsigned int numOutput,
+								unsigned int numNewOutput)
+{
+	ASSERT (bMigrating);
+	
+	if (numOutput > 0) {
+		outputQueue -> enqueueBatch (batch, numOutput);
+		lastOutputTs = batch [numOutput - 1].timestamp;
+	}
+	
+	ASSERT (!outputQueue -> isFull ());
+	
+	outputQueue -> enqueue (Element::Heartbeat (switchTs));
+	
+	for (unsigned int b = 0 ; b < numNewOutput ; b++)
+		batch [b] = newBatch [b];
+	
+	outputQueue = newQueue;
+	storeAlloc = newStoreAlloc;
+	lastOutputTs = newLastOutputTs;
+	
+	newQueue = 0;
+	newStoreAlloc = 0;
+	bMigrating = false;
+	
+	LOG << "StreamSource " << id << ": switched to the new plan at "
+		<< switchTs << endl;
+	
+	return 0;
+}
+
+int StreamSource::decode (const char *inputTuple, StorageAlloc *store,
+						  Tuple &outputTuple)
+{
+	int rc;
+	
+	// Get the storage for the output tuple
+	if ((rc = store -> newTuple (outputTuple)) != 0)
+		return rc;
+	
+	// Get the attributes
+	for (unsigned int a = 0 ; a < numAttrs ; a++) {
+		switch (attrs [a].type) {				
+		case INT:
+			memcpy (&ICOL(outputTuple, outCols[a]), 
+					inputTuple + offsets[a], INT_SIZE);
+			break;
+			
+		case FLOAT:
+			memcpy (&FCOL(outputTuple, outCols[a]),
+					inputTuple + offsets[a], FLOAT_SIZE);
+			break;
+			
+		case BYTE:
+			BCOL(outputTuple, outCols[a]) = inputTuple[offsets[a]];
+			break;
+			
+		case CHAR:
+			strncpy (CCOL(outputTuple, outCols[a]),
+					 inputTuple + offsets[a],
+					 attrs[a].len);
+			break;
+			
+		default:
+			// Should not come
+			return -1;
+		}
+	}
+	
+	return 0;
+}
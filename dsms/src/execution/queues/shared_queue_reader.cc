@@ -59,3 +59,9 @@ bool SharedQueueReader::isEmpty () const
 {
 	return writer -> isEmpty (readerId);
 }
+
+unsigned int SharedQueueReader::dequeueBatch (Element *elements,
+											  unsigned int maxElements)
+{
+	return writer -> dequeueBatch (elements, maxElements, readerId);
+}
@@ -174,6 +174,45 @@ bool SharedQueueWriter::enqueue (Element element)
 	return true;
 }
 
+unsigned int SharedQueueWriter::enqueueBatch (const Element *elements,
+											  unsigned int numElements)
+{
+	unsigned int num;
+	
+	num = getFreeSpace ();
+	if (num > numElements)
+		num = numElements;
+	
+	for (unsigned int e = 0 ; e < num ; e++) {
+		*nextEnqueue.element = elements [e];
+		INCR (nextEnqueue);
+		
+		// See enqueue ()
+		if (elements [e].kind != E_HEARTBEAT) {
+			store -> addRef (elements [e].tuple, numReaders - 1);
+			
+#ifdef _MONITOR_
+			logElem ();
+#endif
+		}
+	}
+	totalEnqueued += num;
+	
+#ifdef _MONITOR_
+	if (num > 0)
+		logTs (elements [num - 1].timestamp);
+#endif
+	
+	return num;
+}
+
+unsigned int SharedQueueWriter::getFreeSpace () const
+{
+	ASSERT (totalEnqueued - totalDequeued [slowestReader] <= maxElements);
+	
+	return maxElements - (totalEnqueued - totalDequeued [slowestReader]);
+}
+
 bool SharedQueueWriter::dequeue (Element &element)
 {
 	ASSERT (0);
@@ -263,3 +302,47 @@ bool SharedQueueWriter::isEmpty (unsigned int reader) const
 	
 	return (totalEnqueued == totalDequeued [reader]);
 }
+
+unsigned int SharedQueueWriter::dequeueBatch (Element *elements,
+											  unsigned int maxElements,
+											  unsigned int reader)
+{
+	unsigned int num;
+	unsigned int totalDequeued_r;
+	
+	ASSERT (reader < numReaders);
+	ASSERT (totalEnqueued >= totalDequeued [reader]);
+	
+	num = totalEnqueued - totalDequeued [reader];
+	if (num > maxElements)
+		num = maxElements;
+	
+	if (num == 0)
+		return 0;
+	
+	for (unsigned int e = 0 ; e < num ; e++) {
+		elements [e] = *(nextDequeue[reader].element);
+		INCR (nextDequeue[reader]);
+	}
+	
+	// Same bookkeeping as dequeue (), except that the reader can now be
+	// ahead of several other readers
+	if (reader == slowestReader) {
+		totalDequeued_r = totalDequeued [reader];
+		for (unsigned int r = 0 ; r < numReaders ; r++) {
+			ASSERT (totalDequeued_r <= totalDequeued [r]);
+			totalDequeued [r] -= totalDequeued_r;
+		}
+		totalEnqueued -= totalDequeued_r;
+		totalDequeued [reader] = num;
+		
+		for (unsigned int r = 0 ; r < numReaders ; r++)
+			if (totalDequeued [r] < totalDequeued [slowestReader])
+				slowestReader = r;
+	}
+	else {
+		totalDequeued [reader] += num;
+	}
+	
+	return num;
+}
@@ -192,3 +192,55 @@ bool SimpleQueue::isEmpty() const
 	
 	return (numElements == 0);
 }
+
+unsigned int SimpleQueue::enqueueBatch (const Element *elements,
+										unsigned int num)
+{
+	ASSERT (numElements <= maxElements);
+	
+	if (num > maxElements - numElements)
+		num = maxElements - numElements;
+	
+	for (unsigned int e = 0 ; e < num ; e++) {
+		*nextEnqueue.element = elements [e];
+		INCR (nextEnqueue);
+		
+#ifdef _MONITOR_
+		if (elements [e].kind != E_HEARTBEAT)
+			logElem ();
+#endif
+	}
+	numElements += num;
+	
+#ifdef _MONITOR_
+	if (num > 0)
+		logTs (elements [num - 1].timestamp);
+#endif
+	
+	return num;
+}
+
+unsigned int SimpleQueue::dequeueBatch (Element *elements,
+										unsigned int maxNum)
+{
+	unsigned int num;
+	
+	ASSERT (numElements <= maxElements);
+	
+	num = (maxNum < numElements)? maxNum : numElements;
+	
+	for (unsigned int e = 0 ; e < num ; e++) {
+		elements [e] = *nextDequeue.element;
+		INCR (nextDequeue);
+	}
+	numElements -= num;
+	
+	return num;
+}
+
+unsigned int SimpleQueue::getFreeSpace () const
+{
+	ASSERT (numElements <= maxElements);
+	
+	return maxElements - numElements;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file        spsc_queue.cc
+ * @date        Oct. 17, 2026
+ * @brief       Implementation of a lock-free queue between two threads
+ */
+
+#ifndef _SPSC_QUEUE_
+#include "execution/queues/spsc_queue.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+using namespace std;
+using namespace Execution;
+
+#define LOAD_ACQUIRE(x)     __atomic_load_n (&(x), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(x,v)  __atomic_store_n (&(x), (v), __ATOMIC_RELEASE)
+
+SpscQueue::SpscQueue (int _id, ostream& _LOG)
+	: LOG (_LOG)
+{
+	this -> id          = _id;
+	this -> memMgr      = 0;
+	this -> numPages    = 0;
+	this -> pages       = 0;
+	this -> numSlots    = 0;
+	this -> nextTail    = 0;
+	this -> numPending  = 0;
+	this -> cachedHead  = 0;
+	this -> tail        = 0;
+	this -> head        = 0;
+	this -> cachedTail  = 0;
+}
+
+SpscQueue::~SpscQueue ()
+{
+	if (pages)
+		delete [] pages;
+}
+
+int SpscQueue::setNumPages (unsigned int numPages)
+{
+	ASSERT (numPages > 0);
+	
+	this -> numPages = numPages;
+	return 0;
+}
+
+int SpscQueue::setMemoryManager (MemoryManager *memMgr)
+{
+	ASSERT (memMgr);
+	
+	this -> memMgr = memMgr;
+	return 0;
+}
+
+/**
+ * Allocate the pages of the ring.  We store a power of two number of
+ * elements per page, so that finding the slot of an index is cheap.
+ */
+int SpscQueue::initialize ()
+{
+	int rc;
+	char *page;
+	
+	ASSERT (memMgr);
+	ASSERT (numPages > 0);
+	
+	ASSERT (memMgr -> getPageSize () >= sizeof (Element));
+	logElementsPerPage = 0;
+	while ((sizeof (Element) << (logElementsPerPage + 1)) <=
+		   memMgr -> getPageSize ())
+		logElementsPerPage ++;
+	
+	pages = new Element* [numPages];
+	for (unsigned int p = 0 ; p < numPages ; p++) {
+		if ((rc = memMgr -> allocatePage (page)) != 0)
+			return rc;
+		pages [p] = (Element *)page;
+	}
+	
+	numSlots = numPages << logElementsPerPage;
+	
+	return 0;
+}
+
+bool SpscQueue::enqueue (Element element)
+{
+	unsigned int n;
+	
+	n = next (nextTail);
+	
+	if (n == cachedHead) {
+		cachedHead = LOAD_ACQUIRE (head);
+		
+		// Really full: make sure the consumer sees what we have
+		if (n == cachedHead) {
+			publish ();
+			return false;
+		}
+	}
+	
+	*slot (nextTail) = element;
+	nextTail = n;
+	
+	if (++ numPending == PUBLISH_BATCH || element.kind == E_HEARTBEAT)
+		publish ();
+
+#ifdef _MONITOR_
+	logTs (element.timestamp);
+	if (element.kind != E_HEARTBEAT)
+		logElem ();
+#endif
+
+	return true;
+}
+
+bool SpscQueue::dequeue (Element &element)
+{
+	if (head == cachedTail) {
+		cachedTail = LOAD_ACQUIRE (tail);
+		
+		if (head == cachedTail)
+			return false;
+	}
+	
+	element = *slot (head);
+	STORE_RELEASE (head, next (head));
+	
+	return true;
+}
+
+bool SpscQueue::peek (Element &element) const
+{
+	if (head == cachedTail) {
+		cachedTail = LOAD_ACQUIRE (tail);
+		
+		if (head == cachedTail)
+			return false;
+	}
+	
+	element = *slot (head);
+	return true;
+}
+
+/**
+ * Called by the producer
+ */
+bool SpscQueue::isFull () const
+{
+	if (next (nextTail) != cachedHead)
+		return false;
+	
+	cachedHead = LOAD_ACQUIRE (head);
+	return (next (nextTail) == cachedHead);
+}
+
+/**
+ * Called by the consumer
+ */
+bool SpscQueue::isEmpty () const
+{
+	if (head != cachedTail)
+		return false;
+	
+	cachedTail = LOAD_ACQUIRE (tail);
+	return (head == cachedTail);
+}
+
+/**
+ * Called by the producer: the batch is published as a whole.
+ */
+unsigned int SpscQueue::enqueueBatch (const Element *elements,
+									  unsigned int numElements)
+{
+	unsigned int num;
+	
+	num = getFreeSpace ();
+	if (num > numElements)
+		num = numElements;
+	
+	for (unsigned int e = 0 ; e < num ; e++) {
+		*slot (nextTail) = elements [e];
+		nextTail = next (nextTail);
+		
+#ifdef _MONITOR_
+		if (elements [e].kind != E_HEARTBEAT)
+			logElem ();
+#endif
+	}
+	
+	if (num > 0) {
+		publish ();
+		
+#ifdef _MONITOR_
+		logTs (elements [num - 1].timestamp);
+#endif
+	}
+	
+	return num;
+}
+
+unsigned int SpscQueue::dequeueBatch (Element *elements,
+									  unsigned int maxElements)
+{
+	unsigned int num;
+	unsigned int h;
+	
+	cachedTail = LOAD_ACQUIRE (tail);
+	
+	h = head;
+	for (num = 0 ; num < maxElements && h != cachedTail ; num++) {
+		elements [num] = *slot (h);
+		h = next (h);
+	}
+	
+	if (num > 0)
+		STORE_RELEASE (head, h);
+	
+	return num;
+}
+
+/**
+ * Called by the producer
+ */
+unsigned int SpscQueue::getFreeSpace () const
+{
+	cachedHead = LOAD_ACQUIRE (head);
+	
+	if (cachedHead > nextTail)
+		return cachedHead - nextTail - 1;
+	return numSlots - (nextTail - cachedHead) - 1;
+}
+
+void SpscQueue::flush ()
+{
+	if (numPending > 0)
+		publish ();
+}
+
+void SpscQueue::publish ()
+{
+	STORE_RELEASE (tail, nextTail);
+	numPending = 0;
+}
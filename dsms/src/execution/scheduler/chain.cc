@@ -0,0 +1,193 @@
+/**
+ * @file       chain.cc
+ * @date       Oct. 17, 2026
+ * @brief      Implementation of the Chain scheduler
+ */
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _CHAIN_
+#include "execution/scheduler/chain.h"
+#endif
+
+#ifdef _MONITOR_
+#ifndef _PROPERTY_
+#include "execution/monitors/property.h"
+#endif
+#endif
+
+using namespace Execution;
+using namespace std;
+
+/// Lower bound on the cost of an operator (secs per element)
+static const double MIN_COST = 1e-7;
+
+/// Priority of operators not on any path
+static const double NO_PRIORITY = -1e30;
+
+ChainScheduler::ChainScheduler (ostream &_LOG)
+	: PriorityScheduler (_LOG)
+{
+	this -> numPaths = 0;
+}
+
+ChainScheduler::~ChainScheduler () {}
+
+void ChainScheduler::updatePriorities (long long int round)
+{
+#ifdef _MONITOR_
+	unsigned int path [MAX_OPS];
+	
+	if (round % UPDATE_PERIOD != 0)
+		return;
+	
+	for (unsigned int o = 0 ; o < numOps ; o++) {
+		estimate (o);
+		ops [o].priority = NO_PRIORITY;
+	}
+	
+	numPaths = 0;
+	for (unsigned int o = 0 ; o < numOps ; o++)
+		if (ops [o].numInputs == 0)
+			addPaths (o, path, 0);
+	
+	for (unsigned int o = 0 ; o < numOps ; o++)
+		if (ops [o].priority == NO_PRIORITY)
+			ops [o].priority = 0.0;
+#endif
+}
+
+double ChainScheduler::getPriority (unsigned int o) const
+{
+	return ops [o].priority;
+}
+
+/**
+ * Estimate the cost and selectivity of an operator from the number of
+ * elements that went through its input and output queues so far.
+ * Readers of shared queues do not count elements, so we use the count of
+ * the queue of the producer instead.
+ */
+void ChainScheduler::estimate (unsigned int o)
+{
+#ifdef _MONITOR_
+	OpInfo *info;
+	int num, numIn, numOut;
+	double time;
+	
+	info = ops + o;
+	
+	numIn = 0;
+	for (unsigned int i = 0 ; i < info -> numInputs ; i++) {
+		num = 0;
+		info -> inQueues [i] -> getIntProperty (Monitor::QUEUE_NUM_ELEM,
+												num);
+		
+		if (num == 0 && info -> inputs [i] < numOps &&
+			ops [info -> inputs [i]].outQueue) {
+			ops [info -> inputs [i]].outQueue ->
+				getIntProperty (Monitor::QUEUE_NUM_ELEM, num);
+		}
+		
+		numIn += num;
+	}
+	
+	numOut = 0;
+	if (info -> outQueue)
+		info -> outQueue -> getIntProperty (Monitor::QUEUE_NUM_ELEM, numOut);
+	
+	time = 0.0;
+	info -> op -> getDoubleProperty (Monitor::OP_TIME_USED, time);
+	
+	// No statistics yet
+	if (numIn == 0) {
+		cost [o] = MIN_COST;
+		selectivity [o] = 1.0;
+		return;
+	}
+	
+	cost [o] = time / numIn;
+	if (cost [o] < MIN_COST)
+		cost [o] = MIN_COST;
+	
+	// Elements reaching an output leave the system
+	selectivity [o] = (double)numOut / numIn;
+#endif
+}
+
+/**
+ * Extend a path with the consumers of operator o, and set the priorities
+ * along the paths that end at an output.
+ *
+ * @param o        last operator of the path
+ * @param path     operators of the path, without the source
+ * @param len      length of the path
+ */
+void ChainScheduler::addPaths (unsigned int o, unsigned int *path,
+							   unsigned int len)
+{
+	bool bEnd;
+	
+	if (ops [o].numInputs > 0)
+		path [len ++] = o;
+	
+	bEnd = true;
+	for (unsigned int c = 0 ; c < numOps && numPaths < MAX_PATHS ; c++) {
+		for (unsigned int i = 0 ; i < ops [c].numInputs ; i++) {
+			if (ops [c].inputs [i] == o) {
+				bEnd = false;
+				if (len < MAX_OPS)
+					addPaths (c, path, len);
+				break;
+			}
+		}
+	}
+	
+	if (bEnd && len > 0 && numPaths < MAX_PATHS) {
+		setSegments (path, len);
+		numPaths ++;
+	}
+}
+
+/**
+ * Compute the lower envelope of the progress chart of a path, and give
+ * each operator the steepness of its segment as priority.
+ */
+void ChainScheduler::setSegments (const unsigned int *path,
+								  unsigned int len)
+{
+	double time [MAX_OPS + 1];
+	double size [MAX_OPS + 1];
+	double slope, minSlope, step;
+	unsigned int begin, end;
+	
+	time [0] = 0.0;
+	size [0] = 1.0;
+	for (unsigned int j = 0 ; j < len ; j++) {
+		step = cost [path [j]] * size [j];
+		if (step < MIN_COST)
+			step = MIN_COST;
+		
+		time [j + 1] = time [j] + step;
+		size [j + 1] = size [j] * selectivity [path [j]];
+	}
+	
+	for (begin = 0 ; begin < len ; begin = end) {
+		end = begin + 1;
+		minSlope = (size [end] - size [begin]) / (time [end] - time [begin]);
+		
+		for (unsigned int j = begin + 2 ; j <= len ; j++) {
+			slope = (size [j] - size [begin]) / (time [j] - time [begin]);
+			if (slope <= minSlope) {
+				minSlope = slope;
+				end = j;
+			}
+		}
+		
+		for (unsigned int j = begin ; j < end ; j++)
+			if (ops [path [j]].priority < -minSlope)
+				ops [path [j]].priority = -minSlope;
+	}
+}
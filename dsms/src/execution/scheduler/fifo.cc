@@ -0,0 +1,60 @@
+/**
+ * @file       fifo.cc
+ * @date       Oct. 17, 2026
+ * @brief      Implementation of the FIFO scheduler
+ */
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _FIFO_
+#include "execution/scheduler/fifo.h"
+#endif
+
+using namespace Execution;
+using namespace std;
+
+/// Priority of an operator blocked at its output
+static const double BLOCKED_PRIORITY = 1.0;
+
+FifoScheduler::FifoScheduler (ostream &_LOG)
+	: PriorityScheduler (_LOG) {}
+
+FifoScheduler::~FifoScheduler () {}
+
+void FifoScheduler::updatePriorities (long long int round)
+{
+	// Priorities depend on the current contents of the queues
+}
+
+/**
+ * Timestamps are nonnegative, so -timestamp is at most 0 and below the
+ * priority of blocked operators.
+ */
+double FifoScheduler::getPriority (unsigned int o) const
+{
+	const OpInfo *info;
+	Element element;
+	double priority;
+	bool bFound;
+	
+	info = ops + o;
+	
+	if (info -> bBlocked)
+		return BLOCKED_PRIORITY;
+	
+	priority = 0.0;
+	bFound = false;
+	for (unsigned int i = 0 ; i < info -> numInputs ; i++) {
+		if (!info -> inQueues [i] -> peek (element))
+			continue;
+		
+		if (!bFound || -(double)element.timestamp > priority) {
+			priority = -(double)element.timestamp;
+			bFound = true;
+		}
+	}
+	
+	return priority;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file       priority.cc
+ * @date       Oct. 17, 2026
+ * @brief      Implementation of the priority scheduler base class
+ */
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _PRIORITY_SCHED_
+#include "execution/scheduler/priority.h"
+#endif
+
+using namespace Execution;
+using namespace std;
+
+static const TimeSlice timeSlice = 100000;
+
+PriorityScheduler::PriorityScheduler (ostream &_LOG)
+	: LOG (_LOG)
+{
+	this -> numOps = 0;
+	this -> bLinked = true;
+	this -> bStop = false;
+}
+
+PriorityScheduler::~PriorityScheduler () {}
+
+int PriorityScheduler::addOperator (Operator *op)
+{
+	ASSERT (op);
+	
+	if (numOps == MAX_OPS)
+		return -1;
+	
+	// Until we know about its queues, the operator is a source
+	ops [numOps].op = op;
+	ops [numOps].numInputs = 0;
+	ops [numOps].outQueue = 0;
+	ops [numOps].bBlocked = false;
+	ops [numOps].bStuck = false;
+	ops [numOps].priority = 0.0;
+	numOps ++;
+	
+	return 0;
+}
+
+int PriorityScheduler::addOperator (Operator *op, unsigned int fragment)
+{
+	// All fragments are run by this thread
+	return addOperator (op);
+}
+
+int PriorityScheduler::setQueues (Operator *op, Queue **inQueues,
+								  Operator **inOps, unsigned int numInputs,
+								  Queue *outQueue)
+{
+	unsigned int o;
+	
+	ASSERT (numInputs <= MAX_INPUTS);
+	
+	for (o = 0 ; o < numOps ; o++)
+		if (ops [o].op == op)
+			break;
+	
+	if (o == numOps) {
+		LOG << "PriorityScheduler: unknown operator" << endl;
+		return -1;
+	}
+	
+	for (unsigned int i = 0 ; i < numInputs ; i++) {
+		ASSERT (inQueues [i]);
+		ASSERT (inOps [i]);
+		
+		ops [o].inQueues [i] = inQueues [i];
+		ops [o].inOps [i] = inOps [i];
+		ops [o].inputs [i] = MAX_OPS;
+	}
+	ops [o].numInputs = numInputs;
+	ops [o].outQueue = outQueue;
+	
+	// The producers can be added after the operator
+	bLinked = false;
+	
+	return 0;
+}
+
+int PriorityScheduler::run (long long int numTimeUnits)
+{
+	int rc;
+	
+	if (!bLinked)
+		link ();
+	
+	for (long long int r = 0 ;
+		 (numTimeUnits == 0 || r < numTimeUnits) && !bStop ; r++) {
+		
+		updatePriorities (r);
+		
+		if ((rc = runQueued ()) != 0)
+			return rc;
+		
+		for (unsigned int o = 0 ; o < numOps ; o++) {
+			if (ops [o].numInputs > 0 || !isReady (ops + o))
+				continue;
+			
+			if ((rc = runOp (o)) != 0)
+				return rc;
+		}
+	}
+	
+	// Natural termination: process the elements still in the queues
+	if (!bStop)
+		return runQueued ();
+	
+	return 0;
+}
+
+/**
+ * Resolve the input operators of each operator to their indexes in ops.
+ */
+void PriorityScheduler::link ()
+{
+	OpInfo *info;
+	
+	for (unsigned int o = 0 ; o < numOps ; o++) {
+		info = ops + o;
+		
+		for (unsigned int i = 0 ; i < info -> numInputs ; i++) {
+			info -> inputs [i] = MAX_OPS;
+			for (unsigned int p = 0 ; p < numOps ; p++) {
+				if (ops [p].op == info -> inOps [i]) {
+					info -> inputs [i] = p;
+					break;
+				}
+			}
+		}
+	}
+	
+	bLinked = true;
+}
+
+/**
+ * Run the ready operators other than the sources in priority order,
+ * until none is ready.
+ */
+int PriorityScheduler::runQueued ()
+{
+	int rc;
+	unsigned int best;
+	double priority, bestPriority;
+	
+	for (unsigned int o = 0 ; o < numOps ; o++)
+		ops [o].bStuck = false;
+	
+	bestPriority = 0.0;
+	for (unsigned int s = 0 ; s < MAX_STEPS_PER_OP * numOps ; s++) {
+		
+		best = numOps;
+		for (unsigned int o = 0 ; o < numOps ; o++) {
+			if (ops [o].numInputs == 0 || ops [o].bStuck ||
+				!isReady (ops + o))
+				continue;
+			
+			priority = getPriority (o);
+			if (best == numOps || priority > bestPriority) {
+				best = o;
+				bestPriority = priority;
+			}
+		}
+		
+		if (best == numOps)
+			break;
+		
+		if ((rc = runOp (best)) != 0)
+			return rc;
+	}
+	
+	return 0;
+}
+
+/**
+ * Run an operator, and find out if it made progress: it was blocked at
+ * its output, or the oldest element of one of its inputs has changed.
+ */
+int PriorityScheduler::runOp (unsigned int o)
+{
+	int rc;
+	OpInfo *info;
+	Element before [MAX_INPUTS], after;
+	bool bBefore [MAX_INPUTS], bAfter, bProgress;
+	
+	info = ops + o;
+	
+	for (unsigned int i = 0 ; i < info -> numInputs ; i++)
+		bBefore [i] = info -> inQueues [i] -> peek (before [i]);
+	
+	if ((rc = info -> op -> run (timeSlice)) != 0)
+		return rc;
+	
+	bProgress = (info -> numInputs == 0 || info -> bBlocked);
+	for (unsigned int i = 0 ; i < info -> numInputs && !bProgress ; i++) {
+		bAfter = info -> inQueues [i] -> peek (after);
+		
+		bProgress = (bAfter != bBefore [i]) ||
+			(bAfter && (after.kind != before [i].kind ||
+						after.tuple != before [i].tuple ||
+						after.timestamp != before [i].timestamp));
+	}
+	
+	info -> bBlocked = (info -> outQueue && info -> outQueue -> isFull());
+	info -> bStuck = !bProgress;
+	
+	// The consumers of this operator might be able to progress now
+	if (bProgress) {
+		for (unsigned int c = 0 ; c < numOps ; c++)
+			for (unsigned int i = 0 ; i < ops [c].numInputs ; i++)
+				if (ops [c].inputs [i] == o)
+					ops [c].bStuck = false;
+	}
+	
+	return 0;
+}
+
+bool PriorityScheduler::isReady (const OpInfo *info) const
+{
+	if (info -> outQueue && info -> outQueue -> isFull ())
+		return false;
+	
+	if (info -> numInputs == 0 || info -> bBlocked)
+		return true;
+	
+	for (unsigned int i = 0 ; i < info -> numInputs ; i++)
+		if (!info -> inQueues [i] -> isEmpty ())
+			return true;
+	
+	return false;
+}
+
+int PriorityScheduler::stop ()
+{
+	bStop = true;
+	return 0;
+}
+
+int PriorityScheduler::resume ()
+{
+	bStop = false;
+	return 0;
+}
@@ -37,6 +37,19 @@ int RoundRobinScheduler::addOperator (Operator *op)
 	return 0;
 }
 
+int RoundRobinScheduler::addOperator (Operator *op, unsigned int fragment)
+{
+	// All fragments are run by this thread
+	return addOperator (op);
+}
+
+int RoundRobinScheduler::setQueues (Operator *op, Queue **inQueues,
+									Operator **inOps, unsigned int numInputs,
+									Queue *outQueue)
+{
+	return 0;
+}
+
 int RoundRobinScheduler::run (long long int numTimeUnits)
 {
 	int rc;
@@ -0,0 +1,263 @@
+/**
+ * @file       thread_pool.cc
+ * @date       Oct. 17, 2026
+ * @brief      Implementation of the thread pool scheduler
+ */
+
+#include <sched.h>
+#include <unistd.h>
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _THREAD_POOL_
+#include "execution/scheduler/thread_pool.h"
+#endif
+
+using namespace Execution;
+using namespace std;
+
+#define LOAD_ACQUIRE(x)     __atomic_load_n (&(x), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(x,v)  __atomic_store_n (&(x), (v), __ATOMIC_RELEASE)
+
+static const TimeSlice timeSlice = 100000;
+
+ThreadPoolScheduler::ThreadPoolScheduler (unsigned int _numThreads,
+										  ostream &_LOG)
+	: LOG (_LOG)
+{
+	ASSERT (_numThreads > 0);
+	ASSERT (_numThreads <= MAX_THREADS);
+	
+	this -> numThreads = _numThreads;
+	this -> numActive = 0;
+	this -> numTimeUnits = 0;
+	this -> bStop = false;
+	
+	for (unsigned int f = 0 ; f < numThreads ; f++) {
+		fragments [f].numOps = 0;
+		fragments [f].sched = this;
+		fragments [f].round = 0;
+		fragments [f].rc = 0;
+	}
+}
+
+ThreadPoolScheduler::~ThreadPoolScheduler () {}
+
+/**
+ * Operators added without a fragment (e.g., operators of monitor plans,
+ * which are added while the execution is interrupted) belong to fragment
+ * 0, which also runs the system stream generator.
+ */
+int ThreadPoolScheduler::addOperator (Operator *op)
+{
+	return addOperator (op, 0);
+}
+
+int ThreadPoolScheduler::addOperator (Operator *op, unsigned int fragment)
+{
+	ASSERT (op);
+	
+	if (fragment >= numThreads) {
+		LOG << "ThreadPoolScheduler: invalid fragment " << fragment << endl;
+		return -1;
+	}
+	
+	if (fragments [fragment].numOps == MAX_OPS)
+		return -1;
+	
+	if (fragments [fragment].numOps == 0)
+		numActive ++;
+	
+	fragments [fragment].ops [fragments [fragment].numOps] = op;
+	fragments [fragment].outQueues [fragments [fragment].numOps] = 0;
+	fragments [fragment].numOps ++;
+	
+	return 0;
+}
+
+int ThreadPoolScheduler::setQueues (Operator *op, Queue **inQueues,
+									Operator **inOps, unsigned int numInputs,
+									Queue *outQueue)
+{
+	for (unsigned int f = 0 ; f < numThreads ; f++) {
+		for (unsigned int o = 0 ; o < fragments [f].numOps ; o++) {
+			if (fragments [f].ops [o] == op) {
+				fragments [f].outQueues [o] = outQueue;
+				return 0;
+			}
+		}
+	}
+	
+	LOG << "ThreadPoolScheduler: unknown operator" << endl;
+	return -1;
+}
+
+int ThreadPoolScheduler::run (long long int numTimeUnits)
+{
+	int rc;
+	long ncpu;
+	cpu_set_t cpus;
+	
+	this -> numTimeUnits = numTimeUnits;
+	for (unsigned int f = 0 ; f < numThreads ; f++)
+		fragments [f].round = 0;
+	
+	// Start a worker for each nonempty fragment other than 0
+	ncpu = sysconf (_SC_NPROCESSORS_ONLN);
+	for (unsigned int f = 1 ; f < numThreads ; f++) {
+		fragments [f].rc = 0;
+		
+		if (fragments [f].numOps == 0)
+			continue;
+		
+		if (pthread_create (&fragments [f].thread, 0, worker,
+							fragments + f) != 0) {
+			LOG << "ThreadPoolScheduler: unable to create thread" << endl;
+			
+			STORE_RELEASE (bStop, true);
+			for (unsigned int g = 1 ; g < f ; g++)
+				if (fragments [g].numOps > 0)
+					pthread_join (fragments [g].thread, 0);
+			return -1;
+		}
+		
+		if (ncpu > 1) {
+			CPU_ZERO (&cpus);
+			CPU_SET (f % ncpu, &cpus);
+			pthread_setaffinity_np (fragments [f].thread, sizeof (cpus),
+									&cpus);
+		}
+	}
+	
+	// Fragment 0 runs in this thread
+	fragments [0].rc = 0;
+	if (fragments [0].numOps > 0)
+		fragments [0].rc = runFragment (fragments);
+	
+	for (unsigned int f = 1 ; f < numThreads ; f++)
+		if (fragments [f].numOps > 0)
+			pthread_join (fragments [f].thread, 0);
+	
+	for (unsigned int f = 0 ; f < numThreads ; f++)
+		if ((rc = fragments [f].rc) != 0)
+			return rc;
+	
+	// Natural termination: flush elements still in flight between
+	// fragments.
+	if (!LOAD_ACQUIRE (bStop) && numTimeUnits != 0)
+		return drain ();
+	
+	return 0;
+}
+
+void *ThreadPoolScheduler::worker (void *arg)
+{
+	Fragment *fragment = (Fragment *)arg;
+	
+	fragment -> rc = fragment -> sched -> runFragment (fragment);
+	
+	return 0;
+}
+
+/**
+ * Run the operators of a fragment in round robin order.
+ */
+int ThreadPoolScheduler::runFragment (Fragment *fragment)
+{
+	int rc;
+	
+	for (long long int t = 0 ; numTimeUnits == 0 || t < numTimeUnits ; t++) {
+		
+		if (!waitForOthers (t))
+			break;
+		
+		for (unsigned int o = 0 ; o < fragment -> numOps ; o++) {
+			if ((rc = runOp (fragment, o)) != 0) {
+				STORE_RELEASE (bStop, true);
+				return rc;
+			}
+		}
+		
+		STORE_RELEASE (fragment -> round, t + 1);
+	}
+	
+	return 0;
+}
+
+/**
+ * Run an operator, and publish its output to the thread of its
+ * consumer.
+ */
+int ThreadPoolScheduler::runOp (Fragment *fragment, unsigned int o)
+{
+	int rc;
+	
+	if ((rc = fragment -> ops [o] -> run (timeSlice)) != 0)
+		return rc;
+	
+	if (fragment -> outQueues [o])
+		fragment -> outQueues [o] -> flush ();
+	
+	return 0;
+}
+
+/**
+ * Wait until all the fragments have completed round - MAX_SKEW rounds.
+ * 
+ * @return false if the scheduler was stopped while waiting
+ */
+bool ThreadPoolScheduler::waitForOthers (long long int round)
+{
+	unsigned int f;
+	
+	while (!LOAD_ACQUIRE (bStop)) {
+		for (f = 0 ; f < numThreads ; f++) {
+			if (fragments [f].numOps > 0 &&
+				LOAD_ACQUIRE (fragments [f].round) + MAX_SKEW < round)
+				break;
+		}
+		
+		if (f == numThreads)
+			return true;
+		
+		sched_yield ();
+	}
+	
+	return false;
+}
+
+/**
+ * When all the threads have stopped, the last elements produced by a
+ * fragment can still be waiting in queues read by other fragments.  We
+ * run one round over all the operators (in this thread) per fragment
+ * boundary that the elements may have to cross.
+ */
+int ThreadPoolScheduler::drain ()
+{
+	int rc;
+	
+	for (unsigned int r = 0 ; r < numActive ; r++) {
+		for (unsigned int f = 0 ; f < numThreads ; f++) {
+			for (unsigned int o = 0 ; o < fragments [f].numOps ; o++) {
+				if ((rc = runOp (fragments + f, o)) != 0)
+					return rc;
+			}
+		}
+	}
+	
+	return 0;
+}
+
+int ThreadPoolScheduler::stop ()
+{
+	STORE_RELEASE (bStop, true);
+	return 0;
+}
+
+int ThreadPoolScheduler::resume ()
+{
+	STORE_RELEASE (bStop, false);
+	return 0;
+}
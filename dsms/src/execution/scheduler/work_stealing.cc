@@ -0,0 +1,362 @@
+/**
+ * @file       work_stealing.cc
+ * @date       Oct. 17, 2026
+ * @brief      Implementation of the work stealing scheduler
+ */
+
+#include <sched.h>
+#include <unistd.h>
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _WORK_STEALING_
+#include "execution/scheduler/work_stealing.h"
+#endif
+
+using namespace Execution;
+using namespace std;
+
+#define LOAD_ACQUIRE(x)     __atomic_load_n (&(x), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(x,v)  __atomic_store_n (&(x), (v), __ATOMIC_RELEASE)
+
+static const TimeSlice timeSlice = 100000;
+
+WorkStealingScheduler::WorkStealingScheduler (unsigned int _numThreads,
+											  ostream &_LOG)
+	: LOG (_LOG)
+{
+	ASSERT (_numThreads > 0);
+	ASSERT (_numThreads <= MAX_THREADS);
+	
+	this -> numOps = 0;
+	this -> numTasks = 0;
+	this -> numThreads = _numThreads;
+	this -> numTimeUnits = 0;
+	this -> bStop = false;
+	
+	for (unsigned int t = 0 ; t < MAX_TASKS ; t++) {
+		tasks [t].numOps = 0;
+		tasks [t].busy = 0;
+	}
+	
+	for (unsigned int w = 0 ; w < numThreads ; w++) {
+		workers [w].sched = this;
+		workers [w].id = w;
+		workers [w].round = 0;
+		workers [w].numSteals = 0;
+		workers [w].rc = 0;
+	}
+}
+
+WorkStealingScheduler::~WorkStealingScheduler () {}
+
+int WorkStealingScheduler::addOperator (Operator *op)
+{
+	return addOperator (op, 0);
+}
+
+int WorkStealingScheduler::addOperator (Operator *op, unsigned int fragment)
+{
+	Task *task;
+	
+	ASSERT (op);
+	
+	if (fragment >= MAX_TASKS) {
+		LOG << "WorkStealingScheduler: invalid fragment " << fragment
+			<< endl;
+		return -1;
+	}
+	
+	if (numOps == MAX_OPS)
+		return -1;
+	
+	// Until we know about its queues, the operator is always ready
+	ops [numOps].op = op;
+	ops [numOps].numInputs = 0;
+	ops [numOps].outQueue = 0;
+	ops [numOps].bBlocked = false;
+	
+	task = tasks + fragment;
+	task -> ops [task -> numOps ++] = numOps;
+	numOps ++;
+	
+	if (fragment >= numTasks)
+		numTasks = fragment + 1;
+	
+	return 0;
+}
+
+int WorkStealingScheduler::setQueues (Operator *op, Queue **inQueues,
+									  Operator **inOps, unsigned int numInputs,
+									  Queue *outQueue)
+{
+	unsigned int o;
+	
+	ASSERT (numInputs <= MAX_INPUTS);
+	
+	for (o = 0 ; o < numOps ; o++)
+		if (ops [o].op == op)
+			break;
+	
+	if (o == numOps) {
+		LOG << "WorkStealingScheduler: unknown operator" << endl;
+		return -1;
+	}
+	
+	for (unsigned int i = 0 ; i < numInputs ; i++) {
+		ASSERT (inQueues [i]);
+		ops [o].inQueues [i] = inQueues [i];
+	}
+	ops [o].numInputs = numInputs;
+	ops [o].outQueue = outQueue;
+	
+	return 0;
+}
+
+int WorkStealingScheduler::run (long long int numTimeUnits)
+{
+	int rc;
+	long ncpu;
+	cpu_set_t cpus;
+	unsigned long long int numSteals;
+	
+	this -> numTimeUnits = numTimeUnits;
+	for (unsigned int w = 0 ; w < numThreads ; w++) {
+		workers [w].round = 0;
+		workers [w].rc = 0;
+	}
+	
+	// Workers other than 0 run in their own threads
+	ncpu = sysconf (_SC_NPROCESSORS_ONLN);
+	for (unsigned int w = 1 ; w < numThreads ; w++) {
+		if (pthread_create (&workers [w].thread, 0, worker,
+							workers + w) != 0) {
+			LOG << "WorkStealingScheduler: unable to create thread" << endl;
+			
+			STORE_RELEASE (bStop, true);
+			for (unsigned int v = 1 ; v < w ; v++)
+				pthread_join (workers [v].thread, 0);
+			return -1;
+		}
+		
+		if (ncpu > 1) {
+			CPU_ZERO (&cpus);
+			CPU_SET (w % ncpu, &cpus);
+			pthread_setaffinity_np (workers [w].thread, sizeof (cpus),
+									&cpus);
+		}
+	}
+	
+	workers [0].rc = runWorker (workers);
+	
+	for (unsigned int w = 1 ; w < numThreads ; w++)
+		pthread_join (workers [w].thread, 0);
+	
+	for (unsigned int w = 0 ; w < numThreads ; w++)
+		if ((rc = workers [w].rc) != 0)
+			return rc;
+	
+	if (numThreads > 1) {
+		numSteals = 0;
+		for (unsigned int w = 0 ; w < numThreads ; w++)
+			numSteals += workers [w].numSteals;
+		LOG << "WorkStealingScheduler: " << numSteals << " tasks stolen"
+			<< endl;
+	}
+	
+	// Natural termination: process the elements still in the queues
+	if (!LOAD_ACQUIRE (bStop) && numTimeUnits != 0)
+		return drain ();
+	
+	return 0;
+}
+
+void *WorkStealingScheduler::worker (void *arg)
+{
+	Worker *worker = (Worker *)arg;
+	
+	worker -> rc = worker -> sched -> runWorker (worker);
+	
+	return 0;
+}
+
+/**
+ * In each round, a worker runs its own tasks.  If none of them had
+ * anything to do, it looks at the tasks of the other workers, and runs
+ * the first one that is ready.
+ */
+int WorkStealingScheduler::runWorker (Worker *worker)
+{
+	int rc;
+	bool bRun, bWork;
+	unsigned int t;
+	
+	for (long long int r = 0 ; numTimeUnits == 0 || r < numTimeUnits ; r++) {
+		
+		if (!waitForOthers (r))
+			break;
+		
+		bWork = false;
+		for (t = worker -> id ; t < numTasks ; t += numThreads) {
+			if ((rc = runTask (tasks + t, bRun)) != 0) {
+				STORE_RELEASE (bStop, true);
+				return rc;
+			}
+			bWork = bWork || bRun;
+		}
+		
+		for (unsigned int s = 1 ; s < numTasks && !bWork ; s++) {
+			t = (worker -> id + s) % numTasks;
+			if (t % numThreads == worker -> id)
+				continue;
+			
+			if ((rc = runTask (tasks + t, bRun)) != 0) {
+				STORE_RELEASE (bStop, true);
+				return rc;
+			}
+			
+			if (bRun) {
+				worker -> numSteals ++;
+				bWork = true;
+			}
+		}
+		
+		if (!bWork)
+			sched_yield ();
+		
+		STORE_RELEASE (worker -> round, r + 1);
+	}
+	
+	return 0;
+}
+
+/**
+ * Run the ready operators of a task, unless the task is being run by
+ * some other worker.
+ *
+ * @param task     task to run
+ * @param bRun     (output) true if some operator was run
+ */
+int WorkStealingScheduler::runTask (Task *task, bool &bRun)
+{
+	int rc;
+	OpInfo *info;
+	
+	bRun = false;
+	
+	if (!__sync_bool_compare_and_swap (&task -> busy, 0, 1))
+		return 0;
+	
+	for (unsigned int o = 0 ; o < task -> numOps ; o++) {
+		info = ops + task -> ops [o];
+		
+		if (!isReady (info))
+			continue;
+		
+		if ((rc = info -> op -> run (timeSlice)) != 0) {
+			__sync_lock_release (&task -> busy);
+			return rc;
+		}
+		
+		// Publish the output before another thread can run the task
+		if (info -> outQueue)
+			info -> outQueue -> flush ();
+		
+		info -> bBlocked = (info -> outQueue && info -> outQueue -> isFull());
+		bRun = true;
+	}
+	
+	__sync_lock_release (&task -> busy);
+	
+	return 0;
+}
+
+/**
+ * An operator blocked at its output queue can hold a stalled element or
+ * owe a heartbeat, so it has work to do as soon as the queue has room,
+ * even if its inputs are empty.
+ */
+bool WorkStealingScheduler::isReady (const OpInfo *info) const
+{
+	if (info -> outQueue && info -> outQueue -> isFull ())
+		return false;
+	
+	if (info -> numInputs == 0 || info -> bBlocked)
+		return true;
+	
+	for (unsigned int i = 0 ; i < info -> numInputs ; i++)
+		if (!info -> inQueues [i] -> isEmpty ())
+			return true;
+	
+	return false;
+}
+
+/**
+ * @return true if some operator other than a source is ready
+ */
+bool WorkStealingScheduler::hasInput () const
+{
+	for (unsigned int o = 0 ; o < numOps ; o++)
+		if (ops [o].numInputs > 0 && isReady (ops + o))
+			return true;
+	
+	return false;
+}
+
+/**
+ * Wait until all the workers have completed round - MAX_SKEW rounds.
+ * 
+ * @return false if the scheduler was stopped while waiting
+ */
+bool WorkStealingScheduler::waitForOthers (long long int round)
+{
+	unsigned int w;
+	
+	while (!LOAD_ACQUIRE (bStop)) {
+		for (w = 0 ; w < numThreads ; w++)
+			if (LOAD_ACQUIRE (workers [w].round) + MAX_SKEW < round)
+				break;
+		
+		if (w == numThreads)
+			return true;
+		
+		sched_yield ();
+	}
+	
+	return false;
+}
+
+/**
+ * Run (in this thread) the operators that have elements in their input
+ * queues, until there are none.  Operators that cannot consume their
+ * input (e.g., a join waiting for its other input) can keep elements in
+ * the queues, so we give up after MAX_DRAIN_ROUNDS rounds.
+ */
+int WorkStealingScheduler::drain ()
+{
+	int rc;
+	bool bRun;
+	
+	for (unsigned int r = 0 ; r < MAX_DRAIN_ROUNDS && hasInput () ; r++) {
+		for (unsigned int t = 0 ; t < numTasks ; t++) {
+			if ((rc = runTask (tasks + t, bRun)) != 0)
+				return rc;
+		}
+	}
+	
+	return 0;
+}
+
+int WorkStealingScheduler::stop ()
+{
+	STORE_RELEASE (bStop, true);
+	return 0;
+}
+
+int WorkStealingScheduler::resume ()
+{
+	STORE_RELEASE (bStop, false);
+	return 0;
+}
@@ -21,6 +21,9 @@ using namespace std;
 
 #define ID(t) ((memMgr -> getId (t)))
 
+#define SET_ID(t,l,id) (ICOL(t, linCols[l]) = (int)(id),\
+						ICOL(t, linHiCols[l]) = (int)((id) >> 32))
+
 LinStoreImpl::LinStoreImpl(unsigned int _id,
 						   ostream& _LOG)
 	: LOG (_LOG)
@@ -94,11 +97,12 @@ int LinStoreImpl::setIndex (Index *index)
 	return 0;
 }
 
-int LinStoreImpl::addLineage (Column col)
+int LinStoreImpl::addLineage (Column col, Column hiCol)
 {
 	ASSERT (numLins < MAX_LINEAGE);
 	
-	linCols [numLins++] = col;
+	linCols [numLins] = col;
+	linHiCols [numLins++] = hiCol;
 	return 0;
 }
 
@@ -251,7 +255,7 @@ int LinStoreImpl::insertTuple_l (Tuple tuple, Tuple *lineage,
 	// Store the lineage
 	for (unsigned int l = 0 ; l < numLins ; l++) {
 		ASSERT (lineage [l]);
-		ICOL (tuple, linCols [l]) = ID(lineage[l]);
+		SET_ID (tuple, l, ID(lineage[l]));
 	}
 	
 	return linIndex -> insertTuple (tuple);
@@ -340,7 +344,7 @@ int LinStoreImpl::getTuple_l (Tuple *lineage, Tuple &tuple,
 	for (unsigned int l = 0 ; l < numLins ; l++) {
 		ASSERT (lineage [l]);
 		
-		ICOL (linTuple, linCols [l]) = ID(lineage[l]);
+		SET_ID (linTuple, l, ID(lineage[l]));
 	}
 	
 	// Assert: linTuple already bound to evalContext
@@ -26,6 +26,7 @@ SimpleStore::SimpleStore(unsigned int _id, ostream& _LOG)
 	this -> firstTupleOffset  = 0;
 	this -> nextTuple         = 0;
 	this -> numAllocInCurPage = 0;
+	this -> bConcurrent       = false;
 }
 
 SimpleStore::~SimpleStore() {}
@@ -46,6 +47,12 @@ int SimpleStore::setTupleLen (unsigned int tupleLen)
 	return 0;
 }
 
+int SimpleStore::setConcurrent (bool bConcurrent)
+{
+	this -> bConcurrent = bConcurrent;
+	return 0;
+}
+
 int SimpleStore::initialize()
 {
 	int rc;
@@ -73,11 +80,28 @@ int SimpleStore::newTuple(Tuple& tuple)
 	ASSERT (COUNT (curPage) > 0);
 	
 	tuple = nextTuple;
-	COUNT (curPage)++;	
+	
+	if (bConcurrent)
+		__sync_add_and_fetch (&COUNT (curPage), 1);
+	else
+		COUNT (curPage)++;	
 	
 	if (++numAllocInCurPage == numTuplesPerPage) {				
-		// Corresponding to COUNT(curPage) = 1 in allocateNewPage
-		COUNT (curPage)--;
+		// Corresponding to COUNT(curPage) = 1 in allocateNewPage.  Other
+		// threads might have released all the tuples of the page by
+		// now, in which case we free it.
+		if (bConcurrent) {
+			if (__sync_sub_and_fetch (&COUNT (curPage), 1) == 0) {
+#ifdef _MONITOR_
+				logPageFree ();
+#endif
+				if ((rc = memMgr -> deallocatePage (curPage)) != 0)
+					return rc;
+			}
+		}
+		else {
+			COUNT (curPage)--;
+		}
 		
 		if ((rc = allocateNewPage()) != 0) {
 			return rc;
@@ -94,7 +118,11 @@ int SimpleStore::newTuple(Tuple& tuple)
 int SimpleStore::addRef (Tuple tuple)
 {	
 	ASSERT (COUNT (memMgr -> getPage (tuple)) > 0);
-	COUNT (memMgr -> getPage (tuple))++;
+	
+	if (bConcurrent)
+		__sync_add_and_fetch (&COUNT (memMgr -> getPage (tuple)), 1);
+	else
+		COUNT (memMgr -> getPage (tuple))++;
 	
 	return 0;
 }
@@ -102,14 +130,26 @@ int SimpleStore::addRef (Tuple tuple)
 int SimpleStore::addRef (Tuple tuple, unsigned int ref)
 {
 	ASSERT (COUNT (memMgr -> getPage (tuple)) > 0);
-	COUNT (memMgr -> getPage (tuple)) += ref;
+	
+	if (bConcurrent)
+		__sync_add_and_fetch (&COUNT (memMgr -> getPage (tuple)), ref);
+	else
+		COUNT (memMgr -> getPage (tuple)) += ref;
 	return 0;
 }
 
 int SimpleStore::decrRef (Tuple tuple)
 {
+	int count;
+	
 	ASSERT (COUNT (memMgr -> getPage (tuple)) > 0);
-	if (--COUNT (memMgr -> getPage (tuple)) == 0) {
+	
+	if (bConcurrent)
+		count = __sync_sub_and_fetch (&COUNT (memMgr -> getPage (tuple)), 1);
+	else
+		count = --COUNT (memMgr -> getPage (tuple));
+	
+	if (count == 0) {
 		
 #ifdef _MONITOR_
 		logPageFree ();
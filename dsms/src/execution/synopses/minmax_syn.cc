@@ -0,0 +1,252 @@
+/**
+ * @file       minmax_syn.cc
+ * @date       Oct. 17, 2026
+ * @brief      Monotonic deques for MAX / MIN aggregation over windows
+ */
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _MINMAX_SYN_
+#include "execution/synopses/minmax_syn.h"
+#endif
+
+using namespace Execution;
+
+MinMaxSynopsis::MinMaxSynopsis (unsigned int _id, std::ostream &_LOG)
+	: LOG (_LOG)
+{
+	this -> id          = _id;
+	this -> memMgr      = 0;
+	this -> numAggrs    = 0;
+	this -> freeNodes   = 0;
+	this -> freeHeaders = 0;
+}
+
+MinMaxSynopsis::~MinMaxSynopsis () {}
+
+int MinMaxSynopsis::setMemoryManager (MemoryManager *memMgr)
+{
+	ASSERT (memMgr);
+	
+	this -> memMgr = memMgr;
+	return 0;
+}
+
+int MinMaxSynopsis::addAggr (Type type, Column inCol, Column outCol,
+							 bool bMax)
+{
+	ASSERT (type == INT || type == FLOAT);
+	
+	if (numAggrs >= MAX_AGGRS) {
+		LOG << "MinMaxSynopsis: too many aggregates" << std::endl;
+		return -1;
+	}
+	
+	aggrs [numAggrs].type   = type;
+	aggrs [numAggrs].inCol  = inCol;
+	aggrs [numAggrs].outCol = outCol;
+	aggrs [numAggrs].bMax   = bMax;
+	numAggrs ++;
+	
+	return 0;
+}
+
+int MinMaxSynopsis::initialize ()
+{
+	ASSERT (memMgr);
+	ASSERT (numAggrs > 0);
+	
+	if (memMgr -> getPageSize () < numAggrs * sizeof (Node)) {
+		LOG << "MinMaxSynopsis: page size too small" << std::endl;
+		return -1;
+	}
+	
+	return 0;
+}
+
+int MinMaxSynopsis::newGroup (char *&group)
+{
+	int rc;
+	Node *header;
+	
+	if ((rc = allocHeader (header)) != 0)
+		return rc;
+	
+	for (unsigned int a = 0 ; a < numAggrs ; a++)
+		header [a].prev = header [a].next = header + a;
+	
+	group = (char *)header;
+	return 0;
+}
+
+int MinMaxSynopsis::deleteGroup (char *group)
+{
+	Node *header, *node;
+	
+	header = (Node *)group;
+	
+	for (unsigned int a = 0 ; a < numAggrs ; a++) {
+		while (header [a].next != header + a) {
+			node = header [a].next;
+			header [a].next = node -> next;
+			
+			node -> next = freeNodes;
+			freeNodes = node;
+		}
+	}
+	
+	header -> next = freeHeaders;
+	freeHeaders = header;
+	
+	return 0;
+}
+
+int MinMaxSynopsis::insertTuple (char *group, Tuple tuple)
+{
+	int rc;
+	Node *header, *node, *back;
+	
+	header = (Node *)group;
+	
+	for (unsigned int a = 0 ; a < numAggrs ; a++) {
+		if ((rc = allocNode (node)) != 0)
+			return rc;
+		
+		node -> tuple = tuple;
+		if (aggrs [a].type == INT)
+			node -> val.ival = ICOL (tuple, aggrs [a].inCol);
+		else
+			node -> val.fval = FCOL (tuple, aggrs [a].inCol);
+		
+		// Tuples that the new one matches or beats can never be the
+		// aggregate again
+		back = header [a].prev;
+		while (back != header + a && dominates (a, node, back)) {
+			header [a].prev = back -> prev;
+			
+			back -> next = freeNodes;
+			freeNodes = back;
+			
+			back = header [a].prev;
+		}
+		
+		node -> prev = back;
+		node -> next = header + a;
+		back -> next = node;
+		header [a].prev = node;
+	}
+	
+	return 0;
+}
+
+int MinMaxSynopsis::deleteTuple (char *group, Tuple tuple)
+{
+	Node *header, *front;
+	
+	header = (Node *)group;
+	
+	for (unsigned int a = 0 ; a < numAggrs ; a++) {
+		front = header [a].next;
+		
+		// The tuple was dropped by a newer one when it was inserted
+		if (front == header + a || front -> tuple != tuple)
+			continue;
+		
+		header [a].next = front -> next;
+		front -> next -> prev = header + a;
+		
+		front -> next = freeNodes;
+		freeNodes = front;
+	}
+	
+	return 0;
+}
+
+int MinMaxSynopsis::copyExtremes (char *group, Tuple aggrTuple) const
+{
+	Node *header, *front;
+	
+	header = (Node *)group;
+	
+	for (unsigned int a = 0 ; a < numAggrs ; a++) {
+		front = header [a].next;
+		ASSERT (front != header + a);
+		
+		if (aggrs [a].type == INT)
+			ICOL (aggrTuple, aggrs [a].outCol) = front -> val.ival;
+		else
+			FCOL (aggrTuple, aggrs [a].outCol) = front -> val.fval;
+	}
+	
+	return 0;
+}
+
+bool MinMaxSynopsis::dominates (unsigned int a, Node *node1,
+								Node *node2) const
+{
+	if (aggrs [a].type == INT) {
+		if (aggrs [a].bMax)
+			return (node1 -> val.ival >= node2 -> val.ival);
+		return (node1 -> val.ival <= node2 -> val.ival);
+	}
+	
+	if (aggrs [a].bMax)
+		return (node1 -> val.fval >= node2 -> val.fval);
+	return (node1 -> val.fval <= node2 -> val.fval);
+}
+
+int MinMaxSynopsis::allocNode (Node *&node)
+{
+	int rc;
+	
+	if (!freeNodes && (rc = allocPage (freeNodes, sizeof (Node))) != 0)
+		return rc;
+	
+	node = freeNodes;
+	freeNodes = node -> next;
+	
+	return 0;
+}
+
+int MinMaxSynopsis::allocHeader (Node *&header)
+{
+	int rc;
+	
+	if (!freeHeaders &&
+		(rc = allocPage (freeHeaders, numAggrs * sizeof (Node))) != 0)
+		return rc;
+	
+	header = freeHeaders;
+	freeHeaders = header -> next;
+	
+	return 0;
+}
+
+/**
+ * Carve a new page into units of unitSize bytes, and put them in the
+ * free list.  Pages are not returned to the memory manager: like the
+ * stores, we keep them for reuse.
+ */
+int MinMaxSynopsis::allocPage (Node *&freeList, unsigned int unitSize)
+{
+	int rc;
+	char *page;
+	Node *unit;
+	unsigned int numUnits;
+	
+	if ((rc = memMgr -> allocatePage (page)) != 0)
+		return rc;
+	
+	numUnits = memMgr -> getPageSize () / unitSize;
+	ASSERT (numUnits > 0);
+	
+	for (unsigned int u = 0 ; u < numUnits ; u++) {
+		unit = (Node *)(page + u * unitSize);
+		unit -> next = freeList;
+		freeList = unit;
+	}
+	
+	return 0;
+}
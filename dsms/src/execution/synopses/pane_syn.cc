@@ -0,0 +1,310 @@
+/**
+ * @file       pane_syn.cc
+ * @date       Oct. 17, 2026
+ * @brief      Per-pane partial aggregates for sliding window aggregation
+ */
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _PANE_SYN_
+#include "execution/synopses/pane_syn.h"
+#endif
+
+#include <string.h>
+
+using namespace Execution;
+
+PaneSynopsis::PaneSynopsis (unsigned int _id, std::ostream &_LOG)
+	: LOG (_LOG)
+{
+	this -> id          = _id;
+	this -> memMgr      = 0;
+	this -> evalContext = 0;
+	this -> initEval    = 0;
+	this -> updateEval  = 0;
+	this -> combineEval = 0;
+	this -> tupleLen    = 0;
+	this -> alignedLen  = 0;
+	this -> paneSize    = 0;
+	this -> groupSize   = 0;
+	this -> groups      = 0;
+	this -> freePanes   = 0;
+	this -> freeGroups  = 0;
+}
+
+PaneSynopsis::~PaneSynopsis ()
+{
+	if (combineEval)
+		delete combineEval;
+}
+
+int PaneSynopsis::setMemoryManager (MemoryManager *memMgr)
+{
+	ASSERT (memMgr);
+	
+	this -> memMgr = memMgr;
+	return 0;
+}
+
+int PaneSynopsis::setEvalContext (EvalContext *evalContext)
+{
+	ASSERT (evalContext);
+	
+	this -> evalContext = evalContext;
+	return 0;
+}
+
+int PaneSynopsis::setEvaluators (AEval *initEval, AEval *updateEval,
+								 AEval *combineEval)
+{
+	ASSERT (initEval);
+	ASSERT (updateEval);
+	ASSERT (combineEval);
+	
+	this -> initEval    = initEval;
+	this -> updateEval  = updateEval;
+	this -> combineEval = combineEval;
+	return 0;
+}
+
+int PaneSynopsis::setTupleLen (unsigned int tupleLen)
+{
+	ASSERT (tupleLen > 0);
+	
+	this -> tupleLen = tupleLen;
+	this -> alignedLen = align (tupleLen);
+	return 0;
+}
+
+int PaneSynopsis::initialize ()
+{
+	ASSERT (memMgr);
+	ASSERT (evalContext);
+	ASSERT (combineEval);
+	ASSERT (tupleLen > 0);
+	
+	paneSize  = align (sizeof (Pane)) + 2 * alignedLen;
+	groupSize = align (sizeof (Group)) + alignedLen;
+	
+	if (memMgr -> getPageSize () < paneSize) {
+		LOG << "PaneSynopsis: page size too small" << std::endl;
+		return -1;
+	}
+	
+	return 0;
+}
+
+int PaneSynopsis::newGroup (char *&group)
+{
+	int rc;
+	Group *g;
+	
+	if ((rc = allocUnit (freeGroups, groupSize, group)) != 0)
+		return rc;
+	
+	g = (Group *)group;
+	g -> aggrTuple = 0;
+	g -> oldest = g -> newest = g -> back = 0;
+	
+	g -> prev = 0;
+	g -> next = groups;
+	if (groups)
+		groups -> prev = g;
+	groups = g;
+	
+	return 0;
+}
+
+int PaneSynopsis::deleteGroup (char *group)
+{
+	Group *g;
+	Pane *pane;
+	
+	g = (Group *)group;
+	
+	while ((pane = g -> oldest) != 0) {
+		g -> oldest = pane -> next;
+		freeUnit (freePanes, (char *)pane);
+	}
+	
+	if (g -> prev)
+		g -> prev -> next = g -> next;
+	else
+		groups = g -> next;
+	
+	if (g -> next)
+		g -> next -> prev = g -> prev;
+	
+	freeUnit (freeGroups, group);
+	
+	return 0;
+}
+
+int PaneSynopsis::insertTuple (char *group, unsigned int paneNo,
+							   Tuple tuple)
+{
+	int rc;
+	Group *g;
+	Pane *pane;
+	char *unit;
+	
+	g = (Group *)group;
+	
+	evalContext -> bind (tuple, INPUT_ROLE);
+	
+	// Another tuple of the newest pane
+	if (g -> newest && g -> newest -> paneNo == paneNo) {
+		evalContext -> bind (getPartial (g -> newest), NEW_OUTPUT_ROLE);
+		updateEval -> eval ();
+		
+		evalContext -> bind (getBackAggr (g), NEW_OUTPUT_ROLE);
+		updateEval -> eval ();
+		
+		return 0;
+	}
+	
+	ASSERT (!g -> newest || g -> newest -> paneNo < paneNo);
+	
+	// A new pane
+	if ((rc = allocUnit (freePanes, paneSize, unit)) != 0)
+		return rc;
+	
+	pane = (Pane *)unit;
+	pane -> paneNo = paneNo;
+	
+	evalContext -> bind (getPartial (pane), NEW_OUTPUT_ROLE);
+	initEval -> eval ();
+	
+	pane -> prev = g -> newest;
+	pane -> next = 0;
+	if (g -> newest)
+		g -> newest -> next = pane;
+	else
+		g -> oldest = pane;
+	g -> newest = pane;
+	
+	// ... which joins the back
+	if (!g -> back) {
+		g -> back = pane;
+		memcpy (getBackAggr (g), getPartial (pane), tupleLen);
+	}
+	else {
+		evalContext -> bind (getBackAggr (g), NEW_OUTPUT_ROLE);
+		updateEval -> eval ();
+	}
+	
+	return 0;
+}
+
+int PaneSynopsis::expirePanes (char *group, unsigned int firstPane,
+							   bool &bEmpty)
+{
+	Group *g;
+	Pane *pane;
+	
+	g = (Group *)group;
+	
+	while (g -> oldest && g -> oldest -> paneNo < firstPane) {
+		
+		// The front is empty
+		if (g -> oldest == g -> back)
+			flip (g);
+		
+		pane = g -> oldest;
+		
+		g -> oldest = pane -> next;
+		if (g -> oldest)
+			g -> oldest -> prev = 0;
+		else
+			g -> newest = 0;
+		
+		// The newest pane expired too
+		if (g -> back == pane)
+			g -> back = 0;
+		
+		freeUnit (freePanes, (char *)pane);
+	}
+	
+	bEmpty = (g -> oldest == 0);
+	return 0;
+}
+
+int PaneSynopsis::getAggregate (char *group, Tuple aggrTuple)
+{
+	Group *g;
+	
+	g = (Group *)group;
+	
+	ASSERT (g -> oldest);
+	
+	if (g -> oldest != g -> back)
+		combine (getSuffix (g -> oldest), getBackAggr (g), aggrTuple);
+	else
+		memcpy (aggrTuple, getBackAggr (g), tupleLen);
+	
+	return 0;
+}
+
+void PaneSynopsis::flip (Group *group)
+{
+	Pane *pane;
+	
+	ASSERT (group -> oldest == group -> back);
+	
+	if (group -> back == group -> newest)
+		return;
+	
+	pane = group -> newest -> prev;
+	memcpy (getSuffix (pane), getPartial (pane), tupleLen);
+	
+	for (pane = pane -> prev ; pane ; pane = pane -> prev)
+		combine (getPartial (pane), getSuffix (pane -> next),
+				 getSuffix (pane));
+	
+	group -> back = group -> newest;
+	memcpy (getBackAggr (group), getPartial (group -> newest), tupleLen);
+}
+
+void PaneSynopsis::combine (char *left, char *right, char *dest)
+{
+	evalContext -> bind (left, OLD_OUTPUT_ROLE);
+	evalContext -> bind (right, PANE_ROLE);
+	evalContext -> bind (dest, NEW_OUTPUT_ROLE);
+	combineEval -> eval ();
+}
+
+/**
+ * Get a unit of unitSize bytes, carving a new page into units if there
+ * are no free ones.  Like the stores, we keep our pages for reuse.
+ */
+int PaneSynopsis::allocUnit (char *&freeList, unsigned int unitSize,
+							 char *&unit)
+{
+	int rc;
+	char *page;
+	unsigned int numUnits;
+	
+	if (!freeList) {
+		if ((rc = memMgr -> allocatePage (page)) != 0)
+			return rc;
+		
+		numUnits = memMgr -> getPageSize () / unitSize;
+		ASSERT (numUnits > 0);
+		
+		for (unsigned int u = 0 ; u < numUnits ; u++)
+			freeUnit (freeList, page + u * unitSize);
+	}
+	
+	unit = freeList;
+	freeList = *(char **)unit;
+	
+	return 0;
+}
+
+void PaneSynopsis::freeUnit (char *&freeList, char *unit)
+{
+	*(char **)unit = freeList;
+	freeList = unit;
+}
@@ -133,39 +133,64 @@ int RelationSynopsisImpl::getScan (unsigned int scanId, TupleIterator *&iter)
 		if ((rc = scans [scanId].index -> getScan (indexIter)) != 0)
 			return rc;
 		
-		if (scans [scanId].predicate) {
-			ASSERT (filterIters [scanId]);
-
-			rc = filterIters [scanId] -> initialize (indexIter);
-			if (rc != 0) return rc;
-			
-			iter = filterIters [scanId];
-
-			sourceIters [scanId] = indexIter;
-		}
-		else {			
-			iter = indexIter;
-		}		
+		return filterScan (scanId, indexIter, iter);
 	}
 	
 	else {
 		if ((rc = store -> getScan_r (fullIter, stubId)) != 0)
 			return rc;
 		
-		if (scans [scanId].predicate) {
-			ASSERT (filterIters [scanId]);
-			
-			rc = filterIters [scanId] -> initialize (fullIter);
-			if (rc != 0) return rc;
-			
-			iter = filterIters [scanId];
-
-			sourceIters [scanId] = fullIter;
-		}
+		return filterScan (scanId, fullIter, iter);
+	}
+}
+
+int RelationSynopsisImpl::prefetchScan (unsigned int scanId, Hash &hint)
+{
+	ASSERT (scanId < numScans);
+	
+	if (scans [scanId].index)
+		return scans [scanId].index -> prefetchScan (hint);
+	
+	hint = 0;
+	return 0;
+}
+
+int RelationSynopsisImpl::getScan (unsigned int scanId, Hash hint,
+								   TupleIterator *&iter)
+{
+	int rc;
+	TupleIterator *indexIter;
+	
+	ASSERT (scanId < numScans);
+	
+	if (!scans [scanId].index)
+		return getScan (scanId, iter);
+	
+	if ((rc = scans [scanId].index -> getScan (hint, indexIter)) != 0)
+		return rc;
+	
+	return filterScan (scanId, indexIter, iter);
+}
+
+int RelationSynopsisImpl::filterScan (unsigned int scanId,
+									  TupleIterator *source,
+									  TupleIterator *&iter)
+{
+	int rc;
+	
+	if (scans [scanId].predicate) {
+		ASSERT (filterIters [scanId]);
 		
-		else {
-			iter = fullIter;
-		}
+		rc = filterIters [scanId] -> initialize (source);
+		if (rc != 0) return rc;
+		
+		iter = filterIters [scanId];
+		
+		sourceIters [scanId] = source;
+	}
+	
+	else {
+		iter = source;
 	}
 	
 	return 0;
@@ -78,7 +78,12 @@ int PlanManagerImpl::genPhysicalPlan(Logical::Operator *logPlan,
 		
 	case Logical::LO_CROSS:
 		
-		// Currently we expect all joins in logical plans to be binary
+		// A join of a few inputs left by LogPlanGen::t_makeCrossBinary
+		if (l_rootOp -> numInputs > 2 &&
+			l_rootOp -> numInputs <= MAX_IN_BRANCHING)
+			return mk_mjoin (logPlan, p_childPlans, phyPlan);
+		
+		// Otherwise we expect all joins in logical plans to be binary
 		if (l_rootOp -> numInputs != 2) {
 			LOG << "PlanMgr: invalid logical plan with multiway joins"
 				<< endl;
@@ -655,6 +660,64 @@ int PlanManagerImpl::mk_join (Logical::Operator *logPlan,
 	return 0;
 }
 
+int PlanManagerImpl::mk_mjoin (Logical::Operator *logPlan,
+							   Physical::Operator **phyChildPlans,
+							   Physical::Operator *&phyPlan)
+{
+	int rc;
+	Physical::Operator *join;
+	
+	ASSERT (logPlan);
+	ASSERT (logPlan -> numInputs > 2);
+	ASSERT (logPlan -> numInputs <= MAX_IN_BRANCHING);
+	ASSERT (logPlan -> kind == Logical::LO_CROSS);
+	
+	// new operator
+	join = new_op (Physical::PO_MJOIN);
+	if (!join) {
+		LOG << "PlanManager: no space for operators" << endl;
+		return -1;
+	}
+	
+	join -> store = 0;
+	join -> instOp = 0;
+	join -> u.MJOIN.joinSyn = 0;
+	
+	// schema = concatenation of schemas of the inputs
+	join -> numAttrs = 0;
+	
+	// output is a stream iff all inputs are streams
+	join -> bStream = true;
+	
+	// outputs:
+	join -> numOutputs = 0;
+	
+	// inputs:
+	join -> numInputs = logPlan -> numInputs;
+	
+	for (unsigned int i = 0 ; i < join -> numInputs ; i++) {
+		if ((rc = append_schema (join, phyChildPlans [i])) != 0)
+			return rc;
+		
+		join -> u.MJOIN.numInputAttrs [i] = phyChildPlans [i] -> numAttrs;
+		join -> u.MJOIN.inSyns [i] = 0;
+		
+		if (!phyChildPlans [i] -> bStream)
+			join -> bStream = false;
+		
+		join -> inputs [i] = phyChildPlans [i];
+		if ((rc = addOutput (phyChildPlans [i], join)) != 0)
+			return rc;
+	}
+	
+	// join predicate: merged from the selects above (mergeSelects)
+	join -> u.MJOIN.pred = 0;
+	
+	phyPlan = join;
+	
+	return 0;
+}
+
 int PlanManagerImpl::mk_str_join (Logical::Operator *logPlan,
 								  Physical::Operator **phyChildPlans,
 								  Physical::Operator *&phyPlan)
@@ -820,7 +883,11 @@ int PlanManagerImpl::mk_group_aggr (Logical::Operator *logPlan,
 
 	// outputs:
 	gaOp -> numOutputs = 0;
-
+	
+	// The operator evaluates a sliding window on its input itself
+	if ((rc = fold_slide_win (gaOp, phyChildPlans [0])) != 0)
+		return rc;
+	
 	// input:
 	gaOp -> numInputs = 1;
 	gaOp -> inputs [0] = phyChildPlans [0];
@@ -833,6 +900,52 @@ int PlanManagerImpl::mk_group_aggr (Logical::Operator *logPlan,
 	return 0;
 }
 
+/**
+ * A range window with a slide changes only a slide at a time: tuples
+ * expire a pane (a slide's worth of input) at a time.  If such a window
+ * is right below the aggregation, we remove it and let the aggregation
+ * maintain the panes itself.  The aggregation then updates each group
+ * once when a pane expires, instead of once per expired tuple.
+ *
+ * The window should have been created for this aggregation alone, and
+ * it should see the same timestamps as the aggregation: when to slide
+ * depends on them.  A slide larger than the range leaves gaps between
+ * windows, which we do not handle.
+ */
+int PlanManagerImpl::fold_slide_win (Operator *gaOp, Operator *&input)
+{
+	Operator *source;
+	unsigned int o;
+	
+	gaOp -> u.GROUP_AGGR.timeUnits = 0;
+	gaOp -> u.GROUP_AGGR.slideUnits = 0;
+	
+	if (input -> kind != PO_RANGE_WIN ||
+		input -> numOutputs != 0 ||
+		input -> u.RANGE_WIN.slideUnits == 0 ||
+		input -> u.RANGE_WIN.slideUnits > input -> u.RANGE_WIN.timeUnits)
+		return 0;
+	
+	source = input -> inputs [0];
+	
+	for (o = 0 ; o < source -> numOutputs ; o++)
+		if (source -> outputs [o] == input)
+			break;
+	ASSERT (o < source -> numOutputs);
+	
+	for ( ; o + 1 < source -> numOutputs ; o++)
+		source -> outputs [o] = source -> outputs [o + 1];
+	source -> numOutputs --;
+	
+	gaOp -> u.GROUP_AGGR.timeUnits = input -> u.RANGE_WIN.timeUnits;
+	gaOp -> u.GROUP_AGGR.slideUnits = input -> u.RANGE_WIN.slideUnits;
+	
+	free_op (input);
+	input = source;
+	
+	return 0;
+}
+
 int PlanManagerImpl::mk_distinct (Logical::Operator *logPlan,
 								  Physical::Operator **phyChildPlans,
 								  Physical::Operator *&phyPlan)
@@ -1471,6 +1584,7 @@ Operator *PlanManagerImpl::new_op (OperatorKind kind)
 	op -> numOutputs = 0;
 	op -> numInputs = 0;	
 	op -> instOp = 0;
+	op -> fragment = 0;
 	
 	return op;
 }
@@ -115,7 +115,7 @@ int PlanManagerImpl::getXMLPlan (char *planBuf, unsigned int planBufLen)
 }
 
 /**
- * Map operator kind to an integer between 0 .. 16 to help us access
+ * Map operator kind to an integer between 0 .. 19 to help us access
  * information about operators in a more systematic way
  */ 
 static int opKindToInt (OperatorKind kind)
@@ -184,6 +184,9 @@ static int opKindToInt (OperatorKind kind)
 	case PO_SS_GEN:
 		return 18;
 		
+	case PO_MJOIN:
+		return 19;
+		
 	default:
 		ASSERT (0);
 		break;
@@ -214,7 +217,8 @@ static const char *opNamesShort[] = {
 	"RelSrc",            // 15
 	"Output",            // 16
 	"Sink",              // 17
-	"SSGen"              // 18
+	"SSGen",             // 18
+	"MJoin"              // 19
 };
 
 /**
@@ -239,7 +243,8 @@ static const char *opNamesLong[] = {
 	"Relation Source",          // 15
 	"Output",                   // 16
 	"Sink",                     // 17
-	"System Stream Generator"   // 18
+	"System Stream Generator",  // 18
+	"Multi-way Join"            // 19
 };
 
 static BufOut& operator << (BufOut& bout, AggrFn fn)
@@ -343,6 +348,13 @@ static BufOut& operator << (BufOut& bout, Operator *op)
 		
 		break;
 		
+	case PO_MJOIN:
+		bout << "<property name = \"Join Predicate\" value = \""
+			 << op -> u.MJOIN.pred
+			 << "\"/>\n";		
+		
+		break;
+		
 	case PO_JOIN_PROJECT:
 		bout << "<property name = \"Join Predicate\" value = \""
 			 << op -> u.JOIN_PROJECT.pred
@@ -396,6 +408,14 @@ static BufOut& operator << (BufOut& bout, Operator *op)
 		}
 		bout << "\"/>\n";
 		
+		if (op -> u.GROUP_AGGR.slideUnits > 0) {
+			bout << "<property name = \"Range\" value = \""
+				 << op -> u.GROUP_AGGR.timeUnits
+				 << "\" slide = \""
+				 << op -> u.GROUP_AGGR.slideUnits
+				 << "\"/>\n";
+		}
+		
 		break;
 		
 	case PO_DISTINCT:
@@ -716,6 +736,13 @@ static const char *getSynPos (Synopsis *relSyn)
 		ASSERT (op -> u.STR_JOIN.innerSyn == relSyn);
 		return "right";
 		
+	case PO_MJOIN:
+		if (op -> u.MJOIN.inSyns [0] == relSyn)
+			return "left";
+		if (op -> u.MJOIN.inSyns [op -> numInputs - 1] == relSyn)
+			return "right";
+		return "center";
+		
 	case PO_JOIN_PROJECT:
 		ASSERT (op -> u.JOIN_PROJECT.innerSyn == relSyn ||
 				op -> u.JOIN_PROJECT.outerSyn == relSyn);
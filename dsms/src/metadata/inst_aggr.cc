@@ -6,6 +6,14 @@
 #include "execution/synopses/rel_syn_impl.h"
 #endif
 
+#ifndef _MINMAX_SYN_
+#include "execution/synopses/minmax_syn.h"
+#endif
+
+#ifndef _PANE_SYN_
+#include "execution/synopses/pane_syn.h"
+#endif
+
 #ifndef _HASH_INDEX_
 #include "execution/indexes/hash_index.h"
 #endif
@@ -39,10 +47,12 @@ static const unsigned int CONST_ROLE = 1;
 static const unsigned int NEW_OUTPUT_ROLE = 2;
 static const unsigned int OLD_OUTPUT_ROLE = 3;
 static const unsigned int INPUT_ROLE = 4;
+static const unsigned int PANE_ROLE = 5;
 static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 //static const float THRESHOLD = 0.85;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 
 using namespace Metadata;
 
@@ -54,10 +64,13 @@ using Execution::BInstr;
 using Execution::HInstr;
 using Execution::EvalContext;
 using Execution::RelationSynopsisImpl;
+using Execution::MinMaxSynopsis;
+using Execution::PaneSynopsis;
 using Execution::HashIndex;
 using Execution::GroupAggr;
 using Execution::StorageAlloc;
 using Execution::MemoryManager;
+using Execution::Column;
 
 //----------------------------------------------------------------------
 // Grouping and aggregating information.  (Prevent us from tying
@@ -121,6 +134,9 @@ static int getMinusEval (Physical::Operator *op,
 						 ConstTupleLayout *ct_layout,
 						 AEval *&eval);
 
+static int getCombineEval (Physical::Operator *op,
+						   AEval *&eval);
+
 static int getScanNotReqEval (Physical::Operator *op,
 							  BEval *&scanNotReqEval);
 
@@ -140,6 +156,11 @@ static int initInIndex (Physical::Operator *op,
 
 static bool inputSynReq (Physical::Operator *op);
 
+static int getMinMaxSyn (Physical::Operator *op,
+						 MemoryManager *memMgr,
+						 std::ostream &LOG,
+						 MinMaxSynopsis *&syn);
+
 int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 {
 	int rc;
@@ -164,10 +185,20 @@ int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 	AEval                  *initEval;
 	BEval                  *bScanNotReq;
 	BEval                  *emptyGroupEval;
+	MinMaxSynopsis         *minMaxSyn;
+	PaneSynopsis           *paneSyn;
+	AEval                  *combineEval;
+	Column                  groupCol;
 	char                   *constTuple;
+	unsigned int            aggrTupleLen;
+	bool                    bPane;
 	
 	bInputRel = !op -> inputs[0] -> bStream;
 	
+	// We evaluate a sliding window over the input stream a pane at a
+	// time (see fold_slide_win)
+	bPane = (op -> u.GROUP_AGGR.slideUnits > 0);
+	
 	// Transform the grouping & aggr. information to a form easier to code :)
 	if ((rc = initGroupAggrInfo (op)) != 0)
 		return rc;
@@ -201,7 +232,7 @@ int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 		return rc;
 	
 	// Get the update Evaluator
-	if (bInputRel) {
+	if (bInputRel || bPane) {
 		if ((rc = getUpdateEval (op, ct_layout, updateEval)) != 0)			
 			return rc;
 		if ((rc = updateEval -> setEvalContext (evalContext)) != 0)
@@ -228,8 +259,19 @@ int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 		minusEval = 0;
 	}
 	
+	// MAX & MIN aggregates over a window (see add_syn_gby_aggr): we
+	// maintain them in monotonic deques, instead of rescanning the group
+	// on MINUS tuples.
+	if (bInputRel && !op -> u.GROUP_AGGR.inSyn) {
+		if ((rc = getMinMaxSyn (op, memMgr, LOG, minMaxSyn)) != 0)
+			return rc;
+	}
+	else {
+		minMaxSyn = 0;
+	}
+	
 	// Get the scanNotReq evaluator
-	if (bInputRel) {
+	if (bInputRel && !minMaxSyn) {
 		if ((rc = getScanNotReqEval (op, bScanNotReq)) != 0)
 			return rc;
 		if ((rc = bScanNotReq -> setEvalContext (evalContext)) != 0)
@@ -296,7 +338,7 @@ int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 
 	inSyn = 0;
 	inScanId = 0;
-	if (inputSynReq (op)) {
+	if (!minMaxSyn && inputSynReq (op)) {
 
 		ASSERT (op -> u.GROUP_AGGR.inSyn);
 		ASSERT (op -> u.GROUP_AGGR.inSyn -> kind == REL_SYN);
@@ -350,11 +392,46 @@ int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 	ASSERT (op -> store -> kind == REL_STORE);
 	tupleLayout = new TupleLayout (op);
 	
+	// Hidden column pointing to the group's deques in minMaxSyn or its
+	// panes in paneSyn
+	if (minMaxSyn || bPane) {
+		if ((rc = tupleLayout -> addCharPtrAttr (groupCol)) != 0)
+			return rc;
+	}
+	
+	// Length of the aggr. tuples without the columns of the store
+	aggrTupleLen = tupleLayout -> getTupleLen ();
+	
 	if ((rc = inst_rel_store (op -> store, tupleLayout)) != 0)
 		return rc;
 	outStore = op -> store -> instStore;
 	ASSERT (outStore);
 	
+	// Partial aggregates of the panes, with the layout of output tuples
+	if (bPane) {
+		if ((rc = getCombineEval (op, combineEval)) != 0)
+			return rc;
+		if ((rc = combineEval -> setEvalContext (evalContext)) != 0)
+			return rc;
+		
+		paneSyn = new PaneSynopsis (op -> id, LOG);
+		
+		if ((rc = paneSyn -> setMemoryManager (memMgr)) != 0)
+			return rc;
+		if ((rc = paneSyn -> setEvalContext (evalContext)) != 0)
+			return rc;
+		if ((rc = paneSyn -> setEvaluators (initEval, updateEval,
+											combineEval)) != 0)
+			return rc;
+		if ((rc = paneSyn -> setTupleLen (aggrTupleLen)) != 0)
+			return rc;
+		if ((rc = paneSyn -> initialize ()) != 0)
+			return rc;
+	}
+	else {
+		paneSyn = 0;
+	}
+	
 	groupAggr = new GroupAggr (op -> id, LOG);
 	
 	if ((rc = groupAggr -> setOutputSynopsis (outSyn, outScanId)) != 0)
@@ -377,6 +454,16 @@ int PlanManagerImpl::inst_aggr (Physical::Operator *op)
 		return rc;
 	if ((rc = groupAggr -> setOutStore (outStore)) != 0)
 		return rc;
+	if (minMaxSyn) {
+		if ((rc = groupAggr -> setMinMaxSynopsis (minMaxSyn, groupCol)) != 0)
+			return rc;
+	}
+	if (paneSyn) {
+		if ((rc = groupAggr -> setPaneSynopsis
+			 (paneSyn, groupCol, op -> u.GROUP_AGGR.timeUnits,
+			  op -> u.GROUP_AGGR.slideUnits)) != 0)
+			return rc;
+	}
 	
 	op -> instOp = groupAggr;
 
@@ -513,6 +600,7 @@ static int getPlusEval (Physical::Operator *op,
 	for (unsigned int g = 0 ; g < numGroupAttrs ; g++) {
 		instr.c1 = groupCols [g];  // source col
 		instr.dc = outCols [g];    // destn col
+		instr.len = op -> attrLen [g];
 		
 		switch (op -> attrTypes [g]) {
 		case INT:    instr.op = Execution::INT_CPY; break;
@@ -914,6 +1002,7 @@ static int getInitEval (Physical::Operator *op,
 		// result (dest): copy of the new attr
 		instr.dr = NEW_OUTPUT_ROLE;
 		instr.dc = outCols [g];
+		instr.len = op -> attrLen [g];
 		
 		if ((rc = eval -> addInstr (instr)) != 0)
 			return rc;
@@ -1041,6 +1130,7 @@ static int getMinusEval (Physical::Operator *op,
 		// result (dest): copy of the new attr
 		instr.dr = NEW_OUTPUT_ROLE;
 		instr.dc = outCols [g];
+		instr.len = op -> attrLen [g];
 		
 		if ((rc = eval -> addInstr (instr)) != 0)
 			return rc;
@@ -1186,6 +1276,136 @@ static int getMinusEval (Physical::Operator *op,
 	return 0;
 }	
 
+/**
+ * The combine evaluator merges the partial aggregates of two panes
+ * (OLD_OUTPUT_ROLE & PANE_ROLE) into NEW_OUTPUT_ROLE.
+ */
+static int getCombineEval (Physical::Operator *op,
+						   AEval *&eval)
+{
+	int rc;
+	AInstr instr;
+	Type type;
+	
+	eval = new AEval ();
+	
+	// Copy the group attributes
+	for (unsigned int g = 0 ; g < numGroupAttrs ; g++) {
+		
+		switch (op -> attrTypes [g]) {
+		case INT:    instr.op = Execution::INT_CPY; break;
+		case FLOAT:  instr.op = Execution::FLT_CPY; break;
+		case CHAR:   instr.op = Execution::CHR_CPY; break;
+		case BYTE:   instr.op = Execution::BYT_CPY; break;
+			
+#ifdef _DM_
+		default:
+			ASSERT (0);
+			break;
+#endif
+		}
+		
+		instr.r1 = OLD_OUTPUT_ROLE;
+		instr.c1 = outCols [g];
+		
+		instr.dr = NEW_OUTPUT_ROLE;
+		instr.dc = outCols [g];
+		instr.len = op -> attrLen [g];
+		
+		if ((rc = eval -> addInstr (instr)) != 0)
+			return rc;
+	}
+	
+	// Non-avg. aggregates in this pass: avg. aggregates depend on the
+	// combined SUM & COUNT aggregates
+	for (unsigned int a = 0 ; a < numAggrAttrs ; a++) {
+		type = op -> inputs [0] -> attrTypes [aggrPos [a]];
+		
+		ASSERT (fn [a] == COUNT || type == INT || type == FLOAT);
+		
+		switch (fn [a]) {
+		case SUM:
+			if (type == INT)
+				instr.op = Execution::INT_ADD;
+			else
+				instr.op = Execution::FLT_ADD;
+			break;
+			
+		case COUNT:
+			instr.op = Execution::INT_ADD;
+			break;
+			
+		case MAX:
+			if (type == INT)
+				instr.op = Execution::INT_UMX;
+			else
+				instr.op = Execution::FLT_UMX;
+			break;
+			
+		case MIN:
+			if (type == INT)
+				instr.op = Execution::INT_UMN;
+			else
+				instr.op = Execution::FLT_UMN;
+			break;
+			
+		case AVG:
+			continue;
+			
+#ifdef _DM_
+		default:
+			ASSERT (0);
+			break;
+#endif
+		}
+		
+		// input1: aggr. of the first pane
+		instr.r1 = OLD_OUTPUT_ROLE;
+		instr.c1 = outCols [a + numGroupAttrs];
+		
+		// input2: aggr. of the second pane
+		instr.r2 = PANE_ROLE;
+		instr.c2 = outCols [a + numGroupAttrs];
+		
+		// result: combined aggr.
+		instr.dr = NEW_OUTPUT_ROLE;
+		instr.dc = outCols [a + numGroupAttrs];
+		
+		if ((rc = eval -> addInstr (instr)) != 0)
+			return rc;
+	}
+	
+	for (unsigned int a = 0 ; a < numAggrAttrs ; a++) {
+		
+		if (fn [a] != AVG)
+			continue;
+		
+		type = op -> inputs [0] -> attrTypes [aggrPos [a]];
+		
+		if (type == INT)
+			instr.op = Execution::INT_AVG;
+		else
+			instr.op = Execution::FLT_AVG;
+		
+		// input1: combined sum aggr.
+		instr.r1 = NEW_OUTPUT_ROLE;
+		instr.c1 = outCols [sumPos [a] + numGroupAttrs];
+		
+		// input2: combined count aggr.
+		instr.r2 = NEW_OUTPUT_ROLE;
+		instr.c2 = outCols [countPos + numGroupAttrs];
+		
+		// result: avg
+		instr.dr = NEW_OUTPUT_ROLE;
+		instr.dc = outCols [a + numGroupAttrs];
+		
+		if ((rc = eval -> addInstr (instr)) != 0)
+			return rc;
+	}
+	
+	return 0;
+}
+
 static int getScanNotReqEval (Physical::Operator *op,
 							  BEval *&scanNotReqEval)
 {
@@ -1280,6 +1500,7 @@ static int initOutIndex (Physical::Operator *op,
 		hinstr.type = op -> attrTypes [g];
 		hinstr.r = UPDATE_ROLE;
 		hinstr.c = outCols [g];
+		hinstr.len = op -> attrLen [g];
 		
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -1291,6 +1512,7 @@ static int initOutIndex (Physical::Operator *op,
 		hinstr.type = op -> attrTypes [g];
 		hinstr.r = INPUT_ROLE;
 		hinstr.c = groupCols [g];
+		hinstr.len = op -> attrLen [g];
 		
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -1323,6 +1545,7 @@ static int initOutIndex (Physical::Operator *op,
 		binstr.r2 = SCAN_ROLE;
 		binstr.c2 = outCols [g];
 		binstr.e2 = 0;
+		binstr.len = op -> attrLen [g];
 		
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
@@ -1347,6 +1570,8 @@ static int initOutIndex (Physical::Operator *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
 	
@@ -1372,6 +1597,7 @@ static int initInIndex (Physical::Operator *op,
 		hinstr.type = op -> attrTypes [g];		
 		hinstr.r = UPDATE_ROLE;
 		hinstr.c = groupCols [g];
+		hinstr.len = op -> attrLen [g];
 		
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -1382,8 +1608,9 @@ static int initInIndex (Physical::Operator *op,
 		hinstr.type = op -> attrTypes [g];		
 		hinstr.r = INPUT_ROLE;
 		hinstr.c = groupCols [g];
+		hinstr.len = op -> attrLen [g];
 		
-		if ((rc = updateHash -> addInstr (hinstr)) != 0)
+		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
 	}
 	
@@ -1414,6 +1641,7 @@ static int initInIndex (Physical::Operator *op,
 		binstr.r2 = SCAN_ROLE;
 		binstr.c2 = groupCols [g];
 		binstr.e2 = 0;
+		binstr.len = op -> attrLen [g];
 		
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
@@ -1438,6 +1666,8 @@ static int initInIndex (Physical::Operator *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
 	
@@ -1455,4 +1685,36 @@ static bool inputSynReq (Physical::Operator *op)
 	
 	return false;
 }
-			
+
+static int getMinMaxSyn (Physical::Operator *op,
+						 MemoryManager *memMgr,
+						 std::ostream &LOG,
+						 MinMaxSynopsis *&syn)
+{
+	int rc;
+	Type type;
+	
+	syn = 0;
+	for (unsigned int a = 0 ; a < numAggrAttrs ; a++) {
+		
+		if (fn [a] != MAX && fn [a] != MIN)
+			continue;
+		
+		if (!syn) {
+			syn = new MinMaxSynopsis (op -> id, LOG);
+			if ((rc = syn -> setMemoryManager (memMgr)) != 0)
+				return rc;
+		}
+		
+		type = op -> inputs [0] -> attrTypes [aggrPos [a]];
+		
+		rc = syn -> addAggr (type, aggrCols [a], outCols [a + numGroupAttrs],
+							 (fn [a] == MAX));
+		if (rc != 0) return rc;
+	}
+	
+	if (syn && (rc = syn -> initialize ()) != 0)
+		return rc;
+	
+	return 0;
+}
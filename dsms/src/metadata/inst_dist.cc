@@ -37,6 +37,7 @@ static const unsigned int INPUT_ROLE = 2;
 static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 using namespace Metadata;
 
 using Execution::AEval;
@@ -259,6 +260,7 @@ static int initIndex (Physical::Operator *op,
 		hinstr.type = op -> attrTypes [a];
 		hinstr.r = UPDATE_ROLE;
 		hinstr.c = outCols [a];
+		hinstr.len = op -> attrLen [a];
 
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;		
@@ -270,6 +272,7 @@ static int initIndex (Physical::Operator *op,
 		hinstr.type = op -> attrTypes [a];
 		hinstr.r = INPUT_ROLE;
 		hinstr.c = outCols [a];
+		hinstr.len = op -> attrLen [a];
 
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -297,6 +300,7 @@ static int initIndex (Physical::Operator *op,
 		binstr.r2 = SCAN_ROLE;
 		binstr.c2 = outCols [a];
 		binstr.e2 = 0;
+		binstr.len = op -> attrLen [a];
 		
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
@@ -323,6 +327,8 @@ static int initIndex (Physical::Operator *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
 	
@@ -415,6 +421,7 @@ static int getInitEval (Physical::Operator *op, ConstTupleLayout *ct_layout,
 		// Destn: synopsis tuple
 		instr.dr = SYN_ROLE;
 		instr.dc = outCols [a];
+		instr.len = op -> attrLen [a];
 		
 		if ((rc = eval -> addInstr (instr)) != 0)
 			return rc;
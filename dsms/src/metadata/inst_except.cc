@@ -23,6 +23,7 @@ static const unsigned int OUTPUT_ROLE  = 5;
 static const unsigned int UPDATE_ROLE  = 6;
 static const unsigned int SCAN_ROLE    = 7;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 
 using namespace Metadata;
 
@@ -579,6 +580,8 @@ static int initCountIdx (Operator      *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
 	
@@ -662,6 +665,8 @@ static int initOutIdx (Operator      *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
 	
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #ifndef _PHY_OP_
 #include "metadata/phy_op.h"
 #endif
@@ -22,6 +24,21 @@ using Execution::BEval;
 using Execution::AInstr;
 using Execution::BInstr;
 
+/**
+ * Width of a CHAR attribute reference or constant
+ */
+static unsigned int charWidth (Expr *expr, Operator *op)
+{
+	ASSERT (expr -> type == CHAR);
+	
+	if (expr -> kind == CONST_VAL)
+		return strlen (expr -> u.sval) + 1;
+	
+	ASSERT (expr -> kind == ATTR_REF);
+	return op -> inputs [expr -> u.attr.input] ->
+		attrLen [expr -> u.attr.pos];
+}
+
 int PlanManagerImpl::inst_expr (Expr            *expr,
 								unsigned int    *roleMap,
 								Operator        *op,
@@ -163,6 +180,7 @@ int PlanManagerImpl::inst_bexpr (Physical::BExpr *expr,
 	AEval *right_eval;
 	unsigned int left_role, left_col;
 	unsigned int right_role, right_col;
+	unsigned int left_width, right_width;
 	
 	if (!beval)
 		beval = new BEval();	
@@ -345,6 +363,23 @@ int PlanManagerImpl::inst_bexpr (Physical::BExpr *expr,
 	instr.e1 = left_eval;
 	instr.e2 = right_eval;
 	
+	// CHAR columns of the same width are compared over that width.
+	// Otherwise the narrower one bounds the comparison only if it is a
+	// constant, whose string is always terminated.
+	if (!left_eval && !right_eval && expr -> left -> type == CHAR) {
+		left_width = charWidth (expr -> left, op);
+		right_width = charWidth (expr -> right, op);
+		
+		if (left_width == right_width)
+			instr.len = left_width;
+		else if (left_width < right_width &&
+				 expr -> left -> kind == CONST_VAL)
+			instr.len = left_width;
+		else if (right_width < left_width &&
+				 expr -> right -> kind == CONST_VAL)
+			instr.len = right_width;
+	}
+	
 	if ((rc = beval -> addInstr (instr)) != 0)
 		return rc;	
 	
@@ -428,6 +463,9 @@ int PlanManagerImpl::inst_expr_dest (Physical::Expr     *expr,
 		instr.dr = dest_role;
 		instr.dc = dest_col;
 		
+		if (expr -> type == CHAR)
+			instr.len = charWidth (expr, op);
+		
 		if ((rc = eval -> addInstr (instr)) != 0)
 			return rc;
 	}
@@ -461,6 +499,9 @@ int PlanManagerImpl::inst_expr_dest (Physical::Expr     *expr,
 		instr.dr = dest_role;
 		instr.dc = dest_col;
 		
+		if (expr -> type == CHAR)
+			instr.len = charWidth (expr, op);
+		
 		if ((rc = eval -> addInstr (instr)) != 0)
 			return rc;
 	}
@@ -45,6 +45,8 @@ static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 static const unsigned int FI_SCAN_ROLE = 8;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
+extern unsigned int JOIN_THREADS;
 
 using namespace Metadata;
 
@@ -76,6 +78,10 @@ static int initInnerIndex (Physical::Operator *op, BExpr *eqPred,
 						   MemoryManager *memMgr,
 						   EvalContext *evalContext, HashIndex *idx);					
 
+static int getPartitionHash (Physical::Operator *op, BExpr *eqPred,
+							 EvalContext *evalContext,
+							 HEval *&outerHash, HEval *&innerHash);
+
 static int getSimpleOutEval (Operator *op, AEval *&outEval);
 
 // Output layout
@@ -116,8 +122,18 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 	unsigned int                 inScanId;
 	unsigned int                 outScanId;
 	StorageAlloc                *store;
-	HashIndex                   *outIdx;
-	HashIndex                   *inIdx;
+	HashIndex                   *outIdx = 0;
+	HashIndex                   *inIdx = 0;
+	
+	// Partitioned probing (see BinaryJoin)
+	bool                         bPartitioned;
+	unsigned int                 numPartitions;
+	EvalContext                 *partnContext [BinaryJoin::MAX_PARTITIONS];
+	HashIndex                   *partnOutIdx [BinaryJoin::MAX_PARTITIONS];
+	HashIndex                   *partnInIdx [BinaryJoin::MAX_PARTITIONS];
+	BEval                       *partnNeEval_in [BinaryJoin::MAX_PARTITIONS];
+	BEval                       *partnNeEval_out [BinaryJoin::MAX_PARTITIONS];
+	HEval                       *outerHash = 0, *innerHash = 0;
 	
 	ASSERT (op);
 	ASSERT (op -> kind == PO_JOIN_PROJECT || op -> kind == PO_JOIN);
@@ -143,8 +159,68 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 	if ((rc = splitPred (pred, eqPred, nePred)) != 0)
 		return rc;
 	
+	// Probe partitions of the inputs in parallel: each partition has
+	// its own evaluation context and indexes, and the synopses are not
+	// indexed
+	bPartitioned = (eqPred && JOIN_THREADS > 1);
+	numPartitions = bPartitioned? JOIN_THREADS : 0;
+	
+	if (bPartitioned) {
+		
+		// Too many indexes
+		if (numIndexes + 2 * numPartitions >= MAX_INDEXES)
+			return -1;
+		
+		for (unsigned int p = 0 ; p < numPartitions ; p++) {
+			partnContext [p] = new EvalContext ();
+			
+			partnOutIdx [p] = new HashIndex (numIndexes, LOG);
+			indexes [numIndexes++] = partnOutIdx [p];
+			
+			if ((rc = initOuterIndex (op, eqPred, memMgr, partnContext [p],
+									  partnOutIdx [p])) != 0)
+				return rc;
+			
+			partnInIdx [p] = new HashIndex (numIndexes, LOG);
+			indexes [numIndexes++] = partnInIdx [p];
+			
+			if ((rc = initInnerIndex (op, eqPred, memMgr, partnContext [p],
+									  partnInIdx [p])) != 0)
+				return rc;
+			
+			partnNeEval_in [p] = partnNeEval_out [p] = 0;
+			
+			if (!nePred)
+				continue;
+			
+			roleMap [0] = FI_SCAN_ROLE;
+			roleMap [1] = INNER_ROLE;
+			
+			if ((rc = inst_bexpr (nePred, roleMap, op, partnNeEval_out [p],
+								  evalCxt)) != 0)
+				return rc;
+			if ((rc = partnNeEval_out [p] ->
+				 setEvalContext (partnContext [p])) != 0)
+				return rc;
+			
+			roleMap [0] = OUTER_ROLE;
+			roleMap [1] = FI_SCAN_ROLE;
+			
+			if ((rc = inst_bexpr (nePred, roleMap, op, partnNeEval_in [p],
+								  evalCxt)) != 0)
+				return rc;
+			if ((rc = partnNeEval_in [p] ->
+				 setEvalContext (partnContext [p])) != 0)
+				return rc;
+		}
+		
+		if ((rc = getPartitionHash (op, eqPred, evalContext,
+									outerHash, innerHash)) != 0)
+			return rc;
+	}
+	
 	// Construct an index on inner input for equality predicate attributes
-	if (eqPred) {
+	else if (eqPred) {
 		
 		// Too many indexes
 		if (numIndexes + 1 >= MAX_INDEXES)
@@ -199,7 +275,13 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 	e_outSyn = new RelationSynopsisImpl (p_outSyn -> id, LOG);	
 	p_outSyn -> u.relSyn = e_outSyn;
 	
-	if (eqPred) {
+	if (bPartitioned) {
+		if ((rc = e_outSyn -> setScan (0, outScanId)) != 0) {
+			return rc;
+		}
+	}
+	
+	else if (eqPred) {
 		if ((rc = e_outSyn -> setIndexScan (neEval_out, outIdx, outScanId)) != 0) {
 			return rc;
 		}
@@ -225,7 +307,13 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 	e_inSyn = new RelationSynopsisImpl (p_inSyn -> id, LOG);
 	p_inSyn -> u.relSyn = e_inSyn;
 	
-	if (eqPred) {
+	if (bPartitioned) {
+		if ((rc = e_inSyn -> setScan (0, inScanId)) != 0) {
+			return rc;
+		}
+	}
+	
+	else if (eqPred) {
 		if ((rc = e_inSyn -> setIndexScan (neEval_in, inIdx, inScanId)) != 0) {
 			return rc;
 		}
@@ -277,6 +365,12 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 		if ((rc = getStaticTuple (scratchTuple, st_size)) != 0)
 			return rc;
 		evalContext -> bind (scratchTuple, SCRATCH_ROLE);
+		
+		for (unsigned int p = 0 ; p < numPartitions ; p++) {
+			if ((rc = getStaticTuple (scratchTuple, st_size)) != 0)
+				return rc;
+			partnContext [p] -> bind (scratchTuple, SCRATCH_ROLE);
+		}
 	}
 	
 	if (ct_size > 0) {
@@ -287,6 +381,9 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 			return rc;
 		
 		evalContext -> bind (constTuple, CONST_ROLE);
+		
+		for (unsigned int p = 0 ; p < numPartitions ; p++)
+			partnContext [p] -> bind (constTuple, CONST_ROLE);
 	}			
 	
 	// (Optional) output synopsis
@@ -344,6 +441,20 @@ int PlanManagerImpl::inst_join (Physical::Operator *op)
 	if ((rc = join -> setOutStore (store)) != 0)
 		return rc;
 	
+	if (bPartitioned) {
+		if ((rc = join -> setPartitions (numPartitions, outerHash,
+										 innerHash)) != 0)
+			return rc;
+		
+		for (unsigned int p = 0 ; p < numPartitions ; p++) {
+			if ((rc = join -> setPartition (p, partnContext [p],
+											partnOutIdx [p], partnInIdx [p],
+											partnNeEval_out [p],
+											partnNeEval_in [p])) != 0)
+				return rc;
+		}
+	}
+	
 	op -> instOp = join;
 	
 	delete st_layout;
@@ -451,6 +562,7 @@ static int initOuterIndex (Operator      *op,
 		hinstr.type = leftChild -> attrTypes [a];
 		hinstr.r    = UPDATE_ROLE;
 		hinstr.c    = leftCols [a];
+		hinstr.len  = leftChild -> attrLen [a];
 		
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;		
@@ -467,6 +579,7 @@ static int initOuterIndex (Operator      *op,
 		hinstr.type = leftChild -> attrTypes [a];
 		hinstr.r    = INNER_ROLE;
 		hinstr.c    = rightCols [rightJoinPos[a]];
+		hinstr.len  = rightChild -> attrLen [rightJoinPos[a]];
 		
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -500,6 +613,13 @@ static int initOuterIndex (Operator      *op,
 		binstr.c2 = rightCols [rightJoinPos[a]];
 		binstr.e2 = 0;
 		
+		// CHAR keys of the same width are compared over that width
+		if (leftChild -> attrLen [a] ==
+			rightChild -> attrLen [rightJoinPos [a]])
+			binstr.len = leftChild -> attrLen [a];
+		else
+			binstr.len = 0;
+		
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
 	}
@@ -516,6 +636,8 @@ static int initOuterIndex (Operator      *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> setEvalContext (evalContext)) != 0)
 		return rc;
 	if ((rc = idx -> initialize()) != 0)
@@ -578,6 +700,7 @@ static int initInnerIndex (Operator      *op,
 		hinstr.type = rightChild -> attrTypes [a];
 		hinstr.r    = UPDATE_ROLE;
 		hinstr.c    = rightCols [a];
+		hinstr.len  = rightChild -> attrLen [a];
 		
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -595,6 +718,7 @@ static int initInnerIndex (Operator      *op,
 		hinstr.type = rightChild -> attrTypes [a];
 		hinstr.r    = OUTER_ROLE;
 		hinstr.c    = leftCols [leftJoinPos [a]];
+		hinstr.len  = leftChild -> attrLen [leftJoinPos [a]];
 		
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -632,6 +756,13 @@ static int initInnerIndex (Operator      *op,
 		binstr.c2 = leftCols [leftJoinPos[a]];
 		binstr.e2 = 0;
 		
+		// CHAR keys of the same width are compared over that width
+		if (leftChild -> attrLen [leftJoinPos [a]] ==
+			rightChild -> attrLen [a])
+			binstr.len = rightChild -> attrLen [a];
+		else
+			binstr.len = 0;
+		
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
 	}	
@@ -648,6 +779,8 @@ static int initInnerIndex (Operator      *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> setEvalContext (evalContext)) != 0)
 		return rc;
 	if ((rc = idx -> initialize ()) != 0)
@@ -656,6 +789,69 @@ static int initInnerIndex (Operator      *op,
 	return 0;
 }
 
+/**
+ * Hash functions that pick the partition of an outer (OUTER_ROLE) and an
+ * inner (INNER_ROLE) tuple.  Both hash the join attributes in the same
+ * order and as the same types, like the scan hash of initOuterIndex, so
+ * that joining tuples fall in the same partition.
+ */
+static int getPartitionHash (Operator      *op,
+							 BExpr         *eqPred,
+							 EvalContext   *evalContext,
+							 HEval        *&outerHash,
+							 HEval        *&innerHash)
+{
+	int rc;
+	Operator *leftChild, *rightChild;
+	bool isEqAttr [MAX_ATTRS];
+	unsigned int rightJoinPos [MAX_ATTRS];
+	HInstr hinstr;
+	
+	leftChild = op -> inputs [0];
+	rightChild = op -> inputs [1];
+	
+	for (unsigned int a = 0 ; a < numLeftCols ; a++) 
+		isEqAttr [a] = false;
+	
+	for (BExpr *p = eqPred ; p ; p = p -> next) {
+		isEqAttr [p -> left -> u.attr.pos] = true;
+		rightJoinPos [p -> left -> u.attr.pos] =
+			p -> right -> u.attr.pos;
+	}
+	
+	outerHash = new HEval ();
+	innerHash = new HEval ();
+	
+	for (unsigned int a = 0 ; a < numLeftCols ; a++) {
+		
+		if (!isEqAttr [a])
+			continue;
+		
+		hinstr.type = leftChild -> attrTypes [a];
+		hinstr.r    = OUTER_ROLE;
+		hinstr.c    = leftCols [a];
+		hinstr.len  = leftChild -> attrLen [a];
+		
+		if ((rc = outerHash -> addInstr (hinstr)) != 0)
+			return rc;
+		
+		hinstr.type = leftChild -> attrTypes [a];
+		hinstr.r    = INNER_ROLE;
+		hinstr.c    = rightCols [rightJoinPos[a]];
+		hinstr.len  = rightChild -> attrLen [rightJoinPos[a]];
+		
+		if ((rc = innerHash -> addInstr (hinstr)) != 0)
+			return rc;
+	}
+	
+	if ((rc = outerHash -> setEvalContext (evalContext)) != 0)
+		return rc;
+	if ((rc = innerHash -> setEvalContext (evalContext)) != 0)
+		return rc;
+	
+	return 0;
+}
+
 static int computeLayout (Operator *op)
 {
 	TupleLayout *outLayout, *leftLayout, *rightLayout;
@@ -717,6 +913,7 @@ static int getSimpleOutEval (Operator *op, AEval *&outEval)
 		// Destn: a'th column of output
 		instr.dr = OUTPUT_ROLE;
 		instr.dc = outCols [a];
+		instr.len = op -> attrLen [a];
 		
 		if ((rc = outEval -> addInstr (instr)) != 0)
 			return rc;		
@@ -742,6 +939,7 @@ static int getSimpleOutEval (Operator *op, AEval *&outEval)
 		// Destn: (a + numLeftAttr) column of output
 		instr.dr = OUTPUT_ROLE;
 		instr.dc = outCols [a + numLeftCols];
+		instr.len = op -> attrLen [a + numLeftCols];
 		
 		if ((rc = outEval -> addInstr (instr)) != 0)
 			return rc;
@@ -32,16 +32,18 @@ using Execution::HInstr;
 using Execution::BEval;
 using Execution::BInstr;
 
-static const unsigned int MAX_LINEAGE = 2;
+static const unsigned int MAX_LINEAGE = 4;
 
 static const unsigned int LIN_ROLE = 2;
 static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 
 /// Number of lineages
 static unsigned int numLineage;
 static unsigned int linCols [MAX_LINEAGE];
+static unsigned int linHiCols [MAX_LINEAGE];
 
 static int initIdx (TupleLayout *dataLayout,
 					EvalContext *evalContext,
@@ -87,11 +89,14 @@ int PlanManagerImpl::inst_lin_store (Physical::Store *store,
 	if ((rc = dataLayout -> addFixedLenAttr (INT, refCountCol)) != 0)
 		return rc;
 	
-	// Lineage columns	
+	// Lineage columns: lower and upper halves of the 64 bit tuple ids
 	for (unsigned int l = 0 ; l < store -> u.LIN_STORE.numLineage ; l++) {
 		if ((rc = dataLayout -> addFixedLenAttr (INT, linCols [l])) != 0) {
 			return rc;
 		}
+		if ((rc = dataLayout -> addFixedLenAttr (INT, linHiCols [l])) != 0) {
+			return rc;
+		}
 	}
 	
 	// Length of the entire tuple
@@ -132,7 +137,8 @@ int PlanManagerImpl::inst_lin_store (Physical::Store *store,
 		return rc;
 	
 	for (unsigned int l = 0 ; l < store -> u.LIN_STORE.numLineage ; l++) {
-		if ((rc = linStore -> addLineage (linCols [l])) != 0) {
+		if ((rc = linStore -> addLineage (linCols [l],
+						  linHiCols [l])) != 0) {
 			return rc;
 		}
 	}
@@ -173,6 +179,11 @@ static int initIdx (TupleLayout *dataLayout,
 		hinstr.r = UPDATE_ROLE;
 		hinstr.c = linCols [l];
 
+		if ((rc = updateHash -> addInstr (hinstr)) != 0)
+			return rc;
+
+		hinstr.c = linHiCols [l];
+
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;
 	}
@@ -186,6 +197,11 @@ static int initIdx (TupleLayout *dataLayout,
 		hinstr.r = LIN_ROLE;
 		hinstr.c = linCols [l];
 
+		if ((rc = scanHash -> addInstr (hinstr)) != 0)
+			return rc;
+
+		hinstr.c = linHiCols [l];
+
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
 	}
@@ -205,6 +221,12 @@ static int initIdx (TupleLayout *dataLayout,
 		binstr.c2 = linCols [l];
 		binstr.e2 = 0;
 
+		if ((rc = keyEqual -> addInstr (binstr)) != 0)
+			return rc;
+
+		binstr.c1 = linHiCols [l];
+		binstr.c2 = linHiCols [l];
+
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
 	}
@@ -228,6 +250,8 @@ static int initIdx (TupleLayout *dataLayout,
 
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 		
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
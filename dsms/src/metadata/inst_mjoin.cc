@@ -0,0 +1,528 @@
+#ifndef _PLAN_MGR_IMPL_
+#include "metadata/plan_mgr_impl.h"
+#endif
+
+#ifndef _CONSTANTS_
+#include "common/constants.h"
+#endif
+
+#ifndef _MJOIN_
+#include "execution/operators/mjoin.h"
+#endif
+
+#ifndef _HASH_INDEX_
+#include "execution/indexes/hash_index.h"
+#endif
+
+#ifndef _REL_SYN_IMPL_
+#include "execution/synopses/rel_syn_impl.h"
+#endif
+
+#ifndef _LIN_SYN_IMPL_
+#include "execution/synopses/lin_syn_impl.h"
+#endif
+
+#ifndef _AEVAL_
+#include "execution/internals/aeval.h"
+#endif
+
+#ifndef _BEVAL_
+#include "execution/internals/beval.h"
+#endif
+
+#ifndef _HEVAL_
+#include "execution/internals/heval.h"
+#endif
+
+#ifndef _STORE_ALLOC_
+#include "execution/stores/store_alloc.h"
+#endif
+
+static const unsigned int UPDATE_ROLE = 6;
+static const unsigned int SCAN_ROLE = 7;
+extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
+
+using namespace Metadata;
+
+using Physical::BExpr;
+using Physical::Expr;
+using Execution::HashIndex;
+using Execution::RelationSynopsisImpl;
+using Execution::LineageSynopsisImpl;
+using Execution::AEval;
+using Execution::BEval;
+using Execution::HEval;
+using Execution::AInstr;
+using Execution::BInstr;
+using Execution::HInstr;
+using Execution::EvalContext;
+using Execution::MJoin;
+using Execution::StorageAlloc;
+using Execution::MemoryManager;
+
+static int computeLayout (Operator *op);
+
+static unsigned int getInputMask (Expr *expr);
+
+static bool isEqConjunct (BExpr *pred, unsigned int j, unsigned int k);
+
+static bool isEqPred (BExpr *pred, unsigned int j, unsigned int k);
+
+static int initIndex (Operator *op, BExpr *pred,
+					  unsigned int j, unsigned int k,
+					  MemoryManager *memMgr,
+					  EvalContext *evalContext, HashIndex *idx);
+
+static int getOutEval (Operator *op, AEval *&outEval);
+
+// Output layout
+static unsigned int outCols [MAX_ATTRS];
+
+// Input layouts
+static unsigned int inCols [MJoin::MAX_INPUTS][MAX_ATTRS];
+
+int PlanManagerImpl::inst_mjoin (Physical::Operator *op)
+{
+	int rc;
+	
+	unsigned int roleMap [MJoin::MAX_INPUTS];
+	EvalContextInfo evalCxt;
+	BExpr *pred, *next;
+	TupleLayout *st_layout;
+	ConstTupleLayout *ct_layout;
+	unsigned int st_size, ct_size;
+	char *scratchTuple, *constTuple;
+	Physical::Synopsis *p_inSyn, *p_joinSyn;
+	TupleLayout *dataLayout;
+	
+	MJoin                       *join;
+	EvalContext                 *evalContext;
+	AEval                       *outEval;
+	BEval                       *predEval;
+	LineageSynopsisImpl         *e_joinSyn;
+	RelationSynopsisImpl        *e_inSyn;
+	unsigned int                 scanId;
+	StorageAlloc                *store;
+	HashIndex                   *idx;
+	
+	ASSERT (op);
+	ASSERT (op -> kind == PO_MJOIN);
+	ASSERT (op -> numInputs <= MJoin::MAX_INPUTS);
+	
+	// compute the layout of output & input tuples
+	if ((rc = computeLayout (op)) != 0)
+		return rc;
+	
+	// Shared evaluation context
+	evalContext = new EvalContext ();
+	
+	// State required for transforming expressions to BEval & AEval
+	st_layout         = new TupleLayout ();
+	ct_layout         = new ConstTupleLayout ();
+	evalCxt.st_layout = st_layout;
+	evalCxt.ct_layout = ct_layout;
+	
+	join = new MJoin (op -> id, LOG);
+	
+	if ((rc = join -> setNumInputs (op -> numInputs)) != 0)
+		return rc;
+	
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++)
+		roleMap [i] = MJoin::INPUT_ROLE + i;
+	
+	// An evaluator for each conjunct of the join predicate, so that the
+	// operator can check it as soon as the inputs it refers to are bound
+	pred = op -> u.MJOIN.pred;
+	while (pred) {
+		next = pred -> next;
+		pred -> next = 0;
+		
+		predEval = 0;
+		rc = inst_bexpr (pred, roleMap, op, predEval, evalCxt);
+		
+		pred -> next = next;
+		if (rc != 0)
+			return rc;
+		
+		if ((rc = predEval -> setEvalContext (evalContext)) != 0)
+			return rc;
+		
+		if ((rc = join -> addPredicate (predEval,
+										getInputMask (pred -> left) |
+										getInputMask (pred -> right))) != 0)
+			return rc;
+		
+		pred = next;
+	}
+	
+	// Synopsis of each input, with an index scan for each input it has
+	// equality predicates with and a scan of all the tuples
+	for (unsigned int j = 0 ; j < op -> numInputs ; j++) {
+		p_inSyn = op -> u.MJOIN.inSyns [j];
+		
+		ASSERT (p_inSyn);
+		e_inSyn = new RelationSynopsisImpl (p_inSyn -> id, LOG);
+		p_inSyn -> u.relSyn = e_inSyn;
+		
+		for (unsigned int k = 0 ; k < op -> numInputs ; k++) {
+			
+			if (k == j || !isEqPred (op -> u.MJOIN.pred, j, k))
+				continue;
+			
+			// Too many indexes
+			if (numIndexes >= MAX_INDEXES)
+				return -1;
+			
+			idx = new HashIndex (numIndexes, LOG);
+			indexes [numIndexes++] = idx;
+			
+			if ((rc = initIndex (op, op -> u.MJOIN.pred, j, k, memMgr,
+								 evalContext, idx)) != 0)
+				return rc;
+			
+			if ((rc = e_inSyn -> setIndexScan (0, idx, scanId)) != 0)
+				return rc;
+			if ((rc = join -> setIndexScan (j, k, scanId)) != 0)
+				return rc;
+		}
+		
+		if ((rc = e_inSyn -> setScan (0, scanId)) != 0)
+			return rc;
+		if ((rc = join -> setFullScan (j, scanId)) != 0)
+			return rc;
+		
+		if ((rc = e_inSyn -> setEvalContext (evalContext)) != 0)
+			return rc;
+		if ((rc = e_inSyn -> initialize ()) != 0)
+			return rc;
+		
+		if ((rc = join -> setSynopsis (j, e_inSyn)) != 0)
+			return rc;
+	}
+	
+	// Evaluator to construct the output tuples
+	if ((rc = getOutEval (op, outEval)) != 0)
+		return rc;
+	if ((rc = outEval -> setEvalContext (evalContext)) != 0)
+		return rc;
+	
+	// Set the constant and scratch tuples
+	st_size = st_layout -> getTupleLen ();
+	ct_size = ct_layout -> getTupleLen ();
+	
+	if (st_size > 0) {
+		if ((rc = getStaticTuple (scratchTuple, st_size)) != 0)
+			return rc;
+		evalContext -> bind (scratchTuple, SCRATCH_ROLE);
+	}
+	
+	if (ct_size > 0) {
+		if ((rc = getStaticTuple (constTuple, ct_size)) != 0)
+			return rc;
+		
+		if ((rc = ct_layout -> genTuple (constTuple)) != 0)
+			return rc;
+		
+		evalContext -> bind (constTuple, CONST_ROLE);
+	}
+	
+	// (Optional) output synopsis
+	p_joinSyn = op -> u.MJOIN.joinSyn;
+	
+	e_joinSyn = 0;
+	if (p_joinSyn) {
+		
+		ASSERT (!op -> bStream);
+		ASSERT (p_joinSyn -> store == op -> store);
+		ASSERT (p_joinSyn -> kind == LIN_SYN);
+		
+		e_joinSyn = new LineageSynopsisImpl (p_joinSyn -> id, LOG);
+		p_joinSyn -> u.linSyn = e_joinSyn;
+	}
+	
+	// Output store
+	ASSERT (op -> store);
+	ASSERT (op -> bStream && (op -> store -> kind == SIMPLE_STORE ||
+							  op -> store -> kind == WIN_STORE)
+			||
+			!op -> bStream && op -> store -> kind == LIN_STORE);
+	
+	dataLayout = new TupleLayout (op);
+	if (op -> store -> kind == LIN_STORE) {
+		if ((rc = inst_lin_store (op -> store, dataLayout)) != 0)
+			return rc;
+		store = op -> store -> instStore;
+	}
+	else {
+		if ((rc = inst_simple_store (op -> store, dataLayout)) != 0)
+			return rc;
+		store = op -> store -> instStore;
+	}
+	
+	if ((rc = join -> setJoinSynopsis (e_joinSyn)) != 0)
+		return rc;
+	if ((rc = join -> setEvalContext (evalContext)) != 0)
+		return rc;
+	if ((rc = join -> setOutputConstructor (outEval)) != 0)
+		return rc;
+	if ((rc = join -> setOutStore (store)) != 0)
+		return rc;
+	if ((rc = join -> initialize ()) != 0)
+		return rc;
+	
+	op -> instOp = join;
+	
+	delete st_layout;
+	delete ct_layout;
+	delete dataLayout;
+	
+	return 0;
+}
+
+static unsigned int getInputMask (Expr *expr)
+{
+	switch (expr -> kind) {
+	case ATTR_REF:
+		return (1 << expr -> u.attr.input);
+	
+	case COMP_EXPR:
+		return getInputMask (expr -> u.COMP_EXPR.left) |
+			getInputMask (expr -> u.COMP_EXPR.right);
+	
+	default:
+		break;
+	}
+	
+	return 0;
+}
+
+/**
+ * Is the conjunct pred an equality predicate between an attribute of
+ * input j and an attribute of the same type of input k?
+ */
+static bool isEqConjunct (BExpr *pred, unsigned int j, unsigned int k)
+{
+	if (pred -> op != EQ ||
+		pred -> left -> kind != ATTR_REF ||
+		pred -> right -> kind != ATTR_REF ||
+		pred -> left -> type != pred -> right -> type)
+		return false;
+	
+	return (pred -> left -> u.attr.input == j &&
+			pred -> right -> u.attr.input == k) ||
+		(pred -> left -> u.attr.input == k &&
+		 pred -> right -> u.attr.input == j);
+}
+
+/**
+ * Does the predicate have a conjunct as above?
+ */
+static bool isEqPred (BExpr *pred, unsigned int j, unsigned int k)
+{
+	for ( ; pred ; pred = pred -> next)
+		if (isEqConjunct (pred, j, k))
+			return true;
+	
+	return false;
+}
+
+/**
+ * Index on the tuples of input j, looked up with a bound tuple of input
+ * k: as initInnerIndex of a binary join with outer k and inner j.
+ */
+static int initIndex (Operator      *op,
+					  BExpr         *pred,
+					  unsigned int   j,
+					  unsigned int   k,
+					  MemoryManager *memMgr,
+					  EvalContext   *evalContext,
+					  HashIndex     *idx)
+{
+	int rc;
+	Operator *jChild, *kChild;
+	
+	// isEqAttr [a] is true iff a'th attribute of j is used in an
+	// equality predicate with k
+	bool isEqAttr [MAX_ATTRS];
+	
+	// if isEqAttr[a] is true, then kJoinPos[a] is *one* of the attribute
+	// positions of k which joins with 'a'
+	unsigned int kJoinPos [MAX_ATTRS];
+	
+	HEval *updateHash, *scanHash;
+	HInstr hinstr;
+	BEval *keyEqual;
+	BInstr binstr;
+	
+	jChild = op -> inputs [j];
+	kChild = op -> inputs [k];
+	
+	for (unsigned int a = 0 ; a < jChild -> numAttrs ; a++)
+		isEqAttr [a] = false;
+	
+	for ( ; pred ; pred = pred -> next) {
+		
+		if (!isEqConjunct (pred, j, k))
+			continue;
+		
+		if (pred -> left -> u.attr.input == j) {
+			isEqAttr [pred -> left -> u.attr.pos] = true;
+			kJoinPos [pred -> left -> u.attr.pos] = pred -> right -> u.attr.pos;
+		}
+		else {
+			isEqAttr [pred -> right -> u.attr.pos] = true;
+			kJoinPos [pred -> right -> u.attr.pos] = pred -> left -> u.attr.pos;
+		}
+	}
+	
+	updateHash = new HEval ();
+	scanHash = new HEval ();
+	keyEqual = new BEval ();
+	
+	for (unsigned int a = 0 ; a < jChild -> numAttrs ; a++) {
+		
+		if (!isEqAttr [a])
+			continue;
+		
+		hinstr.type = jChild -> attrTypes [a];
+		hinstr.r    = UPDATE_ROLE;
+		hinstr.c    = inCols [j][a];
+		hinstr.len  = jChild -> attrLen [a];
+		
+		if ((rc = updateHash -> addInstr (hinstr)) != 0)
+			return rc;
+		
+		hinstr.type = jChild -> attrTypes [a];
+		hinstr.r    = MJoin::INPUT_ROLE + k;
+		hinstr.c    = inCols [k][kJoinPos [a]];
+		hinstr.len  = kChild -> attrLen [kJoinPos [a]];
+		
+		if ((rc = scanHash -> addInstr (hinstr)) != 0)
+			return rc;
+		
+		switch (jChild -> attrTypes [a]) {
+		case INT:    binstr.op = Execution::INT_EQ; break;
+		case FLOAT:  binstr.op = Execution::FLT_EQ; break;
+		case CHAR:   binstr.op = Execution::CHR_EQ; break;
+		case BYTE:   binstr.op = Execution::BYT_EQ; break;
+		
+		default:
+			ASSERT (0);
+			break;
+		}
+		
+		// lhs: a'th col of the tuple of j stored in the index
+		binstr.r1 = SCAN_ROLE;
+		binstr.c1 = inCols [j][a];
+		binstr.e1 = 0;
+		
+		// rhs: col of the tuple of k that joins with it
+		binstr.r2 = MJoin::INPUT_ROLE + k;
+		binstr.c2 = inCols [k][kJoinPos [a]];
+		binstr.e2 = 0;
+		
+		// CHAR keys of the same width are compared over that width
+		if (jChild -> attrLen [a] == kChild -> attrLen [kJoinPos [a]])
+			binstr.len = jChild -> attrLen [a];
+		else
+			binstr.len = 0;
+		
+		if ((rc = keyEqual -> addInstr (binstr)) != 0)
+			return rc;
+	}
+	
+	if ((rc = updateHash -> setEvalContext (evalContext)) != 0)
+		return rc;
+	if ((rc = scanHash -> setEvalContext (evalContext)) != 0)
+		return rc;
+	if ((rc = keyEqual -> setEvalContext (evalContext)) != 0)
+		return rc;
+	
+	if ((rc = idx -> setMemoryManager (memMgr)) != 0)
+		return rc;
+	if ((rc = idx -> setUpdateHashEval (updateHash)) != 0)
+		return rc;
+	if ((rc = idx -> setScanHashEval (scanHash)) != 0)
+		return rc;
+	if ((rc = idx -> setKeyEqual (keyEqual)) != 0)
+		return rc;
+	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
+		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
+	if ((rc = idx -> setEvalContext (evalContext)) != 0)
+		return rc;
+	if ((rc = idx -> initialize ()) != 0)
+		return rc;
+	
+	return 0;
+}
+
+static int computeLayout (Operator *op)
+{
+	TupleLayout *layout;
+	
+	layout = new TupleLayout (op);
+	for (unsigned int a = 0 ; a < op -> numAttrs ; a++)
+		outCols [a] = layout -> getColumn (a);
+	delete layout;
+	
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+		layout = new TupleLayout (op -> inputs [i]);
+		for (unsigned int a = 0 ; a < op -> inputs [i] -> numAttrs ; a++)
+			inCols [i][a] = layout -> getColumn (a);
+		delete layout;
+	}
+	
+	return 0;
+}
+
+/**
+ * The output tuple is the concatenation of the input tuples.
+ */
+static int getOutEval (Operator *op, AEval *&outEval)
+{
+	int rc;
+	AInstr instr;
+	unsigned int outPos;
+	
+	outEval = new AEval ();
+	
+	outPos = 0;
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+		
+		ASSERT (op -> u.MJOIN.numInputAttrs [i] ==
+				op -> inputs [i] -> numAttrs);
+		
+		for (unsigned int a = 0 ; a < op -> u.MJOIN.numInputAttrs [i] ;
+			 a++, outPos++) {
+			
+			// Operation: copy
+			switch (op -> attrTypes [outPos]) {
+			case INT:   instr.op = Execution::INT_CPY; break;
+			case FLOAT: instr.op = Execution::FLT_CPY; break;
+			case BYTE:  instr.op = Execution::BYT_CPY; break;
+			case CHAR:  instr.op = Execution::CHR_CPY; break;
+			default:
+				ASSERT (0); break;
+			}
+			
+			// Source: a'th column of input i
+			instr.r1 = MJoin::INPUT_ROLE + i;
+			instr.c1 = inCols [i][a];
+			
+			// Destn: outPos'th column of output
+			instr.dr = MJoin::OUTPUT_ROLE;
+			instr.dc = outCols [outPos];
+			instr.len = op -> attrLen [outPos];
+			
+			if ((rc = outEval -> addInstr (instr)) != 0)
+				return rc;
+		}
+	}
+	
+	ASSERT (outPos == op -> numAttrs);
+	
+	return 0;
+}
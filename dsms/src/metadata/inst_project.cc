@@ -29,6 +29,8 @@ using Execution::Tuple;
 using Execution::LineageSynopsisImpl;
 using Execution::StorageAlloc;
 
+extern bool VECTORIZE;
+
 int PlanManagerImpl::inst_project (Physical::Operator *op)
 {
 	int rc;
@@ -142,6 +144,10 @@ int PlanManagerImpl::inst_project (Physical::Operator *op)
 	if ((rc = project -> setProjEvaluator (outEval)) != 0)
 		return rc;
 
+	if (VECTORIZE && outEval -> isVectorizable (OUTPUT_ROLE))
+		if ((rc = project -> setVectorized (true)) != 0)
+			return rc;
+
 	if ((rc = project -> setOutStore (store)) != 0)
 		return rc;	
 	
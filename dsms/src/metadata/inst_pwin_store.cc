@@ -25,6 +25,7 @@
 static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 
 static const unsigned int DATA_ROLE = 2;
 static const unsigned int HEADER_ROLE = 3;
@@ -323,6 +324,8 @@ int PlanManagerImpl::inst_pwin_store (Physical::Store *store)
 	
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
@@ -40,6 +40,7 @@ static const unsigned int INPUT_ROLE = 2;
 static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 
 using namespace Metadata;
 
@@ -193,7 +194,7 @@ static int initIndex (Physical::Operator *op,
 	for (unsigned int a = 0 ; a < op -> numAttrs ; a++) {
 		
 		hinstr.type = op -> attrTypes [a];
-		hinstr.r = UPDATE_ROLE;
+		hinstr.r = INPUT_ROLE;
 		hinstr.c = tupleLayout -> getColumn (a);
 		
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
@@ -253,6 +254,8 @@ static int initIndex (Physical::Operator *op,
 	
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
@@ -19,6 +19,8 @@ using Execution::Tuple;
 
 static const unsigned int INPUT_CONTEXT = 2;
 
+extern bool VECTORIZE;
+
 int PlanManagerImpl::inst_select (Physical::Operator *op)
 {
 	int rc;
@@ -80,6 +82,10 @@ int PlanManagerImpl::inst_select (Physical::Operator *op)
 	if ((rc = select -> setEvalContext (evalContext)) != 0)
 		return rc;
 	
+	if (VECTORIZE && pred -> isVectorizable ())
+		if ((rc = select -> setVectorized (true)) != 0)
+			return rc;
+	
 	op -> instOp = select;
 	
 	delete evalCxt.st_layout;
@@ -29,6 +29,8 @@ int PlanManagerImpl::inst_simple_store (Physical::Store *store,
 		return rc;
 	if ((rc = simpleStore -> setMemoryManager (memMgr)) != 0)
 		return rc;
+	if ((rc = simpleStore -> setConcurrent (store -> bConcurrent)) != 0)
+		return rc;
 	if ((rc = simpleStore -> initialize ()) != 0)
 		return rc;
 	
@@ -34,7 +34,8 @@ int PlanManagerImpl::inst_ss_gen (Physical::Operator *op)
 		if (top -> kind == PO_JOIN ||
 			top -> kind == PO_STR_JOIN ||
 			top -> kind == PO_JOIN_PROJECT ||
-			top -> kind == PO_STR_JOIN_PROJECT) {
+			top -> kind == PO_STR_JOIN_PROJECT ||
+			top -> kind == PO_MJOIN) {
 
 			rc = ssgen -> addJoinEntity (top -> id, top -> instOp);
 			if (rc != 0) return rc;
@@ -173,7 +174,8 @@ int PlanManagerImpl::update_ss_gen (Physical::Operator *p_op,
 		if (top -> kind == PO_JOIN ||
 			top -> kind == PO_STR_JOIN ||
 			top -> kind == PO_JOIN_PROJECT ||
-			top -> kind == PO_STR_JOIN_PROJECT) {
+			top -> kind == PO_STR_JOIN_PROJECT ||
+			top -> kind == PO_MJOIN) {
 
 			rc = e_op -> addJoinEntity (top -> id, top -> instOp);
 			if (rc != 0) return rc;
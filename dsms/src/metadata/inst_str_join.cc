@@ -41,6 +41,7 @@ static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 static const unsigned int FI_SCAN_ROLE = 8;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 using namespace Metadata;
 
 using Physical::BExpr;
@@ -387,6 +388,7 @@ static int initInnerIndex (Operator      *op,
 		hinstr.type = rightChild -> attrTypes [a];
 		hinstr.r    = UPDATE_ROLE;
 		hinstr.c    = rightCols [a];
+		hinstr.len  = rightChild -> attrLen [a];
 		
 		if ((rc = updateHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -404,6 +406,7 @@ static int initInnerIndex (Operator      *op,
 		hinstr.type = rightChild -> attrTypes [a];
 		hinstr.r    = OUTER_ROLE;
 		hinstr.c    = leftCols [leftJoinPos [a]];
+		hinstr.len  = leftChild -> attrLen [leftJoinPos [a]];
 		
 		if ((rc = scanHash -> addInstr (hinstr)) != 0)
 			return rc;
@@ -441,6 +444,13 @@ static int initInnerIndex (Operator      *op,
 		binstr.c2 = leftCols [leftJoinPos[a]];
 		binstr.e2 = 0;
 		
+		// CHAR keys of the same width are compared over that width
+		if (leftChild -> attrLen [leftJoinPos [a]] ==
+			rightChild -> attrLen [a])
+			binstr.len = rightChild -> attrLen [a];
+		else
+			binstr.len = 0;
+		
 		if ((rc = keyEqual -> addInstr (binstr)) != 0)
 			return rc;
 	}	
@@ -457,6 +467,8 @@ static int initInnerIndex (Operator      *op,
 		return rc;
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 	if ((rc = idx -> setEvalContext (evalContext)) != 0)
 		return rc;
 	if ((rc = idx -> initialize ()) != 0)
@@ -527,6 +539,7 @@ static int getSimpleOutEval (Operator *op, AEval *&outEval)
 		// Destn: a'th column of output
 		instr.dr = OUTPUT_ROLE;
 		instr.dc = outCols [a];
+		instr.len = op -> attrLen [a];
 		
 		if ((rc = outEval -> addInstr (instr)) != 0)
 			return rc;		
@@ -552,6 +565,7 @@ static int getSimpleOutEval (Operator *op, AEval *&outEval)
 		// Destn: (a + numLeftAttr) column of output
 		instr.dr = OUTPUT_ROLE;
 		instr.dc = outCols [a + numLeftCols];
+		instr.len = op -> attrLen [a + numLeftCols];
 		
 		if ((rc = outEval -> addInstr (instr)) != 0)
 			return rc;
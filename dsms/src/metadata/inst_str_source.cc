@@ -6,6 +6,10 @@
 #include "execution/operators/stream_source.h"
 #endif
 
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
 using namespace Metadata;
 
 using Execution::StreamSource;
@@ -70,3 +74,38 @@ int PlanManagerImpl::inst_str_source (Physical::Operator *op)
 	return 0;
 }
 	
+
+/**
+ * Instantiate the store of a stream source that is already instantiated
+ * and running: the store of the output of the source to a plan it is
+ * migrated to.
+ */
+
+int PlanManagerImpl::inst_str_source_store (Physical::Operator *op)
+{
+	int rc;
+	TupleLayout *tupleLayout;
+	
+	ASSERT (op);
+	ASSERT (op -> kind == PO_STREAM_SOURCE);
+	ASSERT (op -> instOp);
+	ASSERT (op -> store);
+	ASSERT (op -> store -> kind == SIMPLE_STORE ||
+			op -> store -> kind == WIN_STORE);
+	
+	tupleLayout = new TupleLayout (op);
+	
+	if (op -> store -> kind == SIMPLE_STORE) {
+		if ((rc = inst_simple_store (op -> store, tupleLayout)) != 0)
+			return rc;
+	}
+	else {
+		if ((rc = inst_win_store (op -> store, tupleLayout)) != 0)
+			return rc;
+	}
+	ASSERT (op -> store -> instStore);
+	
+	delete tupleLayout;
+	
+	return 0;
+}
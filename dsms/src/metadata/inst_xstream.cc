@@ -38,6 +38,7 @@ static const unsigned int OUTPUT_ROLE = 4;
 static const unsigned int UPDATE_ROLE = 6;
 static const unsigned int SCAN_ROLE = 7;
 extern double INDEX_THRESHOLD;
+extern bool OPEN_HASH_INDEX;
 
 using namespace Metadata;
 
@@ -769,6 +770,8 @@ static int initCountIndex (Physical::Operator *op,
 	
 	if ((rc = idx -> setThreshold (INDEX_THRESHOLD)) != 0)
 		return rc;
+	if ((rc = idx -> setOpenAddressing (OPEN_HASH_INDEX)) != 0)
+		return rc;
 
 	if ((rc = idx -> initialize ()) != 0)
 		return rc;
@@ -162,6 +162,10 @@ ostream& Physical::operator << (ostream& out, Operator *op)
 		out << "StreamJoin (+Project)";
 		break;
 		
+	case PO_MJOIN:
+		out << "MultiJoin";
+		break;
+		
 	case PO_ISTREAM:
 		out << "Istream";
 		break;
@@ -342,6 +346,28 @@ ostream& Physical::operator << (ostream& out, Operator *op)
 		
 		break;
 		
+	case PO_MJOIN:
+		
+		out << "Predicate: ";
+		if (op -> u.MJOIN.pred)
+			out << op -> u.MJOIN.pred << endl;
+		else
+			out << "(null)" << endl;
+		
+		out << "Input Synopses: ";
+		for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+			if (op -> u.MJOIN.inSyns [i])
+				out << op -> u.MJOIN.inSyns [i] -> id << " ";
+		}
+		out << endl;
+		
+		out << "Join Synopsis: ";
+		if (op -> u.MJOIN.joinSyn)
+			out << op -> u.MJOIN.joinSyn -> id;
+		out << endl;
+		
+		break;
+		
 	case PO_JOIN_PROJECT:
 		
 		out << "Projections: ";		
@@ -436,6 +462,16 @@ ostream& Physical::operator << (ostream& out, Operator *op)
 		if (op -> u.GROUP_AGGR.outSyn)
 			out << op -> u.GROUP_AGGR.outSyn -> id;
 		out << endl;
+		
+		if (op -> u.GROUP_AGGR.slideUnits > 0) {
+			out << "Window Size: "
+				<< op -> u.GROUP_AGGR.timeUnits
+				<< endl;
+			
+			out << "Window slide: "
+				<< op -> u.GROUP_AGGR.slideUnits
+				<< endl;
+		}
 
 		
 		break;
@@ -0,0 +1,185 @@
+/**
+ * @file       plan_fragment.cc
+ * @date       Oct. 17, 2026
+ * @brief      Partitioning of the plan into fragments run by different
+ *             threads.
+ */
+
+#ifndef _PLAN_MGR_IMPL_
+#include "metadata/plan_mgr_impl.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _SCHEDULER_
+#include "execution/scheduler/scheduler.h"
+#endif
+
+using namespace Metadata;
+using namespace Physical;
+
+extern unsigned int NUM_THREADS;
+extern Execution::SchedulerKind SCHEDULER;
+
+/// Same as Execution::ThreadPoolScheduler::MAX_THREADS and
+/// Execution::WorkStealingScheduler::MAX_TASKS
+static const unsigned int MAX_FRAGMENTS = 32;
+
+static unsigned int find (unsigned int *parent, unsigned int o)
+{
+	while (parent [o] != o) {
+		parent [o] = parent [parent [o]];
+		o = parent [o];
+	}
+	return o;
+}
+
+static void merge (unsigned int *parent, Operator *op1, Operator *op2)
+{
+	unsigned int r1, r2;
+	
+	ASSERT (op1);
+	ASSERT (op2);
+	
+	r1 = find (parent, op1 -> id);
+	r2 = find (parent, op2 -> id);
+	
+	if (r1 != r2)
+		parent [r2] = r1;
+}
+
+/**
+ * Assign each operator to one of NUM_THREADS fragments.  The work
+ * stealing scheduler balances the load between its threads itself, so
+ * for it we use as many fragments as possible.
+ *
+ * Synopses, indexes and stores other than simple stores are not thread
+ * safe, so all the operators that access one of them have to be in the
+ * same fragment.  The same holds for the readers of a shared queue and
+ * its writer.  The remaining connections between operators are simple
+ * queues and simple stores, which are synchronized when their source and
+ * destination operators end up in different fragments.
+ *
+ * We compute the groups of operators that have to be together, and
+ * assign them to fragments largest first, each group to the fragment
+ * with the fewest operators.  The system stream generator is always in
+ * fragment 0, along with the operators of monitor plans added later.
+ */
+
+int PlanManagerImpl::assign_fragments ()
+{
+	unsigned int parent [MAX_OPS];
+	unsigned int size [MAX_OPS];
+	int groupFragment [MAX_OPS];
+	unsigned int load [MAX_FRAGMENTS];
+	unsigned int numFragments;
+	unsigned int root, maxRoot, minFragment;
+	Operator *op;
+	Store *store;
+	Queue *writer;
+	
+	if (SCHEDULER == Execution::WS_SCHEDULER && NUM_THREADS > 1)
+		numFragments = MAX_FRAGMENTS;
+	else if (SCHEDULER == Execution::CHAIN_SCHEDULER ||
+			 SCHEDULER == Execution::FIFO_SCHEDULER)
+		numFragments = 1;
+	else
+		numFragments = NUM_THREADS;
+	ASSERT (numFragments > 0 && numFragments <= MAX_FRAGMENTS);
+	
+	for (unsigned int o = 0 ; o < MAX_OPS ; o++) {
+		parent [o] = o;
+		size [o] = 0;
+		groupFragment [o] = -1;
+	}
+
+	// Synopses and their stores
+	for (unsigned int s = 0 ; s < numStores ; s++) {
+		store = stores + s;
+		
+		if (!store -> ownOp)
+			continue;
+		
+		for (unsigned int t = 0 ; t < store -> numStubs ; t++)
+			if (store -> stubs [t] -> ownOp)
+				merge (parent, store -> ownOp, store -> stubs [t] -> ownOp);
+	}
+	
+	// Operators referencing tuples of non-simple stores
+	for (op = usedOps ; op ; op = op -> next) {
+		for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+			store = op -> inStores [i];
+			
+			if (store && store -> kind != SIMPLE_STORE && store -> ownOp)
+				merge (parent, op, store -> ownOp);
+		}
+	}
+	
+	// Shared queues
+	for (unsigned int q = 0 ; q < numQueues ; q++) {
+		if (queues [q].kind != WRITER_Q)
+			continue;
+		
+		writer = queues + q;
+		for (unsigned int r = 0 ; r < writer -> u.WRITER.numReaders ; r++)
+			merge (parent, writer -> u.WRITER.source,
+				   writer -> u.WRITER.readers [r] -> u.READER.dest);
+	}
+	
+	for (op = usedOps ; op ; op = op -> next)
+		size [find (parent, op -> id)] ++;
+	
+	for (unsigned int f = 0 ; f < numFragments ; f++)
+		load [f] = 0;
+	
+	// The system stream generator goes to fragment 0
+	for (op = usedOps ; op ; op = op -> next) {
+		if (op -> kind == PO_SS_GEN) {
+			root = find (parent, op -> id);
+			groupFragment [root] = 0;
+			load [0] += size [root];
+		}
+	}
+	
+	// Largest unassigned group to the least loaded fragment
+	while (true) {
+		maxRoot = MAX_OPS;
+		for (op = usedOps ; op ; op = op -> next) {
+			root = find (parent, op -> id);
+			if (groupFragment [root] == -1 &&
+				(maxRoot == MAX_OPS || size [root] > size [maxRoot]))
+				maxRoot = root;
+		}
+		
+		if (maxRoot == MAX_OPS)
+			break;
+		
+		minFragment = 0;
+		for (unsigned int f = 1 ; f < numFragments ; f++)
+			if (load [f] < load [minFragment])
+				minFragment = f;
+		
+		groupFragment [maxRoot] = minFragment;
+		load [minFragment] += size [maxRoot];
+	}
+	
+	for (op = usedOps ; op ; op = op -> next)
+		op -> fragment = groupFragment [find (parent, op -> id)];
+	
+	// Simple stores whose tuples are referenced from other fragments
+	for (op = usedOps ; op ; op = op -> next) {
+		for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+			store = op -> inStores [i];
+			
+			if (store && store -> ownOp &&
+				store -> ownOp -> fragment != op -> fragment) {
+				ASSERT (store -> kind == SIMPLE_STORE);
+				store -> bConcurrent = true;
+			}
+		}
+	}
+	
+	return 0;
+}
@@ -22,6 +22,10 @@
 #include "execution/operators/dstream.h"
 #endif
 
+#ifndef _MJOIN_
+#include "execution/operators/mjoin.h"
+#endif
+
 #ifndef _GROUP_AGGR_
 #include "execution/operators/group_aggr.h"
 #endif
@@ -86,6 +90,10 @@
 #include "execution/queues/simple_queue.h"
 #endif
 
+#ifndef _SPSC_QUEUE_
+#include "execution/queues/spsc_queue.h"
+#endif
+
 #ifndef _SHARED_QUEUE_WRITER_
 #include "execution/queues/shared_queue_writer.h"
 #endif
@@ -134,6 +142,7 @@ using Execution::Select;
 using Execution::Project;
 using Execution::BinaryJoin;
 using Execution::BinStreamJoin;
+using Execution::MJoin;
 using Execution::GroupAggr;
 using Execution::Distinct;
 using Execution::RowWindow;
@@ -151,6 +160,7 @@ using Execution::Sink;
 using Execution::Union;
 using Execution::Except;
 using Execution::SimpleQueue;
+using Execution::SpscQueue;
 using Execution::SharedQueueWriter;
 using Execution::SharedQueueReader;
 using Execution::PartnWindowSynopsisImpl;
@@ -171,6 +181,7 @@ static int set_out_queue_select (Operator *op, Execution::Queue *queue);
 static int set_out_queue_project (Operator *op, Execution::Queue *queue);
 static int set_out_queue_join (Operator *op, Execution::Queue *queue);
 static int set_out_queue_str_join (Operator *op, Execution::Queue *queue);
+static int set_out_queue_mjoin (Operator *op, Execution::Queue *queue);
 static int set_out_queue_aggr (Operator *op, Execution::Queue *queue);
 static int set_out_queue_distinct (Operator *op, Execution::Queue *queue);
 static int set_out_queue_row_win (Operator *op, Execution::Queue *queue);
@@ -187,6 +198,7 @@ static int set_input_queue_select (Operator *op, Execution::Queue *queue, unsign
 static int set_input_queue_project (Operator *op, Execution::Queue *queue, unsigned int pos);
 static int set_input_queue_join (Operator *op, Execution::Queue *queue, unsigned int pos);
 static int set_input_queue_str_join (Operator *op, Execution::Queue *queue, unsigned int pos);
+static int set_input_queue_mjoin (Operator *op, Execution::Queue *queue, unsigned int pos);
 static int set_input_queue_aggr (Operator *op, Execution::Queue *queue, unsigned int pos);
 static int set_input_queue_distinct (Operator *op, Execution::Queue *queue, unsigned int pos);
 static int set_input_queue_row_win (Operator *op, Execution::Queue *queue, unsigned int pos);
@@ -207,6 +219,7 @@ static int set_in_store_select (Operator *op);
 static int set_in_store_project (Operator *op);
 static int set_in_store_join (Operator *op);
 static int set_in_store_str_join (Operator *op);
+static int set_in_store_mjoin (Operator *op);
 static int set_in_store_aggr (Operator *op);
 static int set_in_store_distinct (Operator *op);
 static int set_in_store_row_win (Operator *op);
@@ -227,7 +240,16 @@ extern unsigned int QUEUE_SIZE;
 extern unsigned int SHARED_QUEUE_SIZE;
 
 /// Memory that memory manager gets from the system [6 MB]
-extern unsigned int MEMORY;
+extern unsigned long long int MEMORY;
+
+/// Memory up to which the memory manager can grow
+extern unsigned long long int MAX_MEMORY;
+
+/// Use huge pages for the memory
+extern bool HUGE_PAGES;
+
+/// Bind the memory to NUMA nodes
+extern bool NUMA;
 
 
 int PlanManagerImpl::inst_mem_mgr ()
@@ -237,6 +259,12 @@ int PlanManagerImpl::inst_mem_mgr ()
 	memMgr = new Execution::MemoryManager (0, LOG);
 	if ((rc = memMgr -> setMemorySize (MEMORY)) != 0)
 		return rc;	
+	if ((rc = memMgr -> setMaxMemorySize (MAX_MEMORY)) != 0)
+		return rc;
+	if ((rc = memMgr -> setHugePages (HUGE_PAGES)) != 0)
+		return rc;
+	if ((rc = memMgr -> setNuma (NUMA)) != 0)
+		return rc;
 	if ((rc = memMgr -> initialize ()) != 0)
 		return rc;
 	
@@ -331,6 +359,8 @@ int PlanManagerImpl::inst_simple_queue (Physical::Queue *queue)
 	Operator *source, *dest;
 	unsigned int index;
 	SimpleQueue *simpleQueue;
+	SpscQueue *spscQueue;
+	Execution::Queue *instQueue;
 	
 	// Sanity check
 	ASSERT (queue);
@@ -342,20 +372,34 @@ int PlanManagerImpl::inst_simple_queue (Physical::Queue *queue)
 	dest = queue -> u.SIMPLE.dest;
 	index = queue -> u.SIMPLE.index;
 
-	// Instantiate the queue
-	simpleQueue = new SimpleQueue (queue -> id, LOG);
-	if ((rc = simpleQueue -> setNumPages (QUEUE_SIZE)) != 0)
-		return rc;
-	if ((rc = simpleQueue -> setMemoryManager (memMgr)) != 0)
-		return rc;
-	if ((rc = simpleQueue -> initialize ()) != 0)
-		return rc;	
-	queue -> instQueue = simpleQueue;
+	// Instantiate the queue: queues between operators run by different
+	// threads are lock-free single producer / single consumer rings
+	if (source -> fragment != dest -> fragment) {
+		spscQueue = new SpscQueue (queue -> id, LOG);
+		if ((rc = spscQueue -> setNumPages (QUEUE_SIZE)) != 0)
+			return rc;
+		if ((rc = spscQueue -> setMemoryManager (memMgr)) != 0)
+			return rc;
+		if ((rc = spscQueue -> initialize ()) != 0)
+			return rc;
+		instQueue = spscQueue;
+	}
+	else {
+		simpleQueue = new SimpleQueue (queue -> id, LOG);
+		if ((rc = simpleQueue -> setNumPages (QUEUE_SIZE)) != 0)
+			return rc;
+		if ((rc = simpleQueue -> setMemoryManager (memMgr)) != 0)
+			return rc;
+		if ((rc = simpleQueue -> initialize ()) != 0)
+			return rc;	
+		instQueue = simpleQueue;
+	}
+	queue -> instQueue = instQueue;
 	
 	// Update the operators
-	if ((rc = set_output_queue (source, simpleQueue)) != 0)
+	if ((rc = set_output_queue (source, instQueue)) != 0)
 		return rc;
-	if ((rc = set_input_queue (dest, simpleQueue, index)) != 0)
+	if ((rc = set_input_queue (dest, instQueue, index)) != 0)
 		return rc;
 	
 	return 0;	
@@ -452,6 +496,11 @@ int PlanManagerImpl::inst_op (Operator *op) {
 		if ((rc = inst_str_join (op)) != 0)
 			return rc;
 		break;
+		
+	case PO_MJOIN:
+		if ((rc = inst_mjoin (op)) != 0)
+			return rc;
+		break;
 			
 	case PO_GROUP_AGGR:
 		if ((rc = inst_aggr (op)) != 0)
@@ -674,6 +723,9 @@ static int set_output_queue (Operator *op, Execution::Queue *queue)
 	case PO_STR_JOIN_PROJECT: 
 	case PO_STR_JOIN:
 		return set_out_queue_str_join (op, queue);
+		
+	case PO_MJOIN:
+		return set_out_queue_mjoin (op, queue);
 			
 	case PO_GROUP_AGGR:
 		return set_out_queue_aggr (op, queue);
@@ -740,6 +792,9 @@ static int set_input_queue (Operator *op,
 	case PO_STR_JOIN_PROJECT: 
 	case PO_STR_JOIN:
 		return set_input_queue_str_join (op, queue, inputPos);
+		
+	case PO_MJOIN:
+		return set_input_queue_mjoin (op, queue, inputPos);
 			
 	case PO_GROUP_AGGR:
 		return set_input_queue_aggr (op, queue, inputPos);
@@ -819,6 +874,11 @@ int PlanManagerImpl::link_in_stores ()
 				return rc;
 			break;
 			
+		case PO_MJOIN:
+			if ((rc = set_in_store_mjoin (op)) != 0)
+				return rc;
+			break;
+			
 		case PO_GROUP_AGGR:
 			if ((rc = set_in_store_aggr (op)) != 0)
 				return rc;
@@ -927,6 +987,11 @@ int PlanManagerImpl::link_in_stores_mon (Physical::Operator **opList,
 				return rc;
 			break;
 			
+		case PO_MJOIN:
+			if ((rc = set_in_store_mjoin (op)) != 0)
+				return rc;
+			break;
+			
 		case PO_GROUP_AGGR:
 			if ((rc = set_in_store_aggr (op)) != 0)
 				return rc;
@@ -1022,6 +1087,11 @@ static int set_out_queue_str_join (Operator *op, Execution::Queue *queue)
 	return ((BinStreamJoin *)(op -> instOp)) -> setOutputQueue (queue);
 }
 
+static int set_out_queue_mjoin (Operator *op, Execution::Queue *queue)
+{	
+	return ((MJoin *)(op -> instOp)) -> setOutputQueue (queue);
+}
+
 static int set_out_queue_aggr (Operator *op, Execution::Queue *queue)
 {	
 	return ((GroupAggr *)(op -> instOp)) -> setOutputQueue (queue);
@@ -1112,6 +1182,12 @@ static int set_input_queue_str_join (Operator *op, Execution::Queue *queue, unsi
 		return ((BinStreamJoin *)(op -> instOp)) -> setInnerInputQueue (queue);
 }
 
+static int set_input_queue_mjoin (Operator *op, Execution::Queue *queue, unsigned int pos)
+{
+	ASSERT (pos < op -> numInputs);
+	return ((MJoin *)(op -> instOp)) -> setInputQueue (pos, queue);
+}
+
 static int set_input_queue_aggr (Operator *op, Execution::Queue *queue, unsigned int pos)
 {
 	ASSERT (pos == 0);
@@ -1435,6 +1511,19 @@ static int set_in_store_str_join (Operator *op)
 		(op -> inStores [1] -> instStore);
 }
 
+static int set_in_store_mjoin (Operator *op)
+{
+	int rc;
+	
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+		rc = ((MJoin *)(op -> instOp)) -> setInputStore
+			(i, op -> inStores [i] -> instStore);
+		if (rc != 0) return rc;
+	}
+	
+	return 0;
+}
+
 static int set_in_store_union (Operator *op)
 {
 	int rc;
@@ -46,6 +46,9 @@ PlanManagerImpl::PlanManagerImpl(TableManager *tableMgr, ostream& _LOG)
 	this -> numQueries = 0;
 	this -> memMgr = 0;
 	this -> staticTupleAlloc = 0;
+	this -> numMigrateOps = 0;
+	this -> numMigrateOutputs = 0;
+	this -> migrateHorizon = 0;
 	
 	// Organize all the ops as a linked list
 	init_ops ();
@@ -446,6 +449,9 @@ int PlanManagerImpl::optimize_plan ()
 	
 	LOG << endl << "Optimizing plan" << endl << endl;
 	
+	if ((rc = savePlanRates ()) != 0)
+		return rc;
+	
 	// remove all query sources
 	if((rc = removeQuerySources()) != 0)
 		return rc;
@@ -453,6 +459,9 @@ int PlanManagerImpl::optimize_plan ()
 	if ((rc = addSinks ()) != 0)
 		return rc;
 	
+	if ((rc = shareSubplans ()) != 0)
+		return rc;
+	
 	//LOG << endl << endl;
 	//printPlan();
 	
@@ -495,6 +504,9 @@ int PlanManagerImpl::add_aux_structures ()
 	if ((rc = set_in_stores ()) != 0)
 		return rc;
 	
+	if ((rc = assign_fragments ()) != 0)
+		return rc;
+	
 #ifdef _DM_
 	LOG << endl << endl;
 	printPlan();
@@ -562,7 +574,10 @@ int PlanManagerImpl::initScheduler (Execution::Scheduler *sched)
 
 		ASSERT (op -> instOp);
 		
-		if ((rc = sched -> addOperator (op -> instOp)) != 0)
+		if ((rc = sched -> addOperator (op -> instOp, op -> fragment)) != 0)
+			return rc;
+		
+		if ((rc = set_sched_queues (op, sched)) != 0)
 			return rc;
 		
 		op = op -> next;
@@ -573,6 +588,37 @@ int PlanManagerImpl::initScheduler (Execution::Scheduler *sched)
 
 
 
+/**
+ * Inform the scheduler about the (instantiated) queues of an operator.
+ */
+int PlanManagerImpl::set_sched_queues (Operator *op,
+									   Execution::Scheduler *sched)
+{
+	Execution::Queue *inQueues [MAX_IN_BRANCHING];
+	Execution::Operator *inOps [MAX_IN_BRANCHING];
+	Execution::Queue *outQueue;
+	
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+		ASSERT (op -> inQueues [i]);
+		ASSERT (op -> inQueues [i] -> instQueue);
+		ASSERT (op -> inputs [i]);
+		
+		inQueues [i] = op -> inQueues [i] -> instQueue;
+		inOps [i] = op -> inputs [i] -> instOp;
+	}
+	
+	outQueue = 0;
+	if (op -> numOutputs > 0) {
+		ASSERT (op -> outQueue);
+		ASSERT (op -> outQueue -> instQueue);
+		
+		outQueue = op -> outQueue -> instQueue;
+	}
+	
+	return sched -> setQueues (op -> instOp, inQueues, inOps,
+							   op -> numInputs, outQueue);
+}
+
 #ifdef _DM_
 #include <iostream>
 #include "metadata/phy_op_debug.h"
@@ -670,6 +716,30 @@ int PlanManagerImpl::printStat ()
 		
 		LOG << endl;
 	}
+	
+	// Page caches
+	int hits, refills, remoteFrees;
+	ASSERT (memMgr);
+	if ((rc = memMgr -> getIntProperty (Monitor::MEM_CACHE_HITS,
+										hits)) != 0)
+		return rc;
+	
+	if ((rc = memMgr -> getIntProperty (Monitor::MEM_CACHE_REFILLS,
+										refills)) != 0)
+		return rc;
+	
+	if ((rc = memMgr -> getIntProperty (Monitor::MEM_REMOTE_FREES,
+										remoteFrees)) != 0)
+		return rc;
+	
+	LOG << "Memory: <"
+		<< hits
+		<< ","
+		<< refills
+		<< ","
+		<< remoteFrees
+		<< ">"
+		<< endl;
 
 #if 0	
 	int numEntries, numBuckets, numNonMt;
@@ -138,6 +138,9 @@ int PlanManagerImpl::addMonitorPlan (unsigned int monitorId,
 		
 		if ((rc = sched -> addOperator (opList[o] -> instOp)) != 0)
 			return rc;
+		
+		if ((rc = set_sched_queues (opList [o], sched)) != 0)
+			return rc;
 	}
 	
 	LOG << "planmgr: done" << endl;
@@ -374,6 +377,12 @@ static int getSynList (Operator **opList, unsigned int numOps,
 			TEST_AND_ADD(op -> u.STR_JOIN.innerSyn);
 			break;			
 			
+		case PO_MJOIN:
+			for (unsigned int i = 0 ; i < op -> numInputs ; i++)
+				TEST_AND_ADD(op -> u.MJOIN.inSyns [i]);
+			TEST_AND_ADD(op -> u.MJOIN.joinSyn);
+			break;
+			
 		case PO_JOIN_PROJECT:
 			TEST_AND_ADD(op -> u.JOIN_PROJECT.innerSyn);
 			TEST_AND_ADD(op -> u.JOIN_PROJECT.outerSyn);
@@ -0,0 +1,394 @@
+/**
+ * @file        plan_migrate.cc
+ * @date        Oct. 17, 2026
+ * @brief       Migration of the running plan to a new plan
+ */
+
+#ifdef _SYS_STR_
+
+#ifndef _PLAN_MGR_IMPL_
+#include "metadata/plan_mgr_impl.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _STREAM_SOURCE_
+#include "execution/operators/stream_source.h"
+#endif
+
+#ifndef _OUTPUT_
+#include "execution/operators/output.h"
+#endif
+
+using namespace Metadata;
+using namespace Physical;
+using namespace std;
+
+using Execution::StreamSource;
+using Execution::Output;
+
+/**
+ * Does the operator keep state over an input stream that it reads
+ * directly (as a relation with an unbounded window)?
+ */
+static bool keepsStreamState (Operator *op, unsigned int inputIdx)
+{
+	switch (op -> kind) {
+	case PO_SELECT:
+	case PO_PROJECT:
+	case PO_RANGE_WIN:
+	case PO_OUTPUT:
+	case PO_SINK:
+	case PO_UNION:
+		return false;
+	
+	case PO_STR_JOIN:
+	case PO_STR_JOIN_PROJECT:
+		return (inputIdx != 0);
+	
+	case PO_GROUP_AGGR:
+		// A sliding range window folded into the aggregation
+		return (op -> u.GROUP_AGGR.timeUnits == 0);
+	
+	default:
+		return true;
+	}
+	
+	// never comes
+	return true;
+}
+
+/**
+ * A plan can be migrated if all the tuples it keeps fall in a bounded
+ * period of time: its inputs are base streams (relations and the
+ * results of other queries are not replayed), and all its windows are
+ * range or now windows.  The period (migrateHorizon) is the longest
+ * range of the windows, plus their slide.
+ */
+
+bool PlanManagerImpl::canMigrate ()
+{
+	Operator *op;
+	Operator *source;
+	unsigned int horizon;
+	
+	for (unsigned int t = 0 ; t < numTables ; t++) {
+		source = ops + sourceOps [t].opId;
+		
+		if (source -> kind == PO_SS_GEN)
+			continue;
+		
+		if (source -> kind != PO_STREAM_SOURCE) {
+			LOG << "PlanManager: cannot migrate a plan over relations "
+				<< "or views" << endl;
+			return false;
+		}
+		
+		if (!source -> instOp) {
+			LOG << "PlanManager: cannot migrate a plan before it runs"
+				<< endl;
+			return false;
+		}
+	}
+	
+	migrateHorizon = 0;
+	for (op = usedOps ; op ; op = op -> next) {
+		
+		if (op -> kind == PO_ROW_WIN || op -> kind == PO_PARTN_WIN) {
+			LOG << "PlanManager: cannot migrate a plan with row windows"
+				<< endl;
+			return false;
+		}
+		
+		for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+			if (op -> inputs [i] -> bStream && keepsStreamState (op, i)) {
+				LOG << "PlanManager: cannot migrate a plan with unbounded "
+					<< "windows" << endl;
+				return false;
+			}
+		}
+		
+		horizon = 0;
+		if (op -> kind == PO_RANGE_WIN)
+			horizon = op -> u.RANGE_WIN.timeUnits +
+				op -> u.RANGE_WIN.slideUnits;
+		else if (op -> kind == PO_GROUP_AGGR)
+			horizon = op -> u.GROUP_AGGR.timeUnits +
+				op -> u.GROUP_AGGR.slideUnits;
+		
+		if (horizon > migrateHorizon)
+			migrateHorizon = horizon;
+	}
+	
+	return true;
+}
+
+int PlanManagerImpl::beginMigration (bool &bMigrate)
+{
+	int rc;
+	Operator *source;
+	
+	bMigrate = false;
+	
+	// A previous migration is still under way: try again later
+	for (unsigned int t = 0 ; t < numTables ; t++) {
+		source = ops + sourceOps [t].opId;
+		
+		if (source -> kind == PO_STREAM_SOURCE && source -> instOp &&
+			((StreamSource *) source -> instOp) -> isMigrating ())
+			return 0;
+	}
+	
+	// The plan cannot change: take the rates observed as those of the
+	// plan, so that the same drift is not reported again
+	if (!canMigrate ()) {
+		if ((rc = savePlanRates ()) != 0)
+			return rc;
+		return 0;
+	}
+	
+	bMigrate = true;
+	
+	// The sources are connected to the new plans only: the operators
+	// of the current plans keep their instantiated queues
+	for (unsigned int t = 0 ; t < numTables ; t++) {
+		source = ops + sourceOps [t].opId;
+		
+		if (source -> kind != PO_STREAM_SOURCE)
+			continue;
+		
+		source -> numOutputs = 0;
+		source -> outQueue = 0;
+		source -> store = 0;
+	}
+	
+	numMigrateOps = 0;
+	numMigrateOutputs = 0;
+	
+	return 0;
+}
+
+int PlanManagerImpl::addMigrateOps (Operator *op)
+{
+	int rc;
+	
+	for (unsigned int o = 0 ; o < numMigrateOps ; o++)
+		if (migrateOps [o] == op)
+			return 0;
+	
+	if (numMigrateOps >= MAX_MIGRATE_OPS) {
+		LOG << "PlanManager: too many operators to migrate" << endl;
+		return -1;
+	}
+	
+	migrateOps [numMigrateOps++] = op;
+	
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++)
+		if ((rc = addMigrateOps (op -> inputs [i])) != 0)
+			return rc;
+	
+	return 0;
+}
+
+int PlanManagerImpl::addMigrationPlan (unsigned int queryId,
+									   Logical::Operator *logPlan)
+{
+	int rc;
+	Operator *oldOutput;
+	Operator *phyPlan;
+	Operator *outputOp;
+	
+	// The output operator of the current plan of the query (the most
+	// recent one)
+	for (oldOutput = usedOps ; oldOutput ; oldOutput = oldOutput -> next)
+		if (oldOutput -> kind == PO_OUTPUT &&
+			oldOutput -> u.OUTPUT.queryId == queryId)
+			break;
+	
+	// Query without an output
+	if (!oldOutput)
+		return 0;
+	
+	if ((rc = genPhysicalPlan (logPlan, phyPlan)) != 0)
+		return rc;
+	
+	// Output operator that produces to the same output
+	if ((rc = mk_output (phyPlan, outputOp)) != 0)
+		return rc;
+	outputOp -> u.OUTPUT.outputId = oldOutput -> u.OUTPUT.outputId;
+	outputOp -> u.OUTPUT.queryId = queryId;
+	
+	ASSERT (numMigrateOutputs < MAX_OUTPUT);
+	newOutOps [numMigrateOutputs] = outputOp;
+	oldOutOps [numMigrateOutputs] = oldOutput;
+	numMigrateOutputs ++;
+	
+	return addMigrateOps (outputOp);
+}
+
+/**
+ * The new plans get the tuples of the sources from T0, the last
+ * timestamp the sources have read, and produce the outputs of the
+ * queries from switchTs = T0 + migrateHorizon + 1: by then their windows
+ * hold the same tuples as those of the current plans.  The current
+ * plans get the tuples up to switchTs, and produce the outputs before
+ * it.  The operators of the current plans are left in place: they are
+ * idle once they have processed their last input.
+ */
+
+int PlanManagerImpl::endMigration (Execution::Scheduler *sched)
+{
+	int rc;
+	Operator *op;
+	Operator *plan;
+	Store *storeList [MAX_STORES];
+	unsigned int numMigrateStores;
+	unsigned int firstStore;
+	Timestamp lastTs, switchTs;
+	StreamSource *source;
+	
+	if (numMigrateOutputs == 0)
+		return 0;
+	
+	plan = newOutOps [0];
+	firstStore = numStores;
+	
+	// The new plans share their common subplans, as the current ones
+	if ((rc = shareSubplans_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	if ((rc = optimize_plan_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	// As add_aux_structures_mon (), but with the queues added after the
+	// stores, as add_aux_structures () does: add_store () puts a project
+	// above a select whose output is kept in a synopsis
+	if ((rc = addIntAggrs_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	if ((rc = add_syn_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	if ((rc = add_store_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	numMigrateOps = 0;
+	for (unsigned int o = 0 ; o < numMigrateOutputs ; o++)
+		if ((rc = addMigrateOps (newOutOps [o])) != 0)
+			return rc;
+	
+	if ((rc = add_queues_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	if ((rc = set_in_stores_mon (plan, migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	// Instantiate the new operators, and the new stores of the sources
+	for (unsigned int o = 0 ; o < numMigrateOps ; o++) {
+		op = migrateOps [o];
+		
+		if (op -> kind == PO_STREAM_SOURCE)
+			rc = inst_str_source_store (op);
+		else
+			rc = inst_op (op);
+		
+		if (rc != 0)
+			return rc;
+	}
+	
+	// Timestamp at which the new plans take over
+	lastTs = 0;
+	for (unsigned int o = 0 ; o < numMigrateOps ; o++) {
+		op = migrateOps [o];
+		
+		if (op -> kind != PO_STREAM_SOURCE)
+			continue;
+		
+		source = (StreamSource *) op -> instOp;
+		if (source -> getLastInputTs () > lastTs)
+			lastTs = source -> getLastInputTs ();
+	}
+	switchTs = lastTs + migrateHorizon + 1;
+	
+	// Start feeding the new plans: the sources get the output queues
+	// of the new plans from inst_queues()
+	for (unsigned int o = 0 ; o < numMigrateOps ; o++) {
+		op = migrateOps [o];
+		
+		if (op -> kind != PO_STREAM_SOURCE)
+			continue;
+		
+		ASSERT (op -> store && op -> store -> instStore);
+		
+		source = (StreamSource *) op -> instOp;
+		if ((rc = source -> migrate (op -> store -> instStore,
+									 switchTs)) != 0)
+			return rc;
+	}
+	
+	if ((rc = inst_queues ()) != 0)
+		return rc;
+	
+	// The stores of the new plans (the stores of the sources of the
+	// current plans have the same owners)
+	numMigrateStores = 0;
+	for (unsigned int s = firstStore ; s < numStores ; s++)
+		storeList [numMigrateStores++] = stores + s;
+	
+	if ((rc = link_syn_store_mon (storeList, numMigrateStores)) != 0)
+		return rc;
+	
+	if ((rc = link_in_stores_mon (migrateOps, numMigrateOps)) != 0)
+		return rc;
+	
+	// Hand the outputs over
+	for (unsigned int o = 0 ; o < numMigrateOutputs ; o++) {
+		ASSERT (newOutOps [o] -> instOp);
+		ASSERT (oldOutOps [o] -> instOp);
+		
+		if ((rc = ((Output *) oldOutOps [o] -> instOp) ->
+			 setEnd (switchTs)) != 0)
+			return rc;
+		
+		if ((rc = ((Output *) newOutOps [o] -> instOp) ->
+			 setStart (switchTs, (Output *) oldOutOps [o] -> instOp)) != 0)
+			return rc;
+	}
+	
+	// Update the scheduler with the new operators
+	for (unsigned int o = 0 ; o < numMigrateOps ; o++) {
+		op = migrateOps [o];
+		ASSERT (op -> instOp);
+		
+		if (op -> kind != PO_STREAM_SOURCE &&
+			(rc = sched -> addOperator (op -> instOp)) != 0)
+			return rc;
+	}
+	
+	for (unsigned int o = 0 ; o < numMigrateOps ; o++)
+		if ((rc = set_sched_queues (migrateOps [o], sched)) != 0)
+			return rc;
+	
+	LOG << "PlanManager: migrating "
+		<< numMigrateOutputs
+		<< " queries to a new plan at "
+		<< switchTs
+		<< endl;
+
+#ifdef _DM_
+	printPlan ();
+#endif
+
+	// The statistics the new plan is built with
+	if ((rc = savePlanRates ()) != 0)
+		return rc;
+	
+	numMigrateOps = 0;
+	numMigrateOutputs = 0;
+	
+	return 0;
+}
+
+#endif
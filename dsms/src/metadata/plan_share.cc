@@ -0,0 +1,491 @@
+/**
+ * @file        plan_share.cc
+ * @date        Oct. 17, 2026
+ * @brief       Sharing of the common subplans of the registered queries
+ */
+
+#ifndef _PLAN_MGR_IMPL_
+#include "metadata/plan_mgr_impl.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#include <string.h>
+
+using namespace Metadata;
+using namespace Physical;
+using namespace std;
+
+static bool sameExpr (Expr *e1, Expr *e2)
+{
+	ASSERT (e1);
+	ASSERT (e2);
+	
+	if (e1 -> kind != e2 -> kind || e1 -> type != e2 -> type)
+		return false;
+	
+	switch (e1 -> kind) {
+	case CONST_VAL:
+		switch (e1 -> type) {
+		case INT:   return (e1 -> u.ival == e2 -> u.ival);
+		case FLOAT: return (e1 -> u.fval == e2 -> u.fval);
+		case BYTE:  return (e1 -> u.bval == e2 -> u.bval);
+		case CHAR:  return (strcmp (e1 -> u.sval, e2 -> u.sval) == 0);
+		default:
+			return false;
+		}
+	
+	case ATTR_REF:
+		return (e1 -> u.attr.input == e2 -> u.attr.input &&
+				e1 -> u.attr.pos == e2 -> u.attr.pos);
+	
+	case COMP_EXPR:
+		return (e1 -> u.COMP_EXPR.op == e2 -> u.COMP_EXPR.op &&
+				sameExpr (e1 -> u.COMP_EXPR.left, e2 -> u.COMP_EXPR.left) &&
+				sameExpr (e1 -> u.COMP_EXPR.right, e2 -> u.COMP_EXPR.right));
+	
+	default:
+		break;
+	}
+	
+	return false;
+}
+
+/**
+ * Is the predicate (one conjunct, ignoring pred -> next) one of the
+ * conjuncts of the conjunction?
+ */
+
+static bool containsPred (BExpr *conj, BExpr *pred)
+{
+	for ( ; conj ; conj = conj -> next)
+		if (conj -> op == pred -> op &&
+			sameExpr (conj -> left, pred -> left) &&
+			sameExpr (conj -> right, pred -> right))
+			return true;
+	
+	return false;
+}
+
+/**
+ * Is every conjunct of conj1 also a conjunct of conj2?  (A tuple that
+ * satisfies conj2 then satisfies conj1.)
+ */
+
+static bool subsumesPred (BExpr *conj1, BExpr *conj2)
+{
+	for ( ; conj1 ; conj1 = conj1 -> next)
+		if (!containsPred (conj2, conj1))
+			return false;
+	
+	return true;
+}
+
+static bool samePred (BExpr *conj1, BExpr *conj2)
+{
+	return (subsumesPred (conj1, conj2) && subsumesPred (conj2, conj1));
+}
+
+static bool sameAttrs (Attr *attrs1, Attr *attrs2, unsigned int numAttrs)
+{
+	for (unsigned int a = 0 ; a < numAttrs ; a++)
+		if (attrs1 [a].input != attrs2 [a].input ||
+			attrs1 [a].pos != attrs2 [a].pos)
+			return false;
+	
+	return true;
+}
+
+static bool sameProjs (Expr **projs1, Expr **projs2, unsigned int numAttrs)
+{
+	for (unsigned int a = 0 ; a < numAttrs ; a++)
+		if (!sameExpr (projs1 [a], projs2 [a]))
+			return false;
+	
+	return true;
+}
+
+/**
+ * Do the two operators compute the same output from the same inputs?
+ */
+
+static bool sameOp (Operator *op1, Operator *op2)
+{
+	ASSERT (op1 != op2);
+	
+	if (op1 -> kind != op2 -> kind ||
+		op1 -> bStream != op2 -> bStream ||
+		op1 -> numAttrs != op2 -> numAttrs ||
+		op1 -> numInputs != op2 -> numInputs)
+		return false;
+	
+	for (unsigned int a = 0 ; a < op1 -> numAttrs ; a++)
+		if (op1 -> attrTypes [a] != op2 -> attrTypes [a] ||
+			op1 -> attrLen [a] != op2 -> attrLen [a])
+			return false;
+	
+	for (unsigned int i = 0 ; i < op1 -> numInputs ; i++)
+		if (op1 -> inputs [i] != op2 -> inputs [i])
+			return false;
+	
+	switch (op1 -> kind) {
+	case PO_SELECT:
+		return samePred (op1 -> u.SELECT.pred, op2 -> u.SELECT.pred);
+	
+	case PO_PROJECT:
+		return sameProjs (op1 -> u.PROJECT.projs, op2 -> u.PROJECT.projs,
+						  op1 -> numAttrs);
+	
+	case PO_JOIN:
+		return (op1 -> u.JOIN.numOuterAttrs == op2 -> u.JOIN.numOuterAttrs &&
+				samePred (op1 -> u.JOIN.pred, op2 -> u.JOIN.pred));
+	
+	case PO_STR_JOIN:
+		return (op1 -> u.STR_JOIN.numOuterAttrs ==
+				op2 -> u.STR_JOIN.numOuterAttrs &&
+				samePred (op1 -> u.STR_JOIN.pred, op2 -> u.STR_JOIN.pred));
+	
+	case PO_JOIN_PROJECT:
+		return (sameProjs (op1 -> u.JOIN_PROJECT.projs,
+						   op2 -> u.JOIN_PROJECT.projs,
+						   op1 -> numAttrs) &&
+				samePred (op1 -> u.JOIN_PROJECT.pred,
+						  op2 -> u.JOIN_PROJECT.pred));
+	
+	case PO_STR_JOIN_PROJECT:
+		return (sameProjs (op1 -> u.STR_JOIN_PROJECT.projs,
+						   op2 -> u.STR_JOIN_PROJECT.projs,
+						   op1 -> numAttrs) &&
+				samePred (op1 -> u.STR_JOIN_PROJECT.pred,
+						  op2 -> u.STR_JOIN_PROJECT.pred));
+	
+	case PO_MJOIN:
+		for (unsigned int i = 0 ; i < op1 -> numInputs ; i++)
+			if (op1 -> u.MJOIN.numInputAttrs [i] !=
+				op2 -> u.MJOIN.numInputAttrs [i])
+				return false;
+		return samePred (op1 -> u.MJOIN.pred, op2 -> u.MJOIN.pred);
+	
+	case PO_GROUP_AGGR:
+		if (op1 -> u.GROUP_AGGR.numGroupAttrs !=
+			op2 -> u.GROUP_AGGR.numGroupAttrs ||
+			op1 -> u.GROUP_AGGR.numAggrAttrs !=
+			op2 -> u.GROUP_AGGR.numAggrAttrs ||
+			op1 -> u.GROUP_AGGR.timeUnits != op2 -> u.GROUP_AGGR.timeUnits ||
+			op1 -> u.GROUP_AGGR.slideUnits != op2 -> u.GROUP_AGGR.slideUnits)
+			return false;
+		
+		for (unsigned int a = 0 ; a < op1 -> u.GROUP_AGGR.numAggrAttrs ; a++)
+			if (op1 -> u.GROUP_AGGR.fn [a] != op2 -> u.GROUP_AGGR.fn [a])
+				return false;
+		
+		return (sameAttrs (op1 -> u.GROUP_AGGR.groupAttrs,
+						   op2 -> u.GROUP_AGGR.groupAttrs,
+						   op1 -> u.GROUP_AGGR.numGroupAttrs) &&
+				sameAttrs (op1 -> u.GROUP_AGGR.aggrAttrs,
+						   op2 -> u.GROUP_AGGR.aggrAttrs,
+						   op1 -> u.GROUP_AGGR.numAggrAttrs));
+	
+	case PO_ROW_WIN:
+		return (op1 -> u.ROW_WIN.numRows == op2 -> u.ROW_WIN.numRows);
+	
+	case PO_RANGE_WIN:
+		return (op1 -> u.RANGE_WIN.timeUnits == op2 -> u.RANGE_WIN.timeUnits &&
+				op1 -> u.RANGE_WIN.slideUnits == op2 -> u.RANGE_WIN.slideUnits);
+	
+	case PO_PARTN_WIN:
+		return (op1 -> u.PARTN_WIN.numRows == op2 -> u.PARTN_WIN.numRows &&
+				op1 -> u.PARTN_WIN.numPartnAttrs ==
+				op2 -> u.PARTN_WIN.numPartnAttrs &&
+				sameAttrs (op1 -> u.PARTN_WIN.partnAttrs,
+						   op2 -> u.PARTN_WIN.partnAttrs,
+						   op1 -> u.PARTN_WIN.numPartnAttrs));
+	
+	case PO_DISTINCT:
+	case PO_ISTREAM:
+	case PO_DSTREAM:
+	case PO_RSTREAM:
+	case PO_UNION:
+	case PO_EXCEPT:
+		return true;
+	
+	default:
+		// Sources, outputs and sinks are never shared
+		return false;
+	}
+	
+	// never comes
+	return false;
+}
+
+static bool hasInput (Operator *op, Operator *input)
+{
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++)
+		if (op -> inputs [i] == input)
+			return true;
+	
+	return false;
+}
+
+/**
+ * Can op take over the outputs of dup?  An operator reads each of its
+ * inputs from a different queue, so no operator should end up reading
+ * op twice.
+ */
+
+static bool canMerge (Operator *op, Operator *dup)
+{
+	if (op -> numOutputs + dup -> numOutputs >= MAX_OUT_BRANCHING)
+		return false;
+	
+	for (unsigned int o = 0 ; o < dup -> numOutputs ; o++)
+		if (hasInput (dup -> outputs [o], op))
+			return false;
+	
+	return true;
+}
+
+static void removeOutput (Operator *child, Operator *parent)
+{
+	for (unsigned int o = 0 ; o < child -> numOutputs ; o++) {
+		if (child -> outputs [o] == parent) {
+			child -> outputs [o] = child -> outputs [-- (child -> numOutputs)];
+			return;
+		}
+	}
+	
+	// should never come here
+	ASSERT (0);
+}
+
+/**
+ * Connect all the outputs of dup to op, and disconnect dup from its
+ * inputs.
+ */
+
+static void mergeOp (Operator *op, Operator *dup)
+{
+	Operator *outOp;
+	
+	for (unsigned int o = 0 ; o < dup -> numOutputs ; o++) {
+		outOp = dup -> outputs [o];
+		
+		for (unsigned int i = 0 ; i < outOp -> numInputs ; i++)
+			if (outOp -> inputs [i] == dup)
+				outOp -> inputs [i] = op;
+		
+		ASSERT (op -> numOutputs < MAX_OUT_BRANCHING);
+		op -> outputs [op -> numOutputs ++] = outOp;
+	}
+	dup -> numOutputs = 0;
+	
+	for (unsigned int i = 0 ; i < dup -> numInputs ; i++)
+		removeOutput (dup -> inputs [i], dup);
+}
+
+static unsigned int numConjuncts (BExpr *conj)
+{
+	unsigned int num = 0;
+	
+	for ( ; conj ; conj = conj -> next)
+		num ++;
+	
+	return num;
+}
+
+static bool isListed (Operator *op, Operator **opList, unsigned int numOps)
+{
+	for (unsigned int o = 0 ; o < numOps ; o++)
+		if (opList [o] == op)
+			return true;
+	
+	return false;
+}
+
+/**
+ * Find the select that reads the same input as select and applies the
+ * most of its conjuncts, but not all of them: select can then read the
+ * output of that select and apply the remaining conjuncts only.  If
+ * opList is not null, only the selects in opList are considered.
+ */
+
+static Operator *findSubsumingSelect (Operator *select,
+									  Operator **opList,
+									  unsigned int numOps)
+{
+	Operator *inOp;
+	Operator *cand;
+	Operator *best;
+	unsigned int numCandPred;
+	unsigned int numBestPred;
+	
+	ASSERT (select -> kind == PO_SELECT);
+	
+	inOp = select -> inputs [0];
+	
+	best = 0;
+	numBestPred = 0;
+	for (unsigned int o = 0 ; o < inOp -> numOutputs ; o++) {
+		cand = inOp -> outputs [o];
+		
+		if (cand == select || cand -> kind != PO_SELECT ||
+			cand -> numOutputs >= MAX_OUT_BRANCHING - 1)
+			continue;
+		
+		if (opList && !isListed (cand, opList, numOps))
+			continue;
+		
+		numCandPred = numConjuncts (cand -> u.SELECT.pred);
+		if (numCandPred <= numBestPred)
+			continue;
+		
+		if (!subsumesPred (cand -> u.SELECT.pred, select -> u.SELECT.pred) ||
+			subsumesPred (select -> u.SELECT.pred, cand -> u.SELECT.pred))
+			continue;
+		
+		best = cand;
+		numBestPred = numCandPred;
+	}
+	
+	return best;
+}
+
+/**
+ * Make select read the output of subSelect, and drop the conjuncts that
+ * subSelect applies.
+ */
+
+static void stackSelect (Operator *select, Operator *subSelect)
+{
+	BExpr *pred, *nextPred;
+	BExpr *rest, *restTail;
+	
+	removeOutput (select -> inputs [0], select);
+	select -> inputs [0] = subSelect;
+	subSelect -> outputs [subSelect -> numOutputs ++] = select;
+	
+	rest = restTail = 0;
+	for (pred = select -> u.SELECT.pred ; pred ; pred = nextPred) {
+		nextPred = pred -> next;
+		
+		if (containsPred (subSelect -> u.SELECT.pred, pred))
+			continue;
+		
+		pred -> next = 0;
+		if (restTail)
+			restTail -> next = pred;
+		else
+			rest = pred;
+		restTail = pred;
+	}
+	
+	ASSERT (rest);
+	select -> u.SELECT.pred = rest;
+}
+
+int PlanManagerImpl::shareSubplans ()
+{
+	Operator *op, *dup, *nextDup;
+	Operator *subSelect;
+	unsigned int numShared;
+	unsigned int numStacked;
+	bool bChange;
+	
+	numShared = 0;
+	numStacked = 0;
+	
+	// Operators are shared bottom up: once the inputs of two operators
+	// are shared, the operators themselves can be
+	do {
+		bChange = false;
+		
+		for (op = usedOps ; op ; op = op -> next) {
+			for (dup = op -> next ; dup ; dup = nextDup) {
+				nextDup = dup -> next;
+				
+				if (!sameOp (op, dup) || !canMerge (op, dup))
+					continue;
+				
+				mergeOp (op, dup);
+				free_op (dup);
+				
+				numShared ++;
+				bChange = true;
+			}
+		}
+		
+		for (op = usedOps ; op ; op = op -> next) {
+			if (op -> kind != PO_SELECT)
+				continue;
+			
+			if ((subSelect = findSubsumingSelect (op, 0, 0)) != 0) {
+				stackSelect (op, subSelect);
+				
+				numStacked ++;
+				bChange = true;
+			}
+		}
+	} while (bChange);
+	
+	if (numShared > 0 || numStacked > 0)
+		LOG << "PlanManager: "
+			<< numShared << " operators shared across queries, "
+			<< numStacked << " selects stacked on shared selects"
+			<< endl;
+	
+	return 0;
+}
+
+int PlanManagerImpl::shareSubplans_mon (Operator *&plan,
+										Operator **opList,
+										unsigned int &numOps)
+{
+	Operator *op, *dup;
+	Operator *subSelect;
+	bool bChange;
+	
+	do {
+		bChange = false;
+		
+		for (unsigned int o = 0 ; o < numOps ; o++) {
+			op = opList [o];
+			
+			for (unsigned int d = o + 1 ; d < numOps ; ) {
+				dup = opList [d];
+				
+				if (!sameOp (op, dup) || !canMerge (op, dup)) {
+					d++;
+					continue;
+				}
+				
+				// Root operator is never shared, it is output
+				ASSERT (dup != plan);
+				
+				mergeOp (op, dup);
+				
+				// Move the last operator to the current position
+				numOps--;
+				opList [d] = opList [numOps];
+				
+				free_op (dup);
+				bChange = true;
+			}
+		}
+		
+		for (unsigned int o = 0 ; o < numOps ; o++) {
+			op = opList [o];
+			
+			if (op -> kind != PO_SELECT)
+				continue;
+			
+			if ((subSelect = findSubsumingSelect (op, opList, numOps)) != 0) {
+				stackSelect (op, subSelect);
+				bChange = true;
+			}
+		}
+	} while (bChange);
+	
+	return 0;
+}
@@ -0,0 +1,290 @@
+/**
+ * @file        plan_stats.cc
+ * @date        Oct. 17, 2026
+ * @brief       Statistics of the base tables used by the optimizer
+ */
+
+#ifndef _PLAN_MGR_IMPL_
+#include "metadata/plan_mgr_impl.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifdef _MONITOR_
+#ifndef _PROPERTY_
+#include "execution/monitors/property.h"
+#endif
+#endif
+
+using namespace Metadata;
+using namespace Physical;
+using namespace std;
+
+/// Minimum number of elements over which a rate is observed
+static const int MIN_RATE_SAMPLE = 100;
+
+/// A rate drifts when it changes by more than this factor
+static const double RATE_DRIFT = 2.0;
+
+/// Minimum number of input tuples over which a join selectivity is
+/// observed
+static const int MIN_JOIN_SAMPLE = 100;
+
+/// A join selectivity drifts when it changes by more than this factor
+static const double SEL_DRIFT = 2.0;
+
+static bool isBaseSource (const Operator *op)
+{
+	return (op -> kind == PO_STREAM_SOURCE || op -> kind == PO_RELN_SOURCE);
+}
+
+static bool isBinaryJoin (const Operator *op)
+{
+	return (op -> kind == PO_JOIN ||
+			op -> kind == PO_JOIN_PROJECT ||
+			op -> kind == PO_STR_JOIN ||
+			op -> kind == PO_STR_JOIN_PROJECT);
+}
+
+int PlanManagerImpl::savePlanRates ()
+{
+	unsigned int outerTable, innerTable;
+	
+	for (unsigned int t = 0 ; t < numTables ; t++) {
+		planRates [t] = 0.0;
+		obsTuples [t] = 0;
+		obsTs [t] = 0;
+		
+		if (isBaseSource (ops + sourceOps [t].opId))
+			planRates [t] = tableMgr -> getRate (sourceOps [t].tableId);
+	}
+	
+	for (unsigned int o = 0 ; o < MAX_OPS ; o++) {
+		planJoinSels [o] = 0.0;
+		obsJoinInput [o] = -1;
+	}
+	
+	for (Operator *op = usedOps ; op ; op = op -> next)
+		if (getJoinTables (op, outerTable, innerTable))
+			planJoinSels [op -> id] =
+				tableMgr -> getJoinSelectivity (outerTable, innerTable);
+	
+	return 0;
+}
+
+bool PlanManagerImpl::getJoinTables (const Operator *op,
+									 unsigned int &outerTable,
+									 unsigned int &innerTable) const
+{
+	const Operator *input;
+	unsigned int tables [2];
+	unsigned int t;
+	
+	if (!isBinaryJoin (op))
+		return false;
+	
+	ASSERT (op -> numInputs == 2);
+	
+	for (unsigned int i = 0 ; i < 2 ; i++) {
+		input = op -> inputs [i];
+		
+		while (input -> kind == PO_SELECT ||
+			   input -> kind == PO_PROJECT ||
+			   input -> kind == PO_ROW_WIN ||
+			   input -> kind == PO_RANGE_WIN ||
+			   input -> kind == PO_PARTN_WIN)
+			input = input -> inputs [0];
+		
+		if (!isBaseSource (input))
+			return false;
+		
+		for (t = 0 ; t < numTables ; t++)
+			if (ops + sourceOps [t].opId == input)
+				break;
+		
+		if (t == numTables)
+			return false;
+		
+		tables [i] = sourceOps [t].tableId;
+	}
+	
+	outerTable = tables [0];
+	innerTable = tables [1];
+	
+	return true;
+}
+
+/**
+ * The rate of a table is observed over the elements its source read
+ * since the rate was last observed, once there are MIN_RATE_SAMPLE of
+ * them: it follows the current rate of the table instead of its
+ * average over the whole run.
+ */
+
+int PlanManagerImpl::updateStatistics (bool &bDrifted)
+{
+	bDrifted = false;
+
+#ifdef _MONITOR_
+	int rc;
+	Operator *op;
+	int numTuples, lastTs;
+	double rate;
+	
+	for (unsigned int t = 0 ; t < numTables ; t++) {
+		op = ops + sourceOps [t].opId;
+		
+		// Not instantiated yet, or not a base table
+		if (!isBaseSource (op) || !op -> instOp)
+			continue;
+		
+		if ((rc = op -> instOp -> getIntProperty
+			 (Monitor::SOURCE_NUM_TUPLES, numTuples)) != 0)
+			return rc;
+		
+		if ((rc = op -> instOp -> getIntProperty
+			 (Monitor::OP_LAST_OUT_TS, lastTs)) != 0)
+			return rc;
+		
+		// The first observation only marks the beginning of the sample:
+		// timestamps need not start at 0
+		if (obsTs [t] == 0) {
+			obsTuples [t] = numTuples;
+			obsTs [t] = lastTs;
+			continue;
+		}
+		
+		if (numTuples - obsTuples [t] < MIN_RATE_SAMPLE ||
+			lastTs <= obsTs [t])
+			continue;
+		
+		rate = (double)(numTuples - obsTuples [t]) / (lastTs - obsTs [t]);
+		
+		obsTuples [t] = numTuples;
+		obsTs [t] = lastTs;
+		
+		if ((rc = tableMgr -> setRate (sourceOps [t].tableId, rate)) != 0)
+			return rc;
+		
+		if (planRates [t] == 0.0 ||
+			rate > planRates [t] * RATE_DRIFT ||
+			rate * RATE_DRIFT < planRates [t]) {
+			
+			LOG << "PlanManager: rate of "
+				<< tableMgr -> getTableName (sourceOps [t].tableId)
+				<< " drifted from "
+				<< planRates [t]
+				<< " to "
+				<< rate
+				<< endl;
+			
+			bDrifted = true;
+		}
+	}
+	
+	if ((rc = updateJoinSelectivities (bDrifted)) != 0)
+		return rc;
+#endif
+
+	return 0;
+}
+
+#ifdef _MONITOR_
+
+/**
+ * The selectivity of a join is observed over the input tuples it read
+ * since it was last observed, once there are MIN_JOIN_SAMPLE of them: the
+ * fraction of the pairs of an input tuple and a tuple of the synopsis of
+ * the other input (the relation, for a stream join) that joined.  This is
+ * the selectivity of all the predicates the join evaluates, relative to
+ * its inputs (after the selects below it), which is how the optimizer
+ * uses it.
+ */
+
+int PlanManagerImpl::updateJoinSelectivities (bool &bDrifted)
+{
+	int rc;
+	unsigned int outerTable, innerTable;
+	int numInput, numOutput;
+	double numPairs, pairs, sel, planSel;
+	
+	for (Operator *op = usedOps ; op ; op = op -> next) {
+		
+		// Not instantiated yet, or not a join of two base tables
+		if (!op -> instOp || !getJoinTables (op, outerTable, innerTable))
+			continue;
+		
+		if ((rc = op -> instOp -> getIntProperty
+			 (Monitor::JOIN_NINPUT, numInput)) != 0)
+			return rc;
+		
+		if ((rc = op -> instOp -> getDoubleProperty
+			 (Monitor::JOIN_NPAIRS, numPairs)) != 0)
+			return rc;
+		
+		if ((rc = op -> instOp -> getIntProperty
+			 (Monitor::JOIN_NOUTPUT, numOutput)) != 0)
+			return rc;
+		
+		// The first observation (of this operator) only marks the
+		// beginning of the sample
+		if (obsJoinInput [op -> id] < 0 ||
+			numInput < obsJoinInput [op -> id]) {
+			obsJoinInput [op -> id] = numInput;
+			obsJoinPairs [op -> id] = numPairs;
+			obsJoinOutput [op -> id] = numOutput;
+			continue;
+		}
+		
+		if (numInput - obsJoinInput [op -> id] < MIN_JOIN_SAMPLE)
+			continue;
+		
+		pairs = numPairs - obsJoinPairs [op -> id];
+		
+		// Nothing to join with yet
+		if (pairs < 1.0)
+			continue;
+		
+		// No tuple joined: the selectivity is below one in pairs
+		if (numOutput > obsJoinOutput [op -> id])
+			sel = (numOutput - obsJoinOutput [op -> id]) / pairs;
+		else
+			sel = 1.0 / pairs;
+		
+		if (sel > 1.0)
+			sel = 1.0;
+		
+		obsJoinInput [op -> id] = numInput;
+		obsJoinPairs [op -> id] = numPairs;
+		obsJoinOutput [op -> id] = numOutput;
+		
+		if ((rc = tableMgr -> setJoinSelectivity (outerTable, innerTable,
+												  sel)) != 0)
+			return rc;
+		
+		planSel = planJoinSels [op -> id];
+		
+		if (planSel == 0.0 ||
+			sel > planSel * SEL_DRIFT ||
+			sel * SEL_DRIFT < planSel) {
+			
+			LOG << "PlanManager: selectivity of the join of "
+				<< tableMgr -> getTableName (outerTable)
+				<< " and "
+				<< tableMgr -> getTableName (innerTable)
+				<< " drifted from "
+				<< planSel
+				<< " to "
+				<< sel
+				<< endl;
+			
+			bDrifted = true;
+		}
+	}
+	
+	return 0;
+}
+
+#endif
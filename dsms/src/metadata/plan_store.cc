@@ -60,6 +60,11 @@ int PlanManagerImpl::getSharedSynType (Operator *op,
 		synKind = REL_SYN;
 		break;
 		
+	case PO_MJOIN:
+		bSynReq = true;
+		synKind = REL_SYN;
+		break;
+		
 	case PO_STR_JOIN:
 	case PO_STR_JOIN_PROJECT:
 		
@@ -184,6 +189,14 @@ int PlanManagerImpl::setSharedStore (Operator *op, unsigned int inputIdx,
 		
 		break;
 		
+	case PO_MJOIN:
+		ASSERT (op -> u.MJOIN.inSyns [inputIdx]);
+		
+		if ((rc = mk_stub (op -> u.MJOIN.inSyns [inputIdx], store)) != 0)
+			return rc;
+		
+		break;
+		
 	case PO_STR_JOIN:
 
 		ASSERT (op -> u.STR_JOIN.innerSyn);
@@ -283,6 +296,7 @@ Store *PlanManagerImpl::new_store (StoreKind kind)
 	store -> kind = kind;
 	store -> numStubs = 0;
 	store -> instStore = 0;
+	store -> bConcurrent = false;
 	
 	numStores ++;
 	return store;
@@ -517,6 +531,31 @@ int PlanManagerImpl::add_store (Operator *op)
 		}
 		
 		break;
+		
+	case PO_MJOIN:
+		if (op -> bStream) {
+			storeKind = SIMPLE_STORE;
+			
+			for (unsigned int o = 0 ; o < op -> numOutputs ; o++) {
+				if (bReqStore [o]) {
+					storeKind = WIN_STORE;
+					break;
+				}
+			}
+			
+			store = new_store (storeKind);
+		}
+		
+		else {
+			store = new_store (LIN_STORE);
+			store -> u.LIN_STORE.idx = 0;
+			store -> u.LIN_STORE.numLineage = op -> numInputs;
+			
+			if ((rc = mk_stub (op -> u.MJOIN.joinSyn, store)) != 0)
+				return rc;
+		}
+		
+		break;
 
 		
 	case PO_STR_JOIN:
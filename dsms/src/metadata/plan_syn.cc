@@ -17,6 +17,21 @@ using namespace Physical;
 using namespace Metadata;
 
 
+/**
+ * Do tuples leave the relation produced by op in the order in which
+ * they entered it?  This is the case for the output of a row or range
+ * window, possibly filtered by selections, which pass the input tuples
+ * through unchanged.
+ */
+
+static bool isFifoRel (Operator *op)
+{
+	while (op -> kind == PO_SELECT)
+		op = op -> inputs [0];
+	
+	return (op -> kind == PO_ROW_WIN || op -> kind == PO_RANGE_WIN);
+}
+
 /**
  * Allocate a new synopsis from the pool of available synopses
  */
@@ -130,6 +145,45 @@ int PlanManagerImpl::add_syn_join (Operator *op)
 	return 0;
 }
 
+/**
+ * Like a binary join, a multi-way join needs a relation synopsis for
+ * each input, and a join synopsis if it produces a relation.  It needs
+ * no synopses for the joins of subsets of its inputs.
+ */
+
+int PlanManagerImpl::add_syn_mjoin (Operator *op)
+{
+	Synopsis *inSyn, *join;
+	
+	ASSERT (op);
+	ASSERT (op -> kind == PO_MJOIN);
+	
+	for (unsigned int i = 0 ; i < op -> numInputs ; i++) {
+		inSyn = new_syn (REL_SYN);
+		if (!inSyn)
+			return -1;
+		
+		op -> u.MJOIN.inSyns [i] = inSyn;
+		inSyn -> ownOp = op;
+	}
+	
+	if (!op -> bStream) {
+		join = new_syn (LIN_SYN);
+		
+		if (!join)
+			return -1;
+		
+		op -> u.MJOIN.joinSyn = join;
+		join -> ownOp = op;
+	}
+	
+	else {
+		op -> u.MJOIN.joinSyn = 0;
+	}
+	
+	return 0;
+}
+
 /**
  * A stream join requires a synopsis for its outer input.  No synopsis is
  * required for its inner & its join output.
@@ -235,9 +289,11 @@ int PlanManagerImpl::add_syn_gby_aggr (Operator *op)
 	outSyn -> ownOp = op;
 	
 	// We need the inner synopsis iff one of the aggr. functions is a max
-	// or min and the input is not a stream
+	// or min and the input is not a stream.  If tuples leave the input
+	// in the order in which they entered it, the operator maintains max
+	// and min without rescanning the input (see MinMaxSynopsis).
 	bInSynNeeded = false;
-	if (!op -> inputs [0] -> bStream) {
+	if (!op -> inputs [0] -> bStream && !isFifoRel (op -> inputs [0])) {
 		for (unsigned int f = 0 ; f < op -> u.GROUP_AGGR.numAggrAttrs &&
 				 !bInSynNeeded ; f++) {
 			if ((op -> u.GROUP_AGGR.fn [f] == MAX) ||
@@ -445,6 +501,8 @@ int PlanManagerImpl::add_syn (Operator *op)
 		
 	case PO_STR_JOIN_PROJECT: return add_syn_str_join_proj (op);
 		
+	case PO_MJOIN: return add_syn_mjoin (op);
+		
 	case PO_GROUP_AGGR: return add_syn_gby_aggr (op);
 		
 	case PO_DISTINCT: return add_syn_distinct (op);
@@ -105,7 +105,20 @@ static void transToJoinAttr (Attr &attr, Operator *join)
 	ASSERT (attr.input == 0);
 	ASSERT (attr.pos < join -> numAttrs);
 	
-	// We only deal with binary joins
+	// Multi-way join: the attributes of the inputs follow each other
+	if (join -> kind == PO_MJOIN) {
+		
+		while (join -> u.MJOIN.numInputAttrs [attr.input] <= attr.pos) {
+			attr.pos -= join -> u.MJOIN.numInputAttrs [attr.input];
+			attr.input ++;
+			
+			ASSERT (attr.input < join -> numInputs);
+		}
+		
+		return;
+	}
+	
+	// Otherwise we only deal with binary joins
 	ASSERT (join -> numInputs == 2);
 	ASSERT (join -> inputs [0]);
 	ASSERT (join -> inputs [1]);
@@ -215,6 +228,13 @@ static bool mergeSelect (Operator *op)
 		return true;
 	}
 	
+	if (inOp -> kind == PO_MJOIN) {
+		transToJoinPred (op -> u.SELECT.pred, inOp);
+		
+		append (inOp -> u.MJOIN.pred, op -> u.SELECT.pred);
+		return true;
+	}
+	
 	return false;
 }
 
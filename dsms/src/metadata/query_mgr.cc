@@ -59,3 +59,14 @@ int QueryManager::registerQuery (const char *qryStr,
 	return 0;
 }
 
+unsigned int QueryManager::getNumQueries () const
+{
+	return numQueries;
+}
+
+const char *QueryManager::getQuery (unsigned int queryId) const
+{
+	ASSERT (queryId < numQueries);
+	
+	return queries [queryId];
+}
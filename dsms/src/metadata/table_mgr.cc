@@ -28,6 +28,10 @@ TableManager::TableManager()
 {
 	numTables = 0;
 	
+	for (unsigned int t = 0 ; t < MAX_TABLES ; t++)
+		for (unsigned int u = 0 ; u < MAX_TABLES ; u++)
+			joinSels [t][u] = 0.0;
+	
 #ifdef _SYS_STR_
 	registerSysStr ();	
 #endif
@@ -71,6 +75,7 @@ int TableManager::registerStream(const char     *streamName,
 	tableList [numTables].tableName  = strdup(streamName);
 	tableList [numTables].isStream   = true;
 	tableList [numTables].numAttrs   = 0;	
+	tableList [numTables].rate       = 0.0;
 	
 	numTables++;
 	
@@ -97,6 +102,7 @@ int TableManager::registerRelation(const char       *relName,
 	tableList [numTables].tableName  = strdup(relName);
 	tableList [numTables].isStream   = false;
 	tableList [numTables].numAttrs   = 0;	
+	tableList [numTables].rate       = 0.0;
 	
 	numTables++;
 	
@@ -215,6 +221,45 @@ const char *TableManager::getTableName (unsigned int tableId) const
 	return tableList [tableId].tableName;
 }
 
+int TableManager::setRate (unsigned int tableId, double rate)
+{
+	if (tableId >= numTables || rate < 0.0)
+		return -1;
+	
+	tableList [tableId].rate = rate;
+	
+	return 0;
+}
+
+double TableManager::getRate (unsigned int tableId) const
+{
+	ASSERT (tableId < numTables);
+	
+	return tableList [tableId].rate;
+}
+
+int TableManager::setJoinSelectivity (unsigned int tableId1,
+									  unsigned int tableId2,
+									  double sel)
+{
+	if (tableId1 >= numTables || tableId2 >= numTables ||
+		sel < 0.0 || sel > 1.0)
+		return -1;
+	
+	joinSels [tableId1][tableId2] = sel;
+	joinSels [tableId2][tableId1] = sel;
+	
+	return 0;
+}
+
+double TableManager::getJoinSelectivity (unsigned int tableId1,
+										 unsigned int tableId2) const
+{
+	ASSERT (tableId1 < numTables && tableId2 < numTables);
+	
+	return joinSels [tableId1][tableId2];
+}
+
 #ifdef _SYS_STR_
 
 void TableManager::registerSysStr ()
@@ -0,0 +1,447 @@
+/**
+ * @file     log_join_order.cc
+ * @date     Oct. 17, 2026
+ * @brief    Cost-based ordering of the inputs of a cross product
+ */
+
+#ifndef _LOG_PLAN_GEN_
+#include "querygen/log_plan_gen.h"
+#endif
+
+#ifndef _DEBUG_
+#include "common/debug.h"
+#endif
+
+#ifndef _PHY_OP_
+#include "metadata/phy_op.h"
+#endif
+
+using namespace Logical;
+
+/// Evaluate joins of a few relations by a multi-way join operator
+extern bool MULTIWAY_JOIN;
+
+/// Maximum number of predicates considered for the ordering
+static const unsigned int MAX_PREDS = 50;
+
+/// Rate assumed for a table whose rate is not known
+static const double DEFAULT_RATE = 1.0;
+
+/// Number of time units of a table without a window (relations and
+/// unbounded windows) assumed to be live
+static const double UNBOUNDED_HORIZON = 1000.0;
+
+/// Number of partitions assumed for a partitioned window
+static const double NUM_PARTITIONS = 10.0;
+
+/// Default selectivities of the predicates (for the joins of two tables,
+/// unless their selectivity has been observed)
+static const double EQ_SEL    = 0.1;
+static const double NE_SEL    = 0.9;
+static const double RANGE_SEL = 1.0 / 3;
+
+/**
+ * Get the table (and its variable) at the bottom of an input of a
+ * cross: an input is a source, possibly below a window.
+ */
+static bool getInputTable (const Operator *input,
+						   unsigned int &varId, unsigned int &tableId)
+{
+	while (true) {
+		switch (input -> kind) {
+		case LO_STREAM_SOURCE:
+			varId = input -> u.STREAM_SOURCE.varId;
+			tableId = input -> u.STREAM_SOURCE.strId;
+			return true;
+		
+		case LO_RELN_SOURCE:
+			varId = input -> u.RELN_SOURCE.varId;
+			tableId = input -> u.RELN_SOURCE.relId;
+			return true;
+		
+		case LO_ROW_WIN:
+		case LO_RANGE_WIN:
+		case LO_NOW_WIN:
+		case LO_PARTN_WIN:
+			input = input -> inputs [0];
+			break;
+		
+		default:
+			return false;
+		}
+	}
+	
+	// never comes
+	return false;
+}
+
+/**
+ * Estimated number of tuples of an input of a cross, given the rate of
+ * its table
+ */
+static double getInputCard (const Operator *input, double rate)
+{
+	double card;
+	
+	switch (input -> kind) {
+	case LO_RANGE_WIN:
+		card = rate * input -> u.RANGE_WIN.timeUnits;
+		break;
+	
+	case LO_ROW_WIN:
+		card = input -> u.ROW_WIN.numRows;
+		break;
+	
+	case LO_PARTN_WIN:
+		card = input -> u.PARTN_WIN.numRows * NUM_PARTITIONS;
+		break;
+	
+	case LO_NOW_WIN:
+		card = rate;
+		break;
+	
+	default:
+		card = rate * UNBOUNDED_HORIZON;
+		break;
+	}
+	
+	return (card < 1.0)? 1.0 : card;
+}
+
+/**
+ * The inputs (bit i for input i) referenced by an expression.  Returns
+ * false if the expression references an attribute of no input.
+ */
+static bool getExprInputs (const Expr *expr, const unsigned int *varIds,
+						   unsigned int numInputs, unsigned int &mask)
+{
+	unsigned int i;
+	
+	switch (expr -> kind) {
+	case CONST_VAL:
+		return true;
+	
+	case ATTR_REF:
+		if (expr -> u.attr.kind != NAMED)
+			return false;
+		
+		for (i = 0 ; i < numInputs ; i++) {
+			if (varIds [i] == expr -> u.attr.u.NAMED.varId) {
+				mask |= (1 << i);
+				return true;
+			}
+		}
+		return false;
+	
+	case COMP_EXPR:
+		return (getExprInputs (expr -> u.COMP_EXPR.left, varIds,
+							   numInputs, mask) &&
+				getExprInputs (expr -> u.COMP_EXPR.right, varIds,
+							   numInputs, mask));
+	
+	default:
+		return false;
+	}
+	
+	// never comes
+	return false;
+}
+
+static double getSelectivity (const BExpr &bexpr)
+{
+	switch (bexpr.op) {
+	case EQ: return EQ_SEL;
+	case NE: return NE_SEL;
+	default: return RANGE_SEL;
+	}
+	
+	// never comes
+	return 1.0;
+}
+
+/**
+ * Estimated size of the join of an input with the inputs in mask,
+ * whose join has size card.
+ */
+static double joinCard (double card, unsigned int mask, unsigned int input,
+						const double *inputCard,
+						const unsigned int *predInputs,
+						const double *predSel, unsigned int numPreds)
+{
+	unsigned int newMask;
+	
+	newMask = mask | (1 << input);
+	card *= inputCard [input];
+	
+	// Predicates that become evaluable with the input
+	for (unsigned int p = 0 ; p < numPreds ; p++)
+		if ((predInputs [p] & (1 << input)) &&
+			(predInputs [p] & mask) &&
+			(predInputs [p] & ~newMask) == 0)
+			card *= predSel [p];
+	
+	return card;
+}
+
+/**
+ * Cost of a left-deep join order: the sum of the sizes of the
+ * intermediate results (the synopses of the joins above the first).
+ */
+static double orderCost (const unsigned int *order, unsigned int numInputs,
+						 const double *inputCard,
+						 const unsigned int *predInputs,
+						 const double *predSel, unsigned int numPreds)
+{
+	unsigned int mask;
+	double card, cost;
+	
+	mask = (1 << order [0]);
+	card = inputCard [order [0]];
+	cost = 0.0;
+	
+	for (unsigned int i = 1 ; i < numInputs ; i++) {
+		card = joinCard (card, mask, order [i], inputCard, predInputs,
+						 predSel, numPreds);
+		mask |= (1 << order [i]);
+		cost += card;
+	}
+	
+	return cost;
+}
+
+/**
+ * Transform:
+ *
+ *   Input plan pattern:
+ * (Stream)Cross (inp1, ..., inpn) --> Select* --> (...) --> Project|Aggr
+ *
+ *   Output:
+ * (Stream)Cross (inp_o1, ..., inp_on) --> Select* --> ...
+ *
+ * where o1, ..., on is the order in which the binary joins produced by
+ * t_makeCrossBinary are expected to be cheapest.  The size of each
+ * input is estimated from its window and the rate of its table, reduced
+ * by the selectivities of the predicates over the input alone.  The
+ * predicates that join two inputs have the selectivity observed for the
+ * join of their tables, if the plan has run such a join, and default
+ * selectivities otherwise.  The
+ * order is built greedily: it starts with the smallest input (the
+ * stream of a stream cross stays first), and then adds the input that
+ * minimizes the size of the intermediate result, preferring the inputs
+ * that are joined by a predicate with those already ordered.
+ *
+ * The FROM clause order is kept if no rate of the tables is known, if
+ * the greedy order is no cheaper, or if the cross is evaluated by a
+ * multi-way join (which orders its probes itself).
+ */
+
+int LogPlanGen::t_orderJoins (Operator *&plan)
+{
+	int rc;
+	Operator     *cross;
+	Operator     *op;
+	Operator     *select;
+	bool          bSchemaOp;
+	unsigned int  numInputs;
+	unsigned int  varIds [MAX_INPUT_OPS];
+	unsigned int  tableIds [MAX_INPUT_OPS];
+	double        joinSel;
+	bool          bJoinSelSet;
+	double        rate;
+	bool          bRateKnown;
+	double        inputCard [MAX_INPUT_OPS];
+	unsigned int  predInputs [MAX_PREDS];
+	double        predSel [MAX_PREDS];
+	unsigned int  numPreds;
+	unsigned int  order [MAX_INPUT_OPS];
+	unsigned int  fromOrder [MAX_INPUT_OPS];
+	unsigned int  mask;
+	double        card;
+	Operator     *inputs [MAX_INPUT_OPS];
+	
+	ASSERT (plan);
+	ASSERT (plan -> output == 0);
+	
+	// Walk down the tree to identify the cross operator.  The operators
+	// above it that determine their own schema hide the change in the
+	// order of its attributes.
+	cross = 0;
+	bSchemaOp = false;
+	op = plan;
+	
+	while (true) {
+		ASSERT (op);
+		
+		if (op -> kind == LO_CROSS || op -> kind == LO_STREAM_CROSS) {
+			cross = op;
+			break;
+		}
+		
+		if ((op -> kind == LO_PROJECT) ||
+			(op -> kind == LO_GROUP_AGGR)) {
+			bSchemaOp = true;
+			op = op -> inputs [0];
+		}
+		
+		else if ((op -> kind == LO_SELECT) ||
+				 (op -> kind == LO_DISTINCT) ||
+				 (op -> kind == LO_ISTREAM) ||
+				 (op -> kind == LO_DSTREAM) ||
+				 (op -> kind == LO_RSTREAM)) {
+			op = op -> inputs [0];
+		}
+		
+		// Unrecognized pattern
+		else {
+			return 0;
+		}
+	}
+	
+	numInputs = cross -> numInputs;
+	
+	if (numInputs <= 2 || !bSchemaOp)
+		return 0;
+	
+	// Evaluated by a multi-way join
+	if (cross -> kind == LO_CROSS && MULTIWAY_JOIN &&
+		numInputs <= Physical::MAX_IN_BRANCHING)
+		return 0;
+	
+	if (numInputs > sizeof(unsigned int) * 8)
+		return 0;
+	
+	// Size of the inputs
+	bRateKnown = false;
+	for (unsigned int i = 0 ; i < numInputs ; i++) {
+		if (!getInputTable (cross -> inputs [i], varIds [i], tableIds [i]))
+			return 0;
+		
+		rate = _tableMgr -> getRate (tableIds [i]);
+		if (rate > 0.0)
+			bRateKnown = true;
+		else
+			rate = DEFAULT_RATE;
+		
+		inputCard [i] = getInputCard (cross -> inputs [i], rate);
+	}
+	
+	if (!bRateKnown)
+		return 0;
+	
+	// The predicates: the selects directly above the cross
+	numPreds = 0;
+	for (select = cross -> output ; select && select -> kind == LO_SELECT ;
+		 select = select -> output) {
+		
+		mask = 0;
+		if (!getExprInputs (select -> u.SELECT.bexpr.left, varIds,
+							numInputs, mask) ||
+			!getExprInputs (select -> u.SELECT.bexpr.right, varIds,
+							numInputs, mask))
+			continue;
+		
+		// Predicate over a single input: reduces the size of the input
+		if ((mask & (mask - 1)) == 0) {
+			for (unsigned int i = 0 ; i < numInputs ; i++)
+				if (mask == (unsigned int)(1 << i))
+					inputCard [i] *= getSelectivity (select -> u.SELECT.bexpr);
+			continue;
+		}
+		
+		if (numPreds == MAX_PREDS)
+			continue;
+		
+		predInputs [numPreds] = mask;
+		predSel [numPreds] = getSelectivity (select -> u.SELECT.bexpr);
+		numPreds++;
+	}
+	
+	// The predicates that join two inputs whose join has been observed
+	// running: together, their selectivity is the observed one
+	for (unsigned int i = 0 ; i < numInputs ; i++) {
+		for (unsigned int j = i + 1 ; j < numInputs ; j++) {
+			joinSel = _tableMgr -> getJoinSelectivity (tableIds [i],
+													   tableIds [j]);
+			if (joinSel <= 0.0)
+				continue;
+			
+			bJoinSelSet = false;
+			for (unsigned int p = 0 ; p < numPreds ; p++) {
+				if (predInputs [p] != (unsigned int)((1 << i) | (1 << j)))
+					continue;
+				
+				predSel [p] = bJoinSelSet? 1.0 : joinSel;
+				bJoinSelSet = true;
+			}
+		}
+	}
+	
+	// The first input: the stream of a stream cross, or the smallest
+	order [0] = 0;
+	if (cross -> kind == LO_CROSS)
+		for (unsigned int i = 1 ; i < numInputs ; i++)
+			if (inputCard [i] < inputCard [order [0]])
+				order [0] = i;
+	
+	mask = (1 << order [0]);
+	card = inputCard [order [0]];
+	
+	for (unsigned int o = 1 ; o < numInputs ; o++) {
+		bool   bBestJoined, bJoined;
+		double bestCard, newCard;
+		unsigned int best;
+		
+		best = numInputs;
+		bestCard = 0.0;
+		bBestJoined = false;
+		
+		for (unsigned int i = 0 ; i < numInputs ; i++) {
+			if (mask & (1 << i))
+				continue;
+			
+			bJoined = false;
+			for (unsigned int p = 0 ; p < numPreds ; p++)
+				if ((predInputs [p] & (1 << i)) && (predInputs [p] & mask))
+					bJoined = true;
+			
+			newCard = joinCard (card, mask, i, inputCard, predInputs,
+								predSel, numPreds);
+			
+			if ((best == numInputs) ||
+				(bJoined && !bBestJoined) ||
+				(bJoined == bBestJoined && newCard < bestCard)) {
+				best = i;
+				bestCard = newCard;
+				bBestJoined = bJoined;
+			}
+		}
+		
+		ASSERT (best < numInputs);
+		
+		order [o] = best;
+		mask |= (1 << best);
+		card = bestCard;
+	}
+	
+	// Keep the FROM clause order unless the new one is cheaper
+	for (unsigned int i = 0 ; i < numInputs ; i++)
+		fromOrder [i] = i;
+	
+	if (orderCost (order, numInputs, inputCard, predInputs, predSel,
+				   numPreds) >=
+		orderCost (fromOrder, numInputs, inputCard, predInputs, predSel,
+				   numPreds))
+		return 0;
+	
+	// Reorder the inputs, and update the schemas above the cross up to
+	// the operator that determines the schema of the query
+	for (unsigned int i = 0 ; i < numInputs ; i++)
+		inputs [i] = cross -> inputs [i];
+	for (unsigned int i = 0 ; i < numInputs ; i++)
+		cross -> inputs [i] = inputs [order [i]];
+	
+	if ((rc = update_schema_recursive (cross)) != 0)
+		return rc;
+	
+	return 0;
+}
@@ -6,6 +6,10 @@
 #include "common/debug.h"
 #endif
 
+#ifndef _PHY_OP_
+#include "metadata/phy_op.h"
+#endif
+
 /// debug
 #ifdef _DM_
 #include "querygen/logop_debug.h"
@@ -16,6 +20,9 @@ using namespace std;
 
 using namespace Logical;
 
+/// Evaluate joins of a few relations by a multi-way join operator
+extern bool MULTIWAY_JOIN;
+
 int LogPlanGen::genLogPlan (const Semantic::Query &query,
 							Logical::Operator *& queryPlan) 
 {
@@ -43,6 +50,11 @@ int LogPlanGen::genLogPlan (const Semantic::Query &query,
 	
 	ASSERT (check_plan (queryPlan));
 	
+	if((rc = t_orderJoins (queryPlan)) != 0)
+		return rc;
+	
+	ASSERT (check_plan (queryPlan));
+	
 	if((rc = t_removeProject (queryPlan)) != 0)
 		return rc;
 	
@@ -394,6 +406,9 @@ int LogPlanGen::t_streamCross (Operator *&plan)
  *
  *   Output:
  * Cross(.. Cross(Cross(inp1,inp2), inp3) ..) --> (select .... xstream)
+ *
+ * With MULTIWAY_JOIN, a cross of up to Physical::MAX_IN_BRANCHING inputs
+ * is left as it is, and becomes a single multi-way join (PO_MJOIN).
  */ 
 
 int LogPlanGen::t_makeCrossBinary(Operator *&plan)
@@ -441,6 +456,10 @@ int LogPlanGen::t_makeCrossBinary(Operator *&plan)
 	if(numInputs == 2) 
 		return 0;
 	
+	// Evaluated by a multi-way join: no work to do.
+	if (MULTIWAY_JOIN && numInputs <= Physical::MAX_IN_BRANCHING)
+		return 0;
+	
 	Operator *binCross, *binCrossParent;
 	
 	// Join the first two inputs to get the first of the sequence of
@@ -6,6 +6,10 @@
 #include "common/debug.h"
 #endif
 
+#ifndef _SCHEDULER_
+#include "execution/scheduler/scheduler.h"
+#endif
+
 #include <ctype.h>
 
 using std::endl;
@@ -89,6 +93,22 @@ static const char *SHARED_QUEUE_SIZE_P = "SHARED_QUEUE_SIZE";
 static const char *INDEX_THRESHOLD_P   = "INDEX_THRESHOLD";
 static const char *RUN_TIME_P          = "RUN_TIME";
 static const char *CPU_SPEED_P         = "CPU_SPEED";
+static const char *NUM_THREADS_P       = "NUM_THREADS";
+static const char *SCHEDULER_P         = "SCHEDULER";
+static const char *MAX_MEMORY_SIZE_P   = "MAX_MEMORY_SIZE";
+static const char *HUGE_PAGES_P        = "HUGE_PAGES";
+static const char *NUMA_P              = "NUMA";
+static const char *VECTORIZE_P         = "VECTORIZE";
+static const char *OPEN_HASH_INDEX_P   = "OPEN_HASH_INDEX";
+static const char *JOIN_THREADS_P      = "JOIN_THREADS";
+static const char *MULTIWAY_JOIN_P     = "MULTIWAY_JOIN";
+static const char *REPLAN_INTERVAL_P   = "REPLAN_INTERVAL";
+
+// Values of SCHEDULER
+static const char *ROUND_ROBIN_V       = "round_robin";
+static const char *WORK_STEALING_V     = "work_stealing";
+static const char *CHAIN_V             = "chain";
+static const char *FIFO_V              = "fifo";
 
 int ConfigFileReader::parseLine (const char *line,
 								 Param      &param,
@@ -134,6 +154,56 @@ int ConfigFileReader::parseLine (const char *line,
 			 (strncmp(begin, CPU_SPEED_P, 9) == 0)) {
 		param = CPU_SPEED;
 	}
+
+	else if ((ptr - begin == 11) &&
+			 (strncmp(begin, NUM_THREADS_P, 11) == 0)) {
+		param = NUM_THREADS;
+	}
+
+	else if ((ptr - begin == 9) &&
+			 (strncmp(begin, SCHEDULER_P, 9) == 0)) {
+		param = SCHEDULER;
+	}
+	
+	else if ((ptr - begin == 15) &&
+			 (strncmp(begin, MAX_MEMORY_SIZE_P, 15) == 0)) {
+		param = MAX_MEMORY_SIZE;
+	}
+	
+	else if ((ptr - begin == 10) &&
+			 (strncmp(begin, HUGE_PAGES_P, 10) == 0)) {
+		param = HUGE_PAGES;
+	}
+	
+	else if ((ptr - begin == 4) &&
+			 (strncmp(begin, NUMA_P, 4) == 0)) {
+		param = NUMA;
+	}
+	
+	else if ((ptr - begin == 9) &&
+			 (strncmp(begin, VECTORIZE_P, 9) == 0)) {
+		param = VECTORIZE;
+	}
+	
+	else if ((ptr - begin == 15) &&
+			 (strncmp(begin, OPEN_HASH_INDEX_P, 15) == 0)) {
+		param = OPEN_HASH_INDEX;
+	}
+	
+	else if ((ptr - begin == 12) &&
+			 (strncmp(begin, JOIN_THREADS_P, 12) == 0)) {
+		param = JOIN_THREADS;
+	}
+	
+	else if ((ptr - begin == 13) &&
+			 (strncmp(begin, MULTIWAY_JOIN_P, 13) == 0)) {
+		param = MULTIWAY_JOIN;
+	}
+	
+	else if ((ptr - begin == 15) &&
+			 (strncmp(begin, REPLAN_INTERVAL_P, 15) == 0)) {
+		param = REPLAN_INTERVAL;
+	}
 	
 	else {
 		LOG << "ConfigFileReader: unknown parameter in line no "
@@ -166,18 +236,31 @@ int ConfigFileReader::parseLine (const char *line,
 		return -1;
 	}
 	
-	if (param == MEMORY_SIZE        ||
-		param == QUEUE_SIZE         ||
+	if (param == QUEUE_SIZE         ||
 		param == SHARED_QUEUE_SIZE  ||
-		param == CPU_SPEED) {
+		param == CPU_SPEED          ||
+		param == NUM_THREADS        ||
+		param == HUGE_PAGES         ||
+		param == NUMA               ||
+		param == VECTORIZE          ||
+		param == OPEN_HASH_INDEX    ||
+		param == JOIN_THREADS       ||
+		param == MULTIWAY_JOIN) {
 		
 		val.ival = atoi (ptr);
 	}
 	
-	else if (param == RUN_TIME) {
+	else if (param == RUN_TIME         ||
+			 param == MEMORY_SIZE      ||
+			 param == MAX_MEMORY_SIZE  ||
+			 param == REPLAN_INTERVAL) {
 		val.lval = atoll(ptr);		
 	}
 	
+	else if (param == SCHEDULER) {
+		return parseScheduler (ptr, val);
+	}
+	
 	else {
 		val.dval = atof (ptr);
 	}
@@ -185,3 +268,40 @@ int ConfigFileReader::parseLine (const char *line,
 	return 0;
 }
 	
+
+int ConfigFileReader::parseScheduler (const char *ptr, ParamVal &val)
+{
+	const char *begin;
+	
+	begin = ptr;
+	for (; *ptr && (isalpha (*ptr) || *ptr == '_') ; ptr++);
+	
+	if ((ptr - begin == 11) &&
+		(strncmp (begin, ROUND_ROBIN_V, 11) == 0)) {
+		val.ival = Execution::RR_SCHEDULER;
+	}
+	
+	else if ((ptr - begin == 13) &&
+			 (strncmp (begin, WORK_STEALING_V, 13) == 0)) {
+		val.ival = Execution::WS_SCHEDULER;
+	}
+	
+	else if ((ptr - begin == 5) &&
+			 (strncmp (begin, CHAIN_V, 5) == 0)) {
+		val.ival = Execution::CHAIN_SCHEDULER;
+	}
+	
+	else if ((ptr - begin == 4) &&
+			 (strncmp (begin, FIFO_V, 4) == 0)) {
+		val.ival = Execution::FIFO_SCHEDULER;
+	}
+	
+	else {
+		LOG << "ConfigFileReader: unknown scheduler in line no "
+			<< lineNo
+			<< endl;
+		return -1;
+	}
+	
+	return 0;
+}
@@ -4,6 +4,8 @@
  * @brief      Implementation of the STREAM server.
  */
 
+#include <string.h>
+
 /// debug
 #include <iostream>
 using namespace std;
@@ -41,6 +43,26 @@ using namespace std;
 #include "execution/scheduler/round_robin.h"
 #endif
 
+#ifndef _THREAD_POOL_
+#include "execution/scheduler/thread_pool.h"
+#endif
+
+#ifndef _WORK_STEALING_
+#include "execution/scheduler/work_stealing.h"
+#endif
+
+#ifndef _CHAIN_
+#include "execution/scheduler/chain.h"
+#endif
+
+#ifndef _FIFO_
+#include "execution/scheduler/fifo.h"
+#endif
+
+#ifndef _BIN_JOIN_
+#include "execution/operators/bin_join.h"
+#endif
+
 #ifndef _CONFIG_FILE_READER_
 #include "server/config_file_reader.h"
 #endif
@@ -49,6 +71,10 @@ using namespace std;
 #include "server/params.h"
 #endif
 
+#ifdef _TRACE_
+#include "execution/monitors/trace_buffer.h"
+#endif
+
 #ifdef _DM_
 #include "querygen/query_debug.h"
 #include "parser/nodes_debug.h"
@@ -75,14 +101,25 @@ ServerImpl::ServerImpl(ostream &_LOG)
 	qryMgr            = 0;
 	planMgr           = 0;
 	scheduler         = 0;
+	numAppQueries     = 0;
 	
 	// Set default values of various server params
 	MEMORY            = MEMORY_DEFAULT;
+	MAX_MEMORY        = MAX_MEMORY_DEFAULT;
+	HUGE_PAGES        = HUGE_PAGES_DEFAULT;
+	NUMA              = NUMA_DEFAULT;
+	VECTORIZE         = VECTORIZE_DEFAULT;
+	OPEN_HASH_INDEX   = OPEN_HASH_INDEX_DEFAULT;
+	JOIN_THREADS      = JOIN_THREADS_DEFAULT;
+	MULTIWAY_JOIN     = MULTIWAY_JOIN_DEFAULT;
+	REPLAN_INTERVAL   = REPLAN_INTERVAL_DEFAULT;
 	QUEUE_SIZE        = QUEUE_SIZE_DEFAULT;
 	SHARED_QUEUE_SIZE = SHARED_QUEUE_SIZE_DEFAULT;
 	INDEX_THRESHOLD   = INDEX_THRESHOLD_DEFAULT;
 	SCHEDULER_TIME    = SCHEDULER_TIME_DEFAULT;
 	CPU_SPEED         = CPU_SPEED_DEFAULT;
+	NUM_THREADS       = NUM_THREADS_DEFAULT;
+	SCHEDULER         = SCHEDULER_DEFAULT;
 	
 	pthread_mutex_init (&mutex, NULL);
 	pthread_cond_init (&mainThreadWait, NULL);
@@ -172,6 +209,7 @@ int ServerImpl::registerBaseTable(const char *tableInfo,
 	int rc;
 	NODE  *parseTree;
 	unsigned int tableId;
+	double rate;
 
 	// Tables can be registered only in S_APP_SPEC mode (before
 	// endApplicationSpec() has been called)
@@ -202,6 +240,13 @@ int ServerImpl::registerBaseTable(const char *tableInfo,
 		return PARSE_ERR;
 	}
 	
+	// Rate declared by the source: used for the plans of the queries
+	// registered before the rate of the table is observed
+	if (input && input -> getRateHint (rate) == 0) {
+		if ((rc = tableMgr -> setRate (tableId, rate)) != 0)
+			return rc;
+	}
+	
 	// Inform the plan manager about the new table
 	if ((rc = planMgr -> addBaseTable (tableId, input)) != 0)
 		return rc;
@@ -286,6 +331,7 @@ int ServerImpl::registerMonitor (const char *monitorSpec,
 	NODE *parseTree;
 	Semantic::Query semQuery;
 	Logical::Operator *logPlan;
+	bool bDrifted;
 	int rc;
 
 	ASSERT (output);
@@ -321,6 +367,12 @@ int ServerImpl::registerMonitor (const char *monitorSpec,
 		return rc;
 	}	
 
+	// Plan the monitor with the rates of the tables observed so far
+	if ((rc = planMgr -> updateStatistics (bDrifted)) != 0) {
+		resumeExecution ();
+		return rc;
+	}
+	
 	LOG << "log plan..." << endl;
 	
 	// SemanticQuery -> logical plan
@@ -432,11 +484,34 @@ int ServerImpl::endAppSpecification()
 	if ((rc = planMgr -> instantiate ()) != 0)
 		return rc;
 	
-	scheduler = new Execution::RoundRobinScheduler();
+	// Operators are partitioned into fragments by the plan manager (see
+	// assign_fragments()); a single fragment is run by the round robin
+	// scheduler in this thread.  The chain and fifo schedulers always use
+	// a single fragment.
+	if (SCHEDULER == Execution::WS_SCHEDULER)
+		scheduler = new Execution::WorkStealingScheduler (NUM_THREADS, LOG);
+	else if (SCHEDULER == Execution::CHAIN_SCHEDULER)
+		scheduler = new Execution::ChainScheduler (LOG);
+	else if (SCHEDULER == Execution::FIFO_SCHEDULER)
+		scheduler = new Execution::FifoScheduler (LOG);
+	else if (NUM_THREADS > 1)
+		scheduler = new Execution::ThreadPoolScheduler (NUM_THREADS, LOG);
+	else
+		scheduler = new Execution::RoundRobinScheduler();
 	
 	if ((rc = planMgr -> initScheduler (scheduler)) != 0)
 		return rc;
 	
+	// The new operators of a migrated plan run in the server thread
+	if (REPLAN_INTERVAL > 0 &&
+		(NUM_THREADS > 1 || SCHEDULER == Execution::WS_SCHEDULER)) {
+		LOG << "Server: REPLAN_INTERVAL requires a single thread: "
+			<< "the plan will not be changed" << endl;
+		REPLAN_INTERVAL = 0;
+	}
+	
+	numAppQueries = qryMgr -> getNumQueries ();
+	
 	state = S_PLAN_GEN;
 	
 	return 0;
@@ -496,7 +571,7 @@ int ServerImpl::beginExecution()
 	pthread_mutex_unlock (&mutex);	
 	
 	while (state == S_EXEC) {
-		if ((rc = scheduler -> run (SCHEDULER_TIME)) != 0)
+		if ((rc = runScheduler ()) != 0)
 			return rc;
 		
 		ASSERT (state == S_EXEC || state == S_INT || state == S_END);
@@ -532,9 +607,108 @@ int ServerImpl::beginExecution()
 	if ((rc = planMgr -> printStat()) != 0)
 		return rc;   
 	
+#ifdef _TRACE_
+	Monitor::TraceBuffer::dump (LOG);
+#endif
+	
 	return 0;
 }
 
+/**
+ * The scheduler runs REPLAN_INTERVAL iterations at a time, and the rates
+ * of the tables are checked in between.  It returns when SCHEDULER_TIME
+ * iterations are done (never if SCHEDULER_TIME is 0), or when the
+ * execution is interrupted or stopped.
+ */
+
+int ServerImpl::runScheduler ()
+{
+#ifdef _SYS_STR_
+	int rc;
+	long long int numIters;
+	
+	if (REPLAN_INTERVAL > 0) {
+		for (long long int t = 0 ;
+			 SCHEDULER_TIME == 0 || t < SCHEDULER_TIME ;
+			 t += numIters) {
+			
+			numIters = REPLAN_INTERVAL;
+			if (SCHEDULER_TIME > 0 && numIters > SCHEDULER_TIME - t)
+				numIters = SCHEDULER_TIME - t;
+			
+			if ((rc = scheduler -> run (numIters)) != 0)
+				return rc;
+			
+			// Interrupted or stopped
+			if (state != S_EXEC)
+				return 0;
+			
+			if ((rc = replan ()) != 0)
+				return rc;
+		}
+		
+		return 0;
+	}
+#endif
+	
+	return scheduler -> run (SCHEDULER_TIME);
+}
+
+#ifdef _SYS_STR_
+
+int ServerImpl::replan ()
+{
+	int rc;
+	bool bDrifted;
+	bool bMigrate;
+	const char *queryStr;
+	NODE *parseTree;
+	Semantic::Query semQuery;
+	Logical::Operator *logPlan;
+	
+	if ((rc = planMgr -> updateStatistics (bDrifted)) != 0)
+		return rc;
+	
+	if (!bDrifted)
+		return 0;
+	
+	if ((rc = planMgr -> beginMigration (bMigrate)) != 0)
+		return rc;
+	
+	if (!bMigrate)
+		return 0;
+	
+	LOG << "Server: planning the queries again" << endl;
+	
+	// Logical plans with the rates observed so far.  The queries are
+	// planned one at a time: a logical plan is valid until the next one
+	// is generated.
+	for (unsigned int q = 0 ; q < numAppQueries ; q++) {
+		queryStr = qryMgr -> getQuery (q);
+		
+		// Query String -> Parse Tree
+		parseTree = Parser::parseCommand (queryStr, strlen (queryStr));
+		if (!parseTree)
+			return PARSE_ERR;
+		
+		// Parse Tree -> Semantic Query
+		if ((rc = semInterpreter -> interpretQuery (parseTree,
+													semQuery)) != 0)
+			return rc;
+		
+		// SemanticQuery -> logical plan
+		if ((rc = logPlanGen -> genLogPlan (semQuery, logPlan)) != 0)
+			return rc;
+		
+		if ((rc = planMgr -> addMigrationPlan (q, logPlan)) != 0)
+			return rc;
+	}
+	
+	return planMgr -> endMigration (scheduler);
+}
+
+#endif
+
 int ServerImpl::stopExecution ()
 {
 	
@@ -751,7 +925,49 @@ int ServerImpl::setConfigFile (const char *configFile)
 		
 		switch (param) {
 		case ConfigFileReader::MEMORY_SIZE:
-			MEMORY = (unsigned int)val.ival;
+			MEMORY = (unsigned long long int)val.lval;
+			break;
+			
+		case ConfigFileReader::MAX_MEMORY_SIZE:
+			MAX_MEMORY = (unsigned long long int)val.lval;
+			break;
+			
+		case ConfigFileReader::HUGE_PAGES:
+			HUGE_PAGES = (val.ival != 0);
+			break;
+			
+		case ConfigFileReader::NUMA:
+			NUMA = (val.ival != 0);
+			break;
+			
+		case ConfigFileReader::VECTORIZE:
+			VECTORIZE = (val.ival != 0);
+			break;
+			
+		case ConfigFileReader::OPEN_HASH_INDEX:
+			OPEN_HASH_INDEX = (val.ival != 0);
+			break;
+			
+		case ConfigFileReader::JOIN_THREADS:
+			if (val.ival <= 0 ||
+				val.ival > (int)Execution::BinaryJoin::MAX_PARTITIONS) {
+				LOG << "Server: JOIN_THREADS should be between 1 and "
+					<< Execution::BinaryJoin::MAX_PARTITIONS << endl;
+				return INVALID_PARAM_ERR;
+			}
+			JOIN_THREADS = (unsigned int)val.ival;
+			break;
+			
+		case ConfigFileReader::MULTIWAY_JOIN:
+			MULTIWAY_JOIN = (val.ival != 0);
+			break;
+			
+		case ConfigFileReader::REPLAN_INTERVAL:
+			if (val.lval < 0) {
+				LOG << "Server: REPLAN_INTERVAL should be >= 0" << endl;
+				return INVALID_PARAM_ERR;
+			}
+			REPLAN_INTERVAL = val.lval;
 			break;
 			
 		case ConfigFileReader::QUEUE_SIZE:
@@ -773,6 +989,20 @@ int ServerImpl::setConfigFile (const char *configFile)
 		case ConfigFileReader::CPU_SPEED:
 			CPU_SPEED = (unsigned int)val.lval;
 			break;
+
+		case ConfigFileReader::NUM_THREADS:
+			if (val.ival <= 0 ||
+				val.ival > (int)Execution::ThreadPoolScheduler::MAX_THREADS) {
+				LOG << "Server: NUM_THREADS should be between 1 and "
+					<< Execution::ThreadPoolScheduler::MAX_THREADS << endl;
+				return INVALID_PARAM_ERR;
+			}
+			NUM_THREADS = (unsigned int)val.ival;
+			break;
+			
+		case ConfigFileReader::SCHEDULER:
+			SCHEDULER = (Execution::SchedulerKind)val.ival;
+			break;
 			
 		default:
 			break;
@@ -13,14 +13,13 @@
 #include <iostream>
 using namespace std;
 
-static const unsigned int MAX_LINE_SIZE =  1024;
-static char lineBuffer [MAX_LINE_SIZE];
-
 using Client::FileSource;
 
 FileSource::FileSource (const char *fileName)
 	: input (fileName, std::ios_base::in)
 {
+	rateHint = 0.0;
+	schema [0] = '\0';
 	return;
 }
 
@@ -36,6 +35,9 @@ int FileSource::start ()
 
 	// Read the schema line & parse it
 	input.getline (lineBuffer, MAX_LINE_SIZE);
+	strncpy (schema, lineBuffer, MAX_SCHEMA_SIZE - 1);
+	schema [MAX_SCHEMA_SIZE - 1] = '\0';
+	
 	if ((rc = parseSchema (lineBuffer)) != 0)
 		return rc;
 
@@ -99,6 +101,15 @@ int FileSource::end ()
 	return 0;
 }
 
+int FileSource::getRateHint (double &rate)
+{
+	if (rateHint <= 0.0)
+		return -1;
+	
+	rate = rateHint;
+	return 0;
+}
+
 int FileSource::parseTuple (char *lineBuffer)
 {
 	char *begin, *end;
@@ -27,6 +27,13 @@ namespace Client {
 		/// Buffer for tuples
 		char tupleBuf [MAX_TUPLE_SIZE];
 		
+		/// Maximum size of the lines of the file
+		static const unsigned int MAX_LINE_SIZE = 1024;
+		
+		/// Buffer for the line being parsed: one per source, since the
+		/// sources can be read by different scheduler threads
+		char lineBuffer [MAX_LINE_SIZE];
+		
 		enum Type {
 			INT, FLOAT, CHAR, BYTE
 		};
@@ -46,6 +53,15 @@ namespace Client {
 		/// Length of tuples
 		int tupleLen;
 		
+		/// Declared tuples per time unit (0 if none)
+		double rateHint;
+		
+		/// Maximum size of the schema line we keep
+		static const unsigned int MAX_SCHEMA_SIZE = 256;
+		
+		/// Schema line of the file
+		char schema [MAX_SCHEMA_SIZE];
+		
 	public:
 		FileSource (const char *fileName);
 		~FileSource ();
@@ -53,6 +69,26 @@ namespace Client {
 		int start ();
 		int getNext (char *&tuple, unsigned int &len, bool &isHeartbeta);
 		int end ();
+		int getRateHint (double &rate);
+		
+		void setRateHint (double rate) {
+			rateHint = rate;
+		}
+		
+		/// Schema line of the file (after start())
+		const char *getSchema () const {
+			return schema;
+		}
+		
+		/// Length of the tuples (after start())
+		unsigned int getTupleLen () const {
+			return tupleLen;
+		}
+		
+		/// Is the whole file read?
+		bool atEnd () const {
+			return !input.good ();
+		}
 		
 	private:
 		int parseTuple (char *lineBuffer);
@@ -10,6 +10,7 @@
 
 #include "script_file_reader.h"
 #include "file_source.h"
+#include "mmap_source.h"
 #include "gen_output.h"
 #include "interface/server.h"
 
@@ -29,11 +30,14 @@ static fstream queryOutput [MAX_OUTPUT];
 static int numOutput;
 
 static const unsigned int MAX_SOURCES = 20;
-static FileSource *sources [MAX_SOURCES];
+static TableSource *sources [MAX_SOURCES];
 static unsigned int numSources;
 
 static GenOutput *outputs [MAX_OUTPUT];
 
+/// Seconds per time unit to replay recordings at (0: as fast as possible)
+static double timeScale;
+
 static ofstream logStr;
 
 /**
@@ -74,6 +78,30 @@ static int start_server(Server *& server)
 	return 0;
 }
 
+/**
+ * Recordings (made by rec_convert) are replayed from memory, other files
+ * are parsed line by line.
+ */
+static TableSource *new_source (const char *fileName, double rateHint)
+{
+	const char         *ext;
+	FileSource         *fileSource;
+	MmapSource         *mmapSource;
+	
+	ext = strrchr (fileName, '.');
+	
+	if (ext && strcmp (ext, ".rec") == 0) {
+		mmapSource = new MmapSource (fileName);
+		mmapSource -> setRateHint (rateHint);
+		mmapSource -> setTimeScale (timeScale);
+		return mmapSource;
+	}
+	
+	fileSource = new FileSource (fileName);
+	fileSource -> setRateHint (rateHint);
+	return fileSource;
+}
+
 /**
  * Register an application with the server
  */
@@ -88,7 +116,8 @@ static int register_appln (Server       *server,
 	bool                        bQueryValid;
 	bool                        bQueryIdValid;
 	bool                        bTableSpecValid;
-	FileSource                 *source;
+	double                      rateHint;
+	TableSource                *source;
 	GenOutput                  *output;
 
 	// Reader to interpret the script file
@@ -101,6 +130,7 @@ static int register_appln (Server       *server,
 	bQueryIdValid = false;
 	bTableSpecValid = false;
 	bQueryValid = false;
+	rateHint = 0.0;
 	numOutput = 0;
 	numSources = 0;
 	
@@ -124,6 +154,19 @@ static int register_appln (Server       *server,
 				return -1;			
 			strncpy (tableSpecBuf, command.desc, tableSpecLen+1);
 			bTableSpecValid = true;
+			rateHint = 0.0;
+			
+			break;
+			
+		case ScriptFileReader::RATE:
+			
+			// Rate of the table specified by the previous command
+			if (!bTableSpecValid)
+				return -1;
+			
+			rateHint = atof (command.desc);
+			if (rateHint <= 0.0)
+				return -1;
 			
 			break;
 			
@@ -137,7 +180,8 @@ static int register_appln (Server       *server,
 			if (numSources >= MAX_SOURCES)
 				return -1;
 			
-			source = sources[numSources++] = new FileSource (command.desc);
+			source = sources[numSources++] =
+				new_source (command.desc, rateHint);
 			
 			// register the table
 			if((rc = server -> registerBaseTable(tableSpecBuf,
@@ -255,7 +299,7 @@ void closeOutputFiles ()
 		queryOutput[o].close();
 }
 
-static const char *opt_string = "l:c:";
+static const char *opt_string = "l:c:t:";
 
 extern char *optarg;
 extern int optind;
@@ -274,7 +318,7 @@ static int getOpts (int argc,
 			if (logFile) {
 				cout << "Usage: "
 					 << argv [0]
-					 << " -l[logFile] -c[configFile] [scriptFile]"
+					 << " -l[logFile] -c[configFile] -t[timeScale] [scriptFile]"
 					 << endl;
 				return -1;				
 			}
@@ -285,7 +329,7 @@ static int getOpts (int argc,
 			if (configFile) {
 				cout << "Usage: "
 					 << argv [0]
-					 << " -l[logFile] -c[configFile] [scriptFile]"
+					 << " -l[logFile] -c[configFile] -t[timeScale] [scriptFile]"
 					 << endl;
 				return -1;
 			}
@@ -293,10 +337,22 @@ static int getOpts (int argc,
 			configFile = strdup (optarg);
 		}
 		
+		// Optional: pace the replay of recordings
+		else if (c == 't') {
+			timeScale = atof (optarg);
+			if (timeScale < 0.0) {
+				cout << "Usage: "
+					 << argv [0]
+					 << " -l[logFile] -c[configFile] -t[timeScale] [scriptFile]"
+					 << endl;
+				return -1;
+			}
+		}
+		
 		else {			
  			cout << "Usage: "
 				 << argv [0]
-				 << " -l[logFile] -c[configFile] [scriptFile]"
+				 << " -l[logFile] -c[configFile] -t[timeScale] [scriptFile]"
 				 << endl;
 			
 			return -1;
@@ -306,7 +362,7 @@ static int getOpts (int argc,
 	if (!logFile || !configFile) {
 		cout << "Usage: "
 			 << argv [0]
-			 << " -l[logFile] -c[configFile] [scriptFile]"
+			 << " -l[logFile] -c[configFile] -t[timeScale] [scriptFile]"
 			 << endl;
 		return -1;
 	}	
@@ -314,7 +370,7 @@ static int getOpts (int argc,
 	if (optind != argc - 1) {
 		cout << "Usage: "
 			 << argv [0]
-			 << " -l[logFile] -c[configFile] [scriptFile]"
+			 << " -l[logFile] -c[configFile] -t[timeScale] [scriptFile]"
 			 << endl;
 		return -1;
 	}		
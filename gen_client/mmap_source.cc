@@ -0,0 +1,155 @@
+#ifndef _MMAP_SOURCE_
+#include "mmap_source.h"
+#endif
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+using Client::MmapSource;
+using Client::RecordHeader;
+
+MmapSource::MmapSource (const char *fileName)
+{
+	fd = open (fileName, O_RDONLY);
+	base = 0;
+	mapLen = 0;
+	tuples = 0;
+	tupleLen = 0;
+	numTuples = 0;
+	nextTuple = 0;
+	timeScale = 0.0;
+	bPaceStarted = false;
+	rateHint = 0.0;
+}
+
+MmapSource::~MmapSource ()
+{
+	end ();
+}
+
+int MmapSource::start ()
+{
+	struct stat st;
+	RecordHeader *header;
+	
+	// Recording not properly opened
+	if (fd < 0)
+		return -1;
+	
+	if (fstat (fd, &st) != 0)
+		return -1;
+	
+	if (st.st_size < (off_t) sizeof (RecordHeader))
+		return -1;
+	
+	mapLen = st.st_size;
+	base = (char *) mmap (0, mapLen, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (base == MAP_FAILED) {
+		base = 0;
+		return -1;
+	}
+	
+	// We read the recording once, front to back
+	madvise (base, mapLen, MADV_SEQUENTIAL);
+	
+	header = (RecordHeader *) base;
+	
+	if (memcmp (header -> magic, RECORD_MAGIC, sizeof (RECORD_MAGIC)) != 0)
+		return -1;
+	
+	// Recorded on a host with a different byte order
+	if (header -> byteOrder != 1)
+		return -1;
+	
+	// The first attribute is the timestamp
+	if (header -> schema [0] != 'i' || header -> tupleLen < sizeof (int))
+		return -1;
+	
+	tupleLen = header -> tupleLen;
+	numTuples = header -> numTuples;
+	
+	// Truncated recording
+	if ((mapLen - sizeof (RecordHeader)) / tupleLen < numTuples)
+		return -1;
+	
+	tuples = base + sizeof (RecordHeader);
+	nextTuple = 0;
+	bPaceStarted = false;
+	
+	return 0;
+}
+
+int MmapSource::getNext (char *&tuple, unsigned int &len, bool &isHeartbeat)
+{
+	int ts;
+	
+	isHeartbeat = false;
+	
+	// EOF
+	if (nextTuple >= numTuples) {
+		tuple = 0;
+		len = 0;
+		return 0;
+	}
+	
+	tuple = tuples + nextTuple * tupleLen;
+	
+	if (timeScale > 0.0) {
+		memcpy (&ts, tuple, sizeof (int));
+		
+		if (!bPaceStarted) {
+			paceStart = now ();
+			paceStartTs = ts;
+			bPaceStarted = true;
+		}
+		
+		// Not due yet
+		else if (now () < paceStart + (ts - paceStartTs) * timeScale) {
+			tuple = 0;
+			len = 0;
+			return 0;
+		}
+	}
+	
+	len = tupleLen;
+	nextTuple ++;
+	
+	return 0;
+}
+
+int MmapSource::end ()
+{
+	if (base) {
+		munmap (base, mapLen);
+		base = 0;
+	}
+	
+	if (fd >= 0) {
+		close (fd);
+		fd = -1;
+	}
+	
+	return 0;
+}
+
+int MmapSource::getRateHint (double &rate)
+{
+	if (rateHint <= 0.0)
+		return -1;
+	
+	rate = rateHint;
+	return 0;
+}
+
+double MmapSource::now ()
+{
+	struct timeval tv;
+	
+	gettimeofday (&tv, 0);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
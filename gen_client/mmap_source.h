@@ -0,0 +1,116 @@
+#ifndef _MMAP_SOURCE_
+#define _MMAP_SOURCE_
+
+/**
+ * @file       mmap_source.h
+ * @date       Oct. 17, 2026
+ * @brief      Source replaying a binary recording of a table
+ */
+
+#ifndef _TABLE_SOURCE_
+#include "interface/table_source.h"
+#endif
+
+#include <stddef.h>
+
+using Interface::TableSource;
+
+namespace Client {
+	
+	/// Magic string at the beginning of a recording
+	static const char RECORD_MAGIC [8] = "STRMREC";
+	
+	/// Maximum length of the schema line of a recording
+	static const unsigned int RECORD_SCHEMA_SIZE = 104;
+	
+	/**
+	 * Header of a recording (128 bytes).  The header is followed by the
+	 * tuples of the table back to back, encoded as FileSource encodes
+	 * them: in the byte order of the host that made the recording, so
+	 * that the server can use them as they are.  Recordings are made from
+	 * .dat files with rec_convert.
+	 */
+	
+	struct RecordHeader {
+		/// RECORD_MAGIC
+		char magic [8];
+		
+		/// 1, in the byte order of the recording
+		unsigned int byteOrder;
+		
+		/// Length of each tuple
+		unsigned int tupleLen;
+		
+		/// Number of tuples
+		unsigned long long numTuples;
+		
+		/// Schema line of the .dat file (null terminated)
+		char schema [RECORD_SCHEMA_SIZE];
+	};
+	
+	/**
+	 * A source that replays a recording.  The recording is mapped into
+	 * memory, and getNext() returns pointers to the tuples in the
+	 * mapping: there is no parsing and no copying.
+	 *
+	 * The tuples are replayed as fast as the server takes them, or paced
+	 * by their timestamps (the first attribute) at timeScale seconds per
+	 * time unit: getNext() returns no tuple until the next one is due.
+	 */
+	
+	class MmapSource : public TableSource {
+	private:
+		/// Recording file
+		int fd;
+		
+		/// The mapping of the recording
+		char *base;
+		size_t mapLen;
+		
+		/// First tuple in the mapping
+		char *tuples;
+		
+		/// Length of tuples
+		unsigned int tupleLen;
+		
+		/// Number of tuples in the recording
+		unsigned long long numTuples;
+		
+		/// Next tuple to return
+		unsigned long long nextTuple;
+		
+		/// Seconds of replay per time unit (0: as fast as possible)
+		double timeScale;
+		
+		/// Wall clock time at which the first tuple was returned, and
+		/// its timestamp
+		double paceStart;
+		int paceStartTs;
+		bool bPaceStarted;
+		
+		/// Declared tuples per time unit (0 if none)
+		double rateHint;
+		
+	public:
+		MmapSource (const char *fileName);
+		~MmapSource ();
+		
+		int start ();
+		int getNext (char *&tuple, unsigned int &len, bool &isHeartbeat);
+		int end ();
+		int getRateHint (double &rate);
+		
+		void setRateHint (double rate) {
+			rateHint = rate;
+		}
+		
+		void setTimeScale (double scale) {
+			timeScale = scale;
+		}
+		
+	private:
+		static double now ();
+	};
+}
+
+#endif
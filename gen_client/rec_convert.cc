@@ -0,0 +1,90 @@
+/**
+ * @file       rec_convert.cc
+ * @date       Oct. 17, 2026
+ * @brief      Converts a .dat file of a table to a recording that
+ *             MmapSource can replay.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string.h>
+
+#include "file_source.h"
+#include "mmap_source.h"
+
+using namespace std;
+using namespace Client;
+
+int main (int argc, char *argv[])
+{
+	FileSource      *source;
+	RecordHeader     header;
+	ofstream         output;
+	char            *tuple;
+	unsigned int     tupleLen;
+	bool             bHeartbeat;
+	int              rc;
+	
+	if (argc != 3) {
+		cout << "Usage: "
+			 << argv [0]
+			 << " [datFile] [recFile]"
+			 << endl;
+		return 1;
+	}
+	
+	source = new FileSource (argv [1]);
+	if ((rc = source -> start ()) != 0) {
+		cerr << "Error reading the schema of " << argv [1] << endl;
+		return 1;
+	}
+	
+	if (strlen (source -> getSchema ()) >= RECORD_SCHEMA_SIZE) {
+		cerr << "Schema of " << argv [1] << " too long" << endl;
+		return 1;
+	}
+	
+	memset (&header, 0, sizeof (header));
+	memcpy (header.magic, RECORD_MAGIC, sizeof (RECORD_MAGIC));
+	header.byteOrder = 1;
+	header.tupleLen = source -> getTupleLen ();
+	strcpy (header.schema, source -> getSchema ());
+	
+	output.open (argv [2], ios_base::out | ios_base::binary);
+	if (!output.is_open ()) {
+		cerr << "Error opening " << argv [2] << endl;
+		return 1;
+	}
+	
+	// The number of tuples is filled in at the end
+	output.write ((const char *) &header, sizeof (header));
+	
+	while (!source -> atEnd ()) {
+		if ((rc = source -> getNext (tuple, tupleLen, bHeartbeat)) != 0) {
+			cerr << "Error reading tuple " << header.numTuples + 1
+				 << " of " << argv [1] << endl;
+			return 1;
+		}
+		
+		// Empty line
+		if (!tuple)
+			continue;
+		
+		output.write (tuple, tupleLen);
+		header.numTuples ++;
+	}
+	
+	output.seekp (0);
+	output.write ((const char *) &header, sizeof (header));
+	output.close ();
+	
+	if (!output) {
+		cerr << "Error writing " << argv [2] << endl;
+		return 1;
+	}
+	
+	source -> end ();
+	delete source;
+	
+	return 0;
+}
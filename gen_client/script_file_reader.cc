@@ -52,6 +52,7 @@ bool ScriptFileReader::isCommentLine (const char    *lineBuffer) const
 // String constants used in parsing
 static const char *TABLE_COMMAND   = "table";
 static const char *SOURCE_COMMAND  = "source";
+static const char *RATE_COMMAND    = "rate";
 static const char *QUERY_COMMAND   = "query";
 static const char *DEST_COMMAND    = "dest";
 static const char *VQUERY_COMMAND  = "vquery";
@@ -62,6 +63,7 @@ static const char *VTABLE_COMMAND  = "vtable";
  * 
  * "table   : <command> "
  * "source  : <command> "
+ * "rate    : <tuples per time unit> "
  * "query   : <command  "
  * "vquery  : <command> "
  * "vtable  : <command> "
@@ -94,6 +96,10 @@ int ScriptFileReader::parseLine (char *lineBuffer, Command &command)
 		command.type = SOURCE;
 	}
 	
+	else if (strncmp (begin, RATE_COMMAND, ptr - begin) == 0) {
+		command.type = RATE;
+	}
+	
 	else if (strncmp (begin, QUERY_COMMAND, ptr - begin) == 0) {
 		command.type = QUERY;
 	}
@@ -20,6 +20,7 @@ namespace Client {
 		enum Type {
 			TABLE,    ///< (Base) table (stream/relation) specification
 			SOURCE,   ///< source info for a table
+			RATE,     ///< Declared rate of a table (before its source)
 			QUERY,    ///< Continuous query with output
 			DEST,     ///< Destn info a query
 			VQUERY,   ///< Query part of a view
@@ -67,7 +67,7 @@ namespace Network {
 		bool b_server_started;
 		
 		/// maximum nmber of output connections per comm conn
-		static const int MAX_OUTPUT_CONN = 20;
+		static const int MAX_OUTPUT_CONN = 1024;
 		
 		/// The active output connections of this command connection
 		OutputConnection *out_conns [MAX_OUTPUT_CONN];
@@ -76,7 +76,7 @@ namespace Network {
 		int num_out_conns;		
 		
 		/// Maximum no of input conns per comm conn
-		static const int MAX_INPUT_CONN = 20;
+		static const int MAX_INPUT_CONN = 1024;
 		
 		/// The active input connections of this command connection
 		InputConnection *in_conns [MAX_INPUT_CONN];
@@ -0,0 +1,153 @@
+#ifndef _EVENT_LOOP_
+#define _EVENT_LOOP_
+
+/**
+ * @file      event_loop.h
+ * @date      Oct. 17, 2026
+ * @brief     Event loop multiplexing the sockets of the connections
+ */
+
+#ifndef _THREAD_
+#include "thread.h"
+#endif
+
+#include <pthread.h>
+
+#include <ostream>
+using std::ostream;
+
+namespace Network {
+	
+	/**
+	 * A connection served by an event loop.  The handlers are called in
+	 * the thread of the loop, so they should never block: the sockets
+	 * they read and write are non-blocking.
+	 *
+	 * A handler returns !0 on an error, and the loop then calls
+	 * handleError() to close the connection.  A handler can destroy
+	 * its connection: the loop does not refer to it after the call.
+	 */
+	
+	class EventHandler {
+	public:
+		virtual ~EventHandler () {}
+		
+		/// The socket is readable, or the peer has closed it
+		virtual int handleRead () = 0;
+		
+		/// The socket is writable
+		virtual int handleWrite () = 0;
+		
+		/// The last handler call failed
+		virtual void handleError () = 0;
+		
+		/// A timer set with EventLoop::setTimer() has expired
+		virtual int handleTimer () {
+			return 0;
+		}
+	};
+	
+	/**
+	 * An event loop.  The run() method waits (epoll) for the sockets
+	 * registered with the loop to become readable or writable, and calls
+	 * their handlers.  The sockets can be registered, modified and
+	 * removed from any thread.  The loop also runs one-shot timers for
+	 * its handlers.
+	 */
+	
+	class EventLoop : public Thread {
+	private:
+		/// Event log
+		ostream &LOG;
+		
+		/// epoll instance
+		int epfd;
+		
+		/// Maximum number of events handled per wait
+		static const int MAX_EVENTS = 64;
+		
+		/// Wakes the loop up when a timer expires before the current
+		/// wait does (eventfd)
+		int wakefd;
+		
+		//------------------------------------------------------------
+		// Timers
+		//------------------------------------------------------------
+		
+		/// Maximum number of timers set at the same time
+		static const int MAX_TIMERS = 4096;
+		
+		struct Timer {
+			EventHandler *handler;
+			
+			/// Expiry time (msecs on the monotonic clock)
+			long long deadline;
+		};
+		
+		/// Timers set, in no particular order
+		Timer timers [MAX_TIMERS];
+		
+		/// Number of timers set
+		int numTimers;
+		
+		/// Handlers of the expired timers
+		EventHandler *expired [MAX_TIMERS];
+		
+		/// When the current wait of the loop ends (-1: no timeout)
+		long long waitDeadline;
+		
+		/// Mutex for the timers
+		pthread_mutex_t mutex;
+		
+		int ctl (int op, int fd, EventHandler *handler,
+				 unsigned int events);
+		
+		int getTimeout ();
+		int runTimers ();
+		static long long now ();
+	
+	public:
+		/// Events a handler waits for
+		static const unsigned int EV_READ  = 0x1;
+		static const unsigned int EV_WRITE = 0x2;
+		
+		EventLoop (ostream &LOG);
+		~EventLoop ();
+		
+		virtual void run ();
+		
+		/**
+		 * Register a socket with the loop.
+		 *
+		 * @param  fd       socket (non-blocking)
+		 * @param  handler  handler of the events of the socket
+		 * @param  events   EV_READ and/or EV_WRITE
+		 */
+		int add (int fd, EventHandler *handler, unsigned int events);
+		
+		/**
+		 * Change the handler and events of a registered socket
+		 */
+		int modify (int fd, EventHandler *handler, unsigned int events);
+		
+		/**
+		 * Unregister a socket: its handler is not called after this
+		 * (unless the loop is in the middle of calling it).
+		 */
+		int remove (int fd);
+		
+		/**
+		 * Call the handleTimer() of a handler in msecs milliseconds (or
+		 * earlier, if its timer is already set to expire earlier).
+		 */
+		int setTimer (EventHandler *handler, int msecs);
+		
+		/**
+		 * Cancel the timer of a handler: to be called from the thread of
+		 * the loop before the handler is destroyed.
+		 */
+		int cancelTimer (EventHandler *handler);
+	};
+}
+
+#endif
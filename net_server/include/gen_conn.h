@@ -7,6 +7,8 @@
  * @brief       A generic connection to DSMS server
  */
 
+#include <pthread.h>
+
 #include <ostream>
 using std::ostream;
 
@@ -14,6 +16,10 @@ using std::ostream;
 #include "thread.h"
 #endif
 
+#ifndef _EVENT_LOOP_
+#include "event_loop.h"
+#endif
+
 namespace Network {
     // forward decl.
 	class NetworkManager;
@@ -29,9 +35,12 @@ namespace Network {
 	 * should be a connection identifier which lets to generic connection
 	 * to transform to one of the 3 connections.
 	 *
+	 * A generic connection reads the identifier in an event loop.  Input
+	 * and output connections stay in the loop; a command connection runs
+	 * the (blocking) commands in a thread of its own.
 	 */
 	
-	class GenericConnection : public Thread {
+	class GenericConnection : public Thread, public EventHandler {
 	private:
 		/// Unique identifier for the connection		
 		int id;
@@ -39,12 +48,28 @@ namespace Network {
 		/// Network manager who created us
 		NetworkManager *netMgr;
 		
+		/// Event loop serving the connection
+		EventLoop *loop;
+		
 		/// Event logger
 		std::ostream &log;
 		
 		/// connection socket
 		int sockfd;
 		
+		/// Maximum length of the first message
+		static const int MSG_BUF_LEN = 128;
+		
+		/// The first message: its length (4 bytes in net order)
+		/// followed by the message
+		char msgBuf [sizeof (int) + MSG_BUF_LEN];
+		
+		/// Number of bytes of the first message read so far
+		int msgRead;
+		
+		/// Thread of a command connection
+		pthread_t thread;
+		
 		/// The three types of specific connections that this generic
 		/// connection object morphs into.
 		enum ConnType {
@@ -60,6 +85,11 @@ namespace Network {
 			ConnType type;
 			unsigned int inputId;
 			unsigned int outputId;
+			
+			/// Options of an output connection (see OutputConnection)
+			bool bBinary;
+			int flushBytes;
+			int flushMsecs;
 		};
 		
 	public:
@@ -68,22 +98,30 @@ namespace Network {
 		 * @param  thread_id  An identifier for the thread in which the
 		 *                    connection runs.
 		 * @param  netMgr     Network manager who constructed us
-		 * @param  sockfd     Socket for the connection
+		 * @param  loop       Event loop serving the connection
+		 * @param  sockfd     Socket for the connection (non-blocking)
 		 * @param  LOG        System-wide log
 		 */
 		
 		GenericConnection (int id,
 						   NetworkManager *netMgr,
+						   EventLoop *loop,
 						   int sockfd,
 						   ostream &LOG);
 		
 		/**
-		 * The run method - the thread for the generic connection is
-		 * started off on the run method.
-		 *
-		 * The run() method determines the type of the connection based on
-		 * the first message from the client and then morphs the
+		 * Reads the first message from the client.  Once it is complete,
+		 * determines the type of the connection and morphs the
 		 * connection to the appropriate type.
+		 */
+		
+		virtual int handleRead ();
+		virtual int handleWrite ();
+		virtual void handleError ();
+		
+		/**
+		 * The run method - the thread for a command connection is
+		 * started off on the run method.
 		 */ 
 		
 		virtual void run();
@@ -91,11 +129,17 @@ namespace Network {
 	private:
 
 		/**
-		 * Called when the generic connection thread is run.  It gets the
+		 * Called when the first message has been read.  It gets the
 		 * connection specification info, which is used to transform to
 		 * one of the 3 connection types
 		 */
 		int getConnectionSpec (ConnSpec& spec);
+		
+		/**
+		 * Send the reply to the first message (the socket is briefly
+		 * made blocking: the reply is tiny)
+		 */
+		int sendReply ();
 
 		/**
 		 * Morph to a command connection
@@ -110,7 +154,7 @@ namespace Network {
 		/**
 		 * Morph to an output connection
 		 */		
-		int morphToOutputConn (unsigned int outputId);
+		int morphToOutputConn (const ConnSpec &spec);
 		
 		/**
 		 * Terminate the connection: called only on error
@@ -7,8 +7,8 @@
  * @brief     Input connection
  */
 
-#ifndef _THREAD_
-#include "thread.h"
+#ifndef _EVENT_LOOP_
+#include "event_loop.h"
 #endif
 
 #ifndef _TABLE_SOURCE_
@@ -37,16 +37,50 @@ namespace Network {
 
 	/**
 	 * An input connection.  An input connection object (typically) runs
-	 * as part of two threads.  The first thread which executes the run()
-	 * method talks to a socket connection, and writes the tuples input in
-	 * this connection into a queue.  The second thread calls start(),
-	 * getNext() and end() methods dequeued tuples from the queue.	 
+	 * as part of two threads.  The first thread is the event loop
+	 * serving the socket: its handlers read the tuples input in this
+	 * connection and write them into a queue.  The second thread calls
+	 * start(), getNext() and end() methods dequeued tuples from the
+	 * queue.  While the queue is full the connection is out of the loop;
+	 * getNext() puts it back when it frees a slot.
+	 *
+	 * The first line from the client is the schema of the input (e.g.,
+	 * "i,i,f,c4").  By default the tuples follow as text lines, one
+	 * tuple per line.  If the schema line is prefixed by "BINARY " (and
+	 * ends with a single '\n') the client sends the tuples in binary
+	 * frames instead:
+	 *
+	 *  <frame>    ---> <length> <layout> <numRows> <payload>
+	 *  <length>   ---> bytes following the length: 4 bytes in net order
+	 *  <layout>   ---> 1 byte: 'R' (rows) or 'C' (column chunks)
+	 *  <numRows>  ---> 4 bytes in net order
+	 *  <payload>  ---> (R) numRows x <kind> <1st attr> <2nd attr> ...
+	 *                  (C) numRows x <kind>, then numRows values of the
+	 *                      1st attr, numRows values of the 2nd attr ...
+	 *  <kind>     ---> 1 byte: 'N' (tuple) or 'H' (heartbeat)
+	 *
+	 * The attributes are encoded as in QueryOutput::putNext(), except
+	 * that a string attribute of length n occupies exactly n bytes
+	 * (padded with nulls), so that all the rows are of the same width.
+	 * Only the timestamp (the first attribute) of a heartbeat is
+	 * meaningful.  A frame (with its length) is at most READ_BUF_SIZE
+	 * bytes long.
 	 */ 
 	
-	class InputConnection : public Thread, public Interface::TableSource {		
+	class InputConnection : public EventHandler,
+							public Interface::TableSource {		
+		/// Identifier of the connection with the network manager
+		int id;
+		
+		/// Network manager who created us
+		NetworkManager *netMgr;
+		
 		/// Event log
 		std::ostream &LOG;
 		
+		/// Event loop serving the socket (0 until the client connects)
+		EventLoop *loop;
+		
 		/// Socket for the TCP connection
 		int sockfd;
 		
@@ -66,8 +100,9 @@ namespace Network {
 		/// Size of the read buffer: 32 KB
 		static const int READ_BUF_SIZE = 32 * (1 << 10);
 		
-		/// Buffer used by readline() method to perform buffered net i/o		
-		char readBuf[READ_BUF_SIZE];
+		/// Buffer for the input not yet consumed (one extra byte to
+		/// terminate the last line of the input)
+		char readBuf[READ_BUF_SIZE + 1];
 		
 		/// Next unread position in the buffer
 		char *curPtr;
@@ -81,6 +116,18 @@ namespace Network {
 		/// Has the end() method been called by server ?
 		bool bEnd;
 
+		/// Does the client send binary frames instead of text lines?
+		bool bBinary;
+		
+		/// Frame being consumed: its layout byte in readBuf (0 if none)
+		char *frame;
+		
+		/// Number of rows of the frame
+		int frameRows;
+		
+		/// Next row of the frame to consume
+		int nextRow;
+		
 		//----------------------------------------------------------------------
 		// Schema Information
 		//----------------------------------------------------------------------
@@ -88,7 +135,7 @@ namespace Network {
 		/// Types of attributes
 		Type attrTypes [MAX_ATTRS];
 		
-		/// Attr lengthts
+		/// Attr lengths (the width of the attributes in the tuples)
 		int attrLen [MAX_ATTRS];
 		
 		/// Offsets of attributes in the tupleBuf
@@ -108,31 +155,47 @@ namespace Network {
 		/// Mutex for critical code
 		pthread_mutex_t mutex;
 
-		/// Input connection waiting for server to call end()
-		pthread_cond_t wait_for_end_cond;
+		/// Is the connection out of the loop for the queue to clear up?
+		bool bStalled;
 		
-		/// are we waiting for end
-		bool b_wait_for_end;
+		/// Has the socket been closed?
+		bool bClosed;
 		
 	public:
 		
-		InputConnection (ostream& LOG);
+		InputConnection (int id, NetworkManager *netMgr, ostream& LOG);
+		~InputConnection ();
 		
-		int setSocket (int sockfd);
+		/**
+		 * The client has connected: serve the (non-blocking) socket in
+		 * the event loop.
+		 */
+		int attach (EventLoop *loop, int sockfd);
 		
-		virtual void run();
+		virtual int handleRead ();
+		virtual int handleWrite ();
+		virtual void handleError ();
 		
 		int start ();
 		int getNext (char *&tuple, unsigned int &len, bool& isHeartbeat);
 		int end();
 		
 	private:
-		int initialize ();
+		int initialize (char *schemaLine);
+		int consume ();
+		int consumeLines ();
+		int consumeFrames ();
+		int nextLine (char *&line);
+		int nextFrame ();
+		int stall ();
+		int finish ();
 		int constructTuple (char *tuple, char *line);
 		int parseSchema (char *str);
 		int computeOffsets ();
-		int readline (char *lineBuf, int bufsize);
 		int loadBuf ();
+		int constructRows ();
+		int constructColumns ();
+		void decodeAttr (char *tupleBuf, const char *src, int a);
 	};
 }
 #endif
@@ -9,6 +9,7 @@
 #endif
 
 namespace Network {
+	class EventLoop;
 	class InputConnection;
 	class OutputConnection;
 	class CommandConnection;
@@ -21,17 +22,23 @@ namespace Network {
 		/// Event logger
 		std::ofstream LOG;		
 		
-		/// Maximum number of connection threads we allow
-		static const int NUM_THREADS = 20;
+		/// Number of i/o threads (event loops) serving the connections
+		static const int NUM_IO_THREADS = 4;
 		
 		/// Maximum number of outstanding connection requests
-		static const int MAX_WAIT_CONN = 5;
+		static const int MAX_WAIT_CONN = 1024;
 		
-		/// Connection thread pool
-		pthread_t conn_threads [NUM_THREADS];
+		/// Event loops multiplexing the sockets of the connections
+		EventLoop *loops [NUM_IO_THREADS];
 		
-		/// Usage information of the threads
-		bool b_thread_in_use [NUM_THREADS];
+		/// Threads running the event loops
+		pthread_t io_threads [NUM_IO_THREADS];
+		
+		/// Event loop that gets the next connection
+		int nextLoop;
+		
+		/// Mutex for the connection tables
+		pthread_mutex_t mutex;
 		
 		/// Max. number of connections we can handle before "reboot"
 		static const int MAX_CONN = 100000;
@@ -72,10 +79,10 @@ namespace Network {
 		// Input/Output connections
 		//----------------------------------------------------------------------
 
-		static const int MAX_INPUT_CONN = 100;
+		static const int MAX_INPUT_CONN = 4096;
 		InputConnection *input_conns [MAX_INPUT_CONN];
 		
-		static const int MAX_OUTPUT_CONN = 100;		
+		static const int MAX_OUTPUT_CONN = 4096;		
 		OutputConnection *output_conns [MAX_OUTPUT_CONN];
 		
 	public:
@@ -98,8 +105,9 @@ namespace Network {
 		
 		/**
 		 * Starts off the network manager.  Never returns (if everything
-		 * goes well).  Waits for new connections, and starts off a new
-		 * generic client thread for every new connection request.
+		 * goes well).  Starts off the event loops, waits for new
+		 * connections, and hands every new connection to one of the
+		 * loops as a generic connection.
 		 */	
 		virtual void run();
 
@@ -180,7 +188,8 @@ namespace Network {
 		
 	private:
 		
-		/// Handle a new connection - start off a generic client thread
+		/// Handle a new connection - register a generic connection with
+		/// an event loop
 		int handleNewConn (int cli_sockfd);
 	};
 }
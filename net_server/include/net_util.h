@@ -15,6 +15,9 @@ namespace Network {
 		static int sendMessage (int   sockfd,
 								char *msgBuf,
 								int   msgLen);
+		
+		// Switch a socket between blocking and non-blocking i/o
+		static int setBlocking (int sockfd, bool bBlocking);
 	};
 }
 #endif
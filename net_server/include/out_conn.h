@@ -1,8 +1,12 @@
 #ifndef _OUT_CONN_
 #define _OUT_CONN_
 
-#ifndef _THREAD_
-#include "thread.h"
+#ifndef _EVENT_LOOP_
+#include "event_loop.h"
+#endif
+
+#ifndef _NET_QUEUE_
+#include "queue.h"
 #endif
 
 #ifndef _QUERY_OUTPUT_
@@ -25,32 +29,92 @@ using std::ostream;
 namespace Network {
 	class NetworkManager;
 	
-	class OutputConnection : public Thread, public Interface::QueryOutput {
+	/**
+	 * An output connection.  The server thread queues the output tuples
+	 * as they are (putNext()), and the event loop serving the socket
+	 * encodes them in batches and sends each batch out with one call,
+	 * whenever the socket is writable.  The socket is in the loop only
+	 * while there is something to send.
+	 *
+	 * The client picks the encoding and the flush policy of the output
+	 * when it connects, after the id of the output:
+	 *
+	 *   OUTPUT_CONN<id> [BINARY] [FLUSH <bytes> <msecs>]
+	 *
+	 * The text encoding (default) is a line per tuple:
+	 * "timestamp,sign,attr1,...".  The binary encoding is a sequence of
+	 * frames laid out as the row frames of the input connections:
+	 *
+	 *   <length> 'R' <numRows> <row 1> ... <row n>
+	 *
+	 * where the length (of the rest of the frame) and numRows are 4 bytes
+	 * in network order, and a row is the sign ('+' or '-') followed by the
+	 * timestamp and the attributes, encoded as in the input frames.
+	 *
+	 * With the flush policy, the loop sends the tuples once their size is
+	 * at least <bytes>, or <msecs> milliseconds after the first of them
+	 * (if <msecs> is not 0).  By default each tuple is sent right away.
+	 */
+	
+	class OutputConnection : public EventHandler,
+							 public Interface::QueryOutput {
 	private:
+		/// Identifier of the connection with the network manager
+		int id;
+		
+		/// Network manager who created us
+		NetworkManager *netMgr;
+		
 		/// system-wide log	   
 		std::ostream &LOG;
 		
+		/// Event loop serving the socket (0 until the client connects)
+		EventLoop *loop;
+		
 		/// Socket for the TCP connection
 		int sockfd;
 		
+		/// Output tuples, from the server thread to the loop (created
+		/// with the schema)
+		Queue *queue;
+		
+		/// Indicator for the end of the output stream
+		bool bEnd;
+		
 		//------------------------------------------------------------
-		// Buffer to xfer data from producer to consumer
+		// Batch being sent
 		//------------------------------------------------------------
 		
-		/// Size of each buffer = 512 KB
-		static const int BUF_SIZE = 512 * (1 << 10);
+		/// 64 KB
+		static const int SEND_BUF_SIZE = (1 << 16);
 		
-		/// shared buffer
-		char shared_buf [BUF_SIZE];		
+		/// Encoded tuples
+		char sendBuf [SEND_BUF_SIZE];
 		
-		/// Index into the next read position
-		int read_ptr;
+		/// Offset of the first byte not sent yet
+		int sendOff;
 		
-		/// Index into the next write position in the shared buffer
-		int write_ptr;
-
-		/// Indicator for the end of the output stream
-		bool bEnd;
+		/// Number of bytes not sent yet
+		int sendLen;
+		
+		/// Binary encoding?
+		bool bBinary;
+		
+		/// Size of the header of a binary frame
+		static const int FRAME_HDR_SIZE = 2 * sizeof (int) + 1;
+		
+		//------------------------------------------------------------
+		// Flush policy
+		//------------------------------------------------------------
+		
+		/// Bytes of tuples held back before the socket is armed
+		int flushBytes;
+		
+		/// How long (msecs) tuples are held back (0: no limit)
+		int flushMsecs;
+		
+		/// Bytes of the tuples queued since the socket was last armed
+		int unflushed;
 		
 		//------------------------------------------------------------
 		// Synchronization entities
@@ -59,11 +123,14 @@ namespace Network {
 		/// Mutex for critical code
 		pthread_mutex_t mutex;
 		
-		/// Condition variable for producer waiting for a free buffer space
-		pthread_cond_t prod_wait_cond;
+		/// Is the socket in the loop, waiting to become writable?
+		bool bArmed;
+		
+		/// Is the flush timer set?
+		bool bTimerSet;
 		
-		/// Indicator for whether the producer is waiting or not
-		bool b_prod_waiting;
+		/// Has the socket been closed?
+		bool bClosed;
 		
 		//------------------------------------------------------------
 		// Schema information
@@ -90,20 +157,32 @@ namespace Network {
 		/// Offset of the sign
 		int signOffset;
 		
+		/// Maximum length of a text line
 		static const int LINE_BUF_SIZE = 1024;
 		
-		char lineBuf [LINE_BUF_SIZE];
-
 		/// debug
 		long totalBytes;
 		
 	public:
-		OutputConnection (ostream& LOG);
+		OutputConnection (int id, NetworkManager *netMgr, ostream& LOG);
 		~OutputConnection ();
 		
-		void run();
-
-		int setSocket (int sockfd);
+		/**
+		 * The client has connected: send the output over the
+		 * (non-blocking) socket from the event loop.
+		 *
+		 * @param  bBinary     binary encoding of the output
+		 * @param  flushBytes  bytes of tuples held back
+		 * @param  flushMsecs  msecs the tuples are held back (0: no limit)
+		 */
+		int attach (EventLoop *loop, int sockfd, bool bBinary,
+					int flushBytes, int flushMsecs);
+		
+		virtual int handleRead ();
+		virtual int handleWrite ();
+		virtual void handleError ();
+		virtual int handleTimer ();
+		
 		int setNumAttrs(unsigned int numAttrs);
 		
 		int setAttrInfo(unsigned int attrPos, 
@@ -115,12 +194,12 @@ namespace Network {
 		int end();
 
 	private:
-		int consumeBuf ();
-		int consumeBuf (char *buf, int size);
-		bool buf_empty () const;
-		bool buf_full () const;
-		int writeln (char *line);
-		int writechar (char c);
+		int arm ();
+		int setTimer ();
+		bool queueEmpty () const;
+		int encodeBatch ();
+		int encodeLine (const char *tuple, char *line, int &len);
+		void encodeRow (const char *tuple, char *row);
 	};
 }
 
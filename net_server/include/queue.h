@@ -9,12 +9,36 @@ using std::ostream;
 namespace Network {
 
 	/**
-	 * A queue of fixed length objects.  The queue is thread safe (but it
-	 * assumes one reader and one writer).
+	 * A queue of fixed length objects between two threads: one writer
+	 * and one reader.
 	 *
 	 * This queue is used to exchange information from the input
 	 * connection thread and the dsms thread, and from the dsms thread to
-	 * an output connection thread
+	 * an output connection thread.
+	 *
+	 * The queue takes no locks as long as neither thread has to wait
+	 * (as Execution::SpscQueue):
+	 *
+	 * 1. The objects are stored in a ring.  One slot of the ring is never
+	 *    used, to tell a full ring from an empty one.
+	 *
+	 * 2. The writer owns the tail index and the reader the head index.
+	 *    Each side publishes its index with a release store and reads the
+	 *    index of the other side with an acquire load.  The two indexes
+	 *    are on separate cache lines, and each side keeps a cached copy
+	 *    of the other's index that it refreshes only when the ring looks
+	 *    full (or empty).
+	 *
+	 * 3. Commits can be batched: a commit is published right away, or
+	 *    with a later one.  The pending commits of a side are published
+	 *    once PUBLISH_BATCH of them pile up, when the side calls flush,
+	 *    and when the side finds the ring full (or empty), so that the
+	 *    other side can always make progress.
+	 *
+	 * 4. A side that has to wait for the other spins for a while, and
+	 *    then parks on a condition variable until the other side
+	 *    publishes.  The number of spins adapts: it grows while spinning
+	 *    pays off, and shrinks when the side ends up parking anyway.
 	 */
 	
 	class Queue {
@@ -25,35 +49,30 @@ namespace Network {
 		// 64 KB
 		static const int BUF_SIZE = (1 << 16);
 		
-		/// Buffer for the queue objects
-		char buffer [BUF_SIZE];
+		/// Size of a cache line
+		static const unsigned int CACHE_LINE = 64;
 		
-		/// Length of each queue object
-		int objLen;
+		/// Number of commits pending before they are published
+		static const unsigned int PUBLISH_BATCH = 32;
 		
-		/// Pointer to the last slot
-		char *lastSlot;
+		/// Bounds of the number of spins before parking
+		static const int MIN_SPINS = 16;
+		static const int MAX_SPINS = 1024;
 		
-		/// Next slot to read from.  Contains valid data iff 
-		/// (nextReadSlot != nextWriteSlot) || (!bEmpty)
-		char *nextReadSlot;
+		//------------------------------------------------------------
+		// Read-only after construction
+		//------------------------------------------------------------
 		
-		/// The slot is valid only if the queue is not full:
-		/// (nextReadSlot != nextWriteSlot) || (bEmpty)
-		char *nextWriteSlot;
-		
-		/// Indicator whether queue is empty or not
-		bool bEmpty;
+		/// Buffer for the queue objects
+		char buffer [BUF_SIZE];
 		
-		/// Indicator whether the writer is blocked for the queue to clear
-		/// up some slots
-		bool bWriterBlocked;
+		/// Length of each queue object
+		int objLen;
 		
-		/// Indicator whether the reader is blocked for the queue to
-		/// become nonempty
-		bool bReaderBlocked;
+		/// Number of slots in the ring
+		unsigned int numSlots;
 		
-		/// Mutex for critical code
+		/// Mutex for parking
 		pthread_mutex_t mutex;
 		
 		/// Condition variable for waiting/signaling on queue nonempty condition
@@ -62,6 +81,61 @@ namespace Network {
 		/// Condition variable for waiting/signaling on queue nonfull condition
 		pthread_cond_t nonfull_cond;
 		
+		char pad0 [CACHE_LINE];
+		
+		//------------------------------------------------------------
+		// Writer
+		//------------------------------------------------------------
+		
+		/// Slot of the next object to write
+		unsigned int nextTail;
+		
+		/// Number of writes committed but not published
+		unsigned int numWritesPending;
+		
+		/// Last head seen by the writer
+		unsigned int cachedHead;
+		
+		/// Spins of the writer before it parks
+		int writerSpins;
+		
+		char pad1 [CACHE_LINE];
+		
+		/// Published tail: the objects before it are visible to the
+		/// reader
+		unsigned int tail;
+		
+		/// Is the writer parked (or about to park)?
+		bool bWriterWaiting;
+		
+		char pad2 [CACHE_LINE];
+		
+		//------------------------------------------------------------
+		// Reader
+		//------------------------------------------------------------
+		
+		/// Slot of the next object to read
+		unsigned int nextHead;
+		
+		/// Number of reads committed but not published
+		unsigned int numReadsPending;
+		
+		/// Last tail seen by the reader
+		unsigned int cachedTail;
+		
+		/// Spins of the reader before it parks
+		int readerSpins;
+		
+		char pad3 [CACHE_LINE];
+		
+		/// Published head: the slots before it are free for the writer
+		unsigned int head;
+		
+		/// Is the reader parked (or about to park)?
+		bool bReaderWaiting;
+		
+		char pad4 [CACHE_LINE];
+		
 	public:
 		Queue (ostream &LOG, int objLen);
 		~Queue ();
@@ -74,9 +148,9 @@ namespace Network {
 		 * until the commitWrite() method is called.
 		 *
 		 * The getNextWriteSlot() method blocks if the queue is full
-		 * and remains so until the reader reads one object off from the
-		 * queue.  If the queue is not full, this calls  does not even
-		 * involve any synchronization calls - so it is never blocking.
+		 * and remains so until the reader frees one slot.  If the queue
+		 * is not full, this call does not involve any synchronization
+		 * calls - so it is never blocking.
 		 */ 
 		int getNextWriteSlot (char *&ptr);
 		
@@ -87,19 +161,32 @@ namespace Network {
 		 * should be the same returned by the previous
 		 * getNextWriteSlot().
 		 *
-		 * This call could block *temporarily* since it has some critical
-		 * code.  But the blocking occurs only if the reader is in his
-		 * critical code, and the blocking ends after the reader is out of
-		 * his critical code.
+		 * With bPublish the object (and those committed before it) is
+		 * visible to the reader on return.  Otherwise it may become
+		 * visible only with a later commit or flushWrites().  Publishing
+		 * is a full memory barrier.
 		 */
 		
-		int commitWrite (char *ptr);
+		int commitWrite (char *ptr, bool bPublish = true);
 		
 		/**
-		 * Returns true if the queue is empty and false otherwise.  No
-		 * synchronization involved, nonblocking.
+		 * Publish the writes committed so far
 		 */
-		bool isEmpty () const;
+		int flushWrites ();
+		
+		/**
+		 * Returns true if the queue is empty and false otherwise.  Called
+		 * by the reader: an empty queue publishes its pending reads.
+		 * Nonblocking.
+		 */
+		bool isEmpty ();
+		
+		/**
+		 * Returns true if the queue is full and false otherwise.  Called
+		 * by the writer: a full queue publishes its pending writes.
+		 * Nonblocking.
+		 */
+		bool isFull ();
 		
 		/**
 		 * Get the next read slot.  On return 'ptr' points to beginning of
@@ -107,20 +194,39 @@ namespace Network {
 		 * until the commitRead() method is called.
 		 *
 		 * This method blocks if the queue is empty until the writer
-		 * writes some objects.  But if the queue is not empty, it does not
-		 * involve any synchronization calls and is never blocking.
+		 * publishes some objects.  But if the queue is not empty, it does
+		 * not involve any synchronization calls and is never blocking.
 		 */
 		
 		int getNextReadSlot (char *&ptr);
 		
 		/**
 		 * commit a read operation.  This dequeues the last read object.
-		 * This call could block temporarily since it has some critical
-		 * code.  But the blocking is oinly for the duration of the
-		 * writers critical code.
+		 * With bPublish the slot is free for the writer on return,
+		 * otherwise it may be freed only with a later commit or
+		 * flushReads().  Publishing is a full memory barrier.
 		 */
 		
-		int commitRead (char *ptr);		
+		int commitRead (char *ptr, bool bPublish = true);
+		
+		/**
+		 * Publish the reads committed so far
+		 */
+		int flushReads ();
+	
+	private:
+		char *slot (unsigned int s) {
+			return buffer + s * objLen;
+		}
+		
+		unsigned int next (unsigned int s) const {
+			return (s + 1 == numSlots) ? 0 : s + 1;
+		}
+		
+		void publishWrites ();
+		void publishReads ();
+		void waitNonFull ();
+		void waitNonEmpty ();
 	};
 }
 
@@ -0,0 +1,268 @@
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#ifndef _EVENT_LOOP_
+#include "event_loop.h"
+#endif
+
+#ifndef _DEBUG_
+#include "debug.h"
+#endif
+
+using namespace Network;
+using namespace std;
+
+EventLoop::EventLoop (ostream &_LOG)
+	: LOG (_LOG)
+{
+	epfd = epoll_create (MAX_EVENTS);
+	
+	if (epfd < 0) {
+		LOG << "EventLoop: Can't create an epoll instance" << endl;
+	}
+	
+	// Registered with a null handler
+	wakefd = eventfd (0, EFD_NONBLOCK);
+	
+	if (wakefd < 0) {
+		LOG << "EventLoop: Can't create an eventfd" << endl;
+	}
+	else if (epfd >= 0) {
+		ctl (EPOLL_CTL_ADD, wakefd, 0, EV_READ);
+	}
+	
+	numTimers = 0;
+	waitDeadline = -1;
+	pthread_mutex_init (&mutex, 0);
+}
+
+EventLoop::~EventLoop ()
+{
+	if (wakefd >= 0)
+		close (wakefd);
+	if (epfd >= 0)
+		close (epfd);
+	pthread_mutex_destroy (&mutex);
+}
+
+void EventLoop::run ()
+{
+	int rc;
+	int n;
+	struct epoll_event events [MAX_EVENTS];
+	EventHandler *handler;
+	
+	uint64_t count;
+	
+	if (epfd < 0 || wakefd < 0)
+		return;
+	
+	while (true) {
+		
+		n = epoll_wait (epfd, events, MAX_EVENTS, getTimeout ());
+		
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			
+			LOG << "EventLoop: Error waiting for events" << endl;
+			return;
+		}
+		
+		// One event per socket: a handler that destroys its
+		// connection does not show up again in this batch
+		for (int e = 0 ; e < n ; e++) {
+			handler = (EventHandler *) events [e].data.ptr;
+			
+			// Woken up for a timer
+			if (!handler) {
+				read (wakefd, &count, sizeof (count));
+				continue;
+			}
+			
+			// Errors and hangups are seen by the reads (or writes)
+			if (events [e].events & EPOLLOUT)
+				rc = handler -> handleWrite ();
+			else
+				rc = handler -> handleRead ();
+			
+			if (rc != 0)
+				handler -> handleError ();
+		}
+		
+		if (runTimers () != 0)
+			return;
+	}
+	
+	// never comes
+	return;
+}
+
+int EventLoop::ctl (int op, int fd, EventHandler *handler,
+					unsigned int events)
+{
+	struct epoll_event event;
+	
+	event.events = 0;
+	if (events & EV_READ)
+		event.events |= EPOLLIN;
+	if (events & EV_WRITE)
+		event.events |= EPOLLOUT;
+	event.data.ptr = handler;
+	
+	if (epoll_ctl (epfd, op, fd, &event) != 0) {
+		LOG << "EventLoop: Error registering a socket" << endl;
+		return -1;
+	}
+	
+	return 0;
+}
+
+int EventLoop::add (int fd, EventHandler *handler, unsigned int events)
+{
+	return ctl (EPOLL_CTL_ADD, fd, handler, events);
+}
+
+int EventLoop::modify (int fd, EventHandler *handler, unsigned int events)
+{
+	return ctl (EPOLL_CTL_MOD, fd, handler, events);
+}
+
+int EventLoop::remove (int fd)
+{
+	struct epoll_event event;
+	
+	// (Older kernels want a non-null event)
+	if (epoll_ctl (epfd, EPOLL_CTL_DEL, fd, &event) != 0) {
+		LOG << "EventLoop: Error removing a socket" << endl;
+		return -1;
+	}
+	
+	return 0;
+}
+
+long long EventLoop::now ()
+{
+	struct timespec ts;
+	
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Timeout of the next wait: till the earliest timer expires.
+ */
+int EventLoop::getTimeout ()
+{
+	int timeout;
+	
+	pthread_mutex_lock (&mutex);
+	
+	waitDeadline = -1;
+	for (int t = 0 ; t < numTimers ; t++)
+		if (waitDeadline < 0 || timers [t].deadline < waitDeadline)
+			waitDeadline = timers [t].deadline;
+	
+	if (waitDeadline < 0)
+		timeout = -1;
+	else if (waitDeadline <= now ())
+		timeout = 0;
+	else
+		timeout = (int) (waitDeadline - now ());
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return timeout;
+}
+
+int EventLoop::runTimers ()
+{
+	int rc;
+	int numExpired;
+	long long curTime;
+	
+	pthread_mutex_lock (&mutex);
+	
+	numExpired = 0;
+	curTime = now ();
+	for (int t = 0 ; t < numTimers ; ) {
+		if (timers [t].deadline <= curTime) {
+			expired [numExpired++] = timers [t].handler;
+			timers [t] = timers [--numTimers];
+		}
+		else {
+			t++;
+		}
+	}
+	
+	pthread_mutex_unlock (&mutex);
+	
+	// The handlers can set their timers again
+	for (int e = 0 ; e < numExpired ; e++) {
+		if ((rc = expired [e] -> handleTimer ()) != 0)
+			expired [e] -> handleError ();
+	}
+	
+	return 0;
+}
+
+int EventLoop::setTimer (EventHandler *handler, int msecs)
+{
+	int t;
+	long long deadline;
+	uint64_t count;
+	
+	deadline = now () + msecs;
+	
+	pthread_mutex_lock (&mutex);
+	
+	for (t = 0 ; t < numTimers ; t++)
+		if (timers [t].handler == handler)
+			break;
+	
+	if (t == numTimers) {
+		if (numTimers >= MAX_TIMERS) {
+			pthread_mutex_unlock (&mutex);
+			LOG << "EventLoop: Too many timers" << endl;
+			return -1;
+		}
+		
+		timers [t].handler = handler;
+		timers [t].deadline = deadline;
+		numTimers ++;
+	}
+	else if (deadline < timers [t].deadline) {
+		timers [t].deadline = deadline;
+	}
+	
+	// The loop waits past the deadline: wake it up
+	if (waitDeadline < 0 || deadline < waitDeadline) {
+		waitDeadline = deadline;
+		count = 1;
+		write (wakefd, &count, sizeof (count));
+	}
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return 0;
+}
+
+int EventLoop::cancelTimer (EventHandler *handler)
+{
+	pthread_mutex_lock (&mutex);
+	
+	for (int t = 0 ; t < numTimers ; t++) {
+		if (timers [t].handler == handler) {
+			timers [t] = timers [--numTimers];
+			break;
+		}
+	}
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return 0;
+}
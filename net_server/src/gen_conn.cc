@@ -1,3 +1,7 @@
+#include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
 #ifndef _GEN_CONN_
 #include "gen_conn.h"
 #endif
@@ -33,85 +37,114 @@ using namespace std;
 
 GenericConnection::GenericConnection (int id,
 									  NetworkManager *netMgr,
+									  EventLoop *loop,
 									  int sockfd,
 									  ostream &_LOG)
 	: log (_LOG)
 {
 	this -> id = id;
 	this -> netMgr = netMgr;
+	this -> loop = loop;
 	this -> sockfd = sockfd;
+	this -> msgRead = 0;
 	
 	return;
 }
 
-void GenericConnection::run()
+int GenericConnection::handleRead ()
 {
 	int rc;
+	int n;
+	int msgLen;
+	int msgEnd;
 	ConnSpec connSpec;
 	
-	LOG << "Starting" << endl;   	
+	// The first four bytes are the length of the message
+	msgEnd = sizeof (int);
+	if (msgRead >= (int) sizeof (int)) {
+		memcpy (&msgLen, msgBuf, sizeof (int));
+		msgLen = ntohl (msgLen);
+		
+		// we don't have space
+		if (msgLen <= 0 || msgLen > MSG_BUF_LEN) {
+			LOG << "Invalid connection spec" << endl;
+			return -1;
+		}
+		
+		msgEnd += msgLen;
+	}
+	
+	n = read (sockfd, msgBuf + msgRead, msgEnd - msgRead);
+	
+	if (n < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+		
+		LOG << "Error reading connection spec" << endl;
+		return -1;
+	}
+	
+	if (n == 0) {
+		LOG << "Connection closed before its spec" << endl;
+		return -1;
+	}
+	
+	msgRead += n;
+	
+	// The rest of the message comes with the next read
+	if (msgRead < msgEnd || msgEnd == sizeof (int))
+		return 0;
 	
 	// Determine the type of the connection based on the first message
 	// from the client 
 	if ((rc = getConnectionSpec(connSpec)) != 0) {
 		LOG << "Error getting connection spec" << endl;
+		return -1;
+	}
 		
-		terminate();
-		return;
+	// The generic connection is done with the loop
+	if ((rc = loop -> remove (sockfd)) != 0)
+		return -1;
+	
+	if ((rc = sendReply ()) != 0) {
+		LOG << "Error sending error code"
+			<< endl;
+		return -1;
 	}
 	
 	if (connSpec.type == COMMAND_CONN) {
 		
-		if ((rc = NetUtil::sendErrorCode(sockfd, 0)) != 0) {
-			LOG << "Error sending error code"
+		if ((rc = pthread_create (&thread, NULL, &start_thread,
+								  (void*)this)) != 0) {
+			LOG << "Error creating a command connection thread"
 				<< endl;
-			terminate();
-			return;
+			return -1;
 		}
 		
-		if ((rc = morphToCommandConn()) != 0) {
-			
-			LOG << "Error morphing to command connectin"
-				<< endl;
-			
-			terminate();
-			return;
-		}
+		pthread_detach (thread);
+		return 0;
 	}
 	
-	else if (connSpec.type == INPUT_CONN) {
+	if ((rc = NetUtil::setBlocking (sockfd, false)) != 0) {
+		LOG << "Error setting up the connection" << endl;
+		return -1;
+	}
 		
-		if ((rc = NetUtil::sendErrorCode(sockfd, 0)) != 0) {
-			LOG << "Error sending error code"
-				<< endl;
-			terminate();
-			return;
-		}
+	if (connSpec.type == INPUT_CONN) {
 		
 		if ((rc = morphToInputConn(connSpec.inputId)) != 0) {
 			LOG << "Error morphing to input connection"
 				<< endl;
-			
-			terminate();
-			return;
+			return -1;
 		}					
 	}
 	
 	else if (connSpec.type == OUTPUT_CONN) {
 		
-		if ((rc = NetUtil::sendErrorCode(sockfd, 0)) != 0) {
-			LOG << "Error sending error code"
-				<< endl;
-			terminate();
-			return;
-		}		
-		
-		if ((rc = morphToOutputConn(connSpec.outputId)) != 0) {
-			LOG << "Error morphing to input connection"
+		if ((rc = morphToOutputConn(connSpec)) != 0) {
+			LOG << "Error morphing to output connection"
 				<< endl;
-			
-			terminate();
-			return;
+			return -1;
 		}
 	}
 	
@@ -120,27 +153,56 @@ void GenericConnection::run()
 		ASSERT (false);
 	}
 	
+	// The socket belongs to the input/output connection now
+	delete this;
+	return 0;
+}
+
+int GenericConnection::handleWrite ()
+{
+	// never armed for writes
+	return 0;
+}
+
+void GenericConnection::handleError ()
+{
+	terminate ();
+	delete this;
+}
+
+// Thread of a command connection
+void GenericConnection::run()
+{
+	int rc;
+	
+	if ((rc = morphToCommandConn()) != 0) {
+		
+		LOG << "Error morphing to command connectin"
+			<< endl;
+	}
+	
 	terminate();
 	return;	
 }
 
-static const int MSG_BUF_LEN = 128;
-
 int GenericConnection::getConnectionSpec(ConnSpec &spec)
 {
-	int rc;
-	char msgBuf [MSG_BUF_LEN];
+	char *msg;
+	char *opt;
 	int msgLen;
 	
-	// The first message contains the specification of the connection type
-	if((rc = NetUtil::getMessage(sockfd,
-								 msgBuf,
-								 MSG_BUF_LEN,
-								 msgLen)) != 0)
+	// The message (null terminated) follows its length
+	msg = msgBuf + sizeof (int);
+	msgLen = msgRead - sizeof (int);
+	
+	if (msg [msgLen - 1] != '\0')
 		return -1;
 	
+	// discount the null
+	msgLen--;
+	
 	// It is a command connection
-	if (strncmp(msgBuf, "COMMAND_CONN", 12) == 0) {
+	if (strncmp(msg, "COMMAND_CONN", 12) == 0) {
 		
 #ifdef _DM_
 		if (msgLen != 12)
@@ -153,22 +215,44 @@ int GenericConnection::getConnectionSpec(ConnSpec &spec)
 	}	
 	
 	// It is an input connection
-	else if (strncmp(msgBuf, "INPUT_CONN", 10) == 0) {		
+	else if (strncmp(msg, "INPUT_CONN", 10) == 0) {		
 		spec.type = INPUT_CONN;
-		spec.inputId = atoi(msgBuf + 10);
+		spec.inputId = atoi(msg + 10);
 		spec.outputId = 0;
 	}
 	
-	else if (strncmp(msgBuf, "OUTPUT_CONN", 11) == 0) {
+	else if (strncmp(msg, "OUTPUT_CONN", 11) == 0) {
 		spec.type = OUTPUT_CONN;
-		spec.outputId = atoi(msgBuf + 11);
+		spec.outputId = atoi(msg + 11);
 		spec.inputId = 0;				
+		
+		// Options: [BINARY] [FLUSH <bytes> <msecs>]
+		spec.bBinary = false;
+		spec.flushBytes = 0;
+		spec.flushMsecs = 0;
+		
+		for (opt = strchr (msg, ' ') ; opt ; opt = strchr (opt + 1, ' ')) {
+			
+			if (strncmp (opt + 1, "BINARY", 6) == 0) {
+				spec.bBinary = true;
+			}
+			
+			else if (strncmp (opt + 1, "FLUSH", 5) == 0) {
+				if (sscanf (opt + 6, "%d %d", &spec.flushBytes,
+							&spec.flushMsecs) != 2 ||
+					spec.flushBytes < 0 || spec.flushMsecs < 0) {
+					LOG << "Invalid flush policy: " << msg << endl;
+					return -1;
+				}
+				break;
+			}
+		}
 	}
 	
 	// error
 	else {		
 		LOG << "Unknown connection type"
-			<< msgBuf
+			<< msg
 			<< endl;
 		return -1;							
 	}
@@ -176,6 +260,19 @@ int GenericConnection::getConnectionSpec(ConnSpec &spec)
 	// everything ok here
 	return 0;	
 }
+
+int GenericConnection::sendReply ()
+{
+	int rc;
+	
+	if ((rc = NetUtil::setBlocking (sockfd, true)) != 0)
+		return rc;
+	
+	if ((rc = NetUtil::sendErrorCode (sockfd, 0)) != 0)
+		return rc;
+	
+	return 0;	
+}
 	
 int GenericConnection::morphToCommandConn()
 {
@@ -204,32 +301,26 @@ int GenericConnection::morphToInputConn(unsigned int inputId)
 		return rc;
 	}
 
-	// Set the socket and run ...
-	inputConn -> setSocket (sockfd);	
-	inputConn -> run();
-	netMgr -> destroyInputConn (inputId);
-	
-	return 0;
+	// Hand the socket over: the input connection is served by our
+	// loop from now on
+	return inputConn -> attach (loop, sockfd);
 }
 
-int GenericConnection::morphToOutputConn(unsigned int outputId)
+int GenericConnection::morphToOutputConn(const ConnSpec &spec)
 {
 	int rc;	
 	OutputConnection *outputConn;
 	
 	LOG << "Morphing to OutputConn" << endl;   
 	
-	if ((rc = netMgr -> getOutputConn (outputId, outputConn)) != 0) {
+	if ((rc = netMgr -> getOutputConn (spec.outputId, outputConn)) != 0) {
 		LOG << "Unable to get output connection"
 			<< endl;
 		return rc;
 	}
 	
-	outputConn -> setSocket (sockfd);
-	outputConn -> run();
-	netMgr -> destroyOutputConn (outputId);
-	
-	return 0;
+	return outputConn -> attach (loop, sockfd, spec.bBinary,
+								 spec.flushBytes, spec.flushMsecs);
 }
 
 void GenericConnection::terminate()
@@ -1,4 +1,6 @@
 #include <unistd.h>
+#include <errno.h>
+#include <arpa/inet.h>
 
 #ifndef _IN_CONN_
 #include "in_conn.h"
@@ -8,30 +10,74 @@
 #include "debug.h"
 #endif
 
+#ifndef _NET_MGR_
+#include "net_mgr.h"
+#endif
+
 using namespace Network;
 using namespace std;
 
-InputConnection::InputConnection(ostream &_LOG)
+InputConnection::InputConnection(int id, NetworkManager *netMgr,
+								 ostream &_LOG)
 	: LOG (_LOG)
 {
+	this -> id        = id;
+	this -> netMgr    = netMgr;
+	this -> loop      = 0;
 	this -> sockfd    = -1;
 	this -> bInit     = false;
 	this -> queue     = 0;	
 	this -> curPtr    = readBuf;
 	this -> nbytes    = 0;
+	this -> beof      = false;
 	this -> bEnd      = false;
+	this -> bBinary   = false;
+	this -> frame     = 0;
+	this -> bStalled  = false;
+	this -> bClosed   = false;
 
-	this -> b_wait_for_end = false;
 	pthread_mutex_init (&mutex, NULL);
-	pthread_cond_init (&wait_for_end_cond, NULL);
 	
 	return;
 }
 
-int InputConnection::setSocket (int fd)
+InputConnection::~InputConnection ()
+{
+	if (queue)
+		delete queue;
+	
+	pthread_mutex_destroy (&mutex);
+}
+
+int InputConnection::attach (EventLoop *loop, int fd)
 {
+	int rc;
+	bool bEnded;
+	
+	pthread_mutex_lock (&mutex);
+	
+	if (this -> loop) {
+		pthread_mutex_unlock (&mutex);
+		LOG << "InputConnection: Socket already set"
+			<< endl;
+		return -1;
+	}
+	
+	this -> loop   = loop;
 	this -> sockfd = fd;
-	return 0;
+	
+	// The server has stopped before the client connected
+	rc = 0;
+	bEnded = bEnd;
+	if (!bEnded)
+		rc = loop -> add (sockfd, this, EventLoop::EV_READ);
+	
+	pthread_mutex_unlock (&mutex);
+	
+	if (bEnded)
+		return finish ();
+	
+	return rc;
 }
 
 static bool emptyLine (const char *line)
@@ -41,102 +87,239 @@ static bool emptyLine (const char *line)
 	return (*line == '\0');
 }
 
-static const unsigned int MAX_LINE_SIZE =  1024;
-
-void InputConnection::run()
+int InputConnection::handleRead ()
 {
 	int rc;
-	char *nextTupleSlot;
-	char lineBuffer [MAX_LINE_SIZE];
+	bool bEnded;
+
+	// The server does not want the input any more
+	pthread_mutex_lock (&mutex);
+	bEnded = bEnd;
+	pthread_mutex_unlock (&mutex);
 	
-	if (sockfd == -1) {
-		LOG << "InputConnection: Socket not set"
-			<< endl;
-		return;
-	}
+	if (bEnded)
+		return finish ();
 	
-	// Initialization routine gets the schema from the client, computes
-	// tupleLen, and constructs 'queue'
-	if ((rc = initialize ()) != 0) {
-		LOG << "InputConnection: Error initializing"
-			<< endl;
-		return;
+	// Tuples left in the buffer by a stall
+	if ((rc = consume ()) != 0)
+		return rc;
+	
+	if (bStalled)
+		return 0;
+	
+	// One read per event: the other connections of the loop get their
+	// turn
+	if (!beof) {
+		if ((rc = loadBuf ()) != 0)
+			return rc;
+		
+		if ((rc = consume ()) != 0)
+			return rc;
+		
+		if (bStalled)
+			return 0;
 	}
 	
-	while (!beof) {		
-		// Get the location to write out the next tuple
-		if ((rc = queue -> getNextWriteSlot (nextTupleSlot)) != 0) {
-			LOG << "InputConnection: Error getting a slot from queue"
-				<< endl;
-			return;
-		}
+	// All the input has been consumed
+	if (beof)
+		return finish ();
+	
+	return 0;
+}
+
+/**
+ * The connection is armed for writes only to get back into the loop
+ * thread: after a stall (getNext()) or when the server ends (end()).
+ */
+
+int InputConnection::handleWrite ()
+{
+	int rc;
+	
+	pthread_mutex_lock (&mutex);
+	rc = loop -> modify (sockfd, this, EventLoop::EV_READ);
+	pthread_mutex_unlock (&mutex);
+	
+	if (rc != 0)
+		return rc;
+	
+	return handleRead ();
+}
+
+void InputConnection::handleError ()
+{
+	LOG << "InputConnection: Error reading the input"
+		<< endl;
+	
+	finish ();
+}
+
+/**
+ * Close the socket (this removes it from the loop).  The connection is
+ * destroyed once the server has called end() as well.
+ */
+
+int InputConnection::finish ()
+{
+	bool bDestroy;
+	
+	pthread_mutex_lock (&mutex);
+	
+	close (sockfd);
+	bClosed = true;
+	bDestroy = bEnd;
+	
+	pthread_mutex_unlock (&mutex);
+	
+	LOG << "InputConnection: connection closed" << endl;
+	
+	if (bDestroy)
+		return netMgr -> destroyInputConn (id);
+	
+	return 0;
+}
+
+/**
+ * Stop reading while the queue is full: getNext() puts the connection
+ * back in the loop when it frees a slot.
+ */
+
+int InputConnection::stall ()
+{
+	int rc;
+	
+	if (!queue -> isFull ())
+		return 0;
+	
+	rc = 0;
+	pthread_mutex_lock (&mutex);
+	
+	// The reader frees slots without the mutex, and checks bStalled
+	// after it publishes them (see getNext()): check again after we
+	// set it
+	bStalled = true;
+	__sync_synchronize ();
+	
+	if (queue -> isFull ())
+		rc = loop -> remove (sockfd);
+	else
+		bStalled = false;
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return rc;
+}
+
+int InputConnection::consume ()
+{
+	int rc;
+	char *schemaLine;
+	
+	// The first line encodes the schema
+	if (!bInit) {
+		if ((rc = nextLine (schemaLine)) != 0)
+			return rc;
 		
-		// Get the next line
-		if ((rc = readline (lineBuffer, MAX_LINE_SIZE)) != 0) {
-			LOG << "InputConnection: readline error"
+		if (!schemaLine)
+			return 0;
+		
+		// Initialization routine computes tupleLen, and constructs
+		// 'queue'
+		if ((rc = initialize (schemaLine)) != 0) {
+			LOG << "InputConnection: Error initializing"
 				<< endl;
-			return;
+			return rc;
 		}
+	}
+	
+	if (bBinary)
+		rc = consumeFrames ();
+	else
+		rc = consumeLines ();
+	
+	// The tuples are published to the reader once per read
+	if (rc == 0)
+		rc = queue -> flushWrites ();
+	
+	return rc;
+}
+
+int InputConnection::consumeLines ()
+{
+	int rc;
+	char *nextTupleSlot;
+	char *line;
+	
+	while (true) {
+	
+		if ((rc = stall ()) != 0)
+			return rc;
+	
+		if (bStalled)
+			return 0;
+	
+		// Get the next line
+		if ((rc = nextLine (line)) != 0)
+			return rc;
+		
+		if (!line)
+			return 0;
 		
 		// Ignore empty lines
-		if (emptyLine (lineBuffer)) 
+		if (emptyLine (line)) 
 			continue;		
 		
+		// Get the location to write out the next tuple
+		if ((rc = queue -> getNextWriteSlot (nextTupleSlot)) != 0) {
+			LOG << "InputConnection: Error getting a slot from queue"
+				<< endl;
+			return rc;
+		}
+		
 		// Read the input network stream and construct the next tuple
-		if ((rc = constructTuple (nextTupleSlot, lineBuffer)) != 0) {
+		if ((rc = constructTuple (nextTupleSlot, line)) != 0) {
 			LOG << "InputConnectin:: Error constructing tuple"
 				<< endl;
-			return;
+			return rc;
 		}
 		
-		if ((rc = queue -> commitWrite (nextTupleSlot)) != 0) {
+		if ((rc = queue -> commitWrite (nextTupleSlot, false)) != 0) {
 			LOG << "InputConnection: Error writing to queue" << endl;
-			return;
+			return rc;
 		}		
 	}
 	
-	ASSERT (!b_wait_for_end);	
-	pthread_mutex_lock (&mutex);	
-	if (!bEnd) {
-		LOG << "Waiting for end()" << endl;
-		b_wait_for_end = true;
-		pthread_cond_wait (&wait_for_end_cond, &mutex);
-		b_wait_for_end = false;
-		ASSERT (bEnd);
-		LOG << "end() called" << endl;
-	}
-	
-	pthread_mutex_unlock (&mutex);	
-
-	pthread_mutex_destroy (&mutex);
-	pthread_cond_destroy (&wait_for_end_cond);
-	
-	LOG << "InputConnection: connection closed" << endl;
-	
-	return;
+	// never comes
+	return 0;
 }
 
 static const int SCHEMA_BUF_SIZE = 128;
 
-int InputConnection::initialize ()
+/// Prefix of the schema line that asks for binary frames
+static const char *BINARY_PREFIX = "BINARY ";
+static const int BINARY_PREFIX_LEN = 7;
+
+int InputConnection::initialize (char *schemaLine)
 {
 	int rc;
-	char schemaBuf [SCHEMA_BUF_SIZE];
+	char *schema;
 
-	beof = false;
+	if (strlen (schemaLine) >= (unsigned int) SCHEMA_BUF_SIZE) {
+		LOG << "Schema line too large" << endl;
+		return -1;
+	}
 	
-	// The first message encodes the schema
-	if ((rc = readline (schemaBuf, SCHEMA_BUF_SIZE)) != 0) {
-		LOG << "read Error"
-			<< endl;
-		return rc;
+	schema = schemaLine;
+	if (strncmp (schemaLine, BINARY_PREFIX, BINARY_PREFIX_LEN) == 0) {
+		bBinary = true;
+		schema += BINARY_PREFIX_LEN;
 	}
 	
 	// Parse the schema
-	if ((rc = parseSchema (schemaBuf)) != 0) {
+	if ((rc = parseSchema (schema)) != 0) {
 		LOG << "parse Error"
 			<< endl;
-		LOG << "Schema: " << schemaBuf << endl;
+		LOG << "Schema: " << schemaLine << endl;
 		return rc;
 	}
 	
@@ -156,78 +339,304 @@ int InputConnection::initialize ()
 	return 0;
 }
 
-int InputConnection::readline (char *lineBuf, int lineBufSize)
+/**
+ * The next complete line in the buffer (0 if there is none yet).  The
+ * line is terminated in place.
+ */
+
+int InputConnection::nextLine (char *&line)
 {
-	int rc;
+	char *ptr;
+	char *bufEnd;
 
-	for (int i = 0 ; i < lineBufSize ; i++) {
-		
-		ASSERT (curPtr <= readBuf + nbytes);
+	line = 0;
+	bufEnd = readBuf + nbytes;
 		
-		// we don't have any unread data in the input buffer, recharge the
-		// buffer
-		if (curPtr - readBuf == nbytes) {
-			
-			// Load the buffer with input data
-			if ((rc = loadBuf ()) != 0)
-				return rc;
-			
-			// At the end of loading, curPtr should be at the beginning of
-			// the buffer.  Also loadBuf reads 0 bytes only at the eof.
-			ASSERT (curPtr == readBuf);			
-			ASSERT (nbytes > 0 || beof);
-			
-			// We have reached the end of file: return whatever we have
-			// got 
-			if (beof) {
-				*lineBuf = '\0';
-				return 0;
-			}
-		}
-		
-		ASSERT (curPtr < readBuf + nbytes);
+	for (ptr = curPtr ; ptr < bufEnd ; ptr++)
+		if (*ptr == '\n' || *ptr == '\r')
+			break;
 		
 		// Eol
-		if (*curPtr == '\n' || *curPtr == '\r') {
-			*lineBuf = '\0';
-			curPtr ++;
+	if (ptr < bufEnd) {
+		*ptr = '\0';
+		line = curPtr;
+		curPtr = ptr + 1;
 			return 0;
 		}
 		
-		else {
-			*lineBuf++ = *curPtr++;
-		}
+	// We have reached the end of file: return whatever we have got
+	// (readBuf has a spare byte for the null)
+	if (beof && ptr > curPtr) {
+		*ptr = '\0';
+		line = curPtr;
+		curPtr = ptr;
 	}
 	
-	// linebuffer too small
-	LOG << "readline: Input line too large" << endl;
-	return -1;
+	return 0;
 }
 
+/**
+ * Read the next chunk of input into the buffer, after the input not
+ * yet consumed.
+ */
+
 int InputConnection::loadBuf ()
 {
-	ASSERT (curPtr == readBuf + nbytes);
+	int n;
+	int avail;
 	
-	curPtr = readBuf;
+	// Frames are consumed in place
+	ASSERT (!frame);
 	
-	// try to read an entire chunk of input
-	nbytes = read (sockfd, readBuf, READ_BUF_SIZE);
+	// Move the unread bytes to the beginning of the buffer
+	avail = readBuf + nbytes - curPtr;
+	if (curPtr != readBuf) {
+		memmove (readBuf, curPtr, avail);
+		curPtr = readBuf;
+		nbytes = avail;
+	}
+	
+	// A line (a frame) has to fit in the buffer
+	if (nbytes == READ_BUF_SIZE) {
+		LOG << "InputConnection: Input line too large" << endl;
+	return -1;
+}
 
-	// Error
-	if (nbytes < 0) {
-		LOG << "InputConnection: error reading from the socker"
+	n = read (sockfd, readBuf + nbytes, READ_BUF_SIZE - nbytes);
+	
+	if (n < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+	
+		LOG << "InputConnection: error reading from the socket"
 			<< endl;
 		return -1;
 	}
 
 	// Eof
-	if (nbytes == 0) {
+	if (n == 0) {
 		beof = true;
 	}
 	
+	nbytes += n;
+	
+	return 0;
+}
+
+/// Length of the header of a frame following its length
+static const int FRAME_HDR_SIZE = 5;
+
+int InputConnection::consumeFrames ()
+{
+	int rc;
+	
+	while (true) {
+		
+		// The next frame
+		if (!frame) {
+			if ((rc = nextFrame ()) != 0)
+				return rc;
+			
+			if (!frame)
+				return 0;
+		}
+		
+		if (frame [0] == 'R')
+			rc = constructRows ();
+		else
+			rc = constructColumns ();
+		
+		if (rc != 0)
+			return rc;
+		
+		// The rest of the frame waits for the queue to clear up
+		if (bStalled)
+			return 0;
+		
+		frame = 0;
+	}
+	
+	// never comes
+	return 0;
+}
+
+/**
+ * Set frame to the next frame if it is complete in the buffer, after
+ * checking it against the schema.
+ */
+
+int InputConnection::nextFrame ()
+{
+	int avail;
+	unsigned int frameLen;
+	unsigned int numRows;
+	char layout;
+	
+	avail = readBuf + nbytes - curPtr;
+	
+	// Length of the frame
+	if (avail < (int) sizeof (int)) {
+		if (beof && avail > 0) {
+			LOG << "InputConnection: truncated frame" << endl;
+			return -1;
+		}
+		return 0;
+	}
+	
+	memcpy (&frameLen, curPtr, sizeof (int));
+	frameLen = ntohl (frameLen);
+	
+	if (frameLen < (unsigned int) FRAME_HDR_SIZE ||
+		frameLen > (unsigned int) (READ_BUF_SIZE - sizeof (int))) {
+		LOG << "InputConnection: invalid frame length "
+			<< frameLen << endl;
+		return -1;
+	}
+	
+	// The entire frame
+	if (avail < (int) (sizeof (int) + frameLen)) {
+		if (beof) {
+			LOG << "InputConnection: truncated frame" << endl;
+			return -1;
+		}
+		return 0;
+	}
+	
+	layout = curPtr [sizeof (int)];
+	memcpy (&numRows, curPtr + sizeof (int) + 1, sizeof (int));
+	numRows = ntohl (numRows);
+	
+	if (layout != 'R' && layout != 'C') {
+		LOG << "InputConnection: unknown frame layout" << endl;
+		return -1;
+	}
+	
+	// The frame has to hold exactly numRows rows of the schema
+	if (numRows > (unsigned int) READ_BUF_SIZE / (tupleLen + 1) ||
+		frameLen != FRAME_HDR_SIZE + numRows * (tupleLen + 1)) {
+		LOG << "InputConnection: frame does not match the schema"
+			<< endl;
+		return -1;
+	}
+	
+	frame = curPtr + sizeof (int);
+	frameRows = numRows;
+	nextRow = 0;
+	
+	// The frame stays in the buffer until it is consumed: loadBuf()
+	// is not called before
+	curPtr += sizeof (int) + frameLen;
+	
 	return 0;
 }
 
+int InputConnection::constructRows ()
+{
+	int rc;
+	char *tupleBuf;
+	char *row;
+	
+	for (; nextRow < frameRows ; nextRow++) {
+		row = frame + FRAME_HDR_SIZE + nextRow * (tupleLen + 1);
+		
+		if (row [0] != 'N' && row [0] != 'H') {
+			LOG << "Malformed input tuple" << endl;
+			return -1;
+		}
+		
+		if ((rc = stall ()) != 0)
+			return rc;
+		
+		if (bStalled)
+			return 0;
+		
+		if ((rc = queue -> getNextWriteSlot (tupleBuf)) != 0)
+			return rc;
+		
+		for (int a = 0 ; a < numAttrs ; a++)
+			decodeAttr (tupleBuf + offsets [a], row + 1 + offsets [a], a);
+		tupleBuf [tupleLen] = row [0];
+		
+		if ((rc = queue -> commitWrite (tupleBuf, false)) != 0)
+			return rc;
+	}
+	
+	return 0;
+}
+
+int InputConnection::constructColumns ()
+{
+	int rc;
+	char *tupleBuf;
+	char *payload;
+	char *column;
+	
+	payload = frame + FRAME_HDR_SIZE;
+		
+	for (; nextRow < frameRows ; nextRow++) {
+		
+		if (payload [nextRow] != 'N' && payload [nextRow] != 'H') {
+			LOG << "Malformed input tuple" << endl;
+			return -1;
+		}
+		
+		if ((rc = stall ()) != 0)
+			return rc;
+		
+		if (bStalled)
+			return 0;
+		
+		if ((rc = queue -> getNextWriteSlot (tupleBuf)) != 0)
+			return rc;
+		
+		// The column of an attribute follows the columns of the
+		// attributes before it
+		for (int a = 0 ; a < numAttrs ; a++) {
+			column = payload + frameRows * (1 + offsets [a]);
+			decodeAttr (tupleBuf + offsets [a],
+						column + nextRow * attrLen [a], a);
+		}
+		tupleBuf [tupleLen] = payload [nextRow];
+		
+		if ((rc = queue -> commitWrite (tupleBuf, false)) != 0)
+			return rc;
+	}
+	
+	return 0;
+}
+
+void InputConnection::decodeAttr (char *dest, const char *src, int a)
+{
+	unsigned int val;
+	
+	switch (attrTypes [a]) {
+		
+	case INT:
+	case FLOAT:
+		
+		memcpy (&val, src, sizeof (int));
+		val = ntohl (val);
+		memcpy (dest, &val, sizeof (int));
+		break;
+		
+	case CHAR:
+		
+		memcpy (dest, src, attrLen [a]);
+		dest [attrLen [a] - 1] = '\0';
+		break;
+		
+	case BYTE:
+		
+		*dest = *src;
+		break;
+		
+	default:
+		
+		ASSERT (0);
+		break;
+	}
+}
+
 #include <iostream>
 int InputConnection::parseSchema (char *ptr)
 {	
@@ -361,10 +770,12 @@ int InputConnection::computeOffsets ()
 		
 		switch (attrTypes [a]) {
 		case INT:
+			attrLen [a] = sizeof(int);
 			offset += sizeof(int);
 			break;
 
 		case FLOAT:
+			attrLen [a] = sizeof(float);
 			offset += sizeof(float);
 			break;
 
@@ -373,6 +784,7 @@ int InputConnection::computeOffsets ()
 			break;
 
 		case BYTE:
+			attrLen [a] = 1;
 			offset ++;
 			break;
 
@@ -414,10 +826,30 @@ int InputConnection::getNext (char *&tuple, unsigned int &len,
 	
 	if (lastTuple) {
 		
-		if ((rc = queue -> commitRead (lastTuple)) != 0)
+		// The slot is freed along with the next ones, unless the
+		// connection waits for it
+		if ((rc = queue -> commitRead (lastTuple, bStalled)) != 0)
 			return rc;
 		
 		lastTuple = 0;
+		
+		// The connection waits for a free slot: back to the loop,
+		// through a write event (see handleWrite())
+		if (bStalled) {
+			pthread_mutex_lock (&mutex);
+			
+			rc = 0;
+			if (bStalled) {
+				bStalled = false;
+				rc = loop -> add (sockfd, this,
+								  EventLoop::EV_READ | EventLoop::EV_WRITE);
+			}
+			
+			pthread_mutex_unlock (&mutex);
+			
+			if (rc != 0)
+				return rc;
+		}
 	}
 	
 	// The queue containing the tuples is empty, so just return
@@ -448,15 +880,37 @@ int InputConnection::getNext (char *&tuple, unsigned int &len,
 
 int InputConnection::end ()
 {
+	int rc;
+	bool bDestroy;
+	
 	ASSERT (!bEnd);
 	pthread_mutex_lock (&mutex);
 	bEnd = true;
 	
-	if (b_wait_for_end)
-		pthread_cond_signal (&wait_for_end_cond);
+	// The loop closes the connection (see handleWrite()), unless the
+	// client has not connected yet (see attach())
+	rc = 0;
+	bDestroy = bClosed;
+	if (loop && !bClosed) {
+		
+		if (bStalled) {
+			bStalled = false;
+			rc = loop -> add (sockfd, this,
+							  EventLoop::EV_READ | EventLoop::EV_WRITE);
+		}
+		
+		else {
+			rc = loop -> modify (sockfd, this,
+								 EventLoop::EV_READ | EventLoop::EV_WRITE);
+		}
+	}
 	
 	pthread_mutex_unlock (&mutex);
-	return 0;
+	
+	if (bDestroy)
+		return netMgr -> destroyInputConn (id);
+	
+	return rc;
 }
 
 #ifdef _TEST_
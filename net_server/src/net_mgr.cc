@@ -34,6 +34,14 @@ using namespace std;
 #include "out_conn.h"
 #endif
 
+#ifndef _EVENT_LOOP_
+#include "event_loop.h"
+#endif
+
+#ifndef _NET_UTIL_
+#include "net_util.h"
+#endif
+
 static const int MAX_FILE_NAME = 128;
 static char logFile [MAX_FILE_NAME];
 
@@ -53,9 +61,12 @@ NetworkManager::NetworkManager(int   portNo,
 	sprintf (logFile, "%s", logFilePref);
 	LOG.open (logFile, ofstream::app);
 	
-	// Initialize the thread pool
-	for (int t = 0 ; t < NUM_THREADS ; t++)
-		b_thread_in_use [t] = false;
+	// Initialize the event loops
+	for (int t = 0 ; t < NUM_IO_THREADS ; t++)
+		loops [t] = new EventLoop (LOG);
+	nextLoop = 0;
+	
+	pthread_mutex_init (&mutex, NULL);
 
 	// Initialize input/output connections
 	for (int i = 0 ; i < MAX_INPUT_CONN ; i++)
@@ -74,6 +85,15 @@ void NetworkManager::run()
 	
 	LOG << "NetMgr: starting up" << endl;
 	
+	// Start off the event loops
+	for (int t = 0 ; t < NUM_IO_THREADS ; t++) {
+		if (pthread_create (&io_threads [t], NULL, &start_thread,
+							(void*)loops [t]) != 0) {
+			LOG << "NetMgr: Error creating an i/o thread" << endl;
+			return;
+		}
+	}
+	
 	//-------------------------------------------------------------------
 	// Open a socket, bind the address, and wait for new connections
 	//-------------------------------------------------------------------
@@ -118,34 +138,14 @@ void NetworkManager::run()
 	return;
 }
 
-// Start off a generic connection thread
+// Hand a new connection to an event loop as a generic connection
 int NetworkManager::handleNewConn (int cli_sockfd)
 {
-	int free_thread_id;
 	int rc;
 	int conn_id;
+	EventLoop *loop;
 	GenericConnection *gen_conn;
 	
-	// Get a free thread to do the work for us
-	free_thread_id = -1;
-	for (int t = 0 ; t < (int) NUM_THREADS ; t++) {
-		if (!b_thread_in_use [t]) {
-			free_thread_id = t;
-			break;
-		}
-	}
-	
-	// If we do not have a free thread, we just don't accept the
-	// connection.  We write this situation to the log ...
-	if (free_thread_id == -1) {
-		
-		LOG << "NetMgr: A request not handled due to lack of resources"
-			<< endl;
-		
-		close (cli_sockfd);
-		return 0;
-	}
-	
 	// Create a new generic connection object
 	ASSERT (num_conns <= MAX_CONN);
 	
@@ -156,18 +156,30 @@ int NetworkManager::handleNewConn (int cli_sockfd)
 		return -1;		
 	}
 	
+	// The event loops serve non-blocking sockets
+	if ((rc = NetUtil::setBlocking (cli_sockfd, false)) != 0) {
+		LOG << "NetMgr: Error setting up a new connection" << endl;
+		close (cli_sockfd);
+		return 0;
+	}
+	
+	// The loops get the connections in turns
+	loop = loops [nextLoop];
+	nextLoop = (nextLoop + 1) % NUM_IO_THREADS;
+	
 	conn_id = num_conns;	
-	gen_conn = new GenericConnection (conn_id, this,									  
+	gen_conn = new GenericConnection (conn_id, this, loop,
 									  cli_sockfd, LOG);									  
 	connTable [conn_id].type = UNKNOWN;
 	num_conns ++;
 	
-	// Start off the thread ...
-	rc = pthread_create (&conn_threads [free_thread_id], NULL, &start_thread,
-						 (void*)gen_conn);
-	if (rc != 0) {
-		LOG << "NetMgr: Error creating a new connection thread" << endl;
-		return -1;
+	// The first message from the client says what the connection is
+	if ((rc = loop -> add (cli_sockfd, gen_conn,
+						   EventLoop::EV_READ)) != 0) {
+		LOG << "NetMgr: Error registering a new connection" << endl;
+		delete gen_conn;
+		close (cli_sockfd);
+		return 0;
 	}
 	
 	return 0;
@@ -195,6 +207,8 @@ int NetworkManager::registerCommandConn (int id) {
 
 int NetworkManager::createInputConn (int &conn_id, InputConnection *&conn)
 {
+	pthread_mutex_lock (&mutex);
+	
 	conn_id = -1;
 	for (int i = 0 ; i < MAX_INPUT_CONN  ; i++) {		
 		if (!input_conns [i]) {
@@ -205,25 +219,32 @@ int NetworkManager::createInputConn (int &conn_id, InputConnection *&conn)
 	
 	// We don't have a free connection
 	if (conn_id == -1) {
+		pthread_mutex_unlock (&mutex);
 		return NET_MGR_RSRC_ERR;
 	}
 
 	// Create a new input connection
-	conn = new InputConnection (LOG);
+	conn = new InputConnection (conn_id, this, LOG);
 
 	input_conns [conn_id] = conn;
+	
+	pthread_mutex_unlock (&mutex);
 	return 0;
 }
 
 int NetworkManager::getInputConn (int conn_id, InputConnection *&conn)
 {
-	if (conn_id < 0 || conn_id > MAX_INPUT_CONN)
+	if (conn_id < 0 || conn_id >= MAX_INPUT_CONN)
 		return -1;
 
-	if (!input_conns [conn_id])
-		return -1;
+	pthread_mutex_lock (&mutex);
 
 	conn = input_conns [conn_id];
+	
+	pthread_mutex_unlock (&mutex);
+	
+	if (!conn)
+		return -1;
 
 	return 0;
 }
@@ -231,6 +252,9 @@ int NetworkManager::getInputConn (int conn_id, InputConnection *&conn)
 int NetworkManager::destroyInputConn (int conn_id)
 {
 	ASSERT (conn_id >= 0 && conn_id < MAX_INPUT_CONN);
+	
+	pthread_mutex_lock (&mutex);
+	
 	ASSERT (input_conns [conn_id]);
 
 	LOG << "Destroying input connection: " << conn_id << endl;
@@ -238,12 +262,16 @@ int NetworkManager::destroyInputConn (int conn_id)
 	delete input_conns [conn_id];
 	input_conns [conn_id] = 0;
 	
+	pthread_mutex_unlock (&mutex);
+	
 	return 0;
 }
 
 int NetworkManager::createOutputConn (int &conn_id,
 									  OutputConnection *&conn)
 {
+	pthread_mutex_lock (&mutex);
+	
 	conn_id = -1;
 	
 	for (int i = 0 ; i < MAX_OUTPUT_CONN ; i++) {
@@ -254,13 +282,16 @@ int NetworkManager::createOutputConn (int &conn_id,
 	}
 	
 	if (conn_id == -1) {
+		pthread_mutex_unlock (&mutex);
 		return NET_MGR_RSRC_ERR;
 	}
 	
-	conn = new OutputConnection (LOG);
+	conn = new OutputConnection (conn_id, this, LOG);
 	
 	output_conns [conn_id] = conn;
 	
+	pthread_mutex_unlock (&mutex);
+	
 	return 0;
 }
 
@@ -269,10 +300,14 @@ int NetworkManager::getOutputConn (int conn_id, OutputConnection *&conn)
 	if (conn_id < 0 || conn_id >= MAX_OUTPUT_CONN)
 		return -1;
 
-	if (!output_conns [conn_id])
-		return -1;
+	pthread_mutex_lock (&mutex);
 
 	conn = output_conns [conn_id];
+	
+	pthread_mutex_unlock (&mutex);
+	
+	if (!conn)
+		return -1;
 
 	return 0;
 }
@@ -280,10 +315,15 @@ int NetworkManager::getOutputConn (int conn_id, OutputConnection *&conn)
 int NetworkManager::destroyOutputConn (int conn_id)
 {
 	ASSERT (conn_id >= 0 && conn_id < MAX_OUTPUT_CONN);
+	
+	pthread_mutex_lock (&mutex);
+	
 	ASSERT (output_conns [conn_id]);
 
 	delete output_conns [conn_id];
 	output_conns [conn_id] = 0;
+	
+	pthread_mutex_unlock (&mutex);
 
 	LOG << "Destroying output connection: " << conn_id << endl;
 	
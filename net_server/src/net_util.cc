@@ -1,4 +1,5 @@
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -82,6 +83,23 @@ int NetUtil::sendMessage(int sockfd, char *msgBuf,
 }
 
 
+int NetUtil::setBlocking (int sockfd, bool bBlocking)
+{
+	int flags;
+	
+	if ((flags = fcntl (sockfd, F_GETFL, 0)) < 0)
+		return -1;
+	
+	if (bBlocking)
+		flags &= ~O_NONBLOCK;
+	else
+		flags |= O_NONBLOCK;
+	
+	if (fcntl (sockfd, F_SETFL, flags) < 0)
+		return -1;
+	
+	return 0;
+}
 
 static int readn(int sockfd, char *buffer, unsigned int nbytes)
 {
@@ -5,258 +5,313 @@
 #include <unistd.h>
 #include <time.h>
 #include <errno.h>
+#include <arpa/inet.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 
 #include "debug.h"
 #include "net_util.h"
+#include "net_mgr.h"
 
 using namespace Network;
 using namespace std;
 
-OutputConnection::OutputConnection (std::ostream& _LOG)
+OutputConnection::OutputConnection (int id, NetworkManager *netMgr,
+									std::ostream& _LOG)
 	: LOG (_LOG)
 {
+	this -> id = id;
+	this -> netMgr = netMgr;
+	this -> loop = 0;
 	this -> sockfd = -1;
-	this -> read_ptr = 0;
-	this -> write_ptr = 0;
+	this -> queue = 0;
 	this -> bEnd = false;
-	this -> b_prod_waiting = false;
+	this -> sendOff = 0;
+	this -> sendLen = 0;
+	this -> bBinary = false;
+	this -> flushBytes = 0;
+	this -> flushMsecs = 0;
+	this -> unflushed = 0;
+	this -> bArmed = false;
+	this -> bTimerSet = false;
+	this -> bClosed = false;
 	
 	pthread_mutex_init (&mutex, NULL);
-	pthread_cond_init (&prod_wait_cond, NULL);
 
 	totalBytes = 0;
 }
 
 OutputConnection::~OutputConnection ()
 {
+	if (queue)
+		delete queue;
+	
 	pthread_mutex_destroy (&mutex);
-	pthread_cond_destroy (&prod_wait_cond);
 }
 
-int OutputConnection::setSocket (int fd)
+int OutputConnection::attach (EventLoop *loop, int fd, bool bBinary,
+							  int flushBytes, int flushMsecs)
 {
+	int rc;
+	
+	pthread_mutex_lock (&mutex);
+	
+	if (this -> loop) {
+		pthread_mutex_unlock (&mutex);
+		LOG << "OutputConnection: Socket already set" << endl;
+		return -1;
+	}
+	
+	this -> loop = loop;
 	this -> sockfd = fd;
-	return 0;
+	this -> bBinary = bBinary;
+	this -> flushBytes = flushBytes;
+	this -> flushMsecs = flushMsecs;
+	
+	// Output produced (or the end of the output reached) before the
+	// client connected
+	rc = 0;
+	if (!queueEmpty () || bEnd)
+		rc = arm ();
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return rc;
+}
+
+/**
+ * Put the socket in the loop to send the queued tuples out.  Called with
+ * the mutex held.
+ */
+
+int OutputConnection::arm ()
+{
+	if (!loop || bArmed || bClosed)
+		return 0;
+	
+	bArmed = true;
+	unflushed = 0;
+	return loop -> add (sockfd, this, EventLoop::EV_WRITE);
+}
+
+/**
+ * Have the loop arm the socket once the flush deadline of the tuples
+ * queued passes.  Called with the mutex held.
+ */
+
+int OutputConnection::setTimer ()
+{
+	if (!loop || bTimerSet || bClosed || flushMsecs <= 0)
+		return 0;
+	
+	bTimerSet = true;
+	return loop -> setTimer (this, flushMsecs);
+}
+
+bool OutputConnection::queueEmpty () const
+{
+	return (!queue || queue -> isEmpty ());
 }
 
 // Consumer
-void OutputConnection::run()
+int OutputConnection::handleWrite ()
 {
 	int rc;
-	struct timespec d, r;
-	
-	// Check if the socket is set
-	if (sockfd == -1) {
-		LOG << "OutputConnection: Socket not set" << endl;
-		return;
-	}
+	int nwritten;
+	bool bDestroy;
 	
-	// Set the sleep duration (0.1 sec)
-	d.tv_sec = 0;
-	d.tv_nsec = 100000000;	
+	// The next batch, once the last one is out
+	if (sendLen == 0 && (rc = encodeBatch ()) != 0)
+		return rc;
 	
-	while (!bEnd) {
-		
-		// Sleep for some duration: It is not critical that we sleep for
-		// exactly duration 'd' - so EINTR (error interrupt) is ok
-		if ((rc = nanosleep (&d, &r)) != 0) {
-			
-			if (errno != EINTR) {
-				LOG << "OutputConnection: Unexpected error in nanosleep"
-					<< endl;
-				return;
-			}
-		}
+	if (sendLen > 0) {
+		nwritten = send (sockfd, sendBuf + sendOff, sendLen, MSG_NOSIGNAL);
 		
-		// There is some data in the buffer: send it out to the client
-		if (!buf_empty ()) {
-			
-			if ((rc = consumeBuf ()) != 0) {
-				LOG << "OutputConnection: Error sending output"
-					<< endl;
-				return;
-			}
+		if (nwritten < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return 0;
+			return -1;
 		}
 		
-		// We wake up the producer if he is waiting for buffer space
-		pthread_mutex_lock (&mutex);
+		/// debug
+		totalBytes += nwritten;
 		
-		if (b_prod_waiting && !buf_full ()) {
-			pthread_cond_signal (&prod_wait_cond);
-		}
+		sendOff += nwritten;
+		sendLen -= nwritten;
 		
-		pthread_mutex_unlock (&mutex);
-	}
-
-	// There is (still) some data in the buffer: send it out to the client
-	if (!buf_empty ()) {
-		
-		if ((rc = consumeBuf ()) != 0) {
-			LOG << "OutputConnection: Error sending output"
-				<< endl;
-			return;
-		}		
+		// The rest when the socket is writable again
+		if (sendLen > 0)
+			return 0;
 	}
 	
-	return;
-}
-
-int OutputConnection::consumeBuf ()
-{
-	int rc;
-	int nbytes;
+	pthread_mutex_lock (&mutex);
 	
-	ASSERT (read_ptr != write_ptr);
-	
-	// Note: write_ptr is being updated concurrently
-	nbytes = write_ptr - read_ptr;
-	
-	if (nbytes > 0) {
-		ASSERT (nbytes + read_ptr <= BUF_SIZE);
+	// Nothing left to send: the producer puts the socket back in the
+	// loop (putNext())
+	rc = 0;
+	bDestroy = false;
+	if (queueEmpty ()) {
 		
-		if ((rc = consumeBuf (shared_buf + read_ptr,
-							  nbytes)) != 0)
-			return rc;
+		if (bEnd) {
+			close (sockfd);
+			bClosed = true;
+			bDestroy = true;
+		}
+		
+		else {
+			bArmed = false;
+			
+			// The producer checks bArmed after queueing a tuple: one
+			// of us sees what the other did
+			__sync_synchronize ();
+			
+			if (queueEmpty ())
+				rc = loop -> remove (sockfd);
+			else
+				bArmed = true;
+		}
 	}
 	
-	else {
-		
-		ASSERT (nbytes < 0);
-		ASSERT (nbytes + read_ptr >= 0);
-		
-		if ((rc = consumeBuf (shared_buf + read_ptr,
-							  BUF_SIZE - read_ptr)) != 0)
-			return rc;
-		
-		if ((rc = consumeBuf (shared_buf, nbytes + read_ptr)) != 0)
-			return rc;				
+	pthread_mutex_unlock (&mutex);
+	
+	if (bDestroy) {
+		loop -> cancelTimer (this);
+		LOG << "OutputConnection: connection closed" << endl;
+		return netMgr -> destroyOutputConn (id);
 	}
-
-	read_ptr += nbytes;
 	
-	return 0;
+	return rc;
 }
 
-#ifdef _TEST_
-#include <iostream>
-int OutputConnection::consumeBuf (char *buf, int size)
+int OutputConnection::handleRead ()
 {
-	for (int c = 0 ; c < size ; c++)
-		std::cout << buf [c];
-
-	return 0;
+	// Errors and hangups only: the client does not send anything
+	return -1;
 }
 
-#else
-int OutputConnection::consumeBuf (char *buf, int size)
-{	
-	int nleft, nwritten;
+void OutputConnection::handleError ()
+{
+	char *tuple;
+	bool bDestroy;
 	
-	nleft = size;
-
-	/// debug
-	totalBytes += size;
-	//LOG << "Sending out: " << size << " bytes" << endl;
-	//LOG << "Total sent: " << totalBytes << endl; 
+	LOG << "OutputConnection: Error sending output"
+		<< endl;
 	
-	while (nleft > 0) {
-
-		nwritten = write (sockfd, buf, nleft);
-		
-		if (nwritten <= 0) {
-			return -1;
-		}
-		
-		nleft -= nwritten;
-		buf += nwritten;
+	// The output produced from now on is dropped
+	pthread_mutex_lock (&mutex);
+	
+	close (sockfd);
+	bClosed = true;
+	bDestroy = bEnd;
+	
+	pthread_mutex_unlock (&mutex);
+	
+	// ... and so is the output queued: this also frees a producer
+	// waiting for room
+	while (!queueEmpty ()) {
+		queue -> getNextReadSlot (tuple);
+		queue -> commitRead (tuple);
 	}
 	
-	return 0;
-}
-#endif
-
-int OutputConnection::setNumAttrs (unsigned int numAttrs)
-{
-	if (numAttrs > MAX_ATTRS)
-		return -1;
+	loop -> cancelTimer (this);
 	
-	this -> numAttrs = numAttrs;
-	return 0;
+	if (bDestroy)
+		netMgr -> destroyOutputConn (id);
 }
 
-int OutputConnection::setAttrInfo (unsigned int attrPos,
-								   Type attrType, unsigned len)
+int OutputConnection::handleTimer ()
 {
-	if ((int)attrPos >= numAttrs)
-		return -1;
-
-	attrTypes [attrPos] = attrType;
-	attrLen [attrPos] = len;
-
-	return 0;
-}
+	int rc;
 	
-int OutputConnection::start ()
-{
-	int offset = 0;
+	pthread_mutex_lock (&mutex);
 	
-	if (numAttrs == 0)
-		return -1;
-
-
-	tstampOffset = offset;
-	offset += TIMESTAMP_SIZE;
-
-	signOffset = offset;
-	offset += 1;
+	bTimerSet = false;
 	
-	for (int a = 0 ; a < numAttrs ; a++) {
-
-		offsets [a] = offset;
-
-		switch (attrTypes [a]) {
-		case INT:
-			offset += INT_SIZE;
-			break;
-
-		case FLOAT:
-			offset += FLOAT_SIZE;
-			break;
-
-		case CHAR:
-			offset += attrLen [a];
-			break;
+	rc = 0;
+	if (!queueEmpty ())
+		rc = arm ();
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return rc;
+}
 
-		case BYTE:
-			offset ++;
-			break;
+/**
+ * Encode the tuples queued into the send buffer, as many as fit.  The
+ * tuples are dequeued as they are encoded.
+ */
 
-		default:
-			return -1;
+int OutputConnection::encodeBatch ()
+{
+	int rc;
+	char *tuple;
+	int maxLen;
+	int len;
+	int numRows;
+	int val;
+	
+	sendOff = 0;
+	sendLen = (bBinary)? FRAME_HDR_SIZE : 0;
+	maxLen = (bBinary)? tupleLen : LINE_BUF_SIZE;
+	numRows = 0;
+	
+	while (!queueEmpty () && sendLen + maxLen <= SEND_BUF_SIZE) {
+		
+		if ((rc = queue -> getNextReadSlot (tuple)) != 0)
+			return rc;
+		
+		if (bBinary) {
+			encodeRow (tuple, sendBuf + sendLen);
+			len = tupleLen;
+		}
+		else if ((rc = encodeLine (tuple, sendBuf + sendLen, len)) != 0) {
+			return rc;
 		}
+		
+		if ((rc = queue -> commitRead (tuple, false)) != 0)
+			return rc;
+		
+		sendLen += len;
+		numRows ++;
+	}
+	
+	// The slots are freed for the producer once per batch
+	if ((rc = queue -> flushReads ()) != 0)
+		return rc;
+	
+	if (numRows == 0) {
+		sendLen = 0;
+		return 0;
+	}
+	
+	if (bBinary) {
+		val = htonl (sendLen - sizeof (int));
+		memcpy (sendBuf, &val, sizeof (int));
+		sendBuf [sizeof (int)] = 'R';
+		val = htonl (numRows);
+		memcpy (sendBuf + sizeof (int) + 1, &val, sizeof (int));
 	}
-
-	tupleLen = offset;
 	
 	return 0;
 }
 
-int OutputConnection::putNext (const char *tuple, unsigned int len)
+/**
+ * Encode a tuple as a text line (at most LINE_BUF_SIZE bytes, with the
+ * newline).
+ */
+
+int OutputConnection::encodeLine (const char *tuple, char *line, int &len)
 {
-	int       rc;
 	Timestamp timestamp;
 	int       ival;
 	float     fval;	
 	char      *ptr;
 	int       nwritten, nfree;
 	
-	if ((int)len < tupleLen)
-		return -1;
-
-	// number of free bytes left in the line buffer
+	// number of free bytes left in the line
 	nfree = LINE_BUF_SIZE;
 	
-	ptr = lineBuf;
+	ptr = line;
 
 	//----------------------------------------------------------------------
 	// timestamp
@@ -358,69 +413,199 @@ int OutputConnection::putNext (const char *tuple, unsigned int len)
 		}
 	}
 	
-	// Assert: lineBuf is null terminated
-	if ((rc = writeln(lineBuf)) != 0)
-		return rc;
+	// The null becomes the newline
+	if (nfree <= 1)
+		return -1;
+	
+	*ptr = '\n';
+	len = ptr + 1 - line;
 	
 	return 0;
 }
 
-int OutputConnection::end ()
+/**
+ * Encode a tuple as a row of a binary frame: the sign, then the timestamp
+ * and the attributes.
+ */
+
+void OutputConnection::encodeRow (const char *tuple, char *row)
 {
-	ASSERT (!b_prod_waiting);
+	unsigned int val;
 	
-	bEnd = true;
-	return 0;
+	row [0] = tuple [signOffset];
+	
+	memcpy (&val, tuple + tstampOffset, TIMESTAMP_SIZE);
+	val = htonl (val);
+	memcpy (row + 1, &val, TIMESTAMP_SIZE);
+	
+	// The attributes follow the timestamp and the sign in the tuple
+	for (int a = 0 ; a < numAttrs ; a++) {
+		
+		switch (attrTypes [a]) {
+		case INT:
+		case FLOAT:
+			memcpy (&val, tuple + offsets [a], sizeof (int));
+			val = htonl (val);
+			memcpy (row + offsets [a], &val, sizeof (int));
+			break;
+			
+		case CHAR:
+		case BYTE:
+			memcpy (row + offsets [a], tuple + offsets [a], attrLen [a]);
+			break;
+			
+		default:
+			ASSERT (0);
+			break;
+		}
+	}
 }
 
-int OutputConnection::writeln (char *line)
+int OutputConnection::setNumAttrs (unsigned int numAttrs)
 {
-	int rc;
+	if (numAttrs > MAX_ATTRS)
+		return -1;
 	
-	for (; *line ; line++)
-		if ((rc = writechar (*line)) != 0)
-			return rc;
-
-	if ((rc = writechar ('\n')) != 0)
-		return rc;
+	this -> numAttrs = numAttrs;
 	return 0;
 }
 
+int OutputConnection::setAttrInfo (unsigned int attrPos,
+								   Type attrType, unsigned len)
+{
+	if ((int)attrPos >= numAttrs)
+		return -1;
 
-#define INCR(p) { if ((++(p)) == BUF_SIZE) (p) = 0;}
+	attrTypes [attrPos] = attrType;
+	attrLen [attrPos] = len;
 
-int OutputConnection::writechar (char c)
+	return 0;
+}
+	
+int OutputConnection::start ()
 {
-	ASSERT(!b_prod_waiting);
+	int offset = 0;
 	
-	if (buf_full ()) {
-		pthread_mutex_lock (&mutex);
-		
-		b_prod_waiting = true;
-		pthread_cond_wait (&prod_wait_cond, &mutex);
-		b_prod_waiting = false;
-		
-		pthread_mutex_unlock (&mutex);
-	}
+	if (numAttrs == 0)
+		return -1;
+
+
+	tstampOffset = offset;
+	offset += TIMESTAMP_SIZE;
+
+	signOffset = offset;
+	offset += 1;
 	
-	ASSERT (!buf_full());
+	for (int a = 0 ; a < numAttrs ; a++) {
+
+		offsets [a] = offset;
 
-	shared_buf [write_ptr] = c;
-	INCR (write_ptr);
+		switch (attrTypes [a]) {
+		case INT:
+			offset += INT_SIZE;
+			break;
+
+		case FLOAT:
+			offset += FLOAT_SIZE;
+			break;
+
+		case CHAR:
+			offset += attrLen [a];
+			break;
+
+		case BYTE:
+			attrLen [a] = 1;
+			offset ++;
+			break;
+
+		default:
+			return -1;
+		}
+	}
+
+	tupleLen = offset;
 	
-	return 0;	
+	// A binary frame holds at least one tuple
+	if (tupleLen + FRAME_HDR_SIZE > SEND_BUF_SIZE) {
+		LOG << "OutputConnection: tuples too long" << endl;
+		return -1;
+	}
+	
+	if (!queue)
+		queue = new Queue (LOG, tupleLen);
+	
+	return 0;
 }
 
-bool OutputConnection::buf_empty () const
+int OutputConnection::putNext (const char *tuple, unsigned int len)
 {
-	return (read_ptr == write_ptr);
+	int       rc;
+	char      *slot;
+	
+	if ((int)len < tupleLen)
+		return -1;
+	
+	// The client has gone away: the output is dropped
+	if (bClosed)
+		return 0;
+	
+	// The loop has to make room, whatever the flush policy
+	if (queue -> isFull ()) {
+		pthread_mutex_lock (&mutex);
+		rc = arm ();
+		pthread_mutex_unlock (&mutex);
+		
+		if (rc != 0)
+			return rc;
+	}
+	
+	if ((rc = queue -> getNextWriteSlot (slot)) != 0)
+		return rc;
+	
+	memcpy (slot, tuple, tupleLen);
+	
+	if ((rc = queue -> commitWrite (slot)) != 0)
+		return rc;
+	
+	// The loop sends the tuple out with those before it (see
+	// handleWrite(): the commit is a full barrier)
+	if (bArmed)
+		return 0;
+	
+	// Have the loop send the tuples out, now or by the flush deadline
+	pthread_mutex_lock (&mutex);
+	
+	unflushed += tupleLen;
+	if (unflushed >= flushBytes)
+		rc = arm ();
+	else
+		rc = setTimer ();
+	
+	pthread_mutex_unlock (&mutex);
+	
+	return rc;
 }
 
-bool OutputConnection::buf_full () const
+int OutputConnection::end ()
 {
-	return (((write_ptr == BUF_SIZE - 1) &&
-			 (read_ptr == 0)) ||
-			(write_ptr + 1 == read_ptr));
+	int rc;
+	bool bDestroy;
+	
+	pthread_mutex_lock (&mutex);
+	
+	bEnd = true;
+	
+	// The loop closes the connection once the output is sent out,
+	// unless the client has gone away
+	bDestroy = bClosed;
+	rc = arm ();
+	
+	pthread_mutex_unlock (&mutex);
+	
+	if (bDestroy)
+		return netMgr -> destroyOutputConn (id);
+	
+	return rc;
 }
 
 #ifdef _TEST_
@@ -4,27 +4,42 @@
 using namespace Network;
 using std::endl;
 
-#define INCR(s) ((s) = ((s) == lastSlot)? (buffer) : ((s)+objLen))
+#define LOAD_ACQUIRE(x)     __atomic_load_n (&(x), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(x,v)  __atomic_store_n (&(x), (v), __ATOMIC_RELEASE)
+
+/// Hint to the cpu that we are spinning
+static inline void cpuRelax ()
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__ ("pause");
+#endif
+}
 
 Queue::Queue (ostream &_LOG, int objLen)
 	: LOG (_LOG)
 {
-	int numObjs;
-	
 	this -> objLen = objLen;
 	
-	numObjs = BUF_SIZE / objLen;
-	if (numObjs <= 0) {		
+	// One slot is never used
+	numSlots = BUF_SIZE / objLen;
+	if (numSlots < 2) {
 		LOG << "Queue(constructor): objSize too large"
 			<< endl;
 	}
 	
-	nextReadSlot   = buffer;
-	nextWriteSlot  = buffer;
-	lastSlot       = buffer + objLen * (numObjs - 1);
-	bEmpty         = true;
-	bWriterBlocked = false;
-	bReaderBlocked = false;
+	nextTail         = 0;
+	numWritesPending = 0;
+	cachedHead       = 0;
+	writerSpins      = MIN_SPINS;
+	tail             = 0;
+	bWriterWaiting   = false;
+	
+	nextHead         = 0;
+	numReadsPending  = 0;
+	cachedTail       = 0;
+	readerSpins      = MIN_SPINS;
+	head             = 0;
+	bReaderWaiting   = false;
 	
 	pthread_mutex_init (&mutex, NULL);
 	pthread_cond_init (&nonempty_cond, NULL);
@@ -40,147 +55,206 @@ Queue::~Queue ()
 
 int Queue::getNextWriteSlot (char *&ptr)
 {
-	// The queue can be empty only if the read and write slot point to the
-	// same location.
-	ASSERT (!bEmpty || (nextReadSlot == nextWriteSlot));
-
-	// I (writer) am here, so I am unblocked
-	ASSERT (!bWriterBlocked);
-	
-	// We do have a free slot to write
-	if ((nextReadSlot != nextWriteSlot) || bEmpty) {
-		ptr = nextWriteSlot;
-		return 0;
-	}
+	// I (writer) am here, so I am not parked
+	ASSERT (!bWriterWaiting);
 	
-	// The queue is full
-	pthread_mutex_lock(&mutex);
+	if (isFull ())
+		waitNonFull ();
 	
-	// Note: we have to check again if the queue is full!!!
-	if ((nextReadSlot == nextWriteSlot) && !bEmpty) {
-		
-		// Set the indicator that we have blocked
-		bWriterBlocked = true;
-		
-		// We wait until the queue becomes non-full
-		pthread_cond_wait (&nonfull_cond, &mutex);
+	ptr = slot (nextTail);
+	return 0;
+}
 
-		// We are out of the block:
-		bWriterBlocked = false;		
-	}
-	
-	pthread_mutex_unlock(&mutex);
+int Queue::commitWrite (char *ptr, bool bPublish)
+{
+	// ptr has to be the same as the next write slot
+	ASSERT (ptr == slot (nextTail));
 	
-	// The queue has to be nonfull now
-	ASSERT ((nextReadSlot != nextWriteSlot) || !bEmpty);
+	nextTail = next (nextTail);
 	
-	ptr = nextWriteSlot;
+	if (bPublish || ++ numWritesPending == PUBLISH_BATCH)
+		publishWrites ();
 	
 	return 0;
 }
 
-int Queue::commitWrite (char *ptr)
+int Queue::flushWrites ()
 {
-	// The queue has to be non-full
-	ASSERT (bEmpty || (nextReadSlot != nextWriteSlot));
-	
-	// I (writer) am here, so I am unblocked
-	ASSERT (!bWriterBlocked);
-	
-	// ptr has to be the same as nextWriteSlot
-	ASSERT (ptr == nextWriteSlot);
-
-	// Critical code:
-	pthread_mutex_lock(&mutex);
+	if (numWritesPending > 0)
+		publishWrites ();
 	
-	// Queue can never be empty now
-	bEmpty = false;
-	
-	// Go to the next available write slot
-	INCR(nextWriteSlot);
+	return 0;
+}
 
-	// Wake up any blocked readers
-	if (bReaderBlocked) {
-		pthread_cond_signal (&nonempty_cond);
-	}
+/**
+ * Called by the writer
+ */
+bool Queue::isFull ()
+{
+	if (next (nextTail) != cachedHead)
+		return false;
 	
-	pthread_mutex_unlock (&mutex);
+	cachedHead = LOAD_ACQUIRE (head);
+	if (next (nextTail) != cachedHead)
+		return false;
 	
-	return 0;
+	// Really full: make sure the reader sees what we have
+	flushWrites ();
+	return true;
 }
 
 int Queue::getNextReadSlot (char *&ptr)
 {	
-	// The queue can be empty only if the read and write slot point to the
-	// same location.
-	ASSERT (!bEmpty || (nextReadSlot == nextWriteSlot));
+	// I am a reader and I am not parked
+	ASSERT (!bReaderWaiting);
 	
-	// I am a reader and I am not blocked
-	ASSERT (!bReaderBlocked);
+	if (isEmpty ())
+		waitNonEmpty ();
 	
-	// The queue is not empty:
-	if (!bEmpty) {
-		ptr = nextReadSlot;
-		return 0;
-	}
+	ptr = slot (nextHead);
+	return 0;
+}
 
-	// The queue is empty
-	pthread_mutex_lock(&mutex);
+int Queue::commitRead (char *ptr, bool bPublish)
+{
+	// ptr has to be the same as next read slot
+	ASSERT (ptr == slot (nextHead));
 	
-	// But we have to check it again!
-	if (bEmpty) {
-		
-		// Indicate we are blocked
-		bReaderBlocked = true;
-		
-		// Wait until the queue becomes nonempty
-		pthread_cond_wait (&nonempty_cond, &mutex);
-		
-		// Out of the block
-		bReaderBlocked = false;
-	}
+	// The queue has to be nonempty
+	ASSERT (nextHead != cachedTail);
 	
-	pthread_mutex_unlock(&mutex);
+	nextHead = next (nextHead);
 	
-	ASSERT (!bEmpty);
+	if (bPublish || ++ numReadsPending == PUBLISH_BATCH)
+		publishReads ();
 	
-	ptr = nextReadSlot;
 	return 0;
 }
 
-int Queue::commitRead (char *ptr)
+int Queue::flushReads ()
 {
-	// The queue has to be nonempty
-	ASSERT (!bEmpty);
+	if (numReadsPending > 0)
+		publishReads ();
 	
-	// I am a reader and I am not blocked, so:
-	ASSERT (!bReaderBlocked);
+	return 0;
+}
+
+/**
+ * Called by the reader
+ */
+bool Queue::isEmpty ()
+{
+	if (nextHead != cachedTail)
+		return false;
 	
-	// ptr has to be the same as next read block
-	ASSERT (ptr == nextReadSlot);
+	cachedTail = LOAD_ACQUIRE (tail);
+	if (nextHead != cachedTail)
+		return false;
 	
-	// critical code
-	pthread_mutex_lock(&mutex);
+	// Really empty: let the writer have the slots we have read
+	flushReads ();
+	return true;
+}
+
+/**
+ * The full barrier orders the store of our index before the load of the
+ * waiting flag of the other side, which stores the flag before it loads
+ * our index (see waitNonEmpty()): either it sees our index, or we see it
+ * waiting.
+ */
+
+void Queue::publishWrites ()
+{
+	STORE_RELEASE (tail, nextTail);
+	numWritesPending = 0;
 	
-	// Update the nextReadSlot
-	INCR (nextReadSlot);	
+	__sync_synchronize ();
 	
-	// If the read slot and write slot are identical now, it can happen
-	// only because the queue is empty.
-	if (nextReadSlot == nextWriteSlot) {
-		bEmpty = true;
+	// Wake up the reader if he is parked
+	if (bReaderWaiting) {
+		pthread_mutex_lock (&mutex);
+		pthread_cond_signal (&nonempty_cond);
+		pthread_mutex_unlock (&mutex);
 	}
+}
+
+void Queue::publishReads ()
+{
+	STORE_RELEASE (head, nextHead);
+	numReadsPending = 0;
+	
+	__sync_synchronize ();
 	
-	// Wake up any writers blocked due to queue being full.
-	if (bWriterBlocked) {
+	// Wake up the writer if he is parked
+	if (bWriterWaiting) {
+		pthread_mutex_lock (&mutex);
 		pthread_cond_signal (&nonfull_cond);
+		pthread_mutex_unlock (&mutex);
 	}
+}
+
+void Queue::waitNonFull ()
+{
+	unsigned int n;
 	
-	pthread_mutex_unlock(&mutex);
+	n = next (nextTail);
 	
-	return 0;
+	// The reader is likely to be at work: spin for a while
+	for (int s = 0 ; s < writerSpins ; s++) {
+		cpuRelax ();
+		
+		cachedHead = LOAD_ACQUIRE (head);
+		if (n != cachedHead) {
+			if (writerSpins < MAX_SPINS)
+				writerSpins *= 2;
+			return;
+		}
+	}
+	
+	if (writerSpins > MIN_SPINS)
+		writerSpins /= 2;
+	
+	// Park until the reader frees a slot
+	pthread_mutex_lock (&mutex);
+	
+	bWriterWaiting = true;
+	__sync_synchronize ();
+	
+	while (n == (cachedHead = LOAD_ACQUIRE (head)))
+		pthread_cond_wait (&nonfull_cond, &mutex);
+	
+	bWriterWaiting = false;
+	
+	pthread_mutex_unlock (&mutex);
 }
 
-bool Queue::isEmpty () const {
-	return bEmpty;
+void Queue::waitNonEmpty ()
+{
+	// The writer is likely to be at work: spin for a while
+	for (int s = 0 ; s < readerSpins ; s++) {
+		cpuRelax ();
+		
+		cachedTail = LOAD_ACQUIRE (tail);
+		if (nextHead != cachedTail) {
+			if (readerSpins < MAX_SPINS)
+				readerSpins *= 2;
+			return;
+		}
+	}
+	
+	if (readerSpins > MIN_SPINS)
+		readerSpins /= 2;
+	
+	// Park until the writer publishes an object
+	pthread_mutex_lock (&mutex);
+	
+	bReaderWaiting = true;
+	__sync_synchronize ();
+	
+	while (nextHead == (cachedTail = LOAD_ACQUIRE (tail)))
+		pthread_cond_wait (&nonempty_cond, &mutex);
+	
+	bReaderWaiting = false;
+	
+	pthread_mutex_unlock (&mutex);
 }
@@ -0,0 +1,62 @@
+#!/bin/bash
+
+#----------------------------------------------------------------------
+# Compare the schedulers on the test workloads.
+#
+# Usage: test/bench.sh [num-runs]
+#
+# Each test script is run num-runs times (default 5) with each of the
+# configurations below, and the average wall clock time (seconds) is
+# reported.  The output of every run is checked against sample-out.
+#----------------------------------------------------------------------
+
+ROOTDIR="`dirname $0`/.."
+PWD="`pwd`"
+
+cd "${ROOTDIR}"
+
+NUMRUNS=${1:-5}
+TESTS="1 2 3 4 5 6 7 9 10 11"
+CONFIGS="config config-mt config-ws config-chain config-fifo"
+TIMEFORMAT="%R"
+
+mkdir -p test/logs test/out 
+
+if [ $? -ne 0 ] 
+then
+	echo "Unable to create log and output directories";
+	exit 1
+fi	 
+
+printf "%-8s" "test"
+for CONFIG in ${CONFIGS}; do
+	printf "%12s" "${CONFIG}"
+done
+echo
+
+for TEST in ${TESTS}; do
+	printf "%-8s" "test${TEST}"
+	
+	for CONFIG in ${CONFIGS}; do
+		TOTAL="0"
+		STATUS=""
+		
+		for RUN in `seq ${NUMRUNS}`; do
+			rm -f test/out/test${TEST}*
+			
+			ELAPSED=`{ time ./gen_client/gen_client -l test/logs/bench -c test/${CONFIG} test/scripts/test${TEST} > /dev/null 2>&1 ; } 2>&1`
+			TOTAL=`awk "BEGIN { print ${TOTAL} + ${ELAPSED} }"`
+			
+			for OUT in test/out/test${TEST}*; do
+				diff -q ${OUT} test/sample-out/`basename ${OUT}` > /dev/null 2>&1 || STATUS="*"
+			done
+		done
+		
+		printf "%11.3f%1s" `awk "BEGIN { print ${TOTAL} / ${NUMRUNS} }"` "${STATUS}"
+	done
+	echo
+done
+
+echo "(* = output differs from sample-out)"
+
+cd "${PWD}"
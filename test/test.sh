@@ -178,5 +178,266 @@ else
     echo "Test 10 ok"
 fi 
 
+#------------------------------------------------------------
+# Test 11
+#
+
+`./gen_client/gen_client -l test/logs/log11 -c test/config-mt test/scripts/test11 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test11a test/sample-out/test11a > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test11b test/sample-out/test11b > /dev/null 2>&1`
+RET3="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" ]; then
+    echo "Test 11 failed"
+else
+    echo "Test 11 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 12: Test 11 with the work stealing scheduler
+#
+
+`./gen_client/gen_client -l test/logs/log12 -c test/config-ws test/scripts/test11 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test11a test/sample-out/test11a > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test11b test/sample-out/test11b > /dev/null 2>&1`
+RET3="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" ]; then
+    echo "Test 12 failed"
+else
+    echo "Test 12 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 13: Test 11 with the chain scheduler
+#
+
+`./gen_client/gen_client -l test/logs/log13 -c test/config-chain test/scripts/test11 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test11a test/sample-out/test11a > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test11b test/sample-out/test11b > /dev/null 2>&1`
+RET3="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" ]; then
+    echo "Test 13 failed"
+else
+    echo "Test 13 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 14: Test 11 with the fifo scheduler
+#
+
+`./gen_client/gen_client -l test/logs/log14 -c test/config-fifo test/scripts/test11 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test11a test/sample-out/test11a > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test11b test/sample-out/test11b > /dev/null 2>&1`
+RET3="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" ]; then
+    echo "Test 14 failed"
+else
+    echo "Test 14 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 15: Test 11 with vectorized selections and projections
+#
+
+`./gen_client/gen_client -l test/logs/log15 -c test/config-vec test/scripts/test11 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test11a test/sample-out/test11a > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test11b test/sample-out/test11b > /dev/null 2>&1`
+RET3="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" ]; then
+    echo "Test 15 failed"
+else
+    echo "Test 15 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 16: MAX and MIN aggregation over a window
+#
+
+`./gen_client/gen_client -l test/logs/log16 -c test/config test/scripts/test12 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test12 test/sample-out/test12 > /dev/null 2>&1`
+RET2="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" ]; then
+    echo "Test 16 failed"
+else
+    echo "Test 16 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 17: Tests 3 and 16 with open addressing hash indexes
+#
+
+`./gen_client/gen_client -l test/logs/log17a -c test/config-open test/scripts/test3 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test3 test/sample-out/test3 > /dev/null 2>&1`
+RET2="$?"
+
+`./gen_client/gen_client -l test/logs/log17b -c test/config-open test/scripts/test12 > /dev/null 2>&1`
+RET3="$?"
+
+`diff -q test/out/test12 test/sample-out/test12 > /dev/null 2>&1`
+RET4="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" -o "$RET4" != "0" ]; then
+    echo "Test 17 failed"
+else
+    echo "Test 17 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 18: Aggregation over a sliding range window
+#
+
+`./gen_client/gen_client -l test/logs/log18 -c test/config test/scripts/test13 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test13 test/sample-out/test13 > /dev/null 2>&1`
+RET2="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" ]; then
+    echo "Test 18 failed"
+else
+    echo "Test 18 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 19: Test 3 with the join probed by several threads
+#
+
+`./gen_client/gen_client -l test/logs/log19 -c test/config-par test/scripts/test3 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test3 test/sample-out/test3 > /dev/null 2>&1`
+RET2="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" ]; then
+    echo "Test 19 failed"
+else
+    echo "Test 19 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 20: Multi-way join
+#
+
+`./gen_client/gen_client -l test/logs/log20 -c test/config-mjoin test/scripts/test14 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test14 test/sample-out/test14 > /dev/null 2>&1`
+RET2="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" ]; then
+    echo "Test 20 failed"
+else
+    echo "Test 20 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 21: Join ordering with declared rates
+#
+
+`./gen_client/gen_client -l test/logs/log21 -c test/config test/scripts/test15 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test15 test/sample-out/test15 > /dev/null 2>&1`
+RET2="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" ]; then
+    echo "Test 21 failed"
+else
+    echo "Test 21 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 22: Migration to a new plan when the rates drift
+#
+
+`./gen_client/gen_client -l test/logs/log22 -c test/config-replan test/scripts/test16 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test16 test/sample-out/test16 > /dev/null 2>&1`
+RET2="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" ]; then
+    echo "Test 22 failed"
+else
+    echo "Test 22 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 23: Subplans shared across queries
+#
+
+`./gen_client/gen_client -l test/logs/log23 -c test/config-share test/scripts/test17 > /dev/null 2>&1`
+RET1="$?"
+
+`diff -q test/out/test17a test/sample-out/test17a > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test17b test/sample-out/test17b > /dev/null 2>&1`
+RET3="$?"
+
+`diff -q test/out/test17c test/sample-out/test17c > /dev/null 2>&1`
+RET4="$?"
+
+`diff -q test/out/test17d test/sample-out/test17d > /dev/null 2>&1`
+RET5="$?"
+
+`diff -q test/out/test17e test/sample-out/test17e > /dev/null 2>&1`
+RET6="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" \
+     -o "$RET4" != "0" -o "$RET5" != "0" -o "$RET6" != "0" ]; then
+    echo "Test 23 failed"
+else
+    echo "Test 23 ok"
+fi 
+
+#------------------------------------------------------------
+# Test 24: Replay of a recording
+#
+
+`./gen_client/rec_convert test/data/S3.dat test/out/S3.rec > /dev/null 2>&1`
+RET1="$?"
+
+`./gen_client/gen_client -l test/logs/log24 -c test/config test/scripts/test18 > /dev/null 2>&1`
+RET2="$?"
+
+`diff -q test/out/test18 test/sample-out/test1 > /dev/null 2>&1`
+RET3="$?"
+
+if [ "$RET1" != "0" -o "$RET2" != "0" -o "$RET3" != "0" ]; then
+    echo "Test 24 failed"
+else
+    echo "Test 24 ok"
+fi 
+
 
 cd "${PWD}"